@@ -33,6 +33,7 @@
 
 #include "BLRMatrix.hpp"
 #include "BLRTileBLAS.hpp"
+#include "misc/BinaryIO.hpp"
 
 namespace strumpack {
   namespace BLR {
@@ -369,6 +370,57 @@ namespace strumpack {
       blocks_.clear(); blocks_.shrink_to_fit();
     }
 
+    template<typename scalar_t> void
+    BLRMatrix<scalar_t>::write(BinaryWriter& w) const {
+      w.write(std::uint64_t(m_));
+      w.write(std::uint64_t(n_));
+      w.write_vector(roff_);
+      w.write_vector(coff_);
+      for (auto& b : blocks_) {
+        if (!b) w.write(char(0));
+        else if (b->is_low_rank()) {
+          w.write(char(2));
+          w.write_matrix(b->U());
+          w.write_matrix(b->V());
+        } else {
+          w.write(char(1));
+          w.write_matrix(b->D());
+        }
+      }
+      w.write_vector(piv_);
+    }
+
+    template<typename scalar_t> void
+    BLRMatrix<scalar_t>::read(BinaryReader& r) {
+      auto m = r.read<std::uint64_t>();
+      auto n = r.read<std::uint64_t>();
+      std::vector<std::size_t> roff, coff;
+      r.read_vector(roff);
+      r.read_vector(coff);
+      if (!r.good() || roff.empty() || coff.empty()) return;
+      std::vector<std::size_t> rt(roff.size()-1), ct(coff.size()-1);
+      for (std::size_t i=0; i<rt.size(); i++) rt[i] = roff[i+1] - roff[i];
+      for (std::size_t j=0; j<ct.size(); j++) ct[j] = coff[j+1] - coff[j];
+      *this = BLRMatrix<scalar_t>(m, rt, n, ct);
+      for (auto& b : blocks_) {
+        switch (r.read<char>()) {
+        case 1: {
+          auto t = std::make_unique<DenseTile<scalar_t>>(0, 0);
+          r.read_matrix(t->D());
+          b = std::move(t);
+        } break;
+        case 2: {
+          auto t = std::make_unique<LRTile<scalar_t>>();
+          r.read_matrix(t->U());
+          r.read_matrix(t->V());
+          b = std::move(t);
+        } break;
+        default: b.reset();
+        }
+      }
+      r.read_vector(piv_);
+    }
+
     template<typename scalar_t> std::size_t
     BLRMatrix<scalar_t>::rg2t(std::size_t i) const {
       return std::distance
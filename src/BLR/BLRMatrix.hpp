@@ -44,6 +44,11 @@
 #include "dense/GPUWrapper.hpp"
 
 namespace strumpack {
+
+  // forward declarations
+  class BinaryWriter;
+  class BinaryReader;
+
   namespace BLR {
 
     // forward declarations
@@ -115,6 +120,21 @@ namespace strumpack {
 
       void clear();
 
+      /**
+       * Write this BLR matrix, including the pivots from its LU
+       * factorization (if any), in binary format.
+       *
+       * \see read
+       */
+      void write(BinaryWriter& w) const;
+
+      /**
+       * Read a BLR matrix, written earlier with write.
+       *
+       * \see write
+       */
+      void read(BinaryReader& r);
+
       void solve(DenseM_t& x) const override {
         x.laswp(piv_, true);
         trsm(Side::L, UpLo::L, Trans::N, Diag::U, scalar_t(1.), *this, x, 0);
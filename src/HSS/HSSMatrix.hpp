@@ -512,6 +512,18 @@ namespace strumpack {
        */
       static HSSMatrix<scalar_t> read(const std::string& fname);
 
+      /**
+       * Write this HSSMatrix<scalar_t> to an (opened) binary file
+       * stream. This does not write the ULV factors.
+       */
+      void write(std::ofstream& os) const override;
+
+      /**
+       * Read an HSSMatrix<scalar_t> from an (opened) binary file
+       * stream, written with write(std::ofstream&).
+       */
+      void read(std::ifstream& is) override;
+
       const HSSFactors<scalar_t>& ULV() { return this->ULV_; }
 
     protected:
@@ -668,9 +680,6 @@ namespace strumpack {
       template<typename T> friend
       void draw(const HSSMatrix<T>& H, const std::string& name);
 
-      void read(std::ifstream& is) override;
-      void write(std::ofstream& os) const override;
-
       friend class HSSMatrixMPI<scalar_t>;
 
       using HSSMatrixBase<scalar_t>::child;
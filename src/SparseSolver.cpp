@@ -26,6 +26,10 @@
  *             Division).
  */
 
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
 #include "StrumpackSparseSolver.hpp"
 
 #if defined(STRUMPACK_USE_PAPI)
@@ -37,7 +41,9 @@
 #include "StrumpackOptions.hpp"
 #include "sparse/ordering/MatrixReordering.hpp"
 #include "sparse/EliminationTree.hpp"
+#include "sparse/fronts/Front.hpp"
 #include "iterative/IterativeSolvers.hpp"
+#include "misc/BinaryIO.hpp"
 
 namespace strumpack {
 
@@ -58,8 +64,15 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::setup_tree() {
-    tree_.reset(new EliminationTree<scalar_t,integer_t>
-                (opts_, *mat_, nd_->tree()));
+    if (analysis_key_) {
+      bool cached = !analysis_upd_.empty();
+      tree_.reset(new EliminationTree<scalar_t,integer_t>
+                  (opts_, *mat_, nd_->tree(), analysis_upd_));
+      if (!cached) write_analysis_cache();
+      std::vector<std::vector<integer_t>>().swap(analysis_upd_);
+    } else
+      tree_.reset(new EliminationTree<scalar_t,integer_t>
+                  (opts_, *mat_, nd_->tree()));
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -71,9 +84,95 @@ namespace strumpack {
   SparseSolver<scalar_t,integer_t>::compute_reordering
   (const int* p, int base, int nx, int ny, int nz,
    int components, int width) {
-    if (p) return nd_->set_permutation(opts_, *mat_, p, base);
-    return nd_->nested_dissection
-      (opts_, *mat_, nx, ny, nz, components, width);
+    analysis_key_ = 0;
+    analysis_upd_.clear();
+    analysis_cache_hit_ = false;
+    int ierr;
+    if (p) ierr = nd_->set_permutation(opts_, *mat_, p, base);
+    else {
+      // the analysis cache does not know about the Schur variables
+      if (!opts_.analysis_cache().empty() && schur_vars_.empty()) {
+        analysis_key_ = analysis_key(nx, ny, nz, components, width);
+        if ((analysis_cache_hit_ = read_analysis_cache())) return 0;
+      }
+      ierr = nd_->nested_dissection
+        (opts_, *mat_, nx, ny, nz, components, width);
+    }
+    if (!ierr && !schur_vars_.empty())
+      nd_->move_to_end(schur_vars_);
+    return ierr;
+  }
+
+  namespace {
+    // "STRMPSYM", followed by the cache file format version
+    const std::uint64_t analysis_magic = 0x4d5953504d525453;
+    const std::uint32_t analysis_format = 1;
+  }
+
+  template<typename scalar_t,typename integer_t> std::uint64_t
+  SparseSolver<scalar_t,integer_t>::analysis_key
+  (int nx, int ny, int nz, int components, int width) const {
+    // combine the pattern hash with everything that can change the
+    // outcome of the nested dissection
+    std::uint64_t h = mat_->pattern_hash();
+    for (std::uint64_t v :
+           {std::uint64_t(sizeof(integer_t)),
+               std::uint64_t(opts_.reordering_method()),
+               std::uint64_t(opts_.nd_param()),
+               std::uint64_t(opts_.nd_planar_levels()),
+               std::uint64_t(opts_.use_METIS_NodeNDP()),
+               std::uint64_t(opts_.use_MUMPS_SYMQAMD()),
+               std::uint64_t(opts_.use_agg_amalg()),
+               std::uint64_t(nx), std::uint64_t(ny), std::uint64_t(nz),
+               std::uint64_t(components), std::uint64_t(width)}) {
+      h ^= v + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+    }
+    return h ? h : 1;
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  SparseSolver<scalar_t,integer_t>::read_analysis_cache() {
+    const auto& fname = opts_.analysis_cache();
+    BinaryReader r(fname);
+    if (!r.good()) return false;
+    if (r.read<std::uint64_t>() != analysis_magic ||
+        r.read<std::uint32_t>() != analysis_format ||
+        r.read<std::uint64_t>() != analysis_key_)
+      return false;
+    nd_->read(r);
+    auto nseps = r.read<std::uint64_t>();
+    std::vector<std::vector<integer_t>> upd(nseps);
+    for (auto& u : upd) r.read_vector(u);
+    if (!r.good() || std::size_t(nd_->tree().separators()) != nseps ||
+        nd_->perm().size() != std::size_t(mat_->size())) {
+      std::cerr << "# WARNING: analysis cache " << fname
+                << " is corrupt, ignoring it" << std::endl;
+      nd_.reset(new MatrixReordering<scalar_t,integer_t>(mat_->size()));
+      return false;
+    }
+    analysis_upd_ = std::move(upd);
+    if (opts_.verbose() && is_root_)
+      std::cout << "# reusing ordering and symbolic factorization from "
+                << fname << std::endl;
+    return true;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::write_analysis_cache() const {
+    const auto& fname = opts_.analysis_cache();
+    BinaryWriter w(fname);
+    w.write(analysis_magic);
+    w.write(analysis_format);
+    w.write(analysis_key_);
+    nd_->write(w);
+    w.write(std::uint64_t(analysis_upd_.size()));
+    for (auto& u : analysis_upd_) w.write_vector(u);
+    if (!w.good())
+      std::cerr << "# WARNING: could not write analysis cache to "
+                << fname << std::endl;
+    else if (opts_.verbose() && is_root_)
+      std::cout << "# wrote ordering and symbolic factorization to "
+                << fname << std::endl;
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -86,32 +185,18 @@ namespace strumpack {
   (const CSRMatrix<scalar_t,integer_t>& A) {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
     factored_ = reordered_ = false;
+    schur_vars_.clear();
   }
 
   template <typename scalar_t, typename integer_t>
   void SparseSolver<scalar_t, integer_t>::set_lower_triangle_matrix
   (const CSRMatrix<scalar_t, integer_t> &A) {
-    auto ptr = A.ptr();
-    auto index = A.ind();
-    auto value = A.val();
-    std::vector<integer_t> mat_ptr = {0};
-    std::vector<integer_t> mat_ind;
-    std::vector<scalar_t> mat_val;
-    for (int row = 0; row < A.size(); ++row) {
-      mat_ptr.push_back(integer_t(0));
-      for (int j = ptr[row]; j < ptr[row + 1]; ++j) {
-        if (index[j] <= row) {
-          mat_ind.push_back(index[j]);
-          mat_val.push_back(value[j]);
-          mat_ptr[row + 1]++;
-        }
-      }
-      mat_ptr[row + 1] += mat_ptr[row];
-    }
-    mat_.reset(new CSRMatrix<scalar_t, integer_t>(
-        integer_t(mat_ptr.size() - 1), mat_ptr.data(), mat_ind.data(),
-        mat_val.data()));
+    // the lower triangle is mirrored, the symmetric fronts only use
+    // the lower triangular part, but the full matrix is needed for
+    // iterative refinement, Krylov solvers and the residual
+    mat_ = A.lower_to_full();
     factored_ = reordered_ = false;
+    schur_vars_.clear();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -122,8 +207,9 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
-    mat_.reset(new CSRMatrix<scalar_t,integer_t>(A));
-    permute_matrix_values();
+    replace_matrix_values
+      (std::unique_ptr<CSRMatrix<scalar_t,integer_t>>
+       (new CSRMatrix<scalar_t,integer_t>(A)));
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -133,6 +219,7 @@ namespace strumpack {
     mat_.reset(new CSRMatrix<scalar_t,integer_t>
                (N, row_ptr, col_ind, values, symmetric_pattern));
     factored_ = reordered_ = false;
+    schur_vars_.clear();
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -144,9 +231,43 @@ namespace strumpack {
       this->print_wrong_sparsity_error();
       return;
     }
-    mat_.reset(new CSRMatrix<scalar_t,integer_t>
-               (N, row_ptr, col_ind, values, symmetric_pattern));
+    replace_matrix_values
+      (std::unique_ptr<CSRMatrix<scalar_t,integer_t>>
+       (new CSRMatrix<scalar_t,integer_t>
+        (N, row_ptr, col_ind, values, symmetric_pattern)));
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::replace_matrix_values
+  (std::unique_ptr<CSRMatrix<scalar_t,integer_t>> A) {
+    bool incremental = reordered_ && factored_ &&
+      tree()->incremental_refactorization_supported();
+    auto old = std::move(mat_);
+    mat_ = std::move(A);
     permute_matrix_values();
+    if (!reordered_) return;
+    // entry (i,j) of the permuted matrix is assembled in the front
+    // with min(i,j) in its separator
+    integer_t n = mat_->size();
+    std::vector<integer_t> rows;
+    bool all = !incremental || old->nnz() != mat_->nnz();
+    for (integer_t i=0; i<n && !all; i++) {
+      if (old->ptr(i+1) != mat_->ptr(i+1)) { all = true; break; }
+      for (integer_t k=mat_->ptr(i); k<mat_->ptr(i+1); k++) {
+        auto j = mat_->ind(k);
+        if (old->ind(k) != j) { all = true; break; }
+        if (old->val(k) != mat_->val(k))
+          rows.push_back(std::min(i, j));
+      }
+    }
+    if (all) {
+      rows.resize(n);
+      std::iota(rows.begin(), rows.end(), 0);
+    } else {
+      std::sort(rows.begin(), rows.end());
+      rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    }
+    tree()->mark_changed(rows);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -171,17 +292,38 @@ namespace strumpack {
     return this->solve(*B, X, use_initial_guess);
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::out_of_core_status() const {
+    if (!tree() || tree()->out_of_core_good()) return ReturnCode::SUCCESS;
+    if (is_root_)
+      std::cerr << "ERROR: reading the factors from "
+                << opts_.out_of_core_file() << " failed" << std::endl;
+    return ReturnCode::IO_ERROR;
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::transform_x0
-  (DenseM_t& x, DenseM_t& xtmp) {
+  (DenseM_t& x, DenseM_t& xtmp, Trans op) {
     integer_t N = matrix()->size(), d = x.cols();
     auto& P = reordering()->iperm();
-    if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+    if (op != Trans::N) {
+      // inverse of transform_x for the (conjugate) transposed system
+      auto R = row_scaling();
+      for (integer_t j=0; j<d; j++)
+#pragma omp parallel for
+        for (integer_t i=0; i<N; i++) {
+          auto p = P[i];
+          xtmp(i, j) = x(p, j) / R[p];
+        }
+      x.copy(xtmp);
+      return;
+    }
+    if (matching_.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
       for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
         for (integer_t i=0; i<N; i++)
           x(i, j) = x(i, j) / matching_.C[i];
-    if (opts_.matching() == MatchingJob::NONE)
+    if (matching_.job == MatchingJob::NONE)
       xtmp.copy(x);
     else
       for (integer_t j=0; j<d; j++)
@@ -202,9 +344,20 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::transform_x
-  (DenseM_t& x, DenseM_t& xtmp) {
+  (DenseM_t& x, DenseM_t& xtmp, Trans op) {
     integer_t N = matrix()->size(), d = x.cols();
     auto& Pi = reordering()->perm();
+    if (op != Trans::N) {
+      // the row scaling and permutation of A are the column scaling
+      // and permutation of op(A)
+      auto R = row_scaling();
+      for (integer_t j=0; j<d; j++)
+#pragma omp parallel for
+        for (integer_t i=0; i<N; i++)
+          xtmp(i, j) = R[i] * x(Pi[i], j);
+      x.copy(xtmp);
+      return;
+    }
     for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
       for (integer_t i=0; i<N; i++)
@@ -215,14 +368,14 @@ namespace strumpack {
 #pragma omp parallel for
         for (integer_t i=0; i<N; i++)
           xtmp(i, j) = equil_.C[i] * xtmp(i, j);
-    if (opts_.matching() == MatchingJob::NONE)
+    if (matching_.job == MatchingJob::NONE)
       x.copy(xtmp);
     else {
       for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
         for (integer_t i=0; i<N; i++)
           x(matching_.Q[i], j) = xtmp(i, j);
-      if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+      if (matching_.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
         for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
           for (integer_t i=0; i<N; i++)
@@ -230,21 +383,54 @@ namespace strumpack {
     }
   }
 
-  template<typename scalar_t,typename integer_t> void
-  SparseSolver<scalar_t,integer_t>::transform_b
-  (const DenseM_t& b, DenseM_t& bloc) {
+  template<typename scalar_t,typename integer_t>
+  std::vector<typename RealType<scalar_t>::value_type>
+  SparseSolver<scalar_t,integer_t>::row_scaling() const {
     using real_t = typename RealType<scalar_t>::value_type;
-    integer_t N = matrix()->size(), d = b.cols();
-    auto& P = reordering()->iperm();
+    integer_t N = matrix()->size();
     std::vector<real_t> R(N, 1.);
     if (equil_.type == EquilibrationType::ROW ||
         equil_.type == EquilibrationType::BOTH)
       for (integer_t i=0; i<N; i++)
         R[i] *= equil_.R[i];
     if (this->reordered_ &&
-        opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+        matching_.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
       for (integer_t i=0; i<N; i++)
         R[i] *= matching_.R[i];
+    return R;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::transform_b
+  (const DenseM_t& b, DenseM_t& bloc, Trans op) {
+    using real_t = typename RealType<scalar_t>::value_type;
+    integer_t N = matrix()->size(), d = b.cols();
+    auto& P = reordering()->iperm();
+    if (op != Trans::N) {
+      // the column scaling and permutation of A are the row scaling
+      // and permutation of op(A)
+      std::vector<real_t> C(N, 1.);
+      std::vector<integer_t> Q(N);
+      std::iota(Q.begin(), Q.end(), 0);
+      if (matching_.job != MatchingJob::NONE) {
+        std::copy(matching_.Q.begin(), matching_.Q.end(), Q.begin());
+        if (matching_.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
+          for (integer_t i=0; i<N; i++)
+            C[i] *= matching_.C[Q[i]];
+      }
+      if (equil_.type == EquilibrationType::COLUMN ||
+          equil_.type == EquilibrationType::BOTH)
+        for (integer_t i=0; i<N; i++)
+          C[i] *= equil_.C[i];
+      for (integer_t j=0; j<d; j++)
+#pragma omp parallel for
+        for (integer_t i=0; i<N; i++) {
+          auto p = P[i];
+          bloc(i, j) = C[p] * b(Q[p], j);
+        }
+      return;
+    }
+    auto R = row_scaling();
     for (integer_t j=0; j<d; j++)
 #pragma omp parallel for
       for (integer_t i=0; i<N; i++) {
@@ -256,24 +442,50 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolver<scalar_t,integer_t>::solve_internal
   (const DenseM_t& b, DenseM_t& x, bool use_initial_guess) {
-    // reordering has to be called, even for the iterative solvers
-    if (!this->reordered_) {
-      ReturnCode ierr = this->reorder();
-      if (ierr != ReturnCode::SUCCESS) return ierr;
+    return solve_internal(b, x, Trans::N, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve_internal
+  (const DenseM_t& b, DenseM_t& x, Trans op, bool use_initial_guess) {
+    if (!schur_vars_.empty()) {
+      if (is_root_)
+        std::cerr << "ERROR: solve is not supported after factor_schur,"
+                  << " the factorization is incomplete" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
     }
-    // factor needs to be called, except for the non-preconditioned
-    // solvers
-    if (!this->factored_ &&
-        (opts_.Krylov_solver() != KrylovSolver::GMRES) &&
-        (opts_.Krylov_solver() != KrylovSolver::BICGSTAB)) {
-      ReturnCode ierr = this->factor();
-      // TODO there could be zero pivots, but replaced, and this
-      // should still continue!!
-      if (ierr != ReturnCode::SUCCESS) return ierr;
+    {
+      // concurrent solves wait until the first one has done the
+      // reordering and factorization
+      std::lock_guard<std::mutex> lock(this->setup_mutex_);
+      // reordering has to be called, even for the iterative solvers
+      if (!this->reordered_) {
+        ReturnCode ierr = this->reorder();
+        if (ierr != ReturnCode::SUCCESS) return ierr;
+      }
+      // factor needs to be called, except for the non-preconditioned
+      // solvers
+      if (!this->factored_ &&
+          (opts_.Krylov_solver() != KrylovSolver::GMRES) &&
+          (opts_.Krylov_solver() != KrylovSolver::BICGSTAB) &&
+          (opts_.Krylov_solver() != KrylovSolver::CG)) {
+        ReturnCode ierr = this->factor();
+        // TODO there could be zero pivots, but replaced, and this
+        // should still continue!!
+        if (ierr != ReturnCode::SUCCESS) return ierr;
+      }
+    }
+    if (op != Trans::N && this->factored_ &&
+        !tree()->transpose_solve_supported()) {
+      if (is_root_)
+        std::cerr << "ERROR: the (conjugate) transposed solve is only"
+                  << " supported for dense and BLR fronts on the CPU"
+                  << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
     }
 
     TaskTimer t("solve");
-    this->perf_counters_start();
+    this->solve_stats_start();
     t.start();
     assert(b.cols() == x.cols());
 
@@ -281,14 +493,22 @@ namespace strumpack {
     assert(matrix()->size() < std::numeric_limits<int>::max());
     DenseM_t bloc(b.rows(), d);
 
-    auto spmv = [&](const scalar_t* x, scalar_t* y)
-                { matrix()->spmv(x, y); };
-    Krylov_its_ = 0;
+    auto spmv = [&](const scalar_t* x, scalar_t* y) {
+      if (op == Trans::N) matrix()->spmv(x, y);
+      else {
+        auto N = matrix()->size();
+        auto X = ConstDenseMatrixWrapperPtr(N, 1, x, N);
+        DenseMW_t Y(N, 1, y, N);
+        mat_->spmv(op, *X, Y);
+      }
+    };
+    // per solve, so that solves can run concurrently
+    int its = 0;
 
     if (use_initial_guess &&
         opts_.Krylov_solver() != KrylovSolver::DIRECT)
-      transform_x0(x, bloc);
-    transform_b(b, bloc);
+      transform_x0(x, bloc, op);
+    transform_b(b, bloc, op);
 
     auto MFsolve =
       [&](scalar_t* w) {
@@ -304,74 +524,560 @@ namespace strumpack {
             << "and set the MAGMA_DIR environment variable" << std::endl
             << "-------------------------------------------------------" << std::endl;
 #endif
-        tree()->multifrontal_solve(X);
+        tree()->multifrontal_solve(op, X);
       };
+    auto block_spmv = [&](const DenseM_t& x, DenseM_t& y) {
+      if (op == Trans::N) matrix()->spmv(x, y);
+      else mat_->spmv(op, x, y);
+    };
+    auto block_MFsolve =
+      [&](DenseM_t& w) { tree()->multifrontal_solve(op, w); };
+    auto refine = [&]() {
+      if (op == Trans::N)
+        iterative::IterativeRefinement<scalar_t,integer_t>
+          (*matrix(), block_MFsolve, x, bloc,
+           opts_.rel_tol(), opts_.abs_tol(),
+           its, opts_.maxit(), use_initial_guess,
+           opts_.verbose() && is_root_);
+      else
+        iterative::IterativeRefinement<scalar_t>
+          (block_spmv, block_MFsolve, x, bloc,
+           opts_.rel_tol(), opts_.abs_tol(),
+           its, opts_.maxit(), use_initial_guess,
+           opts_.verbose() && is_root_);
+    };
 
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
+      bool spd = opts_.use_symmetric() && opts_.use_positive_definite();
+      if (opts_.compression() != CompressionType::NONE && spd) {
+        if (x.cols() == 1)
+          iterative::ConjugateGradient<scalar_t>
+            (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
+             opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+             use_initial_guess, opts_.verbose() && is_root_);
+        else
+          iterative::BlockConjugateGradient<scalar_t>
+            (block_spmv, block_MFsolve, x, bloc,
+             opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+             use_initial_guess, opts_.verbose() && is_root_);
+      } else if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
         iterative::GMRes<scalar_t>
           (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
            opts_.gmres_restart(), opts_.GramSchmidt_type(),
            use_initial_guess, opts_.verbose() && is_root_);
-      else
-        iterative::IterativeRefinement<scalar_t,integer_t>
-          (*matrix(), [&](DenseM_t& w) { tree()->multifrontal_solve(w); },
-           x, bloc, opts_.rel_tol(), opts_.abs_tol(),
-           Krylov_its_, opts_.maxit(), use_initial_guess,
-           opts_.verbose() && is_root_);
+      else if (opts_.compression() != CompressionType::NONE)
+        iterative::BlockGMRes<scalar_t>
+          (block_spmv, block_MFsolve, x, bloc,
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      else refine();
     }; break;
     case KrylovSolver::DIRECT: {
       x = bloc;
-      tree()->multifrontal_solve(x);
+      tree()->multifrontal_solve(op, x);
     }; break;
     case KrylovSolver::REFINE: {
-      iterative::IterativeRefinement<scalar_t,integer_t>
-        (*matrix(), [&](DenseM_t& w) { tree()->multifrontal_solve(w); },
-         x, bloc, opts_.rel_tol(), opts_.abs_tol(),
-         Krylov_its_, opts_.maxit(), use_initial_guess,
-         opts_.verbose() && is_root_);
+      refine();
     }; break;
     case KrylovSolver::PREC_GMRES: {
-      assert(x.cols() == 1);
-      iterative::GMRes<scalar_t>
-        (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         opts_.gmres_restart(), opts_.GramSchmidt_type(),
-         use_initial_guess, opts_.verbose() && is_root_);
+      if (x.cols() == 1)
+        iterative::GMRes<scalar_t>
+          (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      else
+        iterative::BlockGMRes<scalar_t>
+          (block_spmv, block_MFsolve, x, bloc,
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose() && is_root_);
     }; break;
     case KrylovSolver::PREC_BICGSTAB: {
-      assert(x.cols() == 1);
-      iterative::BiCGStab<scalar_t>
-        (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         use_initial_guess, opts_.verbose() && is_root_);
+      if (x.cols() == 1)
+        iterative::BiCGStab<scalar_t>
+          (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      else
+        iterative::BlockBiCGStab<scalar_t>
+          (block_spmv, block_MFsolve, x, bloc,
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           use_initial_guess, opts_.verbose() && is_root_);
     }; break;
     case KrylovSolver::GMRES: { // see above
-      assert(x.cols() == 1);
-      iterative::GMRes<scalar_t>
-        (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         opts_.gmres_restart(), opts_.GramSchmidt_type(),
-         use_initial_guess, opts_.verbose() && is_root_);
+      if (x.cols() == 1)
+        iterative::GMRes<scalar_t>
+          (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      else
+        iterative::BlockGMRes<scalar_t>
+          (block_spmv, [](DenseM_t& x) {}, x, bloc,
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose() && is_root_);
     }; break;
     case KrylovSolver::BICGSTAB: {
-      assert(x.cols() == 1);
-      iterative::BiCGStab<scalar_t>
-        (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         use_initial_guess, opts_.verbose() && is_root_);
+      if (x.cols() == 1)
+        iterative::BiCGStab<scalar_t>
+          (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      else
+        iterative::BlockBiCGStab<scalar_t>
+          (block_spmv, [](DenseM_t& x) {}, x, bloc,
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           use_initial_guess, opts_.verbose() && is_root_);
+    }; break;
+    case KrylovSolver::PREC_CG: {
+      if (x.cols() == 1)
+        iterative::ConjugateGradient<scalar_t>
+          (spmv, MFsolve, x.rows(), x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      else
+        iterative::BlockConjugateGradient<scalar_t>
+          (block_spmv, block_MFsolve, x, bloc,
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           use_initial_guess, opts_.verbose() && is_root_);
+    }; break;
+    case KrylovSolver::CG: {
+      if (x.cols() == 1)
+        iterative::ConjugateGradient<scalar_t>
+          (spmv, [](scalar_t* x) {}, x.rows(), x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      else
+        iterative::BlockConjugateGradient<scalar_t>
+          (block_spmv, [](DenseM_t& x) {}, x, bloc,
+           opts_.rel_tol(), opts_.abs_tol(), its, opts_.maxit(),
+           use_initial_guess, opts_.verbose() && is_root_);
     }
     }
-    transform_x(x, bloc);
+    transform_x(x, bloc, op);
 
     t.stop();
-    this->perf_counters_stop("DIRECT/GMRES solve");
-    this->print_solve_stats(t);
+    Krylov_its_ = its;
+    this->solve_stats_stop(t);
+    return out_of_core_status();
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::solve_sparse
+  (const DenseM_t& b, const std::vector<integer_t>& b_rows,
+   DenseM_t& x, const std::vector<integer_t>& x_rows) {
+    if (!schur_vars_.empty()) {
+      if (is_root_)
+        std::cerr << "ERROR: solve is not supported after factor_schur,"
+                  << " the factorization is incomplete" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    {
+      std::lock_guard<std::mutex> lock(this->setup_mutex_);
+      if (!this->reordered_) {
+        ReturnCode ierr = this->reorder();
+        if (ierr != ReturnCode::SUCCESS) return ierr;
+      }
+      if (!this->factored_) {
+        ReturnCode ierr = this->factor();
+        if (ierr != ReturnCode::SUCCESS) return ierr;
+      }
+    }
+    TaskTimer t("solve");
+    this->solve_stats_start();
+    t.start();
+    assert(b.cols() == x.cols());
+    integer_t N = matrix()->size(), d = b.cols();
+    auto& Pi = reordering()->perm();
+    auto R = row_scaling();
+    bool mdps =
+      matching_.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING;
+    bool ceq = equil_.type == EquilibrationType::COLUMN ||
+      equil_.type == EquilibrationType::BOTH;
+    // transform_b/transform_x, restricted to the requested rows
+    DenseM_t bloc(N, d);
+    bloc.zero();
+    std::vector<integer_t> brows, xrows, xcols(x_rows.size());
+    brows.reserve(b_rows.size());
+    for (auto p : b_rows) {
+      assert(p >= 0 && p < N);
+      auto i = Pi[p];
+      for (integer_t j=0; j<d; j++)
+        bloc(i, j) = R[p] * b(p, j);
+      brows.push_back(i);
+    }
+    if (matching_.job == MatchingJob::NONE)
+      std::copy(x_rows.begin(), x_rows.end(), xcols.begin());
+    else {
+      std::vector<integer_t> iQ(N);
+      for (integer_t i=0; i<N; i++)
+        iQ[matching_.Q[i]] = i;
+      for (std::size_t k=0; k<x_rows.size(); k++)
+        xcols[k] = iQ[x_rows[k]];
+    }
+    xrows.reserve(x_rows.size());
+    for (auto i : xcols) {
+      assert(i >= 0 && i < N);
+      xrows.push_back(Pi[i]);
+    }
+    for (auto rows : {&brows, &xrows}) {
+      std::sort(rows->begin(), rows->end());
+      rows->erase(std::unique(rows->begin(), rows->end()), rows->end());
+    }
+    tree()->multifrontal_solve_sparse(bloc, brows, xrows);
+    for (std::size_t k=0; k<x_rows.size(); k++) {
+      auto q = x_rows[k];
+      auto i = xcols[k];
+      for (integer_t j=0; j<d; j++) {
+        auto xqj = bloc(Pi[i], j);
+        if (ceq) xqj *= equil_.C[i];
+        if (mdps) xqj *= matching_.C[q];
+        x(q, j) = xqj;
+      }
+    }
+    Krylov_its_ = 0;
+    t.stop();
+    this->solve_stats_stop(t);
+    return out_of_core_status();
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::factor_schur
+  (const std::vector<integer_t>& vars, DenseM_t& S) {
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    if (is_symmetric_front(opts_)) {
+      if (is_root_)
+        std::cerr << "ERROR: factor_schur is not supported for the"
+                  << " symmetric solver" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    if (reordered_ && vars != schur_vars_) {
+      if (is_root_)
+        std::cerr << "ERROR: the matrix was already reordered, set the"
+                  << " matrix again before calling factor_schur"
+                  << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    integer_t N = matrix()->size(), m = vars.size();
+    std::vector<bool> mark(N, false);
+    for (auto v : vars) {
+      if (v < 0 || v >= N || mark[v]) {
+        if (is_root_)
+          std::cerr << "ERROR: invalid or duplicate Schur variable "
+                    << v << std::endl;
+        return ReturnCode::NOT_SUPPORTED;
+      }
+      mark[v] = true;
+    }
+    if (!reordered_) {
+      schur_vars_ = vars;
+      // the Schur variables must stay in place, so no matching for
+      // this reordering, but the caller's options are left untouched
+      auto job = opts_.matching();
+      if (job != MatchingJob::NONE && opts_.verbose() && is_root_)
+        std::cout << "# disabling matching for the Schur complement"
+                  << std::endl;
+      opts_.set_matching(MatchingJob::NONE);
+      ReturnCode ierr = this->reorder();
+      opts_.set_matching(job);
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    if (tree()->root()->isHSS() ||
+        opts_.compression() == CompressionType::HODLR) {
+      if (is_root_)
+        std::cerr << "ERROR: factor_schur is not supported for HSS or"
+                  << " HODLR compression of the root front" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    // the contribution block of the root is released when it is
+    // assembled in S, so always refactor
+    factored_ = false;
+    ReturnCode ierr = this->factor();
+    if (ierr != ReturnCode::SUCCESS) return ierr;
+    DenseM_t Sp;
+    tree()->schur_complement(*matrix(), Sp);
+    // undo the permutation and the equilibration
+    using real_t = typename RealType<scalar_t>::value_type;
+    auto& Pi = reordering()->perm();
+    auto R = row_scaling();
+    bool ceq = equil_.type == EquilibrationType::COLUMN ||
+      equil_.type == EquilibrationType::BOTH;
+    integer_t s0 = N - m;
+    S = DenseM_t(m, m);
+    for (integer_t j=0; j<m; j++) {
+      auto vj = vars[j];
+      real_t cj = ceq ? equil_.C[vj] : real_t(1.);
+      for (integer_t i=0; i<m; i++) {
+        auto vi = vars[i];
+        S(i, j) = Sp(Pi[vi]-s0, Pi[vj]-s0) / (R[vi] * cj);
+      }
+    }
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::selected_inverse
+  (const std::vector<integer_t>& rows, const std::vector<integer_t>& cols,
+   std::vector<scalar_t>& vals) {
+    assert(rows.size() == cols.size());
+    if (!schur_vars_.empty()) {
+      if (is_root_)
+        std::cerr << "ERROR: selected_inverse is not supported after"
+                  << " factor_schur" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    if (!this->factored_) {
+      ReturnCode ierr = this->factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    if (!tree()->selected_inversion_supported()) {
+      if (is_root_)
+        std::cerr << "ERROR: selected inversion is only supported for"
+                  << " dense fronts on the CPU" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    TaskTimer t("selinv");
+    this->perf_counters_start();
+    t.start();
+    using real_t = typename RealType<scalar_t>::value_type;
+    integer_t N = matrix()->size();
+    auto& Pi = reordering()->perm();
+    auto R = row_scaling();
+    bool mdps =
+      matching_.job == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING;
+    bool ceq = equil_.type == EquilibrationType::COLUMN ||
+      equil_.type == EquilibrationType::BOTH;
+    std::vector<integer_t> iQ;
+    if (matching_.job != MatchingJob::NONE) {
+      iQ.resize(N);
+      for (integer_t i=0; i<N; i++)
+        iQ[matching_.Q[i]] = i;
+    }
+    // inv(A)(a,b) = C(a) inv(Ap)(perm[iQ[a]], perm[b]) R(b), with Ap
+    // the permuted and scaled matrix, see transform_b/transform_x
+    std::size_t n = rows.size();
+    std::vector<integer_t> r(n), c(n);
+    for (std::size_t k=0; k<n; k++) {
+      assert(rows[k] >= 0 && rows[k] < N && cols[k] >= 0 && cols[k] < N);
+      r[k] = Pi[iQ.empty() ? rows[k] : iQ[rows[k]]];
+      c[k] = Pi[cols[k]];
+    }
+    if (!tree()->selected_inversion(r, c, vals)) {
+      auto ierr = out_of_core_status();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+      if (is_root_)
+        std::cerr << "ERROR: requested entries of the inverse are not in"
+                  << " the sparsity pattern of the factors" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    for (std::size_t k=0; k<n; k++) {
+      auto a = rows[k], i = iQ.empty() ? a : iQ[a];
+      real_t s = R[cols[k]];
+      if (ceq) s *= equil_.C[i];
+      if (mdps) s *= matching_.C[a];
+      vals[k] *= s;
+    }
+    t.stop();
+    this->perf_counters_stop("selected inversion");
+    if (opts_.verbose() && is_root_)
+      std::cout << "# selected inversion:" << std::endl
+                << "#   - number of entries = "
+                << number_format_with_commas(n) << std::endl
+                << "#   - selinv time = " << t.elapsed() << std::endl;
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::inverse_diagonal
+  (std::vector<scalar_t>& d) {
+    if (!matrix()) return ReturnCode::MATRIX_NOT_SET;
+    std::vector<integer_t> I(matrix()->size());
+    std::iota(I.begin(), I.end(), 0);
+    return selected_inverse(I, I, d);
+  }
+
+  namespace {
+    // "STRUMPCK" followed by the file format version
+    const std::uint64_t factors_magic = 0x4b43504d55525453;
+    const std::uint32_t factors_format = 2;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::save_factors
+  (const std::string& fname) const {
+    if (!mat_) return ReturnCode::MATRIX_NOT_SET;
+    if (!factored_ || !nd_ || !tree_) {
+      std::cerr << "ERROR: save_factors requires a factored matrix"
+                << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    if (!schur_vars_.empty()) {
+      std::cerr << "ERROR: save_factors is not supported after"
+                << " factor_schur" << std::endl;
+      return ReturnCode::NOT_SUPPORTED;
+    }
+    BinaryWriter w(fname);
+    if (!w.good()) {
+      std::cerr << "ERROR: could not open " << fname
+                << " for writing" << std::endl;
+      return ReturnCode::IO_ERROR;
+    }
+    int v[3];
+    get_version(v, v+1, v+2);
+    w.write(factors_magic);
+    w.write(factors_format);
+    for (auto vi : v) w.write(std::int32_t(vi));
+    w.write(std::uint32_t(sizeof(scalar_t)));
+    w.write(char(is_complex<scalar_t>()));
+    w.write(std::uint32_t(sizeof(integer_t)));
+    w.write(std::int64_t(mat_->size()));
+    w.write(opts_.compression());
+    w.write(opts_.matching());
+    w.write(matching_.job);
+    w.write_vector(matching_.Q);
+    w.write_vector(matching_.R);
+    w.write_vector(matching_.C);
+    w.write(equil_.type);
+    w.write(equil_.info);
+    w.write(equil_.rcond);
+    w.write(equil_.ccond);
+    w.write(equil_.Amax);
+    w.write_vector(equil_.R);
+    w.write_vector(equil_.C);
+    w.write(char(mat_->symm_sparse()));
+    w.write_vector(std::vector<integer_t>
+                   (mat_->ptr(), mat_->ptr()+mat_->size()+1));
+    w.write_vector(std::vector<integer_t>
+                   (mat_->ind(), mat_->ind()+mat_->nnz()));
+    w.write_vector(std::vector<scalar_t>
+                   (mat_->val(), mat_->val()+mat_->nnz()));
+    nd_->write(w);
+    auto ierr = tree_->write(w);
+    if (ierr != ReturnCode::SUCCESS) return ierr;
+    if (!w.good()) {
+      std::cerr << "ERROR: failed writing to " << fname << std::endl;
+      return ReturnCode::IO_ERROR;
+    }
     return ReturnCode::SUCCESS;
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolver<scalar_t,integer_t>::load_factors(const std::string& fname) {
+    TaskTimer t("load");
+    t.start();
+    BinaryReader r(fname);
+    if (!r.good()) {
+      std::cerr << "ERROR: could not open " << fname
+                << " for reading" << std::endl;
+      return ReturnCode::IO_ERROR;
+    }
+    int v[3];
+    get_version(v, v+1, v+2);
+    if (r.read<std::uint64_t>() != factors_magic ||
+        r.read<std::uint32_t>() != factors_format) {
+      std::cerr << "ERROR: " << fname
+                << " is not a STRUMPACK factors file" << std::endl;
+      return ReturnCode::IO_ERROR;
+    }
+    int fv[3];
+    for (auto& vi : fv) vi = r.read<std::int32_t>();
+    if (opts_.verbose() && is_root_ &&
+        (fv[0] != v[0] || fv[1] != v[1] || fv[2] != v[2]))
+      std::cout << "# WARNING: factors were written by STRUMPACK "
+                << fv[0] << "." << fv[1] << "." << fv[2] << std::endl;
+    if (r.read<std::uint32_t>() != sizeof(scalar_t) ||
+        r.read<char>() != char(is_complex<scalar_t>()) ||
+        r.read<std::uint32_t>() != sizeof(integer_t)) {
+      std::cerr << "ERROR: " << fname << " was written with a "
+                << "different scalar or integer type" << std::endl;
+      return ReturnCode::IO_ERROR;
+    }
+    // everything is read into local objects first, so a corrupt or
+    // truncated file leaves the current factorization untouched
+    auto n = r.read<std::int64_t>();
+    auto comp = r.read<CompressionType>();
+    auto mjob = r.read<MatchingJob>();
+    MatchingData<scalar_t,integer_t> matching;
+    r.read(matching.job);
+    r.read_vector(matching.Q);
+    r.read_vector(matching.R);
+    r.read_vector(matching.C);
+    Equilibration<scalar_t> equil;
+    r.read(equil.type);
+    r.read(equil.info);
+    r.read(equil.rcond);
+    r.read(equil.ccond);
+    r.read(equil.Amax);
+    r.read_vector(equil.R);
+    r.read_vector(equil.C);
+    bool symm = r.read<char>();
+    std::vector<integer_t> ptr, ind;
+    std::vector<scalar_t> val;
+    r.read_vector(ptr);
+    r.read_vector(ind);
+    r.read_vector(val);
+    auto valid = [n](const std::vector<integer_t>& v) {
+      return std::all_of(v.begin(), v.end(), [n](integer_t i) {
+          return i >= 0 && i < n; }); };
+    auto valid_size = [n](std::size_t s) {
+      return s == 0 || s == std::size_t(n); };
+    bool ok = r.good() && n >= 0 &&
+      n <= std::numeric_limits<integer_t>::max() &&
+      ptr.size() == std::size_t(n+1) && ind.size() == val.size() &&
+      ptr[0] == 0 && ptr[n] == integer_t(ind.size()) &&
+      std::is_sorted(ptr.begin(), ptr.end()) && valid(ind) &&
+      valid_size(matching.Q.size()) && valid(matching.Q) &&
+      valid_size(matching.R.size()) && valid_size(matching.C.size()) &&
+      valid_size(equil.R.size()) && valid_size(equil.C.size());
+    if (!ok) {
+      std::cerr << "ERROR: failed reading the matrix from "
+                << fname << std::endl;
+      return ReturnCode::IO_ERROR;
+    }
+    std::unique_ptr<MatrixReordering<scalar_t,integer_t>> nd
+      (new MatrixReordering<scalar_t,integer_t>(n));
+    nd->read(r);
+    std::unique_ptr<EliminationTree<scalar_t,integer_t>> tree
+      (new EliminationTree<scalar_t,integer_t>());
+    auto ierr = tree->read(r);
+    if (ierr != ReturnCode::SUCCESS || !r.good() ||
+        nd->perm().size() != std::size_t(n) || !valid(nd->perm()) ||
+        nd->iperm().size() != std::size_t(n) || !valid(nd->iperm())) {
+      std::cerr << "ERROR: failed reading the factors from "
+                << fname << std::endl;
+      return ReturnCode::IO_ERROR;
+    }
+    opts_.set_compression(comp);
+    opts_.set_matching(mjob);
+    matching_ = std::move(matching);
+    equil_ = std::move(equil);
+    schur_vars_.clear();
+    mat_.reset(new CSRMatrix<scalar_t,integer_t>
+               (n, ptr.data(), ind.data(), val.data(), symm));
+    nd_ = std::move(nd);
+    tree_ = std::move(tree);
+    setup_spmv();
+    reordered_ = factored_ = true;
+    if (opts_.verbose() && is_root_)
+      std::cout << "# loaded factors from " << fname
+                << (r.mapped() ? " (memory mapped)" : "")
+                << " in " << t.elapsed() << " seconds" << std::endl;
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolver<scalar_t,integer_t>::setup_spmv() {
+    mat_->set_SELL_spmv(opts_.use_SELL_spmv());
+    if (mat_->SELL_spmv() && opts_.verbose() && is_root_)
+      std::cout << "# using a SELL-C-sigma copy of the matrix"
+                << " for the sparse matrix-vector products" << std::endl;
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolver<scalar_t,integer_t>::delete_factors_internal() {
     tree_.reset(nullptr);
@@ -122,6 +122,19 @@ namespace strumpack {
     return tree()->factor_nonzeros() * sizeof(scalar_t);
   }
 
+  template<typename scalar_t,typename integer_t> FactorizationEstimate
+  SparseSolverBase<scalar_t,integer_t>::factorization_estimate() const {
+    FactorizationEstimate e;
+    if (!reordered_ || !tree()) return e;
+    long long fnnz, cnnz, peak, flops;
+    tree()->factorization_estimate(opts_, fnnz, cnnz, peak, flops);
+    e.factor_memory = double(fnnz) * sizeof(scalar_t);
+    e.compressed_memory = double(cnnz) * sizeof(scalar_t);
+    e.peak_memory = double(peak) * sizeof(scalar_t);
+    e.flops = double(flops);
+    return e;
+  }
+
   template<typename scalar_t,typename integer_t> int
   SparseSolverBase<scalar_t,integer_t>::Krylov_iterations() const {
     return Krylov_its_;
@@ -131,7 +144,7 @@ namespace strumpack {
   SparseSolverBase<scalar_t,integer_t>::inertia
   (integer_t& neg, integer_t& zero, integer_t& pos) {
     neg = zero = pos = 0;
-    if (opts_.matching() != MatchingJob::NONE)
+    if ((reordered_ ? matching_.job : opts_.matching()) != MatchingJob::NONE)
       return ReturnCode::INACCURATE_INERTIA;
     if (!this->factored_) {
       ReturnCode ierr = this->factor();
@@ -261,6 +274,25 @@ namespace strumpack {
 #endif
   }
 
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::solve_stats_start() {
+    if (!opts_.verbose()) return;
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (active_solves_++) solves_overlap_ = true;
+    else perf_counters_start();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SparseSolverBase<scalar_t,integer_t>::solve_stats_stop(TaskTimer& t) {
+    if (!opts_.verbose()) return;
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (!solves_overlap_) {
+      perf_counters_stop("DIRECT/GMRES solve");
+      print_solve_stats(t);
+    }
+    if (--active_solves_ == 0) solves_overlap_ = false;
+  }
+
   template<typename scalar_t,typename integer_t> void
   SparseSolverBase<scalar_t,integer_t>::print_solve_stats
   (TaskTimer& t) const {
@@ -321,6 +353,17 @@ namespace strumpack {
     if (reordered_) return ReturnCode::SUCCESS;
     TaskTimer t1("permute-scale");
     int ierr;
+    // a (nonsymmetric) column permutation or scaling would destroy
+    // the symmetry needed by the symmetric LDL^T/Cholesky fronts, and
+    // by conjugate gradient
+    const bool keep_symmetry = is_symmetric_front(opts_) || is_CG(opts_);
+    if (keep_symmetry && opts_.matching() != MatchingJob::NONE) {
+      if (opts_.verbose() && is_root_)
+        std::cout << "# disabling matching for "
+                  << (is_CG(opts_) ? "conjugate gradient" : "symmetric solver")
+                  << std::endl;
+      opts_.set_matching(MatchingJob::NONE);
+    }
     if (opts_.verbose() && is_root_)
       std::cout << "# matching job: " << get_description(opts_.matching())
                 << std::endl;
@@ -331,12 +374,17 @@ namespace strumpack {
         if (is_root_) std::cerr << e.what() << std::endl;
         return ReturnCode::REORDERING_ERROR;
       }
-    }
+    } else matching_ = MatchingData<scalar_t,integer_t>();
 
     // TODO(Jie): disable equilibration for sym temperately
-    if (!is_symmetric(opts_)){
+    if (!keep_symmetry) {
       equil_ = matrix()->equilibration();
       matrix()->equilibrate(equil_);
+    } else if (!is_symmetric_front(opts_)) {
+      // conjugate gradient with a compressed (nonsymmetric)
+      // preconditioner, use the same row and column scaling
+      equil_ = matrix()->symmetric_equilibration();
+      matrix()->equilibrate(equil_);
     }
     if (opts_.verbose() && is_root_)
       std::cout << "# matrix equilibration, r_cond = "
@@ -681,6 +729,7 @@ namespace strumpack {
       }
     }
     if (rank_out_) tree()->print_rank_statistics(*rank_out_);
+    setup_spmv();
     // if (err_code == ReturnCode::SUCCESS)
     factored_ = true;
     return err_code;
@@ -706,6 +755,48 @@ namespace strumpack {
     return solve_internal(nrhs, b, ldb, x, ldx, use_initial_guess);
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::solve
+  (const scalar_t* b, scalar_t* x, Trans op, bool use_initial_guess) {
+    if (op == Trans::N) return solve_internal(b, x, use_initial_guess);
+    auto N = matrix()->size();
+    auto B = ConstDenseMatrixWrapperPtr(N, 1, b, N);
+    DenseMW_t X(N, 1, x, N);
+    return solve_internal(*B, X, op, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::solve
+  (const DenseM_t& b, DenseM_t& x, Trans op, bool use_initial_guess) {
+    if (op == Trans::N) return solve_internal(b, x, use_initial_guess);
+    return solve_internal(b, x, op, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::solve
+  (int nrhs, const scalar_t* b, int ldb, scalar_t* x, int ldx,
+   Trans op, bool use_initial_guess) {
+    if (op == Trans::N)
+      return solve_internal(nrhs, b, ldb, x, ldx, use_initial_guess);
+    if (!nrhs) return ReturnCode::SUCCESS;
+    auto N = matrix()->size();
+    assert(ldb >= N);
+    assert(ldx >= N);
+    auto B = ConstDenseMatrixWrapperPtr(N, nrhs, b, ldb);
+    DenseMW_t X(N, nrhs, x, ldx);
+    return solve_internal(*B, X, op, use_initial_guess);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  SparseSolverBase<scalar_t,integer_t>::solve_internal
+  (const DenseM_t& b, DenseM_t& x, Trans op, bool use_initial_guess) {
+    if (op == Trans::N) return solve_internal(b, x, use_initial_guess);
+    if (is_root_)
+      std::cerr << "ERROR: the (conjugate) transposed solve is not"
+                << " supported by this solver" << std::endl;
+    return ReturnCode::NOT_SUPPORTED;
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   SparseSolverBase<scalar_t,integer_t>::solve_internal
   (int nrhs, const scalar_t* b, int ldb, scalar_t* x, int ldx,
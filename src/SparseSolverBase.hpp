@@ -34,7 +34,9 @@
 #define STRUMPACK_SPARSE_SOLVER_BASE_HPP
 
 #include <new>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -53,6 +55,22 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> class EliminationTree;
   class TaskTimer;
 
+  /**
+   * Prediction of the cost of the numerical factorization, computed
+   * from the symbolic factorization, see
+   * SparseSolverBase::factorization_estimate. Memory is in bytes.
+   */
+  struct FactorizationEstimate {
+    /** memory for the factors, counting all fronts as dense */
+    double factor_memory = 0.;
+    /** part of factor_memory in fronts which will be compressed */
+    double compressed_memory = 0.;
+    /** peak memory for the factors and the contribution blocks */
+    double peak_memory = 0.;
+    /** flops for the factorization, counting all fronts as dense */
+    double flops = 0.;
+  };
+
   /**
    * \class SparseSolverBase
    *
@@ -278,6 +296,74 @@ namespace strumpack {
                      scalar_t* x, int ldx,
                      bool use_initial_guess=false);
 
+    /**
+     * Solve a linear system op(A) x = b, with op(A) = A, A^T or A^H,
+     * using the factors of A. This does not require the transposed
+     * matrix to be factored separately. Before being able to solve
+     * a linear system, the matrix needs to be factored. One can call
+     * factor() explicitly, or if this was not yet done, this routine
+     * will call factor() internally.
+     *
+     * The (conjugate) transposed solve is supported for the
+     * sequential/multithreaded solver, with dense, BLR (and
+     * symmetric dense) frontal matrices on the CPU.
+     *
+     * \param b input, will not be modified. Pointer to the right-hand
+     * side, of length N, the dimension of the input matrix.
+     * \param x Output, pointer to the solution vector, length N.
+     * \param op Trans::N, Trans::T or Trans::C to solve with A, A^T
+     * or A^H respectively
+     * \param use_initial_guess set to true if x contains an intial
+     * guess to the solution.
+     * \return error code, ReturnCode::NOT_SUPPORTED if the
+     * (conjugate) transposed solve is not supported for this solver
+     * or for the type of frontal matrices
+     * \see solve(const DenseM_t&, DenseM_t&, Trans, bool)
+     */
+    ReturnCode solve(const scalar_t* b, scalar_t* x, Trans op,
+                     bool use_initial_guess=false);
+
+    /**
+     * Solve a linear system op(A) X = B, with one or multiple
+     * right-hand sides, with op(A) = A, A^T or A^H, using the factors
+     * of A.
+     *
+     * \param b input, will not be modified. DenseMatrix containing
+     * the right-hand side vector/matrix, with N rows.
+     * \param x Output, with the same dimensions as b.
+     * \param op Trans::N, Trans::T or Trans::C to solve with A, A^T
+     * or A^H respectively
+     * \param use_initial_guess set to true if x contains an intial
+     * guess to the solution.
+     * \return error code, ReturnCode::NOT_SUPPORTED if the
+     * (conjugate) transposed solve is not supported for this solver
+     * or for the type of frontal matrices
+     * \see solve(const scalar_t*, scalar_t*, Trans, bool)
+     */
+    ReturnCode solve(const DenseM_t& b, DenseM_t& x, Trans op,
+                     bool use_initial_guess=false);
+
+    /**
+     * Solve a linear system op(A) X = B, with one or multiple
+     * right-hand sides, with op(A) = A, A^T or A^H, using the factors
+     * of A.
+     *
+     * \param nrhs Number of right hand sides.
+     * \param b input, will not be modified, N x nrhs
+     * \param ldb leading dimension of b
+     * \param x Output, N x nrhs
+     * \param ldx leading dimension of x
+     * \param op Trans::N, Trans::T or Trans::C to solve with A, A^T
+     * or A^H respectively
+     * \param use_initial_guess set to true if x contains an intial
+     * guess to the solution.
+     * \return error code
+     * \see solve(const DenseM_t&, DenseM_t&, Trans, bool)
+     */
+    ReturnCode solve(int nrhs, const scalar_t* b, int ldb,
+                     scalar_t* x, int ldx, Trans op,
+                     bool use_initial_guess=false);
+
     /**
      * Return the object holding the options for this sparse solver.
      */
@@ -335,9 +421,25 @@ namespace strumpack {
      */
     std::size_t factor_memory() const;
 
+    /**
+     * Predict the memory usage and the number of flops of the
+     * numerical factorization, before calling factor(). This should
+     * be called after reorder(), otherwise all values are zero. The
+     * prediction only uses the dimensions of the fronts: fronts
+     * which will be compressed, according to the current compression
+     * options and thresholds, are counted as dense, and are reported
+     * separately in FactorizationEstimate::compressed_memory. The
+     * peak memory assumes the fronts are factored in postorder. For
+     * the SparseSolverMPIDist distributed memory solver, this returns
+     * the prediction for this MPI rank, it is not collective.
+     */
+    FactorizationEstimate factorization_estimate() const;
+
     /**
      * Return the number of iterations performed by the outer (Krylov)
      * iterative solver. Call this after calling the solve routine.
+     * With concurrent solves, this is the number of iterations of
+     * the solve which finished last.
      */
     int Krylov_iterations() const;
 
@@ -409,6 +511,11 @@ namespace strumpack {
     virtual void perf_counters_stop(const std::string& s);
 
     virtual void synchronize() {}
+    /**
+     * Called when the factorization is done, to prepare the matrix
+     * for the products in the solve phase.
+     */
+    virtual void setup_spmv() {}
     virtual void communicate_ordering() {}
     virtual double max_peak_memory() const
     { return double(params::peak_memory); }
@@ -418,6 +525,13 @@ namespace strumpack {
     void papi_initialize();
     long long dense_factor_nonzeros() const;
     void print_solve_stats(TaskTimer& t) const;
+    /**
+     * Start/stop the performance counters and print the statistics
+     * for a solve, if verbose. The counters are shared, so they are
+     * skipped for solves which overlap with another solve.
+     */
+    void solve_stats_start();
+    void solve_stats_stop(TaskTimer& t);
 
     virtual void reduce_flop_counters() const {}
     void print_flop_breakdown_HSS() const;
@@ -437,6 +551,9 @@ namespace strumpack {
     ReturnCode solve_internal(int nrhs, const scalar_t* b, int ldb,
                               scalar_t* x, int ldx,
                               bool use_initial_guess=false);
+    virtual
+    ReturnCode solve_internal(const DenseM_t& b, DenseM_t& x, Trans op,
+                              bool use_initial_guess=false);
 
     SPOptions<scalar_t> opts_;
     bool is_root_;
@@ -448,7 +565,16 @@ namespace strumpack {
     std::ostream* rank_out_ = nullptr;
     bool factored_ = false;
     bool reordered_ = false;
-    int Krylov_its_ = 0;
+    std::atomic<int> Krylov_its_{0};
+    /**
+     * held while a solve calls reorder or factor, because these
+     * have not been done yet
+     */
+    std::mutex setup_mutex_;
+    /** protects the counters below, see solve_stats_start */
+    std::mutex stats_mutex_;
+    int active_solves_ = 0;
+    bool solves_overlap_ = false;
 
 #if defined(STRUMPACK_USE_PAPI)
     float rtime_ = 0., ptime_ = 0.;
@@ -265,7 +265,8 @@ namespace strumpack {
     // solvers
     if (!this->factored_ &&
         opts_.Krylov_solver() != KrylovSolver::GMRES &&
-        opts_.Krylov_solver() != KrylovSolver::BICGSTAB) {
+        opts_.Krylov_solver() != KrylovSolver::BICGSTAB &&
+        opts_.Krylov_solver() != KrylovSolver::CG) {
       ReturnCode ierr = this->factor();
       if (ierr != ReturnCode::SUCCESS) return ierr;
     }
@@ -277,7 +278,7 @@ namespace strumpack {
     this->perf_counters_start();
     t.start();
     auto nloc = x.rows();
-    this->Krylov_its_ = 0;
+    int its = 0;
 
     auto bloc = b;
     if (opts_.matching() == MatchingJob::MAX_DIAGONAL_PRODUCT_SCALING)
@@ -315,7 +316,7 @@ namespace strumpack {
         iterative::GMResMPI<scalar_t>
           (comm_, spmv, prec, nloc, x.data(), bloc.data(),
            opts_.rel_tol(), opts_.abs_tol(),
-           this->Krylov_its_, opts_.maxit(),
+           its, opts_.maxit(),
            opts_.gmres_restart(), opts_.GramSchmidt_type(),
            use_initial_guess, opts_.verbose() && is_root_);
       };
@@ -325,7 +326,16 @@ namespace strumpack {
         iterative::BiCGStabMPI<scalar_t>
           (comm_, spmv, prec, nloc, x.data(), bloc.data(),
            opts_.rel_tol(), opts_.abs_tol(),
-           this->Krylov_its_, opts_.maxit(),
+           its, opts_.maxit(),
+           use_initial_guess, opts_.verbose() && is_root_);
+      };
+    auto cg =
+      [&](const std::function<void(scalar_t*)>& prec) {
+        assert(x.cols() == 1);
+        iterative::ConjugateGradientMPI<scalar_t>
+          (comm_, spmv, prec, nloc, x.data(), bloc.data(),
+           opts_.rel_tol(), opts_.abs_tol(),
+           its, opts_.maxit(),
            use_initial_guess, opts_.verbose() && is_root_);
       };
     auto MFsolve =
@@ -340,15 +350,17 @@ namespace strumpack {
            [&](DenseM_t& w) {
              tree()->multifrontal_solve_dist(w, mat_mpi_->dist()); },
            x, bloc, opts_.rel_tol(), opts_.abs_tol(),
-           this->Krylov_its_, opts_.maxit(),
+           its, opts_.maxit(),
            use_initial_guess, opts_.verbose() && is_root_);
       };
 
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
-        gmres(MFsolve);
-      else refine();
+      if (opts_.compression() != CompressionType::NONE && x.cols() == 1) {
+        if (opts_.use_symmetric() && opts_.use_positive_definite())
+          cg(MFsolve);
+        else gmres(MFsolve);
+      } else refine();
     }; break;
     case KrylovSolver::REFINE: {
       refine();
@@ -365,6 +377,12 @@ namespace strumpack {
     case KrylovSolver::PREC_BICGSTAB: {
       bicgstab(MFsolve);
     }; break;
+    case KrylovSolver::CG: {
+      cg([](scalar_t*){});
+    }; break;
+    case KrylovSolver::PREC_CG: {
+      cg(MFsolve);
+    }; break;
     case KrylovSolver::DIRECT: {
       // TODO bloc is already a copy, avoid extra copy?
       x = bloc;
@@ -382,6 +400,7 @@ namespace strumpack {
     }
 
     t.stop();
+    this->Krylov_its_ = its;
     this->perf_counters_stop("DIRECT/GMRES solve");
     this->print_solve_stats(t);
     return ReturnCode::SUCCESS;
@@ -77,18 +77,42 @@ namespace strumpack {
         solve_func(wx);
       };
     auto spmv = [&](const refine_t* x, refine_t* y) { mat_.spmv(x, y); };
+    auto block_spmv = [&](const DenseMatrix<refine_t>& x,
+                          DenseMatrix<refine_t>& y) { mat_.spmv(x, y); };
 
+    if (is_CG(opts_)) {
+      auto ierr = factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
     auto old_verbose = solver_.options().verbose();
     solver_.options().set_verbose(false);
     Krylov_its_ = 0;
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
+      bool spd = opts_.use_symmetric() && opts_.use_positive_definite();
+      if (opts_.compression() != CompressionType::NONE && spd) {
+        if (x.cols() == 1)
+          iterative::ConjugateGradient<refine_t>
+            (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
+             opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+             use_initial_guess, opts_.verbose());
+        else
+          iterative::BlockConjugateGradient<refine_t>
+            (block_spmv, solve_func, x, b,
+             opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+             use_initial_guess, opts_.verbose());
+      } else if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
         iterative::GMRes<refine_t>
           (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
            opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
            opts_.gmres_restart(), opts_.GramSchmidt_type(),
            use_initial_guess, opts_.verbose());
+      else if (opts_.compression() != CompressionType::NONE)
+        iterative::BlockGMRes<refine_t>
+          (block_spmv, solve_func, x, b,
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose());
       else
         iterative::IterativeRefinement<refine_t,integer_t>
           (mat_, solve_func, x, b, opts_.rel_tol(), opts_.abs_tol(),
@@ -104,22 +128,46 @@ namespace strumpack {
          Krylov_its_, opts_.maxit(), use_initial_guess, opts_.verbose());
     }; break;
     case KrylovSolver::PREC_GMRES: {
-      assert(x.cols() == 1);
-      iterative::GMRes<refine_t>
-        (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         opts_.gmres_restart(), opts_.GramSchmidt_type(),
-         use_initial_guess, opts_.verbose());
+      if (x.cols() == 1)
+        iterative::GMRes<refine_t>
+          (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose());
+      else
+        iterative::BlockGMRes<refine_t>
+          (block_spmv, solve_func, x, b,
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           opts_.gmres_restart(), opts_.GramSchmidt_type(),
+           use_initial_guess, opts_.verbose());
     }; break;
     case KrylovSolver::PREC_BICGSTAB: {
-      assert(x.cols() == 1);
-      iterative::BiCGStab<refine_t>
-        (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
-         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
-         use_initial_guess, opts_.verbose());
+      if (x.cols() == 1)
+        iterative::BiCGStab<refine_t>
+          (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           use_initial_guess, opts_.verbose());
+      else
+        iterative::BlockBiCGStab<refine_t>
+          (block_spmv, solve_func, x, b,
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           use_initial_guess, opts_.verbose());
+    }; break;
+    case KrylovSolver::PREC_CG: {
+      if (x.cols() == 1)
+        iterative::ConjugateGradient<refine_t>
+          (spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           use_initial_guess, opts_.verbose());
+      else
+        iterative::BlockConjugateGradient<refine_t>
+          (block_spmv, solve_func, x, b,
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           use_initial_guess, opts_.verbose());
     }; break;
     case KrylovSolver::GMRES:
-    case KrylovSolver::BICGSTAB: {
+    case KrylovSolver::BICGSTAB:
+    case KrylovSolver::CG: {
       std::cerr << "ERROR: non-preconditioned solvers not supported "
         "as outer solver in mixed-precision solver." << std::endl;
     }
@@ -183,13 +231,26 @@ namespace strumpack {
   template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   factor() {
+    if (is_CG(opts_)) {
+      // make sure the inner solver is reordered without matching and
+      // equilibration, see reorder
+      auto ierr = reorder();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
     return solver_.factor();
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   reorder(int nx, int ny, int nz) {
-    return solver_.reorder(nx, ny, nz);
+    // conjugate gradient needs a symmetric preconditioner, so the
+    // inner solver should skip the matching and equilibration
+    auto& sopts = solver_.options();
+    auto ks = sopts.Krylov_solver();
+    if (is_CG(opts_)) sopts.set_Krylov_solver(KrylovSolver::PREC_CG);
+    auto ierr = solver_.reorder(nx, ny, nz);
+    sopts.set_Krylov_solver(ks);
+    return ierr;
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> void
@@ -209,14 +270,14 @@ namespace strumpack {
   template<typename factor_t,typename refine_t,typename integer_t> void
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_lower_triangle_matrix(const CSRMatrix<refine_t,integer_t>& A) {
-    mat_ = A;
+    mat_ = *(A.lower_to_full());
     solver_.set_lower_triangle_matrix(cast_matrix<refine_t,integer_t,factor_t>(A));
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> void
   SparseSolverMixedPrecision<factor_t,refine_t,integer_t>::
   set_lower_triangle_matrix(const CSRMatrix<factor_t,integer_t>& A) {
-    mat_ = cast_matrix<factor_t,integer_t,refine_t>(A);
+    mat_ = cast_matrix<factor_t,integer_t,refine_t>(*(A.lower_to_full()));
     solver_.set_lower_triangle_matrix(A);
   }
 
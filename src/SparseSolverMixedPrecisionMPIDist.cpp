@@ -78,13 +78,23 @@ namespace strumpack {
       };
     auto spmv = [&](const refine_t* x, refine_t* y) { mat_.spmv(x, y); };
 
+    if (is_CG(opts_)) {
+      auto ierr = factor();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
     auto old_verbose = solver_.options().verbose();
     solver_.options().set_verbose(false);
     Krylov_its_ = 0;
     bool verbose = opts_.verbose() && solver_.Comm().is_root();
     switch (opts_.Krylov_solver()) {
     case KrylovSolver::AUTO: {
-      if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
+      if (opts_.compression() != CompressionType::NONE && x.cols() == 1 &&
+          opts_.use_symmetric() && opts_.use_positive_definite())
+        iterative::ConjugateGradientMPI<refine_t>
+          (solver_.Comm(), spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
+           opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+           use_initial_guess, verbose);
+      else if (opts_.compression() != CompressionType::NONE && x.cols() == 1)
         iterative::GMResMPI<refine_t>
           (solver_.Comm(), spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
            opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
@@ -121,8 +131,16 @@ namespace strumpack {
          opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
          use_initial_guess, verbose);
     }; break;
+    case KrylovSolver::PREC_CG: {
+      assert(x.cols() == 1);
+      iterative::ConjugateGradientMPI<refine_t>
+        (solver_.Comm(), spmv, solve_func_ptr, x.rows(), x.data(), b.data(),
+         opts_.rel_tol(), opts_.abs_tol(), Krylov_its_, opts_.maxit(),
+         use_initial_guess, verbose);
+    }; break;
     case KrylovSolver::GMRES:
-    case KrylovSolver::BICGSTAB: {
+    case KrylovSolver::BICGSTAB:
+    case KrylovSolver::CG: {
       std::cerr << "ERROR: non-preconditioned solvers not supported "
         "as outer solver in mixed-precision solver." << std::endl;
     }
@@ -154,13 +172,26 @@ namespace strumpack {
   template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
   SparseSolverMixedPrecisionMPIDist<factor_t,refine_t,integer_t>::
   factor() {
+    if (is_CG(opts_)) {
+      // make sure the inner solver is reordered without matching and
+      // equilibration, see reorder
+      auto ierr = reorder();
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
     return solver_.factor();
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> ReturnCode
   SparseSolverMixedPrecisionMPIDist<factor_t,refine_t,integer_t>::
   reorder(int nx, int ny, int nz) {
-    return solver_.reorder(nx, ny, nz);
+    // conjugate gradient needs a symmetric preconditioner, so the
+    // inner solver should skip the matching and equilibration
+    auto& sopts = solver_.options();
+    auto ks = sopts.Krylov_solver();
+    if (is_CG(opts_)) sopts.set_Krylov_solver(KrylovSolver::PREC_CG);
+    auto ierr = solver_.reorder(nx, ny, nz);
+    sopts.set_Krylov_solver(ks);
+    return ierr;
   }
 
   template<typename factor_t,typename refine_t,typename integer_t> void
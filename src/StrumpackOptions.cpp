@@ -52,6 +52,8 @@ namespace strumpack {
     case ReorderingStrategy::AND: return "AND";
     case ReorderingStrategy::MLF: return "MLF";
     case ReorderingStrategy::SPECTRAL: return "Spectral";
+    case ReorderingStrategy::MTND: return "MTND";
+    case ReorderingStrategy::AUTO: return "Auto";
     }
     return "UNKNOWN";
   }
@@ -70,6 +72,8 @@ namespace strumpack {
     case ReorderingStrategy::AND: return false;
     case ReorderingStrategy::MLF: return false;
     case ReorderingStrategy::SPECTRAL: return false;
+    case ReorderingStrategy::MTND: return false;
+    case ReorderingStrategy::AUTO: return false;
     }
     return false;
   }
@@ -185,6 +189,20 @@ namespace strumpack {
        {"sp_proportional_mapping",      required_argument, 0, 50},
        {"sp_enable_openmp_tree",        no_argument, 0, 51},
        {"sp_disable_openmp_tree",       no_argument, 0, 52},
+       {"sp_analysis_cache",            required_argument, 0, 53},
+       {"sp_enable_incremental_refactorization",  no_argument, 0, 54},
+       {"sp_disable_incremental_refactorization", no_argument, 0, 55},
+       {"sp_enable_dag_scheduler",      no_argument, 0, 56},
+       {"sp_disable_dag_scheduler",     no_argument, 0, 57},
+       {"sp_enable_peak_memory_child_order",  no_argument, 0, 58},
+       {"sp_disable_peak_memory_child_order", no_argument, 0, 59},
+       {"sp_out_of_core",               required_argument, 0, 60},
+       {"sp_enable_reduced_precision_factors",  no_argument, 0, 61},
+       {"sp_disable_reduced_precision_factors", no_argument, 0, 62},
+       {"sp_enable_batched_factorization",  no_argument, 0, 63},
+       {"sp_disable_batched_factorization", no_argument, 0, 64},
+       {"sp_enable_SELL_spmv",          no_argument, 0, 65},
+       {"sp_disable_SELL_spmv",         no_argument, 0, 66},
        {"sp_verbose",                   no_argument, 0, 'v'},
        {"sp_quiet",                     no_argument, 0, 'q'},
        {"help",                         no_argument, 0, 'h'},
@@ -221,6 +239,8 @@ namespace strumpack {
         else if (s == "gmres") set_Krylov_solver(KrylovSolver::GMRES);
         else if (s == "pbicgstab") set_Krylov_solver(KrylovSolver::PREC_BICGSTAB);
         else if (s == "bicgstab") set_Krylov_solver(KrylovSolver::BICGSTAB);
+        else if (s == "pcg") set_Krylov_solver(KrylovSolver::PREC_CG);
+        else if (s == "cg") set_Krylov_solver(KrylovSolver::CG);
         else std::cerr << "# WARNING: Krylov solver not recognized,"
                " using default" << std::endl;
       } break;
@@ -252,9 +272,12 @@ namespace strumpack {
         else if (s == "mlf") set_reordering_method(ReorderingStrategy::MLF);
         else if (s == "and") set_reordering_method(ReorderingStrategy::AND);
         else if (s == "spectral") set_reordering_method(ReorderingStrategy::SPECTRAL);
+        else if (s == "mtnd") set_reordering_method(ReorderingStrategy::MTND);
+        else if (s == "auto") set_reordering_method(ReorderingStrategy::AUTO);
         else std::cerr << "# WARNING: matrix reordering strategy not"
                " recognized, use 'metis', 'parmetis', 'scotch', 'ptscotch',"
-               " 'rcm', 'geometric', 'amd', 'mmd', 'mlf', 'and' or 'spectral'"
+               " 'rcm', 'geometric', 'amd', 'mmd', 'mlf', 'and', 'spectral'"
+               " 'mtnd' or 'auto'"
                        << std::endl;
       } break;
       case 8: {
@@ -428,6 +451,26 @@ namespace strumpack {
       } break;
       case 51: enable_openmp_tree(); break;
       case 52: disable_openmp_tree(); break;
+      case 53: {
+        std::string s; std::istringstream iss(optarg); iss >> s;
+        set_analysis_cache(s);
+      } break;
+      case 54: enable_incremental_refactorization(); break;
+      case 55: disable_incremental_refactorization(); break;
+      case 56: enable_dag_scheduler(); break;
+      case 57: disable_dag_scheduler(); break;
+      case 58: enable_peak_memory_child_order(); break;
+      case 59: disable_peak_memory_child_order(); break;
+      case 60: {
+        std::string s; std::istringstream iss(optarg); iss >> s;
+        set_out_of_core_file(s);
+      } break;
+      case 61: enable_reduced_precision_factors(); break;
+      case 62: disable_reduced_precision_factors(); break;
+      case 63: enable_batched_factorization(); break;
+      case 64: disable_batched_factorization(); break;
+      case 65: enable_SELL_spmv(); break;
+      case 66: disable_SELL_spmv(); break;
       case 'h': { describe_options(); } break;
       case 'v': set_verbose(true); break;
       case 'q': set_verbose(false); break;
@@ -468,9 +511,11 @@ namespace strumpack {
     std::cout << "#          Krylov absolute (preconditioned) residual"
               << " stopping tolerance" << std::endl;
     std::cout << "#   --sp_Krylov_solver [auto|direct|refinement|pgmres|"
-              << "gmres|pbicgstab|bicgstab]" << std::endl;
+              << "gmres|pbicgstab|bicgstab|pcg|cg]" << std::endl;
     std::cout << "#          default: auto (refinement when using compression, pgmres"
               << " (preconditioned) with compression)" << std::endl;
+    std::cout << "#          auto uses pcg with compression when the"
+              << " matrix is symmetric positive definite" << std::endl;
     std::cout << "#   --sp_gmres_restart int (default " << gmres_restart()
               << ")" << std::endl;
     std::cout << "#          gmres restart length" << std::endl;
@@ -478,8 +523,17 @@ namespace strumpack {
               << std::endl;
     std::cout << "#          Gram-Schmidt type for GMRES" << std::endl;
     std::cout << "#   --sp_reordering_method [natural|metis|scotch|parmetis|"
-              << "ptscotch|rcm|geometric|amd|mmd|mlf|and|spectral]" << std::endl;
+              << "ptscotch|rcm|geometric|amd|mmd|mlf|and|spectral|mtnd|auto]"
+              << std::endl;
     std::cout << "#          Select a fill-reducing ordering algorithm." << std::endl;
+    std::cout << "#          mtnd is a built-in multithreaded nested"
+              << " dissection." << std::endl;
+    std::cout << "#          spectral is mtnd with spectral bisection, slower"
+              << " but often less fill," << std::endl;
+    std::cout << "#          mlf is minimum local fill." << std::endl;
+    std::cout << "#          auto runs several orderings and keeps the one"
+              << " with the fewest" << std::endl;
+    std::cout << "#          estimated factorization flops." << std::endl;
     std::cout << "#          Geometric only works on regular meshes and you"
               << " need to provide the sizes." << std::endl;
     std::cout << "#   --sp_nd_param int (default " << nd_param() << ")"
@@ -556,6 +610,23 @@ namespace strumpack {
               << "#          should be [FLOPS|FACTOR_MEMORY|PEAK_MEMORY]" << std::endl
               << "#          type of proportional mapping"
               << std::endl;
+    std::cout << "#   --sp_enable_peak_memory_child_order (default "
+              << std::boolalpha << peak_memory_child_order_ << ")" << std::endl
+              << "#          visit the children of the fronts in the order which"
+              << std::endl
+              << "#          minimizes the peak contribution block memory"
+              << std::endl;
+    std::cout << "#   --sp_disable_peak_memory_child_order (default "
+              << std::boolalpha << !peak_memory_child_order_ << ")" << std::endl;
+    std::cout << "#   --sp_enable_reduced_precision_factors (default "
+              << std::boolalpha << reduced_precision_factors_ << ")"
+              << std::endl
+              << "#          store the off-diagonal blocks of the dense factors"
+              << std::endl
+              << "#          in single precision" << std::endl;
+    std::cout << "#   --sp_disable_reduced_precision_factors (default "
+              << std::boolalpha << !reduced_precision_factors_ << ")"
+              << std::endl;
     std::cout << "#   --sp_enable_gpu" << std::endl;
     std::cout << "#   --sp_disable_gpu" << std::endl;
     std::cout << "#   --sp_gpu_streams (default "
@@ -569,6 +640,47 @@ namespace strumpack {
               << std::boolalpha << !use_openmp_tree_ << ")" << std::endl
               << "#          uses less more memory, but scales worse with OpenMP threads"
               << std::endl;
+    std::cout << "#   --sp_enable_dag_scheduler (default "
+              << std::boolalpha << use_dag_scheduler_ << ")" << std::endl
+              << "#          factor the fronts as soon as their children are done,"
+              << std::endl
+              << "#          scales better with many threads, but uses more memory"
+              << std::endl;
+    std::cout << "#   --sp_disable_dag_scheduler (default "
+              << std::boolalpha << !use_dag_scheduler_ << ")" << std::endl;
+    std::cout << "#   --sp_enable_batched_factorization (default "
+              << std::boolalpha << batched_factorization_ << ")" << std::endl
+              << "#          factor the small fronts level by level,"
+              << std::endl
+              << "#          with less overhead per front" << std::endl;
+    std::cout << "#   --sp_disable_batched_factorization (default "
+              << std::boolalpha << !batched_factorization_ << ")"
+              << std::endl;
+    std::cout << "#   --sp_enable_SELL_spmv (default "
+              << std::boolalpha << use_SELL_spmv_ << ")" << std::endl
+              << "#          use a SELL-C-sigma copy of the matrix"
+              << " for the sparse matrix-vector products" << std::endl;
+    std::cout << "#   --sp_disable_SELL_spmv (default "
+              << std::boolalpha << !use_SELL_spmv_ << ")" << std::endl;
+    std::cout << "#   --sp_analysis_cache file (default none)" << std::endl
+              << "#          cache the ordering and symbolic factorization"
+              << std::endl
+              << "#          in this file, reused if the sparsity pattern matches"
+              << std::endl;
+    std::cout << "#   --sp_out_of_core file (default none)" << std::endl
+              << "#          store the factors in this scratch file instead"
+              << std::endl
+              << "#          of in memory, read back during the solve"
+              << std::endl;
+    std::cout << "#   --sp_enable_incremental_refactorization (default "
+              << std::boolalpha << incremental_refactorization_ << ")"
+              << std::endl
+              << "#          after update_matrix_values, only refactor the fronts"
+              << std::endl
+              << "#          affected by the changed values" << std::endl;
+    std::cout << "#   --sp_disable_incremental_refactorization (default "
+              << std::boolalpha << !incremental_refactorization_ << ")"
+              << std::endl;
     std::cout << "#   --sp_lossy_precision [1-64] (default "
               << lossy_precision() << ")" << std::endl
               << "#          lossy compression precision" << std::endl
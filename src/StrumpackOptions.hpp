@@ -34,6 +34,7 @@
 
 #include <limits>
 #include <cstdlib>
+#include <string>
 
 #include "dense/BLASLAPACKWrapper.hpp"
 #include "HSS/HSSOptions.hpp"
@@ -71,7 +72,9 @@ namespace strumpack {
     MMD,        /*!< Multiple minimum degree                        */
     AND,        /*!< Nested dissection                              */
     MLF,        /*!< Minimum local fill                             */
-    SPECTRAL    /*!< Spectral nested dissection                     */
+    SPECTRAL,   /*!< Spectral nested dissection                     */
+    MTND,       /*!< Multithreaded multilevel nested dissection     */
+    AUTO        /*!< Best of several orderings, by estimated flops  */
   };
 
   /**
@@ -165,7 +168,9 @@ namespace strumpack {
    */
   enum class KrylovSolver {
     AUTO,           /*!< Use iterative refinement if no compression is
-                      used, otherwise use GMRes.                            */
+                      used, otherwise use GMRes, or conjugate gradient
+                      if the matrix is marked as symmetric positive
+                      definite.                                             */
     DIRECT,         /*!< No outer iterative solver, just a single
                       application of the multifrontal solver.               */
     REFINE,         /*!< Iterative refinement.                              */
@@ -174,7 +179,13 @@ namespace strumpack {
     GMRES,          /*!< UN-preconditioned GMRes. (for testing mainly)      */
     PREC_BICGSTAB,  /*!< Preconditioned BiCGStab. The preconditioner is the
                       (approx) multifrontal solver.                         */
-    BICGSTAB        /*!< UN-preconditioned BiCGStab. (for testing mainly)   */
+    BICGSTAB,       /*!< UN-preconditioned BiCGStab. (for testing mainly)   */
+    PREC_CG,        /*!< Preconditioned conjugate gradient, for symmetric
+                      (Hermitian) positive definite problems. The
+                      preconditioner is the (approx) multifrontal
+                      solver.                                               */
+    CG              /*!< UN-preconditioned conjugate gradient. (for testing
+                      mainly)                                               */
   };
 
   /**
@@ -287,13 +298,15 @@ namespace strumpack {
     }
 
     /**
-     * Select a Krylov outer solver. Note that the versions GMRES and
-     * BICGSTAB are not preconditioned! Use PREC_GMRES and
-     * PREC_BICGSTAB instead, as they will use STRUMPACK's sparse
-     * solver (possibly with compression) as a preconditioner. Setting
-     * this to DIRECT will not use any iterative solver, and instead
-     * only perform a solve with the (incomplete/compressed) LU
-     * factorization.
+     * Select a Krylov outer solver. Note that the versions GMRES,
+     * BICGSTAB and CG are not preconditioned! Use PREC_GMRES,
+     * PREC_BICGSTAB or PREC_CG instead, as they will use STRUMPACK's
+     * sparse solver (possibly with compression) as a
+     * preconditioner. Setting this to DIRECT will not use any
+     * iterative solver, and instead only perform a solve with the
+     * (incomplete/compressed) LU factorization. (PREC_)CG should only
+     * be used for symmetric (Hermitian) positive definite problems,
+     * it requires less memory than GMRES.
      *
      * \param s outer, iterative solver to use
      * \see set_compression()
@@ -789,6 +802,138 @@ namespace strumpack {
      */
     void disable_openmp_tree() { use_openmp_tree_ = false; }
 
+    /**
+     * Factor the supernodal tree with a dependency driven scheduler,
+     * instead of the recursive OpenMP tasking of
+     * enable_openmp_tree. Each front becomes an (untied) OpenMP task
+     * as soon as its children have been factored, without waiting
+     * for the sibling subtrees, so the BLAS tasks of the large fronts
+     * in the top of the tree overlap with the fronts lower in the
+     * tree. This scales better with many OpenMP threads, but can
+     * require more (peak) memory, since more contribution blocks are
+     * kept at the same time. This is currently only used for the
+     * dense fronts of the sequential/threaded SparseSolver, without
+     * compression.
+     *
+     * \see disable_dag_scheduler()
+     */
+    void enable_dag_scheduler() { use_dag_scheduler_ = true; }
+
+    /**
+     * Use the recursive OpenMP tasking traversal of the supernodal
+     * tree (default).
+     *
+     * \see enable_dag_scheduler()
+     */
+    void disable_dag_scheduler() { use_dag_scheduler_ = false; }
+
+    /**
+     * Factor the small fronts at the bottom of the supernodal tree
+     * level by level, with one OpenMP parallel loop per level,
+     * instead of one OpenMP task per front. The contribution blocks
+     * of all fronts in a level are allocated in a single buffer and
+     * the fronts are factored with an unblocked LU kernel for small
+     * matrices, see BatchedFrontSize. This reduces the tasking and
+     * allocation overhead, which dominates for problems with many
+     * small fronts, such as 2D problems. This is currently only used
+     * for the dense fronts of the sequential/threaded SparseSolver,
+     * without incremental refactorization.
+     *
+     * \see disable_batched_factorization()
+     */
+    void enable_batched_factorization() { batched_factorization_ = true; }
+
+    /**
+     * Factor the small fronts just like the other fronts (default).
+     *
+     * \see enable_batched_factorization()
+     */
+    void disable_batched_factorization() { batched_factorization_ = false; }
+
+    /**
+     * Keep a SELL-C-sigma copy of the (permuted) sparse matrix, built
+     * at the end of the numerical factorization, and use it for the
+     * sparse matrix-vector products in iterative refinement or the
+     * Krylov solvers. The rows are stored in slices of C=8 rows,
+     * sorted by length within windows of sigma rows, which gives
+     * unit stride vectorizable inner loops. This uses extra memory,
+     * about the size of the original matrix. Only used in the
+     * sequential/threaded SparseSolver.
+     *
+     * \see disable_SELL_spmv()
+     */
+    void enable_SELL_spmv() { use_SELL_spmv_ = true; }
+
+    /**
+     * Use the compressed sparse row matrix for the sparse
+     * matrix-vector products (default).
+     *
+     * \see enable_SELL_spmv()
+     */
+    void disable_SELL_spmv() { use_SELL_spmv_ = false; }
+
+    /**
+     * Set the name of a file to cache the symbolic analysis, ie, the
+     * fill-reducing permutation, the separator tree and the update
+     * index lists of the frontal matrices. The cache is keyed by a
+     * hash of the sparsity pattern (after matching and
+     * symmetrization) and the reordering options. If the file exists
+     * and matches, the graph partitioner and the symbolic
+     * factorization are skipped. Otherwise, the file is (over)written
+     * after the analysis. An empty string (default) disables the
+     * cache. This is currently only used by the sequential/threaded
+     * SparseSolver.
+     *
+     * \param fname name of the cache file
+     */
+    void set_analysis_cache(const std::string& fname) {
+      analysis_cache_ = fname;
+    }
+
+    /**
+     * Store the factors out-of-core. Each front writes its factors to
+     * this scratch file as soon as it has been factored, and the
+     * in-memory copy is released. During the solve, the factors are
+     * read back front by front, with the next front prefetched
+     * asynchronously. This reduces the memory for the factors to
+     * roughly that of the largest front, at the cost of I/O. An
+     * empty string (default) keeps the factors in memory. This is
+     * only used by the sequential/threaded SparseSolver, with dense
+     * or BLR fronts, and not with incremental refactorization. The
+     * file is removed when the factors are deleted.
+     *
+     * \param fname name of the scratch file
+     */
+    void set_out_of_core_file(const std::string& fname) {
+      out_of_core_file_ = fname;
+    }
+
+    /**
+     * Enable incremental refactorization. When the matrix values are
+     * updated with update_matrix_values, the solver records which
+     * entries changed, and the next factorization only recomputes
+     * the fronts on the paths from those entries to the root. The
+     * factors and the contribution blocks of all other fronts are
+     * reused. This requires keeping the contribution blocks of all
+     * fronts after the factorization, which increases the memory
+     * usage. This is currently only used by the sequential/threaded
+     * SparseSolver, without compression.
+     *
+     * \see disable_incremental_refactorization()
+     */
+    void enable_incremental_refactorization() {
+      incremental_refactorization_ = true;
+    }
+
+    /**
+     * Disable incremental refactorization (default).
+     *
+     * \see enable_incremental_refactorization()
+     */
+    void disable_incremental_refactorization() {
+      incremental_refactorization_ = false;
+    }
+
     /**
      * Set the precision for lossy compression. Preferred mode is
      * accuracy. To use precision mode, set the accuracy to a negative
@@ -819,6 +964,54 @@ namespace strumpack {
      */
     void set_proportional_mapping(ProportionalMapping pmap) { prop_map_ = pmap; }
 
+    /**
+     * Visit the children of each front in the order which minimizes
+     * the peak size of the stack of contribution blocks during the
+     * multifrontal factorization (Liu's algorithm), instead of
+     * always visiting the left child first. Like
+     * ProportionalMapping::PEAK_MEMORY for the distributed fronts,
+     * this reduces the peak memory of the (sequential) subtrees. The
+     * ordering of the variables is not changed.
+     *
+     * \see disable_peak_memory_child_order(), peak_memory_child_order()
+     */
+    void enable_peak_memory_child_order() { peak_memory_child_order_ = true; }
+
+    /**
+     * Always visit the left child of a front first.
+     *
+     * \see enable_peak_memory_child_order()
+     */
+    void disable_peak_memory_child_order() { peak_memory_child_order_ = false; }
+
+    /**
+     * Store the off-diagonal blocks F12 and F21 of the dense LU
+     * factors in single precision. The fronts are still factored in
+     * the working precision, so the pivot sequence and the Schur
+     * complement updates are not affected, but the stored factors
+     * (and the memory traffic in the solve) are roughly halved. The
+     * blocks are converted back on the fly during the solve. The
+     * rounding error is typically removed by iterative refinement,
+     * see set_Krylov_solver. This has no effect in single precision,
+     * and only applies to the (non-symmetric) dense fronts of the
+     * sequential/threaded solver.
+     *
+     * \see disable_reduced_precision_factors(),
+     * reduced_precision_factors()
+     */
+    void enable_reduced_precision_factors() {
+      reduced_precision_factors_ = true;
+    }
+
+    /**
+     * Store all factors in the working precision (default).
+     *
+     * \see enable_reduced_precision_factors()
+     */
+    void disable_reduced_precision_factors() {
+      reduced_precision_factors_ = false;
+    }
+
     /**
      * Check if verbose output is enabled.
      * \see set_verbose()
@@ -1186,6 +1379,54 @@ namespace strumpack {
      */
     bool use_openmp_tree() const { return use_openmp_tree_; }
 
+    /**
+     * Check whether the dependency driven scheduler is used for the
+     * factorization of the supernodal tree.
+     *
+     * \see enable_dag_scheduler()
+     */
+    bool use_dag_scheduler() const { return use_dag_scheduler_; }
+
+    /**
+     * Check whether the small fronts are factored level by level.
+     *
+     * \see enable_batched_factorization()
+     */
+    bool batched_factorization() const { return batched_factorization_; }
+
+    /**
+     * Check whether a SELL-C-sigma copy of the matrix is used for the
+     * sparse matrix-vector products.
+     *
+     * \see enable_SELL_spmv()
+     */
+    bool use_SELL_spmv() const { return use_SELL_spmv_; }
+
+    /**
+     * Name of the file used to cache the symbolic analysis, empty if
+     * the cache is disabled.
+     *
+     * \see set_analysis_cache
+     */
+    const std::string& analysis_cache() const { return analysis_cache_; }
+
+    /**
+     * Name of the scratch file used to store the factors out-of-core,
+     * empty if the factors are kept in memory.
+     *
+     * \see set_out_of_core_file
+     */
+    const std::string& out_of_core_file() const { return out_of_core_file_; }
+
+    /**
+     * Is incremental refactorization enabled?
+     *
+     * \see enable_incremental_refactorization()
+     */
+    bool incremental_refactorization() const {
+      return incremental_refactorization_;
+    }
+
     /**
      * Returns the number of GPU streams to use.
      */
@@ -1223,6 +1464,24 @@ namespace strumpack {
      */
     ProportionalMapping proportional_mapping() const { return prop_map_; }
 
+    /**
+     * Check whether the children of the fronts are visited in the
+     * order which minimizes the peak contribution block storage.
+     *
+     * \see enable_peak_memory_child_order()
+     */
+    bool peak_memory_child_order() const { return peak_memory_child_order_; }
+
+    /**
+     * Check whether the off-diagonal blocks of the dense factors are
+     * stored in single precision.
+     *
+     * \see enable_reduced_precision_factors()
+     */
+    bool reduced_precision_factors() const {
+      return reduced_precision_factors_;
+    }
+
     /**
      * Get a (const) reference to an object holding various options
      * pertaining to the HSS code, and data structures.
@@ -1326,7 +1585,15 @@ namespace strumpack {
     bool write_root_front_ = false;
     bool print_comp_front_stats_ = false;
     ProportionalMapping prop_map_ = ProportionalMapping::FLOPS;
+    bool peak_memory_child_order_ = false;
+    bool reduced_precision_factors_ = false;
     bool use_openmp_tree_ = true;
+    bool use_dag_scheduler_ = false;
+    bool batched_factorization_ = false;
+    bool use_SELL_spmv_ = false;
+    std::string analysis_cache_;
+    std::string out_of_core_file_;
+    bool incremental_refactorization_ = false;
     bool use_symmetric_ = false;
     bool use_positive_definite_ = false;
 
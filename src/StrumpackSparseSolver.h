@@ -107,6 +107,8 @@ typedef enum
    STRUMPACK_AND=9,
    STRUMPACK_MLF=10,
    STRUMPACK_SPECTRAL=11,
+   STRUMPACK_MTND=12,
+   STRUMPACK_AUTO_REORDERING=13,
   } STRUMPACK_REORDERING_STRATEGY;
 
 typedef enum
@@ -135,7 +137,9 @@ typedef enum
    STRUMPACK_PREC_GMRES=3,
    STRUMPACK_GMRES=4,
    STRUMPACK_PREC_BICGSTAB=5,
-   STRUMPACK_BICGSTAB=6
+   STRUMPACK_BICGSTAB=6,
+   STRUMPACK_PREC_CG=7,
+   STRUMPACK_CG=8
   } STRUMPACK_KRYLOV_SOLVER;
 
 typedef enum
@@ -145,7 +149,9 @@ typedef enum
    STRUMPACK_REORDERING_ERROR=2,
    STRUMPACK_ZERO_PIVOT=3,
    STRUMPACK_NO_CONVERGENCE=4,
-   STRUMPACK_INACCURATE_INERTIA=5
+   STRUMPACK_INACCURATE_INERTIA=5,
+   STRUMPACK_IO_ERROR=6,
+   STRUMPACK_NOT_SUPPORTED=7
   } STRUMPACK_RETURN_CODE;
 
 
@@ -37,6 +37,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <cstdint>
 
 #include "SparseSolverBase.hpp"
 
@@ -60,6 +61,18 @@ namespace strumpack {
    * for a sequential or multithreaded sparse solver. For the fully
    * distributed solver, see SparseSolverMPIDist.
    *
+   * Once the matrix has been factored, the solve routines can be
+   * called concurrently from different threads (for instance from
+   * an OpenMP parallel region), with different right-hand sides and
+   * solution vectors. Each solve allocates its own work memory, and
+   * the factors are only read. The solves are serialized when the
+   * factors are stored out-of-core, for HSS and HODLR compression,
+   * and for the GPU solve. The other routines, such as factor,
+   * reorder, update_matrix_values or the option setters, should not
+   * be called during the solves. With verbose output, the solve
+   * statistics are only printed for solves which did not overlap
+   * with another solve.
+   *
    * \tparam scalar_t can be: float, double, std::complex<float> or
    * std::complex<double>.
    *
@@ -152,6 +165,12 @@ namespace strumpack {
      * Associate the lower triangle from a (sequential) NxN CSR matrix
      * with this solver.
      *
+     * Entries above the diagonal are ignored, the matrix is assumed
+     * to be symmetric (Hermitian for complex scalar_t). Combine with
+     * SPOptions::enable_symmetric() (and
+     * SPOptions::enable_positive_definite()) to use the symmetric
+     * LDL^T (Cholesky) frontal matrices.
+     *
      * This matrix will not be modified. An internal copy will be
      * made, so it is safe to delete the data immediately after
      * calling this function. See the manual for a description of the
@@ -210,7 +229,8 @@ namespace strumpack {
      * vector previously computed will be reused to permute the
      * updated matrix values, instead of recomputing the
      * permutation. The numerical factorization will automatically be
-     * redone.
+     * redone. With SPOptions::enable_incremental_refactorization,
+     * only the fronts affected by the changed values are refactored.
      *
      * \param A Sparse matrix, should have the same sparsity pattern
      * as the matrix associated with this solver earlier.
@@ -219,6 +239,154 @@ namespace strumpack {
      */
     void update_matrix_values(const CSRMatrix<scalar_t,integer_t>& A);
 
+    /**
+     * Write the factorization to a binary file. This stores the
+     * (permuted and scaled) sparse matrix, the matching, scaling and
+     * fill-reducing permutations, the separator tree and the factors
+     * of all the frontal matrices. The file can be read with
+     * load_factors, which restores the solver to the state right
+     * after factor(), without redoing the reordering or the
+     * factorization.
+     *
+     * The file starts with a header with the STRUMPACK version, a
+     * format version, and the scalar and integer sizes. It can only
+     * be read by a solver with the same scalar_t and integer_t.
+     *
+     * This is only supported for dense, BLR and HSS frontal
+     * matrices, on the CPU.
+     *
+     * \param fname name of the file to write
+     * \return error code, ReturnCode::IO_ERROR if the file cannot
+     * be written, or if the factors cannot be stored,
+     * ReturnCode::MATRIX_NOT_SET if no matrix was set,
+     * ReturnCode::NOT_SUPPORTED if the matrix was not factored, or
+     * after factor_schur
+     *
+     * \see load_factors
+     */
+    ReturnCode save_factors(const std::string& fname) const;
+
+    /**
+     * Read a factorization from a file written with
+     * save_factors. After this, solve can be called directly. This
+     * replaces the matrix currently associated with this solver. The
+     * compression type and the matching job from the options are
+     * overwritten with the values used when the factors were
+     * computed.
+     *
+     * The file is memory mapped when supported by the platform. For
+     * HSS fronts, the ULV factorization is recomputed from the
+     * stored HSS generators.
+     *
+     * \param fname name of the file to read
+     * \return error code, ReturnCode::IO_ERROR if the file cannot
+     * be read, is corrupt, or was written by an incompatible solver
+     * or version. On error, the solver is left unchanged.
+     *
+     * \see save_factors
+     */
+    ReturnCode load_factors(const std::string& fname);
+
+    /**
+     * Check whether the last reordering was read from the analysis
+     * cache file, see SPOptions::set_analysis_cache, instead of
+     * being computed.
+     */
+    bool analysis_cache_hit() const { return analysis_cache_hit_; }
+
+    /**
+     * Solve a linear system with a sparse right-hand side, computing
+     * only selected entries of the solution. The right-hand side b
+     * is assumed to be zero in all rows not in b_rows, and only the
+     * rows x_rows of x are computed, the other rows of x are not
+     * modified. This only traverses the parts of the elimination
+     * tree on the paths from b_rows and x_rows to the root, which is
+     * much cheaper than a full solve when both sets are small, for
+     * instance to compute selected entries of the inverse.
+     *
+     * This always does a single direct solve with the factors, the
+     * Krylov solver option is ignored. With HSS or HODLR compression
+     * the full tree is traversed.
+     *
+     * \param b input, right-hand side, N x nrhs, only the rows in
+     * b_rows are used
+     * \param b_rows rows of b which can be nonzero, in the original
+     * ordering of the matrix, need not be sorted
+     * \param x output, N x nrhs, only the rows in x_rows are set
+     * \param x_rows requested rows of the solution, in the original
+     * ordering of the matrix, need not be sorted
+     * \return error code
+     * \see solve
+     */
+    ReturnCode solve_sparse(const DenseM_t& b,
+                            const std::vector<integer_t>& b_rows,
+                            DenseM_t& x,
+                            const std::vector<integer_t>& x_rows);
+
+    /**
+     * Compute the Schur complement S = A(v,v) - A(v,r) A(r,r)^{-1}
+     * A(r,v) of A, with v the variables vars and r all other
+     * variables. The variables vars are moved out of the root
+     * separator, to the end of the fill-reducing ordering, and all
+     * fronts are factored. The Schur complement is then assembled
+     * from the contribution block of the root front, instead of
+     * solving with |vars| unit vectors.
+     *
+     * This does the reordering, and has to be called before
+     * reorder() or factor(), or after update_matrix_values() with
+     * the same vars. Matching is disabled, since a column
+     * permutation would mix the variables in vars with the other
+     * variables. The factorization is incomplete, so solve cannot be
+     * used afterwards, until a new matrix is set. This is not
+     * supported for the symmetric solver, or for HSS or HODLR
+     * compression of the root front.
+     *
+     * \param vars the variables, in the original ordering of the
+     * matrix, without duplicates
+     * \param S output, the Schur complement, |vars| x |vars|, row
+     * and column i correspond to vars[i]
+     * \return error code
+     */
+    ReturnCode factor_schur(const std::vector<integer_t>& vars,
+                            DenseM_t& S);
+
+    /**
+     * Compute selected entries of the inverse of the matrix, using
+     * the Takahashi recurrences on the factors, top-down through the
+     * elimination tree. This computes the entries of the inverse on
+     * the sparsity pattern of the factors at a cost comparable to the
+     * factorization, without solving with columns of the
+     * identity. The matrix is factored if needed.
+     *
+     * The entries (rows[k], cols[k]) are requested in the original
+     * ordering. This works for any entry for which A(cols[k],
+     * rows[k]) is nonzero, in particular for the diagonal, unless
+     * matching is used and the diagonal of A has zeros. This is only
+     * supported for dense frontal matrices, without compression, on
+     * the CPU.
+     *
+     * \param rows row indices of the requested entries
+     * \param cols column indices of the requested entries
+     * \param vals output, vals[k] is entry (rows[k], cols[k]) of the
+     * inverse
+     * \return error code, ReturnCode::NOT_SUPPORTED if the fronts do
+     * not support this, or if an entry is not in the sparsity
+     * pattern of the factors
+     * \see inverse_diagonal
+     */
+    ReturnCode selected_inverse(const std::vector<integer_t>& rows,
+                                const std::vector<integer_t>& cols,
+                                std::vector<scalar_t>& vals);
+
+    /**
+     * Compute the diagonal of the inverse of the matrix, see
+     * selected_inverse.
+     *
+     * \param d output, the diagonal of the inverse
+     * \return error code
+     */
+    ReturnCode inverse_diagonal(std::vector<scalar_t>& d);
+
   private:
     void setup_tree() override;
     void setup_reordering() override;
@@ -235,22 +403,49 @@ namespace strumpack {
     const Tree_t* tree() const override { return tree_.get(); }
 
     void permute_matrix_values();
+    /**
+     * Set new values for the matrix, and mark the fronts affected by
+     * the changed values for an incremental refactorization, see
+     * SPOptions::enable_incremental_refactorization.
+     */
+    void replace_matrix_values
+    (std::unique_ptr<CSRMatrix<scalar_t,integer_t>> A);
+
+    std::uint64_t analysis_key(int nx, int ny, int nz,
+                               int components, int width) const;
+    bool read_analysis_cache();
+    void write_analysis_cache() const;
 
     ReturnCode solve_internal(const scalar_t* b, scalar_t* x,
                               bool use_initial_guess=false) override;
     ReturnCode solve_internal(const DenseM_t& b, DenseM_t& x,
                               bool use_initial_guess=false) override;
+    ReturnCode solve_internal(const DenseM_t& b, DenseM_t& x, Trans op,
+                              bool use_initial_guess=false) override;
 
     void delete_factors_internal() override;
+    void setup_spmv() override;
 
-    void transform_x0(DenseM_t& x, DenseM_t& xtmp);
-    void transform_b(const DenseM_t& b, DenseM_t& bloc);
-    void transform_x(DenseM_t& x, DenseM_t& xtmp);
+    void transform_x0(DenseM_t& x, DenseM_t& xtmp, Trans op=Trans::N);
+    void transform_b(const DenseM_t& b, DenseM_t& bloc, Trans op=Trans::N);
+    void transform_x(DenseM_t& x, DenseM_t& xtmp, Trans op=Trans::N);
+    std::vector<typename RealType<scalar_t>::value_type>
+    row_scaling() const;
+    /** IO_ERROR if the out-of-core factors could not be read */
+    ReturnCode out_of_core_status() const;
 
     std::unique_ptr<CSRMatrix<scalar_t,integer_t>> mat_;
     std::unique_ptr<MatrixReordering<scalar_t,integer_t>> nd_;
     std::unique_ptr<EliminationTree<scalar_t,integer_t>> tree_;
 
+    /** symbolic analysis cache, see SPOptions::set_analysis_cache */
+    std::uint64_t analysis_key_ = 0;
+    std::vector<std::vector<integer_t>> analysis_upd_;
+    bool analysis_cache_hit_ = false;
+
+    /** variables moved to the end of the ordering, see factor_schur */
+    std::vector<integer_t> schur_vars_;
+
     using SPBase_t = SparseSolverBase<scalar_t,integer_t>;
     using SPBase_t::opts_;
     using SPBase_t::is_root_;
@@ -26,6 +26,7 @@
  *             Division).
  *
  */
+#include <memory>
 #include "BLASLAPACKOpenMPTask.hpp"
 #include "StrumpackFortranCInterface.h"
 
@@ -79,6 +80,44 @@ namespace strumpack {
     }
   }
 
+  template<typename scalar, typename real>
+  void herk_omp_task(char ul, char t, int n, int k, real alpha,
+                     const scalar* a, int lda, real beta,
+                     scalar* c, int ldc, int depth) {
+    if (depth>=params::task_recursion_cutoff_level ||
+        double(n)*n*k <= gemmOMPThreshold)
+      blas::herk(ul, t, n, k, alpha, a, lda, beta, c, ldc);
+    else {
+      bool opA = t=='T'||t=='t'||t=='C'||t=='c';
+      bool lower = ul=='L'||ul=='l';
+      auto n1 = n/2, n2 = n-n/2;
+      auto a2 = opA ? a+n1*lda : a+n1;
+#pragma omp task final(depth >= params::task_recursion_cutoff_level-1)  \
+  mergeable
+      herk_omp_task
+        (ul, t, n1, k, alpha, a, lda, beta, c, ldc, depth+1);
+#pragma omp task final(depth >= params::task_recursion_cutoff_level-1)  \
+  mergeable
+      herk_omp_task
+        (ul, t, n2, k, alpha, a2, lda, beta, c+n1+n1*ldc, ldc, depth+1);
+      // off-diagonal block of the referenced triangle
+      if (lower) {
+#pragma omp task final(depth >= params::task_recursion_cutoff_level-1)  \
+  mergeable
+        gemm_omp_task
+          (opA ? 'C' : 'N', opA ? 'N' : 'C', n2, n1, k, scalar(alpha),
+           a2, lda, a, lda, scalar(beta), c+n1, ldc, depth+1);
+      } else {
+#pragma omp task final(depth >= params::task_recursion_cutoff_level-1)  \
+  mergeable
+        gemm_omp_task
+          (opA ? 'C' : 'N', opA ? 'N' : 'C', n1, n2, k, scalar(alpha),
+           a, lda, a2, lda, scalar(beta), c+n1*ldc, ldc, depth+1);
+      }
+#pragma omp taskwait
+    }
+  }
+
   template<typename scalar>
   void gemv_omp_task(char t, int m, int n, scalar alpha,
                      const scalar *a, int lda,
@@ -475,6 +514,51 @@ namespace strumpack {
           trsm_omp_task
             (s, ul, ta, d, m/2, n, scalar(1.), a, lda, b, ldb, depth);
         }
+      } else if ((s=='R' || s=='r') &&
+                 (ul=='L' || ul=='l') && (ta!='N' && ta!='n')) {
+        if (m >= n) {
+#pragma omp task final(depth >= params::task_recursion_cutoff_level-1)  \
+  mergeable
+          trsm_omp_task
+            (s, ul, ta, d, m/2, n, alpha, a, lda, b, ldb, depth+1);
+#pragma omp task final(depth >= params::task_recursion_cutoff_level-1)  \
+  mergeable
+          trsm_omp_task
+            (s, ul, ta, d, m-m/2, n, alpha, a, lda, b+m/2, ldb, depth+1);
+#pragma omp taskwait
+        } else {
+          trsm_omp_task
+            (s, ul, ta, d, m, n/2, alpha, a, lda, b, ldb, depth);
+          gemm_omp_task
+            ('N', ta, m, n-n/2, n/2, scalar(-1.), b, ldb,
+             a+n/2, lda, alpha, b+n/2*ldb, ldb, depth);
+          trsm_omp_task
+            (s, ul, ta, d, m, n-n/2, scalar(1.),
+             a+n/2+n/2*lda, lda, b+n/2*ldb, ldb, depth);
+        }
+      } else if ((s=='L' || s=='l') &&
+                 (ul=='L' || ul=='l') && (ta!='N' && ta!='n')) {
+        if (n >= m) {
+#pragma omp task final(depth >= params::task_recursion_cutoff_level-1)  \
+  mergeable
+          trsm_omp_task
+            (s, ul, ta, d, m, n/2, alpha, a, lda, b, ldb, depth+1);
+#pragma omp task final(depth >= params::task_recursion_cutoff_level-1)  \
+  mergeable
+          trsm_omp_task
+            (s, ul, ta, d, m, n-n/2, alpha, a, lda,
+             b+n/2*ldb, ldb, depth+1);
+#pragma omp taskwait
+        } else {
+          trsm_omp_task
+            (s, ul, ta, d, m-m/2, n, alpha,
+             a+m/2+m/2*lda, lda, b+m/2, ldb, depth);
+          gemm_omp_task
+            (ta, 'N', m/2, n, m-m/2, scalar(-1.),
+             a+m/2, lda, b+m/2, ldb, alpha, b, ldb, depth);
+          trsm_omp_task
+            (s, ul, ta, d, m/2, n, scalar(1.), a, lda, b, ldb, depth);
+        }
       } else {
         // std::cerr << "trsm_omp_task not implemented with this combination of"
         //           << " side, uplo and transpose" << std::endl;
@@ -561,12 +645,155 @@ namespace strumpack {
   }
 
 
+  // Partial LU factorization of the block matrix [A11 A12; A21 A22],
+  // with A11 n x n and A22 m x m, pivoting only in A11, as a single
+  // tiled task graph. The column tiles of [A11; A21] and [A12; A22]
+  // are the units of the dependencies. Panel k can start as soon as
+  // its own column tile has been updated with panel k-1, while the
+  // updates of the other column tiles with panel k-1 are still
+  // running (lookahead).
+  template<typename scalar> int
+  getrf_tiled_omp_task(int n, int m, scalar* a11, int ld11,
+                       scalar* a12, int ld12, scalar* a21, int ld21,
+                       scalar* a22, int ld22, int* ipiv, double thresh) {
+    const int nb = TiledLUTileSize;
+    int nt = (n + nb - 1) / nb, mt = (m + nb - 1) / nb, info = 0;
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+    // dummies for task synchronization, one per column tile
+    std::unique_ptr<int[]> B_(new int[nt+mt]);
+    [[maybe_unused]] auto B1 = B_.get();
+    [[maybe_unused]] auto B2 = B1 + nt;
+#pragma omp taskgroup
+#endif
+    {
+      for (int k=0; k<nt; k++) {
+        int k0 = k*nb, kb = std::min(nb, n-k0);
+        scalar* akk = a11 + k0 + k0*ld11;
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+#pragma omp task default(shared) firstprivate(k,k0,kb,akk)     \
+  depend(inout:B1[k]) priority(nt+mt)
+#endif
+        { // panel, and the corresponding column tile of A21
+          int ierr = blas::getrf(n-k0, kb, akk, ld11, ipiv+k0);
+          if (ierr && !info) info = ierr + k0;
+          for (int i=k0; i<k0+kb; i++) ipiv[i] += k0;
+          if (thresh > 0)
+            for (int i=0; i<kb; i++)
+              if (std::abs(akk[i+i*ld11]) < thresh)
+                akk[i+i*ld11] = (std::real(akk[i+i*ld11]) < 0) ?
+                  -thresh : thresh;
+          if (m)
+            blas::trsm('R', 'U', 'N', 'N', m, kb, scalar(1.),
+                       akk, ld11, a21+k0*ld21, ld21);
+        }
+        for (int j=k+1; j<nt+mt; j++) {
+          bool left = j < nt;
+          int j0 = left ? j*nb : (j-nt)*nb,
+            jb = std::min(nb, (left ? n : m) - j0);
+          scalar *c1 = left ? a11+j0*ld11 : a12+j0*ld12,
+            *c2 = left ? a21+j0*ld21 : a22+j0*ld22;
+          int ld1 = left ? ld11 : ld12, ld2 = left ? ld21 : ld22;
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+          [[maybe_unused]] int* Bj = left ? &B1[j] : &B2[j-nt];
+#pragma omp task default(shared)                                \
+  firstprivate(k,k0,kb,akk,jb,c1,c2,ld1,ld2,Bj)                  \
+  depend(in:B1[k]) depend(inout:Bj[0]) priority(nt+mt-j)
+#endif
+          { // swap, solve with L_kk and update this column tile
+            blas::laswp(jb, c1, ld1, k0+1, k0+kb, ipiv, 1);
+            blas::trsm('L', 'L', 'N', 'U', kb, jb, scalar(1.),
+                       akk, ld11, c1+k0, ld1);
+            if (n-k0-kb)
+              blas::gemm('N', 'N', n-k0-kb, jb, kb, scalar(-1.),
+                         akk+kb, ld11, c1+k0, ld1,
+                         scalar(1.), c1+k0+kb, ld1);
+            if (m)
+              blas::gemm('N', 'N', m, jb, kb, scalar(-1.),
+                         a21+k0*ld21, ld21, c1+k0, ld1,
+                         scalar(1.), c2, ld2);
+          }
+        }
+      }
+      // apply the interchanges of the later panels to the L factor
+      for (int k=0; k<nt-1; k++) {
+        int k0 = k*nb, kb = std::min(nb, n-k0);
+#if defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+#pragma omp task default(shared) firstprivate(k,k0,kb)         \
+  depend(in:B1[nt-1]) depend(inout:B1[k])
+#endif
+        blas::laswp(kb, a11+k0*ld11, ld11, k0+kb+1, n, ipiv, 1);
+      }
+    }
+    return info;
+  }
+
+
+  // Unblocked partial LU factorization of [A11 A12; A21 A22], for
+  // the small fronts, where the overhead of the BLAS calls and the
+  // tasks would dominate. The loops over the rows are contiguous in
+  // memory and are vectorized.
+  template<typename scalar> int
+  getrf_small(int n, int m, scalar* a11, int ld11,
+              scalar* a12, int ld12, scalar* a21, int ld21,
+              scalar* a22, int ld22, int* ipiv, double thresh) {
+    int info = 0;
+    for (int k=0; k<n; k++) {
+      scalar* ak = a11 + k*ld11;
+      int p = k;
+      auto pmax = std::abs(ak[k]);
+      for (int i=k+1; i<n; i++)
+        if (std::abs(ak[i]) > pmax) { p = i; pmax = std::abs(ak[i]); }
+      ipiv[k] = p + 1;
+      if (p != k) {
+        for (int j=0; j<n; j++) std::swap(a11[k+j*ld11], a11[p+j*ld11]);
+        for (int j=0; j<m; j++) std::swap(a12[k+j*ld12], a12[p+j*ld12]);
+      }
+      if (thresh > 0 && std::abs(ak[k]) < thresh)
+        ak[k] = (std::real(ak[k]) < 0) ? -thresh : thresh;
+      if (ak[k] == scalar(0.)) {
+        if (!info) info = k + 1;
+        continue;
+      }
+      const scalar r = scalar(1.) / ak[k];
+      scalar* bk = a21 + k*ld21;
+#pragma omp simd
+      for (int i=k+1; i<n; i++) ak[i] *= r;
+#pragma omp simd
+      for (int i=0; i<m; i++) bk[i] *= r;
+      // rank-1 update of [A11 A12; A21 A22] with [ak; bk]
+      for (int j=k+1; j<n+m; j++) {
+        bool left = j < n;
+        scalar *c1 = left ? a11+j*ld11 : a12+(j-n)*ld12,
+          *c2 = left ? a21+j*ld21 : a22+(j-n)*ld22;
+        const scalar u = c1[k];
+        if (u == scalar(0.)) continue;
+#pragma omp simd
+        for (int i=k+1; i<n; i++) c1[i] -= ak[i] * u;
+#pragma omp simd
+        for (int i=0; i<m; i++) c2[i] -= bk[i] * u;
+      }
+    }
+    STRUMPACK_FLOPS
+      ((is_complex<scalar>() ? 4 : 1) *
+       (blas::getrf_flops(n, n) +
+        blas::trsm_flops(n, m, scalar(1.), 'L') +
+        blas::trsm_flops(m, n, scalar(1.), 'R') +
+        blas::gemm_flops(m, m, n, scalar(-1.), scalar(1.))));
+    return info;
+  }
+
+
   // explicit template declarations
   template void gemm_omp_task(char ta, char tb, int m, int n, int k, float alpha, const float* a, int lda, const float* b, int ldb, float beta, float* c, int ldc, int depth);
   template void gemm_omp_task(char ta, char tb, int m, int n, int k, double alpha, const double* a, int lda, const double* b, int ldb, double beta, double* c, int ldc, int depth);
   template void gemm_omp_task(char ta, char tb, int m, int n, int k, std::complex<float> alpha, const std::complex<float>* a, int lda, const std::complex<float>* b, int ldb, std::complex<float> beta, std::complex<float>* c, int ldc, int depth);
   template void gemm_omp_task(char ta, char tb, int m, int n, int k, std::complex<double> alpha, const std::complex<double>* a, int lda, const std::complex<double>* b, int ldb, std::complex<double> beta, std::complex<double>* c, int ldc, int depth);
 
+  template void herk_omp_task(char ul, char t, int n, int k, float alpha, const float* a, int lda, float beta, float* c, int ldc, int depth);
+  template void herk_omp_task(char ul, char t, int n, int k, double alpha, const double* a, int lda, double beta, double* c, int ldc, int depth);
+  template void herk_omp_task(char ul, char t, int n, int k, float alpha, const std::complex<float>* a, int lda, float beta, std::complex<float>* c, int ldc, int depth);
+  template void herk_omp_task(char ul, char t, int n, int k, double alpha, const std::complex<double>* a, int lda, double beta, std::complex<double>* c, int ldc, int depth);
+
   template void gemv_omp_task(char t, int m, int n, float alpha, const float *a, int lda, const float *x, int incx, float beta, float *y, int incy, int depth);
   template void gemv_omp_task(char t, int m, int n, double alpha, const double *a, int lda, const double *x, int incx, double beta, double *y, int incy, int depth);
   template void gemv_omp_task(char t, int m, int n, std::complex<float> alpha, const std::complex<float> *a, int lda, const std::complex<float> *x, int incx, std::complex<float> beta, std::complex<float> *y, int incy, int depth);
@@ -597,6 +824,16 @@ namespace strumpack {
   template int getrf_omp_task(int m, int n, std::complex<float>* a, int lda, int* ipiv, int depth);
   template int getrf_omp_task(int m, int n, std::complex<double>* a, int lda, int* ipiv, int depth);
 
+  template int getrf_tiled_omp_task(int n, int m, float* a11, int ld11, float* a12, int ld12, float* a21, int ld21, float* a22, int ld22, int* ipiv, double thresh);
+  template int getrf_tiled_omp_task(int n, int m, double* a11, int ld11, double* a12, int ld12, double* a21, int ld21, double* a22, int ld22, int* ipiv, double thresh);
+  template int getrf_tiled_omp_task(int n, int m, std::complex<float>* a11, int ld11, std::complex<float>* a12, int ld12, std::complex<float>* a21, int ld21, std::complex<float>* a22, int ld22, int* ipiv, double thresh);
+  template int getrf_tiled_omp_task(int n, int m, std::complex<double>* a11, int ld11, std::complex<double>* a12, int ld12, std::complex<double>* a21, int ld21, std::complex<double>* a22, int ld22, int* ipiv, double thresh);
+
+  template int getrf_small(int n, int m, float* a11, int ld11, float* a12, int ld12, float* a21, int ld21, float* a22, int ld22, int* ipiv, double thresh);
+  template int getrf_small(int n, int m, double* a11, int ld11, double* a12, int ld12, double* a21, int ld21, double* a22, int ld22, int* ipiv, double thresh);
+  template int getrf_small(int n, int m, std::complex<float>* a11, int ld11, std::complex<float>* a12, int ld12, std::complex<float>* a21, int ld21, std::complex<float>* a22, int ld22, int* ipiv, double thresh);
+  template int getrf_small(int n, int m, std::complex<double>* a11, int ld11, std::complex<double>* a12, int ld12, std::complex<double>* a21, int ld21, std::complex<double>* a22, int ld22, int* ipiv, double thresh);
+
   template int getrs_omp_task(char t, int m, int n, const float *a, int lda, const int* piv, float *b, int ldb, int depth);
   template int getrs_omp_task(char t, int m, int n, const double *a, int lda, const int* piv, double *b, int ldb, int depth);
   template int getrs_omp_task(char t, int m, int n, const std::complex<float> *a, int lda, const int* piv, std::complex<float> *b, int ldb, int depth);
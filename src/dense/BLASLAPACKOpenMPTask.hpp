@@ -36,6 +36,7 @@
 namespace strumpack {
 
   template<typename scalar> void gemm_omp_task(char ta, char tb, int m, int n, int k, scalar alpha, const scalar* a, int lda, const scalar* b, int ldb, scalar beta, scalar* c, int ldc, int depth);
+  template<typename scalar, typename real> void herk_omp_task(char ul, char t, int n, int k, real alpha, const scalar* a, int lda, real beta, scalar* c, int ldc, int depth);
   template<typename scalar> void gemv_omp_task(char t, int m, int n, scalar alpha, const scalar *a, int lda, const scalar *x, int incx, scalar beta, scalar *y, int incy, int depth);
   template<typename scalar> void trsv_omp_task(char ul, char ta, char d, int n, const scalar* a, int lda, scalar* x, int incx, int depth);
   template<typename scalar> void trmm_omp_task(char s, char ul, char ta, char d, int m, int n, scalar alpha, const scalar* a, int lda, scalar* b, int ldb, int depth);
@@ -43,6 +44,37 @@ namespace strumpack {
   template<typename scalar> void trsm_omp_task(char s, char ul, char ta, char d, int m, int n, scalar alpha, const scalar* a, int lda, scalar* b, int ldb, int depth);
   template<typename scalar> void laswp_omp_task(int n, scalar* a, int lda, int k1, int k2, const int* ipiv, int incx, int depth);
   template<typename scalar> int getrf_omp_task(int m, int n, scalar* a, int lda, int* ipiv, int depth);
+  /**
+   * Tile size for getrf_tiled_omp_task, which should only be used
+   * for n of at least a few times this size.
+   */
+  const int TiledLUTileSize = 128;
+
+  /**
+   * Partial LU factorization of [A11 A12; A21 A22], A11 is n x n and
+   * A22 is m x m: A11 = P L U, A12 := L^{-1} P A12, A21 := A21
+   * U^{-1} and A22 := A22 - A21 A12, pivoting only in A11, in one
+   * task graph on column tiles (with OpenMP task depend). Pivots on
+   * the diagonal of U smaller than thresh (if > 0) are replaced by
+   * +-thresh. The ipiv vector has n (1-based) entries. Returns the
+   * getrf info.
+   */
+  template<typename scalar> int getrf_tiled_omp_task(int n, int m, scalar* a11, int ld11, scalar* a12, int ld12, scalar* a21, int ld21, scalar* a22, int ld22, int* ipiv, double thresh);
+
+  /**
+   * Fronts with n + m at most this size are factored with
+   * getrf_small, see SPOptions::enable_batched_factorization.
+   */
+  const int BatchedFrontSize = 48;
+
+  /**
+   * Same as getrf_tiled_omp_task, for small n + m, without tasks and
+   * without BLAS calls: an unblocked right-looking LU where each
+   * rank-1 update sweeps over all four blocks at once. Pivots smaller
+   * than thresh (if > 0) are replaced by +-thresh before they are
+   * used. Returns the getrf info.
+   */
+  template<typename scalar> int getrf_small(int n, int m, scalar* a11, int ld11, scalar* a12, int ld12, scalar* a21, int ld21, scalar* a22, int ld22, int* ipiv, double thresh);
   template<typename scalar> int getrs_omp_task(char t, int m, int n, const scalar *a, int lda, const int* piv, scalar *b, int ldb, int depth);
 
 } // end namespace strumpack
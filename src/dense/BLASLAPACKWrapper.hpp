@@ -470,6 +470,37 @@ namespace strumpack {
               const std::complex<double>* a, int lda,
               std::complex<double>* b, int ldb);
 
+    inline long long herk_flops(long long n, long long k) {
+      return n * (n + 1) * k;
+    }
+    inline long long herk_moves(long long n, long long k) {
+      return n * k + n * n;
+    }
+    void syrk(char ul, char t, int n, int k, float alpha,
+              const float* a, int lda, float beta, float* c, int ldc);
+    void syrk(char ul, char t, int n, int k, double alpha,
+              const double* a, int lda, double beta, double* c, int ldc);
+    /**
+     * Hermitian rank-k update, only the triangle of C indicated by ul
+     * is referenced and updated. For real data this is xSYRK.
+     */
+    inline void herk(char ul, char t, int n, int k, float alpha,
+                     const float* a, int lda, float beta,
+                     float* c, int ldc) {
+      syrk(ul, t, n, k, alpha, a, lda, beta, c, ldc);
+    }
+    inline void herk(char ul, char t, int n, int k, double alpha,
+                     const double* a, int lda, double beta,
+                     double* c, int ldc) {
+      syrk(ul, t, n, k, alpha, a, lda, beta, c, ldc);
+    }
+    void herk(char ul, char t, int n, int k, float alpha,
+              const std::complex<float>* a, int lda, float beta,
+              std::complex<float>* c, int ldc);
+    void herk(char ul, char t, int n, int k, double alpha,
+              const std::complex<double>* a, int lda, double beta,
+              std::complex<double>* c, int ldc);
+
     template<typename scalar_t> inline
     long long trmm_flops(long long m, long long n, scalar_t alpha, char s) {
       if (s=='L' || s=='l')
@@ -1014,6 +1014,33 @@ namespace strumpack {
          b.data(), b.ld(), beta, c, ldc);
   }
 
+  template<typename scalar_t> void
+  herk(UpLo ul, Trans ta, typename RealType<scalar_t>::value_type alpha,
+       const DenseMatrix<scalar_t>& a,
+       typename RealType<scalar_t>::value_type beta,
+       DenseMatrix<scalar_t>& c, int depth) {
+    assert(c.rows() == c.cols());
+    assert((ta==Trans::N && a.rows()==c.rows()) ||
+           (ta!=Trans::N && a.cols()==c.rows()));
+    // for real data, Trans::C and Trans::T are both accepted by xSYRK
+    char t = (ta == Trans::N) ? 'N' :
+      (is_complex<scalar_t>() ? 'C' : 'T');
+#if defined(_OPENMP)
+    bool in_par = depth < params::task_recursion_cutoff_level
+      && omp_in_parallel();
+#else
+    bool in_par = false;
+#endif
+    if (in_par)
+      herk_omp_task
+        (char(ul), t, c.rows(), (ta==Trans::N) ? a.cols() : a.rows(),
+         alpha, a.data(), a.ld(), beta, c.data(), c.ld(), depth);
+    else
+      blas::herk
+        (char(ul), t, c.rows(), (ta==Trans::N) ? a.cols() : a.rows(),
+         alpha, a.data(), a.ld(), beta, c.data(), c.ld());
+  }
+
   /**
    * TRMM performs one of the matrix-matrix operations
    *
@@ -1331,6 +1358,21 @@ namespace strumpack {
        const DenseMatrix<std::complex<double>>& b, std::complex<double> beta,
        std::complex<double>* c, int ldc, int depth);
 
+  template void
+  herk(UpLo ul, Trans ta, float alpha, const DenseMatrix<float>& a,
+       float beta, DenseMatrix<float>& c, int depth);
+  template void
+  herk(UpLo ul, Trans ta, double alpha, const DenseMatrix<double>& a,
+       double beta, DenseMatrix<double>& c, int depth);
+  template void
+  herk(UpLo ul, Trans ta, float alpha,
+       const DenseMatrix<std::complex<float>>& a,
+       float beta, DenseMatrix<std::complex<float>>& c, int depth);
+  template void
+  herk(UpLo ul, Trans ta, double alpha,
+       const DenseMatrix<std::complex<double>>& a,
+       double beta, DenseMatrix<std::complex<double>>& c, int depth);
+
   template void
   trmm(Side s, UpLo ul, Trans ta, Diag d, float alpha,
        const DenseMatrix<float>& a, DenseMatrix<float>& b,
@@ -1357,6 +1357,24 @@ namespace strumpack {
        const DenseMatrix<scalar_t>& b, scalar_t beta,
        scalar_t* c, int ldc, int depth=0);
 
+  /**
+   * Hermitian rank-k update (xSYRK for real, xHERK for complex
+   * scalar types)
+   *
+   *    C := alpha*op( A )*op( A )**H + beta*C,
+   *
+   * where op( A ) = A or op( A ) = A**H, alpha and beta are real
+   * scalars and C is an n by n Hermitian matrix. Only the triangle of
+   * C indicated by ul is referenced and updated.
+   *
+   * \param depth current OpenMP task recursion depth
+   */
+  template<typename scalar_t> void
+  herk(UpLo ul, Trans ta, typename RealType<scalar_t>::value_type alpha,
+       const DenseMatrix<scalar_t>& a,
+       typename RealType<scalar_t>::value_type beta,
+       DenseMatrix<scalar_t>& c, int depth=0);
+
   /**
    * TRMM performs one of the matrix-matrix operations
    *
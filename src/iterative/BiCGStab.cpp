@@ -28,6 +28,8 @@
  */
 #include <iostream>
 #include <iomanip>
+#include <vector>
+#include <algorithm>
 
 #include "IterativeSolvers.hpp"
 
@@ -120,6 +122,132 @@ namespace strumpack {
       return error;
     }
 
+    /**
+     * BiCGStab for multiple right-hand sides. The recurrences are
+     * independent for each column of x/b, but the operator and the
+     * preconditioner are applied to all columns at once. Columns
+     * that have converged (or broken down) are set to zero before
+     * applying the operator and preconditioner.
+     */
+    template<typename scalar_t, typename real_t> real_t BlockBiCGStab
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      std::size_t n = x.rows(), d = x.cols();
+      DenseM_t r(n, d), r_tld(n, d), p_hat(n, d), s_hat(n, d),
+        p(n, d), v(n, d), s(n, d), t(n, d);
+      if (non_zero_guess) {      // compute initial residual
+        A(x, r);
+        for (std::size_t j=0; j<d; j++)
+          blas::axpby(n, scalar_t(1.), b.ptr(0, j), 1,
+                      scalar_t(-1.), r.ptr(0, j), 1);
+      } else {
+        r.copy(b);
+        x.zero();
+      }
+      std::vector<real_t> bnrm2(d), error(d, real_t(0.));
+      std::vector<scalar_t> alpha(d, scalar_t(0.)), rho(d),
+        rho_1(d, scalar_t(0.)), omega(d, scalar_t(1.));
+      std::vector<char> active(d);
+      std::size_t nactive = 0;
+      auto print = [&]() {
+        real_t res = 0., rel = 0.;
+        for (std::size_t j=0; j<d; j++) {
+          res = std::max(res, error[j] * bnrm2[j]);
+          rel = std::max(rel, error[j]);
+        }
+        std::cout << "BiCGStab it. " << totit
+                  << "\tres = " << std::setw(12) << res
+                  << "\trel.res = " << std::setw(12) << rel << std::endl;
+      };
+      auto deactivate = [&](std::size_t j) {
+        active[j] = false;
+        nactive--;
+      };
+      for (std::size_t j=0; j<d; j++) {
+        bnrm2[j] = blas::nrm2(n, b.ptr(0, j), 1);
+        active[j] = bnrm2[j] != real_t(0.);
+        if (!active[j]) continue;
+        auto resid = blas::nrm2(n, r.ptr(0, j), 1);
+        error[j] = resid / bnrm2[j];
+        active[j] = !(error[j] <= rtol || resid <= atol);
+        if (active[j]) nactive++;
+      }
+      if (verbose) print();
+      r_tld.copy(r);
+      for (totit=1; totit<=maxit && nactive; totit++) {
+        for (std::size_t j=0; j<d; j++) {
+          if (active[j]) {
+            rho[j] = blas::dotc(n, r_tld.ptr(0, j), 1, r.ptr(0, j), 1);
+            if (rho[j] == scalar_t(0.0)) deactivate(j);
+          }
+          auto pj = p.ptr(0, j);
+          auto phj = p_hat.ptr(0, j);
+          if (!active[j]) {
+            std::fill(phj, phj+n, scalar_t(0.));
+            continue;
+          }
+          if (totit > 1) {
+            auto beta = (rho[j] / rho_1[j]) * (alpha[j] / omega[j]);
+            // p = r + beta (p - omega v)
+            blas::axpy(n, -omega[j], v.ptr(0, j), 1, pj, 1);
+            blas::axpby(n, scalar_t(1), r.ptr(0, j), 1, beta, pj, 1);
+          } else std::copy(r.ptr(0, j), r.ptr(0, j)+n, pj);
+          std::copy(pj, pj+n, phj);         // p_hat = M \ p
+        }
+        if (!nactive) break;
+        M(p_hat);
+        A(p_hat, v);                          // v = A * p_hat
+        for (std::size_t j=0; j<d; j++) {
+          auto shj = s_hat.ptr(0, j);
+          if (active[j]) {
+            auto sj = s.ptr(0, j);
+            alpha[j] = rho[j] /
+              blas::dotc(n, r_tld.ptr(0, j), 1, v.ptr(0, j), 1);
+            std::copy(r.ptr(0, j), r.ptr(0, j)+n, sj); // s = r_1 - alpha v
+            blas::axpy(n, -alpha[j], v.ptr(0, j), 1, sj, 1);
+            auto snrm = blas::nrm2(n, sj, 1);
+            if (snrm < atol) {                // early convergence check
+              blas::axpy(n, alpha[j], p_hat.ptr(0, j), 1, x.ptr(0, j), 1);
+              std::copy(sj, sj+n, r.ptr(0, j));
+              error[j] = snrm / bnrm2[j];
+              deactivate(j);
+            } else std::copy(sj, sj+n, shj); // s_hat = M \ s
+          }
+          if (!active[j]) std::fill(shj, shj+n, scalar_t(0.));
+        }
+        if (!nactive) { if (verbose) print(); break; }
+        M(s_hat);
+        A(s_hat, t);                          // t = A*s_hat
+        for (std::size_t j=0; j<d; j++) {
+          if (!active[j]) continue;
+          auto tj = t.ptr(0, j);
+          auto sj = s.ptr(0, j);
+          auto rj = r.ptr(0, j);
+          // omega = ( t'*s) / ( t'*t );
+          omega[j] = blas::dotc(n, tj, 1, sj, 1) / blas::dotc(n, tj, 1, tj, 1);
+          // x = x + alpha*p_hat + omega*s_hat
+          blas::axpy(n, alpha[j], p_hat.ptr(0, j), 1, x.ptr(0, j), 1);
+          blas::axpy(n, omega[j], s_hat.ptr(0, j), 1, x.ptr(0, j), 1);
+          std::copy(sj, sj+n, rj);            // r = s - omega*t
+          blas::axpy(n, -omega[j], tj, 1, rj, 1);
+          auto resid = blas::nrm2(n, rj, 1);
+          error[j] = resid / bnrm2[j];
+          if (error[j] <= rtol || resid <= atol ||
+              omega[j] == scalar_t(0.0))
+            deactivate(j);
+          rho_1[j] = rho[j];
+        }
+        if (verbose) print();
+      }
+      for (std::size_t j=0; j<d; j++)
+        if (bnrm2[j] != real_t(0.))
+          error[j] = blas::nrm2(n, r.ptr(0, j), 1) / bnrm2[j];
+      return *std::max_element(error.begin(), error.end());
+    }
+
     // explicit template instantiations
     template float BiCGStab
     (const SPMV<float>& A, const PREC<float>& M, std::size_t n,
@@ -140,6 +268,32 @@ namespace strumpack {
      double rtol, double atol, int& totit, int maxit,
      bool non_zero_guess, bool verbose);
 
+
+    template float BlockBiCGStab
+    (const BlockSPMV<float>& A, const BlockPREC<float>& M,
+     DenseMatrix<float>& x, const DenseMatrix<float>& b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double BlockBiCGStab
+    (const BlockSPMV<double>& A, const BlockPREC<double>& M,
+     DenseMatrix<double>& x, const DenseMatrix<double>& b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template float BlockBiCGStab
+    (const BlockSPMV<std::complex<float>>& A,
+     const BlockPREC<std::complex<float>>& M,
+     DenseMatrix<std::complex<float>>& x,
+     const DenseMatrix<std::complex<float>>& b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double BlockBiCGStab
+    (const BlockSPMV<std::complex<double>>& A,
+     const BlockPREC<std::complex<double>>& M,
+     DenseMatrix<std::complex<double>>& x,
+     const DenseMatrix<std::complex<double>>& b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+
   } // end namespace iterative
 
 } // end namespace strumpack
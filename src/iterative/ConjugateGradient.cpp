@@ -0,0 +1,234 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+#include "IterativeSolvers.hpp"
+
+namespace strumpack {
+
+  namespace iterative {
+
+    /**
+     * http://www.netlib.org/templates/matlab/cg.m
+     */
+    template<typename scalar_t, typename real_t> real_t ConjugateGradient
+    (const SPMV<scalar_t>& A, const PREC<scalar_t>& M, std::size_t n,
+     scalar_t* x, const scalar_t* b, real_t rtol, real_t atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose) {
+      real_t bnrm2 = blas::nrm2(n, b, 1);
+      if (bnrm2 == 0.0) return real_t(0.0);
+      std::unique_ptr<scalar_t[]> work(new scalar_t[4*n]);
+      auto r = work.get();
+      auto z = r + n;
+      auto p = r + 2 * n;
+      auto q = r + 3 * n;
+      if (non_zero_guess) {      // compute initial residual
+        A(x, r);
+        blas::axpby(n, scalar_t(1.), b, 1, scalar_t(-1.), r, 1);
+      } else {
+        std::copy(b, b+n, r);
+        std::fill(x, x+n, scalar_t(0.));
+      }
+      real_t resid = blas::nrm2(n, r, 1);
+      real_t error = resid / bnrm2;
+      if (verbose)
+        std::cout << "CG it. " << totit
+                  << "\tres = " << std::setw(12) << resid
+                  << "\trel.res = " << std::setw(12) << error << std::endl;
+      if (error <= rtol || resid <= atol)
+        return error;
+      scalar_t alpha, rho, rho_1 = scalar_t(0.), beta;
+      for (totit=1; totit<=maxit; totit++) {
+        std::copy(r, r+n, z);                 // z = M \ r
+        M(z);
+        rho = blas::dotc(n, r, 1, z, 1);
+        if (rho == scalar_t(0.0)) break;
+        if (totit > 1) {
+          beta = rho / rho_1;                 // p = z + beta p
+          blas::axpby(n, scalar_t(1.), z, 1, beta, p, 1);
+        } else std::copy(z, z+n, p);
+        A(p, q);                              // q = A * p
+        alpha = rho / blas::dotc(n, p, 1, q, 1);
+        blas::axpy(n, alpha, p, 1, x, 1);     // x = x + alpha p
+        blas::axpy(n, -alpha, q, 1, r, 1);    // r = r - alpha q
+        resid = blas::nrm2(n, r, 1);
+        error = resid / bnrm2;
+        if (verbose)
+          std::cout << "CG it. " << totit
+                    << "\tres = " << std::setw(12) << resid
+                    << "\trel.res = " << std::setw(12) << error << std::endl;
+        if (error <= rtol || resid <= atol) break;
+        rho_1 = rho;
+      }
+      return error;
+    }
+
+    template<typename scalar_t, typename real_t> real_t BlockConjugateGradient
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      std::size_t n = x.rows(), d = x.cols();
+      DenseM_t r(n, d), z(n, d), p(n, d), q(n, d);
+      if (non_zero_guess) {      // compute initial residual
+        A(x, r);
+        for (std::size_t j=0; j<d; j++)
+          blas::axpby(n, scalar_t(1.), b.ptr(0, j), 1,
+                      scalar_t(-1.), r.ptr(0, j), 1);
+      } else {
+        r.copy(b);
+        x.zero();
+      }
+      std::vector<real_t> bnrm2(d), error(d, real_t(0.));
+      std::vector<scalar_t> rho(d), rho_1(d, scalar_t(0.));
+      std::vector<char> active(d);
+      std::size_t nactive = 0;
+      auto print = [&]() {
+        real_t res = 0., rel = 0.;
+        for (std::size_t j=0; j<d; j++) {
+          res = std::max(res, error[j] * bnrm2[j]);
+          rel = std::max(rel, error[j]);
+        }
+        std::cout << "CG it. " << totit
+                  << "\tres = " << std::setw(12) << res
+                  << "\trel.res = " << std::setw(12) << rel << std::endl;
+      };
+      for (std::size_t j=0; j<d; j++) {
+        bnrm2[j] = blas::nrm2(n, b.ptr(0, j), 1);
+        active[j] = bnrm2[j] != real_t(0.);
+        if (!active[j]) continue;
+        auto resid = blas::nrm2(n, r.ptr(0, j), 1);
+        error[j] = resid / bnrm2[j];
+        active[j] = !(error[j] <= rtol || resid <= atol);
+        if (active[j]) nactive++;
+      }
+      if (verbose) print();
+      for (totit=1; totit<=maxit && nactive; totit++) {
+        // z = M \ r, for the inactive columns M is applied to zero
+        for (std::size_t j=0; j<d; j++) {
+          auto zj = z.ptr(0, j);
+          if (active[j]) std::copy(r.ptr(0, j), r.ptr(0, j)+n, zj);
+          else std::fill(zj, zj+n, scalar_t(0.));
+        }
+        M(z);
+        for (std::size_t j=0; j<d; j++) {
+          auto pj = p.ptr(0, j);
+          if (active[j]) {
+            rho[j] = blas::dotc(n, r.ptr(0, j), 1, z.ptr(0, j), 1);
+            if (rho[j] == scalar_t(0.0)) {
+              active[j] = false;
+              nactive--;
+            }
+          }
+          if (!active[j]) {
+            std::fill(pj, pj+n, scalar_t(0.));
+            continue;
+          }
+          if (totit > 1)                      // p = z + beta p
+            blas::axpby(n, scalar_t(1.), z.ptr(0, j), 1,
+                        rho[j] / rho_1[j], pj, 1);
+          else std::copy(z.ptr(0, j), z.ptr(0, j)+n, pj);
+        }
+        if (!nactive) break;
+        A(p, q);                              // q = A * p
+        for (std::size_t j=0; j<d; j++) {
+          if (!active[j]) continue;
+          auto pj = p.ptr(0, j);
+          auto qj = q.ptr(0, j);
+          auto rj = r.ptr(0, j);
+          auto alpha = rho[j] / blas::dotc(n, pj, 1, qj, 1);
+          blas::axpy(n, alpha, pj, 1, x.ptr(0, j), 1);
+          blas::axpy(n, -alpha, qj, 1, rj, 1);
+          auto resid = blas::nrm2(n, rj, 1);
+          error[j] = resid / bnrm2[j];
+          if (error[j] <= rtol || resid <= atol) {
+            active[j] = false;
+            nactive--;
+          }
+          rho_1[j] = rho[j];
+        }
+        if (verbose) print();
+      }
+      return *std::max_element(error.begin(), error.end());
+    }
+
+    // explicit template instantiations
+    template float ConjugateGradient
+    (const SPMV<float>& A, const PREC<float>& M, std::size_t n,
+     float* x, const float* b, float rtol, float atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+    template double ConjugateGradient
+    (const SPMV<double>& A, const PREC<double>& M, std::size_t n,
+     double* x, const double* b, double rtol, double atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+    template float ConjugateGradient
+    (const SPMV<std::complex<float>>& A,
+     const PREC<std::complex<float>>& M, std::size_t n,
+     std::complex<float>* x, const std::complex<float>* b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double ConjugateGradient
+    (const SPMV<std::complex<double>>& A,
+     const PREC<std::complex<double>>& M, std::size_t n,
+     std::complex<double>* x, const std::complex<double>* b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+
+    template float BlockConjugateGradient
+    (const BlockSPMV<float>& A, const BlockPREC<float>& M,
+     DenseMatrix<float>& x, const DenseMatrix<float>& b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double BlockConjugateGradient
+    (const BlockSPMV<double>& A, const BlockPREC<double>& M,
+     DenseMatrix<double>& x, const DenseMatrix<double>& b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template float BlockConjugateGradient
+    (const BlockSPMV<std::complex<float>>& A,
+     const BlockPREC<std::complex<float>>& M,
+     DenseMatrix<std::complex<float>>& x,
+     const DenseMatrix<std::complex<float>>& b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double BlockConjugateGradient
+    (const BlockSPMV<std::complex<double>>& A,
+     const BlockPREC<std::complex<double>>& M,
+     DenseMatrix<std::complex<double>>& x,
+     const DenseMatrix<std::complex<double>>& b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+
+  } // end namespace iterative
+
+} // end namespace strumpack
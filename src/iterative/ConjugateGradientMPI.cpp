@@ -0,0 +1,116 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <iomanip>
+
+#include "IterativeSolversMPI.hpp"
+
+namespace strumpack {
+
+  namespace iterative {
+
+    /**
+     * http://www.netlib.org/templates/matlab/cg.m
+     */
+    template<typename scalar_t,typename real_t> real_t ConjugateGradientMPI
+    (const MPIComm& comm, const SPMV<scalar_t>& A, const PREC<scalar_t>& M,
+     std::size_t n, scalar_t* x, const scalar_t* b, real_t rtol, real_t atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose) {
+      real_t bnrm2 = norm2(n, b, 1, comm);
+      if (bnrm2 == 0.0) return real_t(0.0);
+      std::unique_ptr<scalar_t[]> work(new scalar_t[4*n]);
+      auto r = work.get();
+      auto z = r + n;
+      auto p = r + 2 * n;
+      auto q = r + 3 * n;
+      if (non_zero_guess) {  // compute initial residual
+        A(x, r);
+        blas::axpby(n, scalar_t(1.), b, 1, scalar_t(-1.), r, 1);
+      } else {
+        std::copy(b, b+n, r);
+        std::fill(x, x+n, scalar_t(0.));
+      }
+      real_t resid = norm2(n, r, 1, comm);
+      real_t error = resid / bnrm2;
+      if (verbose)
+        std::cout << "CG it. " << totit
+                  << "\tres = " << std::setw(12) << resid
+                  << "\trel.res = " << std::setw(12) << error << std::endl;
+      if (resid <= atol || error <= rtol)
+        return error;
+      scalar_t alpha, rho, rho_1(0.), beta;
+      for (totit=1; totit<=maxit; totit++) {
+        std::copy(r, r+n, z);                 // z = M \ r
+        M(z);
+        rho = dotc(n, r, 1, z, 1, comm);
+        if (rho == scalar_t(0.0)) break;
+        if (totit > 1) {
+          beta = rho / rho_1;                 // p = z + beta p
+          blas::axpby(n, scalar_t(1.), z, 1, beta, p, 1);
+        } else std::copy(z, z+n, p);
+        A(p, q);                              // q = A * p
+        alpha = rho / dotc(n, p, 1, q, 1, comm);
+        blas::axpy(n, alpha, p, 1, x, 1);     // x = x + alpha p
+        blas::axpy(n, -alpha, q, 1, r, 1);    // r = r - alpha q
+        resid = norm2(n, r, 1, comm);
+        error = resid / bnrm2;
+        if (verbose)
+          std::cout << "CG it. " << totit
+                    << "\tres = " << std::setw(12) << resid
+                    << "\trel.res = " << std::setw(12) << error << std::endl;
+        if (error <= rtol || resid <= atol) break;
+        rho_1 = rho;
+      }
+      return error;
+    }
+
+    // explicit template instantiations
+    template float ConjugateGradientMPI
+    (const MPIComm& comm, const SPMV<float>& A, const PREC<float>& M,
+     std::size_t n, float* x, const float* b, float rtol, float atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+    template double ConjugateGradientMPI
+    (const MPIComm& comm, const SPMV<double>& A, const PREC<double>& M,
+     std::size_t n, double* x, const double* b, double rtol, double atol,
+     int& totit, int maxit, bool non_zero_guess, bool verbose);
+    template float ConjugateGradientMPI
+    (const MPIComm& comm, const SPMV<std::complex<float>>& A,
+     const PREC<std::complex<float>>& M, std::size_t n,
+     std::complex<float>* x, const std::complex<float>* b,
+     float rtol, float atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+    template double ConjugateGradientMPI
+    (const MPIComm& comm, const SPMV<std::complex<double>>& A,
+     const PREC<std::complex<double>>& M, std::size_t n,
+     std::complex<double>* x, const std::complex<double>* b,
+     double rtol, double atol, int& totit, int maxit,
+     bool non_zero_guess, bool verbose);
+
+  } // end namespace iterative
+} // end namespace strumpack
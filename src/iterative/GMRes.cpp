@@ -28,6 +28,8 @@
  */
 #include <iostream>
 #include <iomanip>
+#include <vector>
+#include <algorithm>
 
 #include "IterativeSolvers.hpp"
 
@@ -142,6 +144,143 @@ namespace strumpack {
       return rho;
     }
 
+    /*
+     * Left preconditioned restarted GMRes for multiple right-hand
+     * sides. Every column of x/b has its own Krylov space, Hessenberg
+     * matrix and convergence test, but the operator and the
+     * preconditioner are applied to all columns at once.
+     */
+    template<typename scalar_t, typename real_t> real_t BlockGMRes
+    (const BlockSPMV<scalar_t>& A, const BlockPREC<scalar_t>& M,
+     DenseMatrix<scalar_t>& x, const DenseMatrix<scalar_t>& b,
+     real_t rtol, real_t atol, int& totit, int maxit, int restart,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose) {
+      using DenseM_t = DenseMatrix<scalar_t>;
+      std::size_t n = x.rows(), d = x.cols();
+      if (restart > maxit) restart = maxit;
+      int ldh = restart+1;
+      // V[k] holds the k-th Krylov vector for all right-hand sides
+      std::vector<DenseM_t> V(restart+1, DenseM_t(n, d));
+      DenseM_t hess(ldh*restart, d), givens_c(restart, d),
+        givens_s(restart, d), b_(restart+1, d), b_prec(b);
+      M(b_prec);
+
+      std::vector<real_t> rho(d), rho0(d, real_t(0.));
+      std::vector<int> nrit(d);
+      std::vector<char> active(d);
+      auto converged = [&](std::size_t j) {
+        return rho[j]/rho0[j] < rtol || rho[j] < atol;
+      };
+      auto print = [&](bool restarted) {
+        real_t r = 0., rr = 0.;
+        for (std::size_t j=0; j<d; j++) {
+          r = std::max(r, rho[j]);
+          if (rho0[j] > real_t(0.)) rr = std::max(rr, rho[j]/rho0[j]);
+        }
+        std::cout << "GMRES it. " << totit << "\tres = "
+                  << std::setw(12) << r
+                  << "\trel.res = " << std::setw(12) << rr
+                  << (restarted ? "\t restart!" : "") << std::endl;
+      };
+
+      bool no_conv = true;
+      totit = 0;
+      while (no_conv) {
+        auto& V0 = V[0];
+        if (non_zero_guess || totit > 0) {
+          A(x, V0);
+          M(V0);
+          for (std::size_t j=0; j<d; j++)
+            blas::axpby(n, scalar_t(1.), b_prec.ptr(0, j), 1,
+                        scalar_t(-1.), V0.ptr(0, j), 1);
+        } else {
+          V0.copy(b_prec);
+          x.zero();
+        }
+        std::size_t nactive = 0;
+        for (std::size_t j=0; j<d; j++) {
+          auto v = V0.ptr(0, j);
+          rho[j] = blas::nrm2(n, v, 1);
+          if (totit == 0) rho0[j] = rho[j];
+          nrit[j] = -1;
+          active[j] = !converged(j);
+          if (!active[j]) {
+            std::fill(v, v+n, scalar_t(0.));
+            continue;
+          }
+          nactive++;
+          nrit[j] = restart-1;
+          blas::scal(n, scalar_t(1./rho[j]), v, 1);
+          b_(0, j) = rho[j];
+          for (int i=1; i<=restart; i++) b_(i, j) = scalar_t(0.);
+        }
+        if (!nactive) break;
+        if (verbose) print(true);
+        for (int it=0; it<restart; it++) {
+          totit++;
+          A(V[it], V[it+1]);
+          M(V[it+1]);
+          for (std::size_t j=0; j<d; j++) {
+            auto w = V[it+1].ptr(0, j);
+            if (!active[j]) {
+              std::fill(w, w+n, scalar_t(0.));
+              continue;
+            }
+            auto h = hess.ptr(0, j);
+            auto gc = givens_c.ptr(0, j);
+            auto gs = givens_s.ptr(0, j);
+            auto bj = b_.ptr(0, j);
+            if (GStype == GramSchmidtType::CLASSICAL) {
+              for (int k=0; k<=it; k++)
+                h[k+it*ldh] = blas::dotc(n, V[k].ptr(0, j), 1, w, 1);
+              for (int k=0; k<=it; k++)
+                blas::axpy(n, scalar_t(-h[k+it*ldh]), V[k].ptr(0, j), 1, w, 1);
+            } else if (GStype == GramSchmidtType::MODIFIED) {
+              for (int k=0; k<=it; k++) {
+                h[k+it*ldh] = blas::dotc(n, V[k].ptr(0, j), 1, w, 1);
+                blas::axpy(n, scalar_t(-h[k+it*ldh]), V[k].ptr(0, j), 1, w, 1);
+              }
+            }
+            h[it+1+it*ldh] = blas::nrm2(n, w, 1);
+            blas::scal(n, scalar_t(1.)/h[it+1+it*ldh], w, 1);
+
+            for (int k=1; k<it+1; k++) {
+              scalar_t gamma = blas::my_conj(gc[k-1])*h[k-1+it*ldh]
+                + blas::my_conj(gs[k-1])*h[k+it*ldh];
+              h[k+it*ldh] = -gs[k-1]*h[k-1+it*ldh] + gc[k-1]*h[k+it*ldh];
+              h[k-1+it*ldh] = gamma;
+            }
+            scalar_t delta =
+              std::sqrt(std::pow(std::abs(h[it+it*ldh]),scalar_t(2))
+                        + std::pow(h[it+1+it*ldh],scalar_t(2)));
+            gc[it] = h[it+it*ldh] / delta;
+            gs[it] = h[it+1+it*ldh] / delta;
+            h[it+it*ldh] = blas::my_conj(gc[it])*h[it+it*ldh]
+              + blas::my_conj(gs[it])*h[it+1+it*ldh];
+            bj[it+1] = -gs[it]*bj[it];
+            bj[it] = blas::my_conj(gc[it])*bj[it];
+            rho[j] = std::abs(bj[it+1]);
+            if (converged(j) || totit >= maxit) {
+              active[j] = false;
+              nactive--;
+              nrit[j] = it;
+            }
+          }
+          if (verbose) print(false);
+          if (!nactive) break;
+        }
+        for (std::size_t j=0; j<d; j++) {
+          if (nrit[j] < 0) continue;
+          auto bj = b_.ptr(0, j);
+          blas::trsv('U', 'N', 'N', nrit[j]+1, hess.ptr(0, j), ldh, bj, 1);
+          for (int k=0; k<=nrit[j]; k++)
+            blas::axpy(n, bj[k], V[k].ptr(0, j), 1, x.ptr(0, j), 1);
+        }
+        if (totit >= maxit) no_conv = false;
+      }
+      return *std::max_element(rho.begin(), rho.end());
+    }
+
     // explicit template instantiations
     template float GMRes
     (const SPMV<float>& A, const PREC<float>& M, std::size_t n,
@@ -164,5 +303,31 @@ namespace strumpack {
      double rtol, double atol, int& totit, int maxit, int restart,
      GramSchmidtType GStype, bool non_zero_guess, bool verbose);
 
+
+    template float BlockGMRes
+    (const BlockSPMV<float>& A, const BlockPREC<float>& M,
+     DenseMatrix<float>& x, const DenseMatrix<float>& b,
+     float rtol, float atol, int& totit, int maxit, int restart,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+    template double BlockGMRes
+    (const BlockSPMV<double>& A, const BlockPREC<double>& M,
+     DenseMatrix<double>& x, const DenseMatrix<double>& b,
+     double rtol, double atol, int& totit, int maxit, int restart,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+    template float BlockGMRes
+    (const BlockSPMV<std::complex<float>>& A,
+     const BlockPREC<std::complex<float>>& M,
+     DenseMatrix<std::complex<float>>& x,
+     const DenseMatrix<std::complex<float>>& b,
+     float rtol, float atol, int& totit, int maxit, int restart,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+    template double BlockGMRes
+    (const BlockSPMV<std::complex<double>>& A,
+     const BlockPREC<std::complex<double>>& M,
+     DenseMatrix<std::complex<double>>& x,
+     const DenseMatrix<std::complex<double>>& b,
+     double rtol, double atol, int& totit, int maxit, int restart,
+     GramSchmidtType GStype, bool non_zero_guess, bool verbose);
+
   } // end namespace iterative
 } // end namespace strumpack
@@ -124,6 +124,45 @@ namespace strumpack {
       }
     }
 
+    template<typename scalar_t,typename real_t> void
+    IterativeRefinement(const BlockSPMV<scalar_t>& A,
+                        const BlockPREC<scalar_t>& M,
+                        DMat<scalar_t>& x, const DMat<scalar_t>& b,
+                        real_t rtol, real_t atol, int& totit, int maxit,
+                        bool non_zero_guess, bool verbose) {
+      DMat<scalar_t> r(x.rows(), x.cols());
+      if (non_zero_guess) {
+        A(x, r);
+        r.scale_and_add(scalar_t(-1.), b);
+      } else {
+        r = b;
+        x.zero();
+      }
+      auto res_norm = r.norm();
+      auto res0 = res_norm;
+      auto rel_res_norm = real_t(1.);
+      totit = 0;
+      if (verbose)
+        std::cout << "REFINEMENT it. " << totit
+                  << "\tres = " << std::setw(12) << res_norm
+                  << "\trel.res = " << std::setw(12) << rel_res_norm
+                  << std::endl;
+      while (res_norm > atol && rel_res_norm > rtol &&
+             totit++ < maxit) {
+        M(r);
+        x.add(r);
+        A(x, r);
+        r.scale_and_add(scalar_t(-1.), b);
+        res_norm = r.norm();
+        rel_res_norm = res_norm / res0;
+        if (verbose)
+          std::cout << "REFINEMENT it. " << totit << "\tres = "
+                    << std::setw(12) << res_norm
+                    << "\trel.res = " << std::setw(12) << rel_res_norm
+                    << std::endl;
+      }
+    }
+
     // explicit template instantiations
     template void
     IterativeRefinement(const SpMat<float,int>& A, const Prec<float>& M,
@@ -230,6 +269,33 @@ namespace strumpack {
                         double rtol, double atol, int& totit, int maxit,
                         bool non_zero_guess, bool verbose);
 
+    template void
+    IterativeRefinement(const BlockSPMV<float>& A,
+                        const BlockPREC<float>& M,
+                        DMat<float>& x, const DMat<float>& b,
+                        float rtol, float atol, int& totit, int maxit,
+                        bool non_zero_guess, bool verbose);
+    template void
+    IterativeRefinement(const BlockSPMV<double>& A,
+                        const BlockPREC<double>& M,
+                        DMat<double>& x, const DMat<double>& b,
+                        double rtol, double atol, int& totit, int maxit,
+                        bool non_zero_guess, bool verbose);
+    template void
+    IterativeRefinement(const BlockSPMV<std::complex<float>>& A,
+                        const BlockPREC<std::complex<float>>& M,
+                        DMat<std::complex<float>>& x,
+                        const DMat<std::complex<float>>& b,
+                        float rtol, float atol, int& totit, int maxit,
+                        bool non_zero_guess, bool verbose);
+    template void
+    IterativeRefinement(const BlockSPMV<std::complex<double>>& A,
+                        const BlockPREC<std::complex<double>>& M,
+                        DMat<std::complex<double>>& x,
+                        const DMat<std::complex<double>>& b,
+                        double rtol, double atol, int& totit, int maxit,
+                        bool non_zero_guess, bool verbose);
+
   } // end namespace iterative
 } // end namespace strumpack
 
@@ -48,6 +48,12 @@ namespace strumpack {
     template<typename T>
     using PREC = std::function<void(T*)>;
 
+    template<typename T> using BlockSPMV =
+      std::function<void(const DenseMatrix<T>&, DenseMatrix<T>&)>;
+
+    template<typename T>
+    using BlockPREC = std::function<void(DenseMatrix<T>&)>;
+
     /*
      * This is left preconditioned restarted GMRes.
      *
@@ -74,6 +80,78 @@ namespace strumpack {
                     real_t rtol, real_t atol, int& totit, int maxit,
                     bool non_zero_guess, bool verbose);
 
+    /**
+     * Preconditioned conjugate gradient, for Hermitian positive
+     * definite A and M. Only needs storage for 4 vectors, and each
+     * iteration performs a single application of A and M.
+     * http://www.netlib.org/templates/matlab/cg.m
+     *
+     *  Input vectors x and b have stride 1, length n
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t ConjugateGradient(const SPMV<scalar_t>& A,
+                             const PREC<scalar_t>& M,
+                             std::size_t n, scalar_t* x, const scalar_t* b,
+                             real_t rtol, real_t atol, int& totit, int maxit,
+                             bool non_zero_guess, bool verbose);
+
+    /**
+     * Left preconditioned restarted GMRes for multiple right-hand
+     * sides. Each column of x and b is solved with its own Krylov
+     * space and convergence test, but the operator A and the
+     * preconditioner M are always applied to a block of vectors, ie,
+     * as a sparse matrix times dense matrix product, and a
+     * multiple right-hand side multifrontal solve.
+     *
+     * \param A routine to compute y = A*x for a block x
+     * \param M routine to apply M^{-1} to a block, in place
+     * \param x on output the solution, on input the initial guess
+     * if non_zero_guess. Should be allocated to the size of b
+     * \param b the right hand sides
+     * \param totit on output the number of iterations
+     * \return the largest (preconditioned) residual norm
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t BlockGMRes(const BlockSPMV<scalar_t>& A,
+                      const BlockPREC<scalar_t>& M,
+                      DenseMatrix<scalar_t>& x,
+                      const DenseMatrix<scalar_t>& b,
+                      real_t rtol, real_t atol, int& totit, int maxit,
+                      int restart, GramSchmidtType GStype,
+                      bool non_zero_guess, bool verbose);
+
+    /**
+     * BiCGStab for multiple right-hand sides, see BlockGMRes.
+     *
+     * \return the largest relative residual norm
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t BlockBiCGStab(const BlockSPMV<scalar_t>& A,
+                         const BlockPREC<scalar_t>& M,
+                         DenseMatrix<scalar_t>& x,
+                         const DenseMatrix<scalar_t>& b,
+                         real_t rtol, real_t atol, int& totit, int maxit,
+                         bool non_zero_guess, bool verbose);
+
+    /**
+     * Conjugate gradient for multiple right-hand sides, see
+     * BlockGMRes.
+     *
+     * \return the largest relative residual norm
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    real_t BlockConjugateGradient(const BlockSPMV<scalar_t>& A,
+                                  const BlockPREC<scalar_t>& M,
+                                  DenseMatrix<scalar_t>& x,
+                                  const DenseMatrix<scalar_t>& b,
+                                  real_t rtol, real_t atol,
+                                  int& totit, int maxit,
+                                  bool non_zero_guess, bool verbose);
+
     /**
      * Iterative refinement, with a sparse matrix, to solve a linear
      * system M^{-1}Ax=M^{-1}b.
@@ -135,6 +213,25 @@ namespace strumpack {
                              real_t rtol, real_t atol, int& totit, int maxit,
                              bool non_zero_guess, bool verbose);
 
+    /**
+     * Iterative refinement, with the matrix only available as a
+     * routine to compute y = A*x for a block x, for instance to
+     * refine a solve with A^T. Unlike the sparse matrix version, this
+     * does not check the componentwise backward error.
+     *
+     * \param A routine to compute y = A*x for a block x
+     * \param M routine to apply M^{-1} to a block, in place
+     * \see IterativeRefinement
+     */
+    template<typename scalar_t,
+             typename real_t = typename RealType<scalar_t>::value_type>
+    void IterativeRefinement(const BlockSPMV<scalar_t>& A,
+                             const BlockPREC<scalar_t>& M,
+                             DenseMatrix<scalar_t>& x,
+                             const DenseMatrix<scalar_t>& b,
+                             real_t rtol, real_t atol, int& totit, int maxit,
+                             bool non_zero_guess, bool verbose);
+
   } // end namespace iterative
 } // end namespace strumpack
 
@@ -0,0 +1,419 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/**
+ * \file BinaryIO.hpp
+ * \brief Helpers to write and read the binary files used to store
+ * sparse factors. Reading is done from a memory mapped view of the
+ * file when the platform supports it, see MemoryMappedFile, which is
+ * also used to read sparse matrix files.
+ */
+#ifndef STRUMPACK_BINARY_IO_HPP
+#define STRUMPACK_BINARY_IO_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define STRUMPACK_BINARY_IO_MMAP
+#endif
+
+#include "dense/DenseMatrix.hpp"
+
+namespace strumpack {
+
+  /**
+   * All arrays are stored at offsets which are a multiple of this
+   * value, so that they can be used directly from a memory mapped
+   * file.
+   */
+  constexpr std::size_t binary_io_alignment = 64;
+
+  /**
+   * \class BinaryWriter
+   * \brief Write plain values, vectors and dense matrices to a
+   * binary file. Arrays are padded to binary_io_alignment bytes.
+   */
+  class BinaryWriter {
+  public:
+    BinaryWriter(const std::string& fname)
+      : os_(fname, std::ios::out | std::ios::trunc | std::ios::binary) {}
+
+    bool good() const { return os_.good(); }
+
+    /** current offset in the file */
+    std::size_t tell() { return std::size_t(os_.tellp()); }
+    void flush() { os_.flush(); }
+
+    template<typename T> void write(const T& v) {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "BinaryWriter::write requires a trivially copyable type");
+      os_.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    void write(const std::string& s) {
+      write(std::uint64_t(s.size()));
+      os_.write(s.data(), s.size());
+    }
+
+    template<typename T, typename A>
+    void write_vector(const std::vector<T,A>& v) {
+      write(std::uint64_t(v.size()));
+      align();
+      os_.write(reinterpret_cast<const char*>(v.data()), v.size()*sizeof(T));
+    }
+
+    template<typename scalar_t>
+    void write_matrix(const DenseMatrix<scalar_t>& D) {
+      write(std::uint64_t(D.rows()));
+      write(std::uint64_t(D.cols()));
+      align();
+      if (D.rows())
+        for (std::size_t c=0; c<D.cols(); c++)
+          os_.write(reinterpret_cast<const char*>(D.ptr(0, c)),
+                    D.rows()*sizeof(scalar_t));
+    }
+
+    /**
+     * Access to the underlying stream, for objects that implement
+     * their own (stream based) serialization.
+     */
+    std::ofstream& stream() { return os_; }
+
+  private:
+    std::ofstream os_;
+
+    void align() {
+      auto p = std::size_t(os_.tellp()) % binary_io_alignment;
+      if (p) {
+        char zeros[binary_io_alignment] = {0};
+        os_.write(zeros, binary_io_alignment - p);
+      }
+    }
+  };
+
+
+  /**
+   * \class MemoryMappedFile
+   * \brief Read only view of a complete file. The file is memory
+   * mapped (if supported), otherwise it is read in memory
+   * completely. A missing or empty file gives data() == nullptr.
+   */
+  class MemoryMappedFile {
+  public:
+    MemoryMappedFile(const std::string& fname) {
+#if defined(STRUMPACK_BINARY_IO_MMAP)
+      int fd = ::open(fname.c_str(), O_RDONLY);
+      if (fd != -1) {
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+          void* p = ::mmap(nullptr, st.st_size, PROT_READ,
+                           MAP_PRIVATE, fd, 0);
+          if (p != MAP_FAILED) {
+            ::madvise(p, st.st_size, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(p);
+            size_ = st.st_size;
+            mapped_ = true;
+          }
+        }
+        ::close(fd);
+      }
+#endif
+      if (!mapped_) {
+        std::ifstream is(fname, std::ios::in | std::ios::binary);
+        if (is.good()) {
+          buf_.assign(std::istreambuf_iterator<char>(is),
+                      std::istreambuf_iterator<char>());
+          if (!buf_.empty()) {
+            data_ = buf_.data();
+            size_ = buf_.size();
+          }
+        }
+      }
+    }
+
+    ~MemoryMappedFile() {
+#if defined(STRUMPACK_BINARY_IO_MMAP)
+      if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool mapped() const { return mapped_; }
+
+    /**
+     * Ask the OS to read (willneed) or drop (!willneed) the given
+     * range, if the file is memory mapped.
+     */
+    void advise(std::size_t pos, std::size_t bytes, bool willneed) const {
+#if defined(STRUMPACK_BINARY_IO_MMAP)
+      if (!mapped_ || pos >= size_) return;
+      bytes = std::min(bytes, size_ - pos);
+      // madvise needs a page aligned address
+      std::size_t page = ::sysconf(_SC_PAGESIZE), p0 = pos / page * page;
+      ::madvise(const_cast<char*>(data_) + p0, bytes + pos - p0,
+                willneed ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+    }
+
+  private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<char> buf_;
+  };
+
+
+  /**
+   * \class BinaryReader
+   * \brief Read back a file written with BinaryWriter, from a
+   * MemoryMappedFile. Reading past the end of the file sets an
+   * error flag, see good().
+   */
+  class BinaryReader {
+  public:
+    BinaryReader(const std::string& fname) : fname_(fname), f_(fname) {
+      data_ = f_.data();
+      size_ = f_.size();
+      good_ = data_ != nullptr;
+    }
+
+    BinaryReader(const BinaryReader&) = delete;
+    BinaryReader& operator=(const BinaryReader&) = delete;
+
+    bool good() const { return good_; }
+    bool mapped() const { return f_.mapped(); }
+
+    /** move the read position to offset pos in the file */
+    void seek(std::size_t pos) { pos_ = pos; }
+    std::size_t tell() const { return pos_; }
+
+    /**
+     * Ask the OS to start reading the given range of the file in the
+     * background, if the file is memory mapped.
+     */
+    void prefetch(std::size_t pos, std::size_t bytes) const {
+      f_.advise(pos, bytes, true);
+    }
+    /**
+     * Drop the given range of a memory mapped file from memory. It
+     * will be read from the file again when accessed.
+     */
+    void evict(std::size_t pos, std::size_t bytes) const {
+      f_.advise(pos, bytes, false);
+    }
+
+    template<typename T> void read(T& v) {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "BinaryReader::read requires a trivially copyable type");
+      copy(reinterpret_cast<char*>(&v), sizeof(T));
+    }
+    template<typename T> T read() { T v{}; read(v); return v; }
+
+    void read(std::string& s) {
+      auto n = read<std::uint64_t>();
+      if (!check(n)) return;
+      s.resize(n);
+      copy(&s[0], n);
+    }
+
+    template<typename T, typename A>
+    void read_vector(std::vector<T,A>& v) {
+      auto n = read<std::uint64_t>();
+      align();
+      if (!check(n, sizeof(T))) return;
+      v.resize(n);
+      copy(reinterpret_cast<char*>(v.data()), n*sizeof(T));
+    }
+
+    template<typename scalar_t>
+    void read_matrix(DenseMatrix<scalar_t>& D) {
+      auto m = read<std::uint64_t>();
+      auto n = read<std::uint64_t>();
+      align();
+      if (!check(0) || (m && n && (!check(m, sizeof(scalar_t)) ||
+                                   !check(n, m*sizeof(scalar_t)))))
+        return;
+      D = DenseMatrix<scalar_t>(m, n);
+      if (m)
+        for (std::size_t c=0; c<n; c++)
+          copy(reinterpret_cast<char*>(D.ptr(0, c)), m*sizeof(scalar_t));
+    }
+
+    /**
+     * Read an object that implements its own (stream based)
+     * deserialization, starting at the current position. f is
+     * called with an std::ifstream positioned at the current offset.
+     */
+    template<typename F> void read_stream(F f) {
+      if (!good_) return;
+      std::ifstream is(fname_, std::ios::in | std::ios::binary);
+      is.seekg(pos_);
+      f(is);
+      if (!is.good()) { good_ = false; return; }
+      pos_ = is.tellg();
+    }
+
+  private:
+    std::string fname_;
+    MemoryMappedFile f_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0, pos_ = 0;
+    bool good_ = false;
+
+    // check that n items of s bytes can be read, without overflow
+    bool check(std::uint64_t n, std::size_t s=1) {
+      if (!good_ || pos_ > size_ || n > (size_ - pos_) / s)
+        good_ = false;
+      return good_;
+    }
+    void copy(char* dst, std::size_t bytes) {
+      if (!check(bytes)) return;
+      std::memcpy(dst, data_ + pos_, bytes);
+      pos_ += bytes;
+    }
+    void align() {
+      auto p = pos_ % binary_io_alignment;
+      if (p) pos_ += binary_io_alignment - p;
+    }
+  };
+
+
+  /**
+   * \class OutOfCoreStore
+   * \brief Scratch file for the out-of-core factorization, see
+   * SPOptions::set_out_of_core_file. Records are appended while the
+   * fronts are factored, and read back, from a memory mapped view of
+   * the file, after finish_writing. The file is removed when this
+   * object is destroyed. Once a write or read fails, the store is no
+   * longer good().
+   */
+  class OutOfCoreStore {
+  public:
+    OutOfCoreStore(const std::string& fname)
+      : fname_(fname), w_(new BinaryWriter(fname)) {}
+    ~OutOfCoreStore() {
+      r_.reset();
+      w_.reset();
+      std::remove(fname_.c_str());
+    }
+    OutOfCoreStore(const OutOfCoreStore&) = delete;
+    OutOfCoreStore& operator=(const OutOfCoreStore&) = delete;
+
+    bool good() const {
+      return !failed_ && (r_ ? r_->good() : w_ && w_->good());
+    }
+    const std::string& file() const { return fname_; }
+
+    /**
+     * Append a record, written by f(BinaryWriter&). Returns the id of
+     * the record. Thread safe.
+     */
+    template<typename F> std::size_t write(F f) {
+      std::size_t id = 0;
+#pragma omp critical (strumpack_out_of_core)
+      {
+        auto p0 = w_->tell();
+        f(*w_);
+        records_.emplace_back(p0, w_->tell() - p0);
+        id = records_.size() - 1;
+      }
+      return id;
+    }
+
+    /**
+     * Close the file for writing and map it for reading. Returns
+     * false if writing or mapping the file failed, then nothing can
+     * be read.
+     */
+    bool finish_writing() {
+      w_->flush();
+      if (!w_->good()) return false;
+      w_.reset();
+      r_.reset(new BinaryReader(fname_));
+      return r_->good();
+    }
+
+    /**
+     * Read record id with f(BinaryReader&), which returns false if
+     * the record is invalid. Returns false if the file is not mapped
+     * for reading, see finish_writing, or if the read failed. Thread
+     * safe.
+     */
+    template<typename F> bool read(std::size_t id, F f) {
+      bool ok = false;
+#pragma omp critical (strumpack_out_of_core)
+      {
+        if (r_ && id < records_.size()) {
+          r_->seek(records_[id].first);
+          ok = f(*r_) && r_->good();
+        }
+        if (!ok) failed_ = true;
+      }
+      return ok;
+    }
+
+    /** start reading record id in the background */
+    void prefetch(std::size_t id) const {
+      if (r_ && id < records_.size())
+        r_->prefetch(records_[id].first, records_[id].second);
+    }
+    /** drop record id from memory, it is still in the file */
+    void evict(std::size_t id) const {
+      if (r_ && id < records_.size())
+        r_->evict(records_[id].first, records_[id].second);
+    }
+
+  private:
+    std::string fname_;
+    std::unique_ptr<BinaryWriter> w_;
+    std::unique_ptr<BinaryReader> r_;
+    std::atomic<bool> failed_{false};
+    // offset and size in bytes of each record
+    std::vector<std::pair<std::size_t,std::size_t>> records_;
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_BINARY_IO_HPP
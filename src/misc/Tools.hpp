@@ -31,6 +31,8 @@
 
 #include <vector>
 #include <iomanip>
+#include <cassert>
+#include <algorithm>
 #include "StrumpackConfig.hpp"
 #include "StrumpackParameters.hpp"
 #include "dense/BLASLAPACKWrapper.hpp"
@@ -240,6 +242,42 @@ namespace strumpack {
 #endif
   };
 
+  /**
+   * Stack allocator for the contribution blocks of a subtree which is
+   * factored sequentially, in postorder. The buffer is allocated once,
+   * with the maximum stack depth from the symbolic factorization, so
+   * push and pop do not allocate and do not need locks.
+   */
+  template<typename scalar_t> class StackArena {
+  public:
+    StackArena(std::vector<scalar_t,NoInit<scalar_t>>&& buf)
+      : buf_(std::move(buf)) {}
+
+    /** current top of the stack, an offset in the buffer */
+    std::size_t top() const { return top_; }
+    scalar_t* data(std::size_t offset) { return buf_.data() + offset; }
+
+    /** reserve s elements on top of the stack */
+    scalar_t* push(std::size_t s) {
+      assert(top_ + s <= buf_.size());
+      auto p = buf_.data() + top_;
+      top_ += s;
+      peak_ = std::max(peak_, top_);
+      return p;
+    }
+    /** reset the top of the stack to offset t */
+    void pop(std::size_t t) { assert(t <= top_); top_ = t; }
+    /** maximum depth the stack has reached */
+    std::size_t peak() const { return peak_; }
+
+    /** release the buffer, for instance to hand it to a VectorPool */
+    std::vector<scalar_t,NoInit<scalar_t>>& buffer() { return buf_; }
+
+  private:
+    std::vector<scalar_t,NoInit<scalar_t>> buf_;
+    std::size_t top_ = 0, peak_ = 0;
+  };
+
 
   // this sorts both indices and values at the same time
   template<typename scalar_t,typename integer_t>
@@ -268,6 +306,27 @@ namespace strumpack {
     }
   }
 
+  /**
+   * Split the rows [0, rows) in P contiguous parts with about the
+   * same number of nonzeros plus rows, using the row pointer ptr
+   * (which does not need to start at 0). Returns the first row of
+   * part p, so part p is [nnz_balanced_row(p), nnz_balanced_row(p+1)).
+   */
+  template<typename integer_t> integer_t
+  nnz_balanced_row(const integer_t* ptr, integer_t rows, int p, int P) {
+    if (p <= 0) return 0;
+    if (p >= P) return rows;
+    const long long w = (long long)(ptr[rows] - ptr[0]) + rows,
+      t = w * p / P;
+    integer_t lo = 0, hi = rows;
+    while (lo < hi) {
+      integer_t m = lo + (hi - lo) / 2;
+      if ((long long)(ptr[m] - ptr[0]) + m < t) lo = m + 1;
+      else hi = m;
+    }
+    return lo;
+  }
+
   template<class T> std::string number_format_with_commas(T value) {
     struct Numpunct : public std::numpunct<char>{
     protected:
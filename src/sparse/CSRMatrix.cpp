@@ -32,9 +32,12 @@
 #include <tuple>
 #include <algorithm>
 #include <string>
+#include <cstring>
 
 #include "CSRMatrix.hpp"
+#include "misc/BinaryIO.hpp"
 #include "MC64ad.hpp"
+#include "SELLMatrix.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "dense/DistributedMatrix.hpp"
 #endif
@@ -104,8 +107,9 @@ namespace strumpack {
     std::ofstream fs(filename, std::ofstream::binary);
     char s = 'R';
     fs.write(&s, sizeof(char));
-    if (std::is_same<integer_t,int>()) s = '4';
-    else if (std::is_same<integer_t,int64_t>()) s = '8';
+    // number of bytes per integer, int64_t is not long long on all
+    // platforms
+    s = '0' + sizeof(integer_t);
     fs.write(&s, sizeof(char));
     if (is_complex<scalar_t>()) {
       if (std::is_same<real_t,float>()) s = 'c';
@@ -139,14 +143,21 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> int
   CSRMatrix<scalar_t,integer_t>::read_binary(const std::string& filename) {
-    std::ifstream fs(filename, std::ifstream::in | std::ifstream::binary);
-    char s;
-    fs.read(&s, sizeof(s));
+    sell_.reset();
+    MemoryMappedFile f(filename);
+    const char* d = f.data();
+    const std::size_t hbytes = 3*sizeof(char) + 3*sizeof(integer_t);
+    if (!d || f.size() < hbytes) {
+      std::cerr << "Error: could not read binary CSR file "
+                << filename << std::endl;
+      return 1;
+    }
+    char s = d[0];
     if (s != 'R') {
       std::cerr << "Error: matrix is not in binary CSR format." << std::endl;
       return 1;//throw "Error: matrix is not in binary CSR format.";
     }
-    fs.read(&s, sizeof(s));
+    s = d[1];
     if (sizeof(integer_t) != s-'0') {
       std::cerr << "Error: matrix integer_t type does not match,"
         " input matrix uses " << (s-'0') << " bytes per integer."
@@ -154,7 +165,7 @@ namespace strumpack {
       //throw "Error: matrix integer_t type does not match input matrix.";
       return 1;
     }
-    fs.read(&s, sizeof(s));
+    s = d[2];
     if ((!is_complex<scalar_t>() && std::is_same<real_t,float>() && s!='s') ||
         (!is_complex<scalar_t>() && std::is_same<real_t,double>() && s!='d') ||
         (is_complex<scalar_t>() && std::is_same<real_t,float>() && s!='c') ||
@@ -163,9 +174,14 @@ namespace strumpack {
         " input matrix is of type " << s << std::endl;
       return 1;//throw "Error: scalar type of input matrix does not match";
     }
-    fs.read((char*)&n_, sizeof(integer_t));
-    fs.read((char*)&n_, sizeof(integer_t));
-    fs.read((char*)&nnz_, sizeof(integer_t));
+    std::memcpy(&n_, d+3+sizeof(integer_t), sizeof(integer_t));
+    std::memcpy(&nnz_, d+3+2*sizeof(integer_t), sizeof(integer_t));
+    if (f.size() < hbytes + (std::size_t(n_)+1+nnz_)*sizeof(integer_t)
+        + std::size_t(nnz_)*sizeof(scalar_t)) {
+      std::cerr << "Error: binary CSR file " << filename
+                << " is truncated." << std::endl;
+      return 1;
+    }
     std::cout << "# Reading matrix with n="
               << number_format_with_commas(n_)
               << ", nnz=" << number_format_with_commas(nnz_)
@@ -174,13 +190,24 @@ namespace strumpack {
     ptr_.resize(n_+1);
     ind_.resize(nnz_);
     val_.resize(nnz_);
-    for (integer_t i=0; i<n_+1; i++)
-      fs.read((char*)(&ptr_[i]), sizeof(integer_t));
-    for (integer_t i=0; i<nnz_; i++)
-      fs.read((char*)(&ind_[i]), sizeof(integer_t));
-    for (integer_t i=0; i<nnz_; i++)
-      fs.read((char*)(&val_[i]), sizeof(scalar_t));
-    fs.close();
+    // The vectors own their memory, so the data is copied from the
+    // mapped file. The copy is done in parallel, in blocks, so that
+    // the pages of the file are also read in parallel.
+    const std::size_t B = 1 << 20;
+    char* dst[3] = {reinterpret_cast<char*>(ptr_.data()),
+                    reinterpret_cast<char*>(ind_.data()),
+                    reinterpret_cast<char*>(val_.data())};
+    std::size_t bytes[3] = {(std::size_t(n_)+1)*sizeof(integer_t),
+                            std::size_t(nnz_)*sizeof(integer_t),
+                            std::size_t(nnz_)*sizeof(scalar_t)};
+    const char* src = d + hbytes;
+    for (int a=0; a<3; a++) {
+      std::size_t nb = (bytes[a] + B - 1) / B;
+#pragma omp parallel for schedule(static)
+      for (std::size_t b=0; b<nb; b++)
+        std::memcpy(dst[a] + b*B, src + b*B, std::min(B, bytes[a] - b*B));
+      src += bytes[a];
+    }
     return 0;
   }
 
@@ -214,16 +241,50 @@ namespace strumpack {
 //   }
 // #endif
 
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrix<scalar_t,integer_t>::set_SELL_spmv(bool enable) {
+    if (enable)
+      sell_.reset(new SELLMatrix<scalar_t,integer_t>
+                  (n_, ptr_.data(), ind_.data(), val_.data()));
+    else sell_.reset();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrix<scalar_t,integer_t>::permute
+  (const integer_t* iorder, const integer_t* order) {
+    sell_.reset();
+    CSM_t::permute(iorder, order);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrix<scalar_t,integer_t>::symmetrize_sparsity() {
+    sell_.reset();
+    CSM_t::symmetrize_sparsity();
+  }
+
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::spmv
   (const scalar_t* x, scalar_t* y) const {
-#pragma omp parallel for
-    for (integer_t r=0; r<n_; r++) {
-      const auto hij = ptr_[r+1];
-      scalar_t yr(0);
-      for (integer_t j=ptr_[r]; j<hij; j++)
-        yr += val_[j] * x[ind_[j]];
-      y[r] = yr;
+    if (sell_) sell_->spmv(x, y);
+    else {
+      // every thread gets a contiguous block of rows with about the
+      // same number of nonzeros
+#pragma omp parallel
+      {
+        integer_t lo = 0, hi = n_;
+#if defined(_OPENMP)
+        int t = omp_get_thread_num(), T = omp_get_num_threads();
+        lo = nnz_balanced_row(ptr_.data(), n_, t, T);
+        hi = nnz_balanced_row(ptr_.data(), n_, t+1, T);
+#endif
+        for (integer_t r=lo; r<hi; r++) {
+          const auto hij = ptr_[r+1];
+          scalar_t yr(0);
+          for (integer_t j=ptr_[r]; j<hij; j++)
+            yr += val_[j] * x[ind_[j]];
+          y[r] = yr;
+        }
+      }
     }
     STRUMPACK_FLOPS(this->spmv_flops());
     STRUMPACK_BYTES(this->spmv_bytes());
@@ -235,8 +296,43 @@ namespace strumpack {
     // assert(x.cols() == y.cols());
     // assert(x.rows() == std::size_t(n_));
     // assert(y.rows() == std::size_t(n_));
-    for (std::size_t c=0; c<x.cols(); c++)
-      spmv(x.ptr(0,c), y.ptr(0,c));
+    const std::size_t d = x.cols();
+    if (d == 1) {
+      spmv(x.data(), y.data());
+      return;
+    }
+    // process up to B columns at once, so that the sparse matrix is
+    // only read once for every B right-hand sides
+    const std::size_t B = 8;
+    const auto ldx = x.ld();
+#pragma omp parallel
+    {
+      integer_t lo = 0, hi = n_;
+#if defined(_OPENMP)
+      int t = omp_get_thread_num(), T = omp_get_num_threads();
+      lo = nnz_balanced_row(ptr_.data(), n_, t, T);
+      hi = nnz_balanced_row(ptr_.data(), n_, t+1, T);
+#endif
+      for (std::size_t c0=0; c0<d; c0+=B) {
+        const std::size_t nc = std::min(B, d-c0);
+        const auto px = x.ptr(0, c0);
+        for (integer_t r=lo; r<hi; r++) {
+          scalar_t yr[B];
+          for (std::size_t c=0; c<nc; c++) yr[c] = scalar_t(0.);
+          const auto hij = ptr_[r+1];
+          for (integer_t j=ptr_[r]; j<hij; j++) {
+            const auto v = val_[j];
+            const auto xj = px + ind_[j];
+            for (std::size_t c=0; c<nc; c++)
+              yr[c] += v * xj[c*ldx];
+          }
+          for (std::size_t c=0; c<nc; c++)
+            y(r, c0+c) = yr[c];
+        }
+      }
+    }
+    STRUMPACK_FLOPS(this->spmv_flops()*d);
+    STRUMPACK_BYTES(this->spmv_bytes()*((d+B-1)/B));
   }
 
   // TODO use MKL routines for better performance
@@ -322,8 +418,49 @@ namespace strumpack {
     return eq;
   }
 
+  template<typename scalar_t,typename integer_t> Equilibration<scalar_t>
+  CSRMatrix<scalar_t,integer_t>::symmetric_equilibration() const {
+    // same as LAPACK xPOEQU, using the diagonal
+    Equil_t eq(n_);
+    if (!n_) return eq;
+    real_t small = blas::lamch<real_t>('S');
+    real_t big = 1. / small;
+#pragma omp parallel for
+    for (integer_t i=0; i<n_; i++) {
+      scalar_t d(0.);
+      for (integer_t j=ptr_[i]; j<ptr_[i+1]; j++)
+        if (ind_[j] == i) d += val_[j];
+      eq.R[i] = std::abs(d);
+    }
+    auto mM = std::minmax_element(eq.R.begin(), eq.R.end());
+    real_t dmin = *(mM.first), dmax = *(mM.second);
+    eq.Amax = dmax;
+    if (dmin == 0.) {
+      for (integer_t i=0; i<n_; i++)
+        if (eq.R[i] == 0.) {
+          eq.info = i+1;
+          return eq;
+        }
+    }
+#pragma omp parallel for
+    for (integer_t i=0; i<n_; i++)
+      eq.R[i] = 1. / std::sqrt(std::min(std::max(eq.R[i], small), big));
+    eq.rcond = eq.ccond =
+      std::sqrt(std::max(dmin, small) / std::min(dmax, big));
+    auto D = eq.R;
+    eq.set_type();
+    if (eq.type != EquilibrationType::NONE) {
+      // set_type might only keep R or C, but both are needed
+      eq.type = EquilibrationType::BOTH;
+      eq.C = D;
+      eq.R = std::move(D);
+    }
+    return eq;
+  }
+
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::equilibrate(const Equil_t& eq) {
+    sell_.reset();
     if (!n_) return;
     switch (eq.type) {
     case EquilibrationType::COLUMN: {
@@ -640,6 +777,88 @@ namespace strumpack {
     }
   }
 
+  // same traversal as extract_front
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrix<scalar_t,integer_t>::front_scatter_map
+  (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
+   FrontScatterMap<integer_t>& m) const {
+    std::size_t ds = shi - slo, du = upd.size();
+    m.clear();
+    std::vector<integer_t> nz12;
+    std::vector<std::size_t> pos12;
+    for (std::size_t row=0; row<ds; row++) { // separator rows
+      std::size_t upd_ptr = 0;
+      const auto hij = ptr_[row+slo+1];
+      for (integer_t j=ptr_[row+slo]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi) {
+            m.nz.push_back(j);
+            m.pos.push_back(row + (col-slo)*ds);
+          } else {
+            while (upd_ptr<du && upd[upd_ptr]<col)
+              upd_ptr++;
+            if (upd_ptr == du) break;
+            if (upd[upd_ptr] == col) {
+              nz12.push_back(j);
+              pos12.push_back(row + upd_ptr*ds);
+            }
+          }
+        }
+      }
+    }
+    m.n11 = m.nz.size();
+    m.n12 = nz12.size();
+    m.nz.insert(m.nz.end(), nz12.begin(), nz12.end());
+    m.pos.insert(m.pos.end(), pos12.begin(), pos12.end());
+    for (std::size_t i=0; i<du; i++) { // update rows
+      auto row = upd[i];
+      const auto hij = ptr_[row+1];
+      for (integer_t j=ptr_[row]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi) {
+            m.nz.push_back(j);
+            m.pos.push_back(i + (col-slo)*du);
+          } else break;
+        }
+      }
+    }
+    m.nz.shrink_to_fit();
+    m.pos.shrink_to_fit();
+  }
+
+  // only the lower triangular parts of F11 and F21 are set
+  template<typename scalar_t,typename integer_t> void
+  CSRMatrix<scalar_t,integer_t>::extract_front_symmetric
+  (DenseM_t& F11, DenseM_t& F21, integer_t slo, integer_t shi,
+   const std::vector<integer_t>& upd, int depth) const {
+    integer_t ds = shi - slo, du = upd.size();
+    for (integer_t row=0; row<ds; row++) { // separator rows
+      const auto hij = ptr_[row+slo+1];
+      for (integer_t j=ptr_[row+slo]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col-slo <= row)
+            F11(row, col-slo) = val_[j];
+          else break;
+        }
+      }
+    }
+    for (integer_t i=0; i<du; i++) { // update rows
+      auto row = upd[i];
+      const auto hij = ptr_[row+1];
+      for (integer_t j=ptr_[row]; j<hij; j++) {
+        integer_t col = ind_[j];
+        if (col >= slo) {
+          if (col < shi)
+            F21(i, col-slo) = val_[j];
+          else break;
+        }
+      }
+    }
+  }
+
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::front_multiply
   (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
@@ -900,6 +1119,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::scale
   (const std::vector<scalar_t>& Dr, const std::vector<scalar_t>& Dc) {
+    sell_.reset();
 #pragma omp parallel for
     for (integer_t j=0; j<n_; j++)
       for (integer_t i=ptr_[j]; i<ptr_[j+1]; i++)
@@ -912,6 +1132,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::scale_real
   (const std::vector<real_t>& Dr, const std::vector<real_t>& Dc) {
+    sell_.reset();
 #pragma omp parallel for
     for (integer_t j=0; j<n_; j++)
       for (integer_t i=ptr_[j]; i<ptr_[j+1]; i++)
@@ -924,6 +1145,7 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::permute_columns
   (const std::vector<integer_t>& perm) {
+    sell_.reset();
     std::unique_ptr<integer_t[]> iperm(new integer_t[n_]);
     for (integer_t i=0; i<n_; i++) iperm[perm[i]] = i;
 #pragma omp parallel for
@@ -944,32 +1166,14 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> int
   CSRMatrix<scalar_t,integer_t>::read_matrix_market
   (const std::string& filename) {
-    using Triplet = std::tuple<integer_t,integer_t,scalar_t>;
-    std::vector<Triplet> A;
-    try {
-      A = this->read_matrix_market_entries(filename);
-    } catch (...) { return 1; }
-    std::sort
-      (A.begin(), A.end(),
-       [](const Triplet& a, const Triplet& b) -> bool {
-         // sort based on the row,column indices
-         return std::make_tuple(std::get<0>(a),std::get<1>(a)) <
-           std::make_tuple(std::get<0>(b), std::get<1>(b));
-       });
-    ptr_.resize(n_+1);
-    ind_.resize(nnz_);
-    val_.resize(nnz_);
-    integer_t row = -1;
-    for (integer_t i=0; i<nnz_; i++) {
-      val_[i] = std::get<2>(A[i]);
-      ind_[i] = std::get<1>(A[i]);
-      auto new_row = std::get<0>(A[i]);
-      if (new_row != row) {
-        for (int j=row+1; j<=new_row; j++) ptr_[j] = i;
-        row = new_row;
-      }
-    }
-    for (int j=row+1; j<=n_; j++) ptr_[j] = nnz_;
+    sell_.reset();
+    std::vector<std::vector<Triplet<scalar_t,integer_t>>> A;
+    bool zero_based = false, index_n = false;
+    long long entries = 0, nnz = 0;
+    if (this->read_matrix_market_entries
+        (filename, A, zero_based, index_n, entries, nnz))
+      return 1;
+    this->triplets_to_csr(A, 0, n_, zero_based ? 0 : 1);
     return 0;
   }
 
@@ -1040,6 +1244,40 @@ namespace strumpack {
     return Anew;
   }
 
+  template<typename scalar_t,typename integer_t>
+  std::unique_ptr<CSRMatrix<scalar_t,integer_t>>
+  CSRMatrix<scalar_t,integer_t>::lower_to_full() const {
+    std::vector<integer_t> cnt(n_+1);
+    for (integer_t r=0; r<n_; r++)
+      for (integer_t k=ptr_[r]; k<ptr_[r+1]; k++) {
+        auto c = ind_[k];
+        if (c < r) { cnt[r+1]++; cnt[c+1]++; }
+        else if (c == r) cnt[r+1]++;
+      }
+    for (integer_t r=0; r<n_; r++)
+      cnt[r+1] += cnt[r];
+    std::unique_ptr<CSRMatrix<scalar_t,integer_t>>
+      Anew(new CSRMatrix<scalar_t,integer_t>(n_, cnt[n_]));
+    for (integer_t r=0; r<=n_; r++)
+      Anew->ptr(r) = cnt[r];
+    // rows are traversed in order, so the mirrored upper triangular
+    // entries are appended to each row in increasing column order,
+    // after the lower triangular entries of that row
+    for (integer_t r=0; r<n_; r++)
+      for (integer_t k=ptr_[r]; k<ptr_[r+1]; k++) {
+        auto c = ind_[k];
+        if (c > r) continue;
+        Anew->ind(cnt[r]) = c;
+        Anew->val(cnt[r]++) = val_[k];
+        if (c < r) {
+          Anew->ind(cnt[c]) = r;
+          Anew->val(cnt[c]++) = blas::my_conj(val_[k]);
+        }
+      }
+    Anew->sort_rows();
+    return Anew;
+  }
+
 #if defined(STRUMPACK_USE_MPI)
   template<typename scalar_t,typename integer_t> void
   CSRMatrix<scalar_t,integer_t>::extract_separator_2d
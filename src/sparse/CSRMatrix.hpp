@@ -34,6 +34,7 @@
 #define STRUMPACK_CSR_MATRIX_HPP
 
 #include <vector>
+#include <memory>
 
 #include "CompressedSparseMatrix.hpp"
 #include "CSRGraph.hpp"
@@ -41,6 +42,8 @@
 
 namespace strumpack {
 
+  template<typename scalar_t,typename integer_t> class SELLMatrix;
+
   /**
    * \class CSRMatrix
    * \brief Class for storing a compressed sparse row matrix (single
@@ -76,8 +79,32 @@ namespace strumpack {
 
     void spmv(Trans op, const DenseM_t& x, DenseM_t& y) const;
 
+    /**
+     * Build (enable) or drop (!enable) a sliced ELLPACK copy of the
+     * matrix, see SELLMatrix. When present, it is used by spmv for a
+     * single vector. This roughly doubles the memory for the
+     * matrix. The copy is dropped by the member functions that
+     * modify the matrix, but not when the matrix is modified through
+     * the non-const ptr/ind/val accessors, call this again after
+     * that.
+     */
+    void set_SELL_spmv(bool enable);
+
+    /**
+     * Check whether spmv uses a sliced ELLPACK copy of the matrix.
+     * \see set_SELL_spmv
+     */
+    bool SELL_spmv() const { return sell_ != nullptr; }
+
+    void permute(const integer_t* iorder, const integer_t* order) override;
+    using CSM_t::permute;
+
+    void symmetrize_sparsity() override;
+
     Equil_t equilibration() const override;
 
+    Equil_t symmetric_equilibration() const override;
+
     void equilibrate(const Equil_t& eq) override;
 
     void permute_columns(const std::vector<integer_t>& perm) override;
@@ -90,6 +117,14 @@ namespace strumpack {
     std::unique_ptr<CSRMatrix<scalar_t,integer_t>>
     add_missing_diagonal(const scalar_t& s) const;
 
+    /**
+     * Return the symmetric (Hermitian for complex scalar_t) matrix
+     * defined by the lower triangular part of this matrix. Entries
+     * above the diagonal are ignored, and replaced by the (conjugate)
+     * transpose of the strictly lower triangular part.
+     */
+    std::unique_ptr<CSRMatrix<scalar_t,integer_t>> lower_to_full() const;
+
     int read_matrix_market(const std::string& filename) override;
     int read_binary(const std::string& filename);
     void print_dense(const std::string& name) const override;
@@ -125,6 +160,14 @@ namespace strumpack {
                        integer_t sep_begin, integer_t sep_end,
                        const std::vector<integer_t>& upd,
                        int depth) const override;
+    void extract_front_symmetric(DenseM_t& F11, DenseM_t& F21,
+                                 integer_t sep_begin, integer_t sep_end,
+                                 const std::vector<integer_t>& upd,
+                                 int depth) const override;
+    void front_scatter_map(integer_t sep_begin, integer_t sep_end,
+                           const std::vector<integer_t>& upd,
+                           FrontScatterMap<integer_t>& m) const override;
+    using CSM_t::extract_front;
 
     void push_front_elements(integer_t, integer_t,
                              const std::vector<integer_t>&,
@@ -198,6 +241,9 @@ namespace strumpack {
     void sort_rows();
 
   private:
+    // shared between copies, it is not modified after construction
+    std::shared_ptr<const SELLMatrix<scalar_t,integer_t>> sell_;
+
     using CSM_t::n_;
     using CSM_t::nnz_;
     using CSM_t::ptr_;
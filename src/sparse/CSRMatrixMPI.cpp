@@ -507,6 +507,11 @@ namespace strumpack {
     spmv_rind.erase
       (std::unique(spmv_rind.begin(), spmv_rind.end()), spmv_rind.end());
 
+    spmv_bufs_.prptr.resize(lrows_+1);
+    spmv_bufs_.prptr[0] = 0;
+    for (integer_t r=0; r<lrows_; r++)
+      spmv_bufs_.prptr[r+1] = spmv_bufs_.prptr[r] +
+        ptr_[r+1] - offdiag_start_[r];
     spmv_bufs_.prbuf.reserve(nr_offdiag_nnz);
     for (integer_t r=0; r<lrows_; r++)
       for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++)
@@ -568,8 +573,99 @@ namespace strumpack {
     assert(x.cols() == y.cols());
     assert(x.rows() == std::size_t(lrows_));
     assert(y.rows() == std::size_t(lrows_));
-    for (std::size_t c=0; c<x.cols(); c++)
-      spmv(x.ptr(0,c), y.ptr(0,c));
+    const std::size_t d = x.cols();
+    if (d == 1) {
+      spmv(x.data(), y.data());
+      return;
+    }
+    setup_spmv_buffers();
+    const auto& b = spmv_bufs_;
+    const std::size_t ns = b.sind.size(), nr = b.roffs.back();
+
+    // all columns are sent in a single message per rank, the block
+    // for rank p starts at d*soff[p], stored column by column
+    std::vector<scalar_t> sbuf(d*ns), rbuf(d*nr);
+    for (std::size_t p=0; p<b.sranks.size(); p++) {
+      const std::size_t s0 = b.soff[p], sp = b.soff[p+1] - s0;
+      for (std::size_t c=0; c<d; c++)
+        for (std::size_t i=0; i<sp; i++)
+          sbuf[d*s0+c*sp+i] = x(b.sind[s0+i]-brow_, c);
+    }
+    std::vector<MPI_Request> sreq(b.sranks.size()), rreq(b.rranks.size());
+    for (std::size_t p=0; p<b.sranks.size(); p++)
+      comm_.isend(sbuf.data() + d*b.soff[p], d*(b.soff[p+1] - b.soff[p]),
+                  b.sranks[p], 0, &sreq[p]);
+    for (std::size_t p=0; p<b.rranks.size(); p++)
+      comm_.irecv(rbuf.data() + d*b.roffs[p], d*(b.roffs[p+1] - b.roffs[p]),
+                  b.rranks[p], 0, &rreq[p]);
+
+    // the nonzeros of A are only read once for every B columns
+    const std::size_t B = 8;
+    const auto ldx = x.ld();
+    // block diagonal part, while the communication is going on
+#pragma omp parallel
+    {
+      integer_t lo = 0, hi = lrows_;
+#if defined(_OPENMP)
+      int t = omp_get_thread_num(), T = omp_get_num_threads();
+      lo = nnz_balanced_row(ptr_.data(), lrows_, t, T);
+      hi = nnz_balanced_row(ptr_.data(), lrows_, t+1, T);
+#endif
+      for (std::size_t c0=0; c0<d; c0+=B) {
+        const std::size_t nc = std::min(B, d-c0);
+        const auto px = x.ptr(0, c0) - brow_;
+        for (integer_t r=lo; r<hi; r++) {
+          scalar_t yr[B];
+          for (std::size_t c=0; c<nc; c++) yr[c] = scalar_t(0.);
+          for (auto j=ptr_[r]; j<offdiag_start_[r]; j++) {
+            const auto v = val_[j];
+            const auto xj = px + ind_[j];
+            for (std::size_t c=0; c<nc; c++)
+              yr[c] += v * xj[c*ldx];
+          }
+          for (std::size_t c=0; c<nc; c++)
+            y(r, c0+c) = yr[c];
+        }
+      }
+    }
+    wait_all(rreq);
+
+    // store the received values column by column, so column c of the
+    // off-diagonal part of x starts at c*nr
+    std::vector<scalar_t> xoff(d*nr);
+    for (std::size_t p=0; p<b.rranks.size(); p++) {
+      const std::size_t r0 = b.roffs[p], rp = b.roffs[p+1] - r0;
+      for (std::size_t c=0; c<d; c++)
+        std::copy(rbuf.data() + d*r0 + c*rp, rbuf.data() + d*r0 + (c+1)*rp,
+                  xoff.data() + c*nr + r0);
+    }
+#pragma omp parallel
+    {
+      integer_t lo = 0, hi = lrows_;
+#if defined(_OPENMP)
+      int t = omp_get_thread_num(), T = omp_get_num_threads();
+      lo = nnz_balanced_row(b.prptr.data(), lrows_, t, T);
+      hi = nnz_balanced_row(b.prptr.data(), lrows_, t+1, T);
+#endif
+      for (std::size_t c0=0; c0<d; c0+=B) {
+        const std::size_t nc = std::min(B, d-c0);
+        const auto px = xoff.data() + c0*nr;
+        for (integer_t r=lo; r<hi; r++) {
+          scalar_t yr[B];
+          for (std::size_t c=0; c<nc; c++) yr[c] = scalar_t(0.);
+          auto pb = b.prbuf.data() + b.prptr[r];
+          for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++) {
+            const auto v = val_[j];
+            const auto xj = px + *pb++;
+            for (std::size_t c=0; c<nc; c++)
+              yr[c] += v * xj[c*nr];
+          }
+          for (std::size_t c=0; c<nc; c++)
+            y(r, c0+c) += yr[c];
+        }
+      }
+    }
+    wait_all(sreq);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -593,23 +689,44 @@ namespace strumpack {
                   spmv_bufs_.roffs[p+1] - spmv_bufs_.roffs[p],
                   spmv_bufs_.rranks[p], 0, &rreq[p]);
 
-    // first do the block diagonal part, while the communication is going on
-#pragma omp parallel for
-    for (integer_t r=0; r<lrows_; r++) {
-      auto yrow = scalar_t(0.);
-      for (auto j=ptr_[r]; j<offdiag_start_[r]; j++)
-        yrow += val_[j] * x[ind_[j] - brow_];
-      y[r] = yrow;
+    // first do the block diagonal part, while the communication is
+    // going on, every thread gets a contiguous block of rows with
+    // about the same number of nonzeros
+#pragma omp parallel
+    {
+      integer_t lo = 0, hi = lrows_;
+#if defined(_OPENMP)
+      int t = omp_get_thread_num(), T = omp_get_num_threads();
+      lo = nnz_balanced_row(ptr_.data(), lrows_, t, T);
+      hi = nnz_balanced_row(ptr_.data(), lrows_, t+1, T);
+#endif
+      for (integer_t r=lo; r<hi; r++) {
+        auto yrow = scalar_t(0.);
+        for (auto j=ptr_[r]; j<offdiag_start_[r]; j++)
+          yrow += val_[j] * x[ind_[j] - brow_];
+        y[r] = yrow;
+      }
     }
     // wait for incoming messages
     wait_all(rreq);
 
     // do the block off-diagonal part of the matrix
-    // TODO some openmp here
-    auto pbuf = spmv_bufs_.prbuf.begin();
-    for (integer_t r=0; r<lrows_; r++)
-      for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++)
-        y[r] += val_[j] * spmv_bufs_.rbuf[*pbuf++];
+#pragma omp parallel
+    {
+      integer_t lo = 0, hi = lrows_;
+#if defined(_OPENMP)
+      int t = omp_get_thread_num(), T = omp_get_num_threads();
+      lo = nnz_balanced_row(spmv_bufs_.prptr.data(), lrows_, t, T);
+      hi = nnz_balanced_row(spmv_bufs_.prptr.data(), lrows_, t+1, T);
+#endif
+      for (integer_t r=lo; r<hi; r++) {
+        auto pbuf = spmv_bufs_.prbuf.data() + spmv_bufs_.prptr[r];
+        auto yrow = scalar_t(0.);
+        for (integer_t j=offdiag_start_[r]; j<ptr_[r+1]; j++)
+          yrow += val_[j] * spmv_bufs_.rbuf[*pbuf++];
+        y[r] += yrow;
+      }
+    }
 
     // wait for all send messages to finish
     wait_all(sreq);
@@ -849,6 +966,56 @@ namespace strumpack {
     return eq;
   }
 
+  template<typename scalar_t,typename integer_t> Equilibration<scalar_t>
+  CSRMatrixMPI<scalar_t,integer_t>::symmetric_equilibration() const {
+    // same as LAPACK xPOEQU, using the diagonal
+    Equil_t eq(lrows_, n_);
+    if (!n_) return eq;
+    real_t small = blas::lamch<real_t>('S');
+    real_t big = 1. / small;
+    const auto brow = begin_row();
+#pragma omp parallel for
+    for (integer_t r=0; r<lrows_; r++) {
+      scalar_t d(0.);
+      for (integer_t j=ptr_[r]; j<ptr_[r+1]; j++)
+        if (ind_[j] == r + brow) d += val_[j];
+      eq.R[r] = std::abs(d);
+    }
+    auto mM = std::minmax_element(eq.R.begin(), eq.R.end());
+    real_t dmin = lrows_ ? *(mM.first) : std::numeric_limits<real_t>::max();
+    real_t dmax = lrows_ ? *(mM.second) : 0;
+    dmin = comm_.all_reduce(dmin, MPI_MIN);
+    dmax = comm_.all_reduce(dmax, MPI_MAX);
+    eq.Amax = dmax;
+    if (dmin == 0.) {
+      for (integer_t r=0; r<lrows_; r++)
+        if (eq.R[r] == 0.) {
+          eq.info = brow + r+1;
+          break;
+        }
+      eq.info = comm_.all_reduce(eq.info, MPI_MIN);
+      return eq;
+    }
+#pragma omp parallel for
+    for (integer_t r=0; r<lrows_; r++)
+      eq.R[r] = 1. / std::sqrt(std::min(std::max(eq.R[r], small), big));
+    eq.rcond = eq.ccond =
+      std::sqrt(std::max(dmin, small) / std::min(dmax, big));
+    // the column scaling is the (global) row scaling
+    std::fill(eq.C.begin(), eq.C.end(), real_t(0.));
+    std::copy(eq.R.begin(), eq.R.end(), eq.C.begin()+brow);
+    comm_.all_reduce(eq.C, MPI_MAX);
+    auto R = eq.R, C = eq.C;
+    eq.set_type();
+    if (eq.type != EquilibrationType::NONE) {
+      // set_type might only keep R or C, but both are needed
+      eq.type = EquilibrationType::BOTH;
+      eq.R = std::move(R);
+      eq.C = std::move(C);
+    }
+    return eq;
+  }
+
   template<typename scalar_t,typename integer_t> void
   CSRMatrixMPI<scalar_t,integer_t>::equilibrate(const Equil_t& eq) {
     if (!lrows_) return;
@@ -1030,15 +1197,72 @@ namespace strumpack {
     spmv_bufs_ = SPMVBuffers<scalar_t,integer_t>();
   }
 
+  /**
+   * Every process maps the file, and parses only its part of the
+   * bytes. The entries are then sent to the process owning the row,
+   * with the rows divided over the processes to balance the number
+   * of nonzeros. Collective on comm_.
+   */
   template<typename scalar_t,typename integer_t> int
   CSRMatrixMPI<scalar_t,integer_t>::read_matrix_market
   (const std::string& filename) {
-    std::cout << "ERROR: reading a distributed matrix"
-              << " from file is not supported." << std::endl;
-    abort();
-    // TODO: first read the matrix as a sequential matrix
-    // then make a Distributed matrix from the sequential one
-    // Aydin has code for MPI-IO input of matrix-market file
+    using Trip_t = Triplet<scalar_t,integer_t>;
+    auto P = comm_.size();
+    auto rank = comm_.rank();
+    std::vector<std::vector<Trip_t>> A;
+    bool zero_based = false, index_n = false;
+    long long entries = 0, nnz = 0;
+    int err = this->read_matrix_market_entries
+      (filename, A, zero_based, index_n, entries, nnz, rank, P);
+    if (comm_.all_reduce(err, MPI_MAX)) return 1;
+    zero_based = comm_.all_reduce(int(zero_based), MPI_MAX);
+    index_n = comm_.all_reduce(int(index_n), MPI_MAX);
+    entries = comm_.all_reduce(entries, MPI_SUM);
+    if (this->check_matrix_market_entries
+        (filename, zero_based, index_n, entries, nnz))
+      return 1;
+    integer_t base = zero_based ? 0 : 1;
+    integer_t chunks = A.size();
+    // global number of nonzeros per row, to compute dist_
+    std::vector<integer_t> rptr(n_+1, 0);
+    for (integer_t c=0; c<chunks; c++)
+      for (auto& t : A[c])
+        rptr[t.r-base+1]++;
+    comm_.all_reduce(rptr, MPI_SUM);
+    for (integer_t r=0; r<n_; r++)
+      rptr[r+1] += rptr[r];
+    dist_.resize(P+1);
+    dist_[0] = 0;
+    for (int p=1; p<P; p++) {
+      integer_t t = p * float(rptr[n_]) / P;
+      auto hi = std::distance
+        (rptr.begin(), std::upper_bound
+         (rptr.begin()+dist_[p-1], rptr.begin()+n_, t));
+      dist_[p] = ((hi-1 >= dist_[p-1]) &&
+                  (t-rptr[hi-1] < rptr[hi]-t)) ? hi-1 : hi;
+    }
+    dist_[P] = n_;
+    std::vector<std::vector<Trip_t>> sbuf(P);
+    for (integer_t c=0; c<chunks; c++) {
+      for (auto& t : A[c]) {
+        auto p = std::distance
+          (dist_.begin(), std::upper_bound
+           (dist_.begin(), dist_.end(), t.r-base)) - 1;
+        sbuf[p].push_back(t);
+      }
+      std::vector<Trip_t>().swap(A[c]);
+    }
+    A.resize(1);
+    A[0] = comm_.all_to_all_v(sbuf);
+    Trip_t::free_mpi_type();
+    brow_ = dist_[rank];
+    lrows_ = dist_[rank+1] - brow_;
+    this->triplets_to_csr(A, brow_, lrows_, base);
+    lnnz_ = nnz_;
+    nnz_ = rptr[n_];
+    split_diag_offdiag();
+    spmv_bufs_ = SPMVBuffers<scalar_t,integer_t>();
+    check();
     return 0;
   }
 
@@ -53,6 +53,8 @@ namespace strumpack {
     // for each off-diagonal entry spmv_prbuf stores the
     // corresponding index in the receive buffer
     std::vector<integer_t> prbuf;
+    // start of the off-diagonal entries of each local row in prbuf
+    std::vector<integer_t> prptr;
   };
 
 
@@ -135,6 +137,8 @@ namespace strumpack {
 
     Equil_t equilibration() const override;
 
+    Equil_t symmetric_equilibration() const override;
+
     void equilibrate(const Equil_t&) override;
 
     void permute_columns(const std::vector<integer_t>& perm) override;
@@ -32,9 +32,12 @@
 #include <cstdio>
 #include <cstring>
 #include <exception>
+#include <cstdlib>
+#include <cassert>
 
 #include "CompressedSparseMatrix.hpp"
 #include "misc/Tools.hpp"
+#include "misc/BinaryIO.hpp"
 #include "CSRGraph.hpp"
 #include "StrumpackConfig.hpp"
 #include "dense/DenseMatrix.hpp"
@@ -90,6 +93,22 @@ namespace strumpack {
     std::cout << std::endl;
   }
 
+  template<typename scalar_t,typename integer_t> std::uint64_t
+  CompressedSparseMatrix<scalar_t,integer_t>::pattern_hash() const {
+    const std::uint64_t prime = 0x100000001b3;
+    std::uint64_t h = 0xcbf29ce484222325;
+    auto hash = [&](const integer_t* v, std::size_t n) {
+      for (std::size_t i=0; i<n; i++) {
+        h ^= std::uint64_t(v[i]);
+        h *= prime;
+      }
+    };
+    hash(&n_, 1);
+    hash(ptr_.data(), ptr_.size());
+    hash(ind_.data(), ind_.size());
+    return h;
+  }
+
   template<typename scalar_t,typename integer_t>
   MatchingData<scalar_t,integer_t>
   CompressedSparseMatrix<scalar_t,integer_t>::matching
@@ -201,124 +220,257 @@ namespace strumpack {
     return std::complex<float>(vr, vi);
   }
 
-  template<typename scalar_t,typename integer_t>
-  std::vector<std::tuple<integer_t,integer_t,scalar_t>>
-  CompressedSparseMatrix<scalar_t,integer_t>::read_matrix_market_entries
-  (const std::string& filename) {
-    std::cout << "# opening file \'" << filename << "\'" << std::endl;
-    FILE *fp = fopen(filename.c_str(), "r");
-    if (fp == NULL) {
-      std::cerr << "ERROR: could not read file";
-      exit(1);
+  // Helpers for the matrix market parser. These work on the memory
+  // mapped file, p is the current position, e the end of the range.
+  inline const char* mm_skip_blanks(const char* p, const char* e) {
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p;
+  }
+  inline const char* mm_next_line(const char* p, const char* e) {
+    p = static_cast<const char*>(std::memchr(p, '\n', e - p));
+    return p ? p + 1 : e;
+  }
+  // returns nullptr if no integer could be read
+  template<typename int_t> const char*
+  mm_parse_int(const char* p, const char* e, int_t& v) {
+    p = mm_skip_blanks(p, e);
+    bool neg = false;
+    if (p < e && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+    const char* b = p;
+    int_t x = 0;
+    while (p < e && *p >= '0' && *p <= '9') x = 10 * x + (*p++ - '0');
+    if (p == b) return nullptr;
+    v = neg ? -x : x;
+    return p;
+  }
+  // returns nullptr if no real value could be read. The mapped file
+  // is not null terminated, so the token is copied for strtod, which
+  // rounds tiny or huge values to 0 or inf
+  inline const char* mm_parse_real(const char* p, const char* e, double& v) {
+    p = mm_skip_blanks(p, e);
+    auto t = p;
+    while (t < e && *t != ' ' && *t != '\t' && *t != '\r' && *t != '\n') t++;
+    char buf[64];
+    std::string long_token;
+    const char* s = buf;
+    if (std::size_t(t - p) < sizeof(buf)) {
+      std::memcpy(buf, p, t - p);
+      buf[t - p] = '\0';
+    } else {
+      long_token.assign(p, t);
+      s = long_token.c_str();
     }
-    const int max_cline = 256;
-    char cline[max_cline];
-    if (fgets(cline, max_cline, fp) == NULL) {
-      std::cerr << "ERROR: could not read from file" << std::endl;
-      exit(1);
+    char* end = nullptr;
+    v = std::strtod(s, &end);
+    if (end == s) return nullptr;
+    return p + (end - s);
+  }
+
+  template<typename scalar_t,typename integer_t> int
+  CompressedSparseMatrix<scalar_t,integer_t>::read_matrix_market_entries
+  (const std::string& filename,
+   std::vector<std::vector<Triplet<scalar_t,integer_t>>>& A,
+   bool& zero_based, bool& index_n, long long& entries, long long& nnz,
+   int part, int parts) {
+    bool verb = (part == 0);
+    if (verb)
+      std::cout << "# opening file \'" << filename << "\'" << std::endl;
+    MemoryMappedFile f(filename);
+    const char *d = f.data(), *e = d + f.size();
+    if (!d) {
+      std::cerr << "ERROR: could not read file "
+                << filename << std::endl;
+      return 1;
     }
-    printf("# %s", cline);
-    if (strstr(cline, "pattern")) {
+    auto p = mm_next_line(d, e);
+    std::string banner(d, p);
+    if (verb) std::cout << "# " << banner;
+    if (strstr(banner.c_str(), "pattern")) {
       std::cerr << "ERROR: This is not a matrix,"
                 << " but just a sparsity pattern" << std::endl;
-      exit(1);
-    }
-    else if (strstr(cline, "complex")) {
-      if (!is_complex<scalar_t>()) {
-        fclose(fp);
-        throw "ERROR: Complex matrix";
-      }
+      return 1;
     }
+    bool cplx = strstr(banner.c_str(), "complex");
+    // not an error, the caller can try again with a complex matrix
+    if (cplx && !is_complex<scalar_t>()) return 1;
     MMsym s = GENERAL;
-    if (strstr(cline, "skew-symmetric")) {
-      s = SKEWSYMMETRIC;
-      symm_sparse_ = true;
-    } else if (strstr(cline, "symmetric")) {
-      s = SYMMETRIC;
-      symm_sparse_ = true;
-    } else if (strstr(cline, "hermitian")) {
-      s = HERMITIAN;
-      symm_sparse_ = true;
+    if (strstr(banner.c_str(), "skew-symmetric")) s = SKEWSYMMETRIC;
+    else if (strstr(banner.c_str(), "symmetric")) s = SYMMETRIC;
+    else if (strstr(banner.c_str(), "hermitian")) s = HERMITIAN;
+    symm_sparse_ = (s != GENERAL);
+    // skip the comments, first line after that should be: m n nnz
+    while (p < e) {
+      auto b = mm_skip_blanks(p, e);
+      if (b < e && *b != '%' && *b != '\n') break;
+      p = mm_next_line(p, e);
     }
-
-    while (fgets(cline, max_cline, fp)) {
-      if (cline[0] != '%') { // first line should be: m n nnz
-        int m, in, innz;
-        sscanf(cline, "%d %d %d", &m, &in, &innz);
-        nnz_ = static_cast<integer_t>(innz);
-        n_ = static_cast<integer_t>(in);
-        std::cout << "# reading " << number_format_with_commas(m) << " by "
-                  << number_format_with_commas(n_) << " matrix with "
-                  << number_format_with_commas(nnz_) << " nnz's from "
-                  << filename << std::endl;
-        if (s != GENERAL) nnz_ = 2 * nnz_;
-        if (m != n_) {
-          std::cerr << "ERROR: matrix is not square!" << std::endl;
-          exit(1);
-        }
-        break;
-      }
+    long long m = 0, n = 0, innz = 0;
+    const char* q = mm_parse_int(p, e, m);
+    if (q) q = mm_parse_int(q, e, n);
+    if (q) q = mm_parse_int(q, e, innz);
+    if (!q) {
+      std::cerr << "ERROR: could not read the matrix size from "
+                << filename << std::endl;
+      return 1;
+    }
+    if (verb)
+      std::cout << "# reading " << number_format_with_commas(m) << " by "
+                << number_format_with_commas(n) << " matrix with "
+                << number_format_with_commas(innz) << " nnz's from "
+                << filename << std::endl;
+    if (m != n) {
+      std::cerr << "ERROR: matrix is not square!" << std::endl;
+      return 1;
     }
-    std::vector<std::tuple<integer_t,integer_t,scalar_t>> A;
-    A.reserve(nnz_);
-    bool zero_based = false;
-    if (!is_complex<scalar_t>()) {
-      int ir, ic;
-      double dv;
-      while (fscanf(fp, "%d %d %lf\n", &ir, &ic, &dv) != EOF) {
-        scalar_t v = static_cast<scalar_t>(dv);
-        integer_t r = static_cast<integer_t>(ir);
-        integer_t c = static_cast<integer_t>(ic);
-        if (r==0 || c==0) zero_based = true;
-        A.push_back(std::make_tuple(r, c, v));
+    n_ = static_cast<integer_t>(n);
+    const char* db = mm_next_line(q, e);
+    // align byte offset o (in [db, e]) to the start of a line
+    auto align = [db,e](const char* o) {
+      return (o <= db || o >= e || o[-1] == '\n') ? o : mm_next_line(o, e);
+    };
+    std::size_t bytes = e - db;
+    const char* pb = align(db + bytes * part / parts);
+    const char* pe = align(db + bytes * (part+1) / parts);
+    int chunks = 1;
+#if defined(_OPENMP)
+    chunks = 4 * omp_get_max_threads();
+#endif
+    // do not use chunks of less than 64KB
+    chunks = std::max
+      (1, std::min(chunks, int((pe - pb) / (std::size_t(1) << 16))));
+    A.clear();
+    A.resize(chunks);
+    // estimate for the number of entries per byte
+    double epb = (s == GENERAL ? 1. : 2.) * innz / std::max(bytes, std::size_t(1));
+    bool err = false, zb = false, top = false;
+    long long cnt = 0;
+#pragma omp parallel for schedule(dynamic,1) reduction(||:err,zb,top) \
+  reduction(+:cnt)
+    for (int k=0; k<chunks; k++) {
+      const char* cb = align(pb + (pe - pb) * std::size_t(k) / chunks);
+      const char* ce = align(pb + (pe - pb) * std::size_t(k+1) / chunks);
+      auto& Ak = A[k];
+      Ak.reserve(epb * (ce - cb));
+      for (const char* l=cb; l<ce; l=mm_next_line(l, ce)) {
+        l = mm_skip_blanks(l, ce);
+        if (l == ce || *l == '\n') continue;
+        integer_t r, c;
+        double vr, vi = 0.;
+        l = mm_parse_int(l, ce, r);
+        if (l) l = mm_parse_int(l, ce, c);
+        if (l) l = mm_parse_real(l, ce, vr);
+        if (l && cplx) l = mm_parse_real(l, ce, vi);
+        // the base is not known yet, it is checked by the caller
+        if (!l || r < 0 || c < 0 || r > n_ || c > n_) {
+          err = true;
+          break;
+        }
+        if (r == 0 || c == 0) zb = true;
+        if (r == n_ || c == n_) top = true;
+        cnt++;
+        auto v = get_scalar<scalar_t>(vr, vi);
+        Ak.emplace_back(r, c, v);
         if (r != c) {
           switch (s) {
-          case SKEWSYMMETRIC:
-            A.push_back(std::make_tuple(c, r, -v));
-            break;
-          case SYMMETRIC:
-            A.push_back(std::make_tuple(c, r, v));
-            break;
-          case HERMITIAN:
-            A.push_back(std::make_tuple(c, r, blas::my_conj(v)));
-            break;
+          case SKEWSYMMETRIC: Ak.emplace_back(c, r, -v); break;
+          case SYMMETRIC: Ak.emplace_back(c, r, v); break;
+          case HERMITIAN: Ak.emplace_back(c, r, blas::my_conj(v)); break;
           default: break;
           }
         }
       }
-    } else {
-      double vr=0, vi=0;
-      int ir, ic;
-      while (fscanf(fp, "%d %d %lf %lf\n", &ir, &ic, &vr, &vi) != EOF) {
-        scalar_t v = get_scalar<scalar_t>(vr, vi);
-        integer_t r = static_cast<integer_t>(ir),
-          c = static_cast<integer_t>(ic);
-        if (r==0 || c==0) zero_based = true;
-        A.push_back(std::make_tuple(r, c, v));
-        if (r != c) {
-          switch (s) {
-          case SKEWSYMMETRIC:
-            A.push_back(std::make_tuple(c, r, -v));
-            break;
-          case SYMMETRIC:
-            A.push_back(std::make_tuple(c, r, v));
-            break;
-          case HERMITIAN:
-            A.push_back(std::make_tuple(c, r, blas::my_conj(v)));
-            break;
-          default: break;
-          }
+    }
+    if (err) {
+      std::cerr << "ERROR: could not parse the entries in "
+                << filename << ", or index out of range" << std::endl;
+      return 1;
+    }
+    zero_based = zb;
+    index_n = top;
+    entries = cnt;
+    nnz = innz;
+    if (parts == 1)
+      return check_matrix_market_entries
+        (filename, zero_based, index_n, entries, innz);
+    return 0;
+  }
+
+  template<typename scalar_t,typename integer_t> int
+  CompressedSparseMatrix<scalar_t,integer_t>::check_matrix_market_entries
+  (const std::string& filename, bool zero_based, bool index_n,
+   long long entries, long long nnz) const {
+    if (zero_based && index_n) {
+      std::cerr << "ERROR: indices in " << filename << " are not in [0, "
+                << n_ << ") nor in [1, " << n_ << "]" << std::endl;
+      return 1;
+    }
+    if (entries != nnz) {
+      std::cerr << "ERROR: found " << entries << " entries in " << filename
+                << ", expected " << nnz << ", file truncated?" << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  CompressedSparseMatrix<scalar_t,integer_t>::triplets_to_csr
+  (std::vector<std::vector<Triplet<scalar_t,integer_t>>>& A,
+   integer_t row0, integer_t rows, integer_t base) {
+    integer_t chunks = A.size(), r0 = row0 + base;
+    // The chunks are divided in nb blocks, each with its own count
+    // per row, so no atomics are needed. The memory for the counts
+    // is kept below the number of triplets.
+    std::size_t ntrip = 0;
+    for (auto& Ac : A) ntrip += Ac.size();
+    integer_t nb = 1;
+#if defined(_OPENMP)
+    nb = omp_get_max_threads();
+#endif
+    nb = std::max(integer_t(1), std::min
+                  ({nb, chunks, integer_t(ntrip / std::max(rows, integer_t(1)))}));
+    std::vector<integer_t> cnt(std::size_t(nb) * rows, 0);
+#pragma omp parallel for schedule(static,1)
+    for (integer_t b=0; b<nb; b++) {
+      auto cb = cnt.data() + std::size_t(b) * rows;
+      for (integer_t c=b; c<chunks; c+=nb)
+        for (auto& t : A[c]) {
+          assert(t.r - r0 >= 0 && t.r - r0 < rows);
+          cb[t.r-r0]++;
         }
+    }
+    // prefix sum over the rows, and for each row over the blocks, to
+    // get the position of the first entry of each block in each row
+    ptr_.resize(rows+1);
+    integer_t nnz = 0;
+    for (integer_t r=0; r<rows; r++) {
+      ptr_[r] = nnz;
+      for (integer_t b=0; b<nb; b++) {
+        auto& cbr = cnt[std::size_t(b) * rows + r];
+        auto k = cbr;
+        cbr = nnz;
+        nnz += k;
       }
     }
-    nnz_ = A.size();
-    fclose(fp);
-    if (!zero_based)
-      for (auto& t : A) {
-        std::get<0>(t)--;
-        std::get<1>(t)--;
+    ptr_[rows] = nnz_ = nnz;
+    ind_.resize(nnz_);
+    val_.resize(nnz_);
+#pragma omp parallel for schedule(static,1)
+    for (integer_t b=0; b<nb; b++) {
+      auto pos = cnt.data() + std::size_t(b) * rows;
+      for (integer_t c=b; c<chunks; c+=nb) {
+        for (auto& t : A[c]) {
+          auto j = pos[t.r-r0]++;
+          ind_[j] = t.c - base;
+          val_[j] = t.v;
+        }
+        std::vector<Triplet<scalar_t,integer_t>>().swap(A[c]);
       }
-    return A;
+    }
+    A.clear();
+#pragma omp parallel for
+    for (integer_t r=0; r<rows; r++)
+      sort_indices_values<scalar_t>
+        (ind_.data(), val_.data(), ptr_[r], ptr_[r+1]);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -37,6 +37,7 @@
 #include <vector>
 #include <string>
 #include <tuple>
+#include <cstdint>
 
 #include "misc/Tools.hpp"
 #include "misc/Triplet.hpp"
@@ -126,6 +127,22 @@ namespace strumpack {
     }
   };
 
+  /**
+   * \class FrontScatterMap
+   * \brief The nonzeros of a sparse matrix which are assembled in a
+   * front, see CompressedSparseMatrix::front_scatter_map. For each
+   * of these, the index in the nonzero values, and the (column
+   * major) position in F11, F12 or F21. The first n11 entries are
+   * for F11, the next n12 for F12 and the rest for F21.
+   */
+  template<typename integer_t> struct FrontScatterMap {
+    std::vector<integer_t> nz;
+    std::vector<std::size_t> pos;
+    std::size_t n11 = 0, n12 = 0;
+    bool empty() const { return nz.empty(); }
+    void clear() { *this = FrontScatterMap<integer_t>(); }
+  };
+
   /**
    * \class CompressedSparseMatrix
    * \brief Abstract base class for compressed sparse matrix storage.
@@ -292,6 +309,16 @@ namespace strumpack {
      */
     void set_symm_sparse(bool symm_sparse=true) { symm_sparse_ = symm_sparse; }
 
+    /**
+     * Compute a 64 bit (FNV-1a like) hash of the sparsity pattern, ie, of
+     * the (local) ptr and ind arrays. This does not depend on the
+     * nonzero values. Two matrices with the same hash are very
+     * likely to have the same sparsity pattern, so this can be used
+     * to detect whether the results of the symbolic analysis can be
+     * reused.
+     */
+    std::uint64_t pattern_hash() const;
+
 
     /**
      * Sparse matrix times dense vector/matrix product
@@ -338,6 +365,15 @@ namespace strumpack {
 
     virtual Equil_t equilibration() const { return Equil_t(this->size()); }
 
+    /**
+     * Symmetric scaling, R = C = 1/sqrt(|a_ii|), as in LAPACK
+     * xPOEQU. This keeps a symmetric matrix symmetric, which is
+     * needed for conjugate gradient.
+     */
+    virtual Equil_t symmetric_equilibration() const {
+      return Equil_t(this->size());
+    }
+
     virtual void equilibrate(const Equil_t&) {}
 
     virtual Match_t matching(MatchingJob, bool apply=true);
@@ -385,6 +421,40 @@ namespace strumpack {
                   integer_t slo, integer_t shi,
                   const std::vector<integer_t>& upd,
                   int depth) const = 0;
+    /**
+     * Record where the nonzeros extracted by extract_front end up, so
+     * that matrices with the same sparsity pattern can be assembled
+     * with the extract_front overload which takes the map. The map
+     * is left empty if this is not supported.
+     */
+    virtual void
+    front_scatter_map(integer_t slo, integer_t shi,
+                      const std::vector<integer_t>& upd,
+                      FrontScatterMap<integer_t>& m) const {}
+    /**
+     * Same as extract_front, but using a map computed with
+     * front_scatter_map for a matrix with the same sparsity
+     * pattern. F11, F12 and F21 should have ld equal to the number
+     * of rows.
+     */
+    void extract_front(DenseM_t& F11, DenseM_t& F12, DenseM_t& F21,
+                       const FrontScatterMap<integer_t>& m) const {
+      const auto v = val();
+      const auto n = m.nz.size(), n112 = m.n11 + m.n12;
+      auto f11 = F11.data(), f12 = F12.data(), f21 = F21.data();
+      for (std::size_t k=0; k<m.n11; k++) f11[m.pos[k]] = v[m.nz[k]];
+      for (std::size_t k=m.n11; k<n112; k++) f12[m.pos[k]] = v[m.nz[k]];
+      for (std::size_t k=n112; k<n; k++) f21[m.pos[k]] = v[m.nz[k]];
+    }
+    /*
+     * Only the lower triangular part of F11 and F21 are set, used
+     * for symmetric fronts.
+     */
+    virtual void
+    extract_front_symmetric(DenseM_t& F11, DenseM_t& F21,
+                            integer_t slo, integer_t shi,
+                            const std::vector<integer_t>& upd,
+                            int depth) const { abort(); }
     virtual void
     push_front_elements(integer_t, integer_t, const std::vector<integer_t>&,
                         std::vector<Triplet<scalar_t>>&,
@@ -475,8 +545,46 @@ namespace strumpack {
                            const integer_t* col_ind,
                            const scalar_t* values, bool symm_sparsity);
 
-    std::vector<std::tuple<integer_t,integer_t,scalar_t>>
-    read_matrix_market_entries(const std::string& filename);
+    /**
+     * Read the entries of a matrix market file. The file is memory
+     * mapped, and the entries are split (at line ends) in parts
+     * blocks of bytes. Block part is split further in chunks which
+     * are parsed in parallel, each into a separate list of
+     * triplets. Symmetric entries are expanded. This sets n_ and
+     * symm_sparse_. The indices are returned as in the file, and
+     * should be in [0, n_]. In block part, zero_based is set when an
+     * index 0 was found, index_n when an index n_ was found, and
+     * entries is the number of entries. nnz is the number of entries
+     * from the header of the file. With a single part, these are
+     * checked with check_matrix_market_entries. Returns 0 on
+     * success.
+     */
+    int read_matrix_market_entries
+    (const std::string& filename,
+     std::vector<std::vector<Triplet<scalar_t,integer_t>>>& A,
+     bool& zero_based, bool& index_n, long long& entries, long long& nnz,
+     int part=0, int parts=1);
+
+    /**
+     * Check that the indices are all zero or all one based, and that
+     * the number of entries read matches the nnz from the header of
+     * the file, see read_matrix_market_entries. Returns 0 on
+     * success.
+     */
+    int check_matrix_market_entries
+    (const std::string& filename, bool zero_based, bool index_n,
+     long long entries, long long nnz) const;
+
+    /**
+     * Build ptr_, ind_ and val_ for rows [row0, row0+rows) from the
+     * triplets in A, with a parallel counting sort on the rows. All
+     * indices in A are shifted by -base, and the rows should be in
+     * the given range. The columns in each row are sorted. A is
+     * cleared. This sets nnz_ to the number of local nonzeros.
+     */
+    void triplets_to_csr
+    (std::vector<std::vector<Triplet<scalar_t,integer_t>>>& A,
+     integer_t row0, integer_t rows, integer_t base);
 
     virtual int strumpack_mc64(MatchingJob, Match_t&) { return 0; }
 
@@ -28,11 +28,14 @@
  */
 #include <iostream>
 #include <algorithm>
+#include <numeric>
 
 #include "EliminationTree.hpp"
 #include "fronts/FrontFactory.hpp"
 #include "fronts/Front.hpp"
+#include "fronts/FrontDense.hpp"
 #include "SeparatorTree.hpp"
+#include "misc/BinaryIO.hpp"
 
 namespace strumpack {
 
@@ -44,7 +47,34 @@ namespace strumpack {
 #pragma omp parallel default(shared)
 #pragma omp single
     symbolic_factorization(A, sep_tree, sep_tree.root(), upd);
-    root_ = setup_tree(opts, A, sep_tree, upd, sep_tree.root(), 0);
+    std::vector<bool> rfirst;
+    if (opts.peak_memory_child_order()) {
+      rfirst.resize(sep_tree.separators());
+      peak_memory_child_order(sep_tree, upd, sep_tree.root(), rfirst);
+    }
+    root_ = setup_tree(opts, A, sep_tree, upd, rfirst, sep_tree.root(), 0);
+  }
+
+  template<typename scalar_t,typename integer_t>
+  EliminationTree<scalar_t,integer_t>::EliminationTree
+  (const SPOptions<scalar_t>& opts, const SpMat_t& A,
+   SeparatorTree<integer_t>& sep_tree,
+   std::vector<std::vector<integer_t>>& upd) {
+    if (upd.empty()) {
+      upd.resize(sep_tree.separators());
+#pragma omp parallel default(shared)
+#pragma omp single
+      symbolic_factorization(A, sep_tree, sep_tree.root(), upd);
+    }
+    std::vector<bool> rfirst;
+    if (opts.peak_memory_child_order()) {
+      rfirst.resize(sep_tree.separators());
+      peak_memory_child_order(sep_tree, upd, sep_tree.root(), rfirst);
+    }
+    // the fronts take ownership of their update indices
+    auto fupd = upd;
+    root_ = setup_tree
+      (opts, A, sep_tree, fupd, rfirst, sep_tree.root(), 0);
   }
 
   template<typename scalar_t,typename integer_t>
@@ -84,7 +114,9 @@ namespace strumpack {
     }
     auto sep_begin = sep_tree.sizes[sep];
     auto sep_end = sep_tree.sizes[sep+1];
-    if (sep != sep_tree.root()) { // not necessary for the root
+    // not necessary for the root, unless variables were moved out
+    // of the root separator, see MatrixReordering::move_to_end
+    if (sep != sep_tree.root() || sep_end < A.size()) {
       for (integer_t c=sep_begin; c<sep_end; c++) {
         auto ice = A.ind()+A.ptr(c+1);
         auto icb = std::lower_bound
@@ -128,7 +160,7 @@ namespace strumpack {
   (const SPOptions<scalar_t>& opts, const SpMat_t& A,
    SeparatorTree<integer_t>& sep_tree,
    std::vector<std::vector<integer_t>>& upd,
-   integer_t sep, int level) {
+   const std::vector<bool>& rfirst, integer_t sep, int level) {
     auto sep_begin = sep_tree.sizes[sep];
     auto sep_end = sep_tree.sizes[sep+1];
     auto dim_sep = sep_end - sep_begin;
@@ -139,32 +171,196 @@ namespace strumpack {
       sep_begin = sep_end = sep_tree.sizes[sep_tree.rch[sep]+1];
     auto front = create_frontal_matrix<scalar_t,integer_t>
       (opts, sep, sep_begin, sep_end, upd[sep], level, nr_fronts_);
-    if (sep_tree.lch[sep] != -1)
+    // the lchild_ of the front is visited first
+    auto chl = sep_tree.lch[sep], chr = sep_tree.rch[sep];
+    if (!rfirst.empty() && rfirst[sep]) std::swap(chl, chr);
+    if (chl != -1)
       front->set_lchild
-        (setup_tree(opts, A, sep_tree, upd, sep_tree.lch[sep], level+1));
-    if (sep_tree.rch[sep] != -1)
+        (setup_tree(opts, A, sep_tree, upd, rfirst, chl, level+1));
+    if (chr != -1)
       front->set_rchild
-        (setup_tree(opts, A, sep_tree, upd, sep_tree.rch[sep], level+1));
+        (setup_tree(opts, A, sep_tree, upd, rfirst, chr, level+1));
     return front;
   }
 
+  template<typename scalar_t,typename integer_t> std::size_t
+  EliminationTree<scalar_t,integer_t>::peak_memory_child_order
+  (const SeparatorTree<integer_t>& sep_tree,
+   const std::vector<std::vector<integer_t>>& upd,
+   integer_t sep, std::vector<bool>& rfirst) const {
+    auto cb_size = [&](integer_t s) -> std::size_t {
+      if (s == -1) return 0;
+      std::size_t d = upd[s].size();
+      return d * d;
+    };
+    auto chl = sep_tree.lch[sep], chr = sep_tree.rch[sep];
+    std::size_t pl = 0, pr = 0, cl = cb_size(chl), cr = cb_size(chr);
+    if (chl != -1) pl = peak_memory_child_order(sep_tree, upd, chl, rfirst);
+    if (chr != -1) pr = peak_memory_child_order(sep_tree, upd, chr, rfirst);
+    // the CB of the child visited first stays on the stack while the
+    // other child is factored
+    rfirst[sep] = pr + cl > pl + cr;
+    auto peak = rfirst[sep] ? std::max(pr, cr + pl) : std::max(pl, cl + pr);
+    return std::max(peak, cl + cr + cb_size(sep));
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   EliminationTree<scalar_t,integer_t>::multifrontal_factorization
   (const SpMat_t& A, const SPOptions<scalar_t>& opts) {
-    return root_->multifrontal_factorization(A, opts);
+    if (ooc_) {
+      // the factors of the previous factorization are only on file,
+      // so all fronts need to be refactored
+      root_->set_out_of_core(nullptr);
+      root_->reset_changed();
+      ooc_.reset();
+    }
+    if (!opts.out_of_core_file().empty()) {
+      if (opts.incremental_refactorization() ||
+          !root_->out_of_core_supported())
+        std::cerr << "# WARNING: out-of-core factor storage is not "
+                  << "supported with these options, keeping the "
+                  << "factors in memory" << std::endl;
+      else {
+        ooc_.reset(new OutOfCoreStore(opts.out_of_core_file()));
+        if (!ooc_->good()) {
+          std::cerr << "# ERROR: could not open "
+                    << opts.out_of_core_file() << std::endl;
+          ooc_.reset();
+          return ReturnCode::IO_ERROR;
+        }
+        root_->set_out_of_core(ooc_.get());
+      }
+    }
+    // when the matrix is refactored with the same sparsity pattern,
+    // keep the maps to assemble the fronts for later refactorizations
+    auto h = A.pattern_hash();
+    root_->cache_assembly_maps(A, h == pattern_hash_);
+    pattern_hash_ = h;
+    auto e = root_->multifrontal_factorization(A, opts);
+    root_->reset_changed();
+    if (ooc_) {
+      if (!ooc_->finish_writing()) {
+        std::cerr << "# ERROR: writing the factors to "
+                  << opts.out_of_core_file() << " failed" << std::endl;
+        if (e == ReturnCode::SUCCESS) e = ReturnCode::IO_ERROR;
+      }
+    }
+    return e;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::mark_changed
+  (const std::vector<integer_t>& rows) {
+    root_->mark_changed(rows);
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::incremental_refactorization_supported()
+    const {
+    return root_->incremental_refactorization_supported();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::schur_complement
+  (const SpMat_t& A, DenseM_t& S) {
+    integer_t n = A.size(), s0 = root_->sep_end();
+    std::vector<integer_t> upd;
+    S = DenseM_t(n-s0, n-s0);
+    S.zero();
+    DenseM_t S12(n-s0, 0), S21(0, n-s0), S22;
+    A.extract_front(S, S12, S21, s0, n, upd, 0);
+    // the Schur variables act as the separator of a dense parent
+    FrontDense<scalar_t,integer_t> pa(-1, s0, n, upd);
+    root_->extend_add_to_dense(S, S12, S21, S22, &pa, 0);
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::selected_inversion
+  (const std::vector<integer_t>& rows, const std::vector<integer_t>& cols,
+   std::vector<scalar_t>& z) const {
+    // sort the entries by the front in which they are computed
+    std::size_t n = rows.size();
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](std::size_t a, std::size_t b) {
+                return std::min(rows[a], cols[a]) <
+                  std::min(rows[b], cols[b]); });
+    std::vector<integer_t> key(n), r(n), c(n);
+    for (std::size_t k=0; k<n; k++) {
+      r[k] = rows[order[k]];
+      c[k] = cols[order[k]];
+      key[k] = std::min(r[k], c[k]);
+    }
+    std::vector<scalar_t> zs(n);
+    bool found = true;
+    auto lock = solve_lock();
+#pragma omp parallel default(shared)
+#pragma omp single
+    found = root_->selected_inversion(DenseM_t(), key, r, c, zs);
+    z.resize(n);
+    for (std::size_t k=0; k<n; k++)
+      z[order[k]] = zs[k];
+    return found;
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::selected_inversion_supported() const {
+    return root_->selected_inversion_supported();
   }
 
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::delete_factors() {
     root_->delete_factors();
+    root_->reset_changed();
+    root_->set_out_of_core(nullptr);
+    ooc_.reset();
   }
 
   template<typename scalar_t,typename integer_t> void
   EliminationTree<scalar_t,integer_t>::multifrontal_solve
   (DenseM_t& x) const {
+    auto lock = solve_lock();
     root_->multifrontal_solve(x);
   }
 
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::multifrontal_solve
+  (Trans op, DenseM_t& x) const {
+    if (op == Trans::N) multifrontal_solve(x);
+    else {
+      auto lock = solve_lock();
+      root_->multifrontal_solve(op, x);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::multifrontal_solve_sparse
+  (DenseM_t& x, const std::vector<integer_t>& b_rows,
+   const std::vector<integer_t>& x_rows) const {
+    auto lock = solve_lock();
+    root_->multifrontal_solve_sparse(x, b_rows, x_rows);
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::out_of_core_good() const {
+    return !ooc_ || ooc_->good();
+  }
+
+  template<typename scalar_t,typename integer_t> std::unique_lock<std::mutex>
+  EliminationTree<scalar_t,integer_t>::solve_lock() const {
+    // the work memory of the solve is allocated per call, so the
+    // solve only needs to be serialized if the fronts are modified
+    std::unique_lock<std::mutex> lock(solve_mutex_, std::defer_lock);
+    if (!root_->concurrent_solve_supported()) lock.lock();
+    return lock;
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  EliminationTree<scalar_t,integer_t>::transpose_solve_supported() const {
+    return root_->transpose_solve_supported();
+  }
+
   template<typename scalar_t,typename integer_t> integer_t
   EliminationTree<scalar_t,integer_t>::maximum_rank() const {
     integer_t max_rank;
@@ -192,21 +388,32 @@ namespace strumpack {
     return nonzeros;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  EliminationTree<scalar_t,integer_t>::factorization_estimate
+  (const SPOptions<scalar_t>& opts, long long& fnnz, long long& cnnz,
+   long long& peak, long long& flops) const {
+    fnnz = cnnz = peak = flops = 0;
+    if (root_) root_->factorization_estimate(opts, fnnz, cnnz, peak, flops);
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   EliminationTree<scalar_t,integer_t>::inertia
   (integer_t& neg, integer_t& zero, integer_t& pos) const {
+    auto lock = solve_lock();
     return root_->inertia(neg, zero, pos);
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
   EliminationTree<scalar_t,integer_t>::subnormals
   (std::size_t& ns, std::size_t& nz) const {
+    auto lock = solve_lock();
     return root_->subnormals(ns, nz);
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
   EliminationTree<scalar_t,integer_t>::pivot_growth
   (scalar_t& pgL, scalar_t& pgU) const {
+    auto lock = solve_lock();
     return root_->pivot_growth(pgL, pgU);
   }
 
@@ -224,6 +431,20 @@ namespace strumpack {
     of.close();
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  EliminationTree<scalar_t,integer_t>::write(BinaryWriter& w) const {
+    if (!root_) return ReturnCode::IO_ERROR;
+    auto lock = solve_lock();
+    return root_->write(w);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  EliminationTree<scalar_t,integer_t>::read(BinaryReader& r) {
+    nr_fronts_ = FrontCounter();
+    root_ = F_t::read(r, nr_fronts_);
+    return root_ ? ReturnCode::SUCCESS : ReturnCode::IO_ERROR;
+  }
+
   // explicit template specializations
   template class EliminationTree<float,int>;
   template class EliminationTree<double,int>;
@@ -31,6 +31,7 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
 
 #include "dense/DenseMatrix.hpp"
 #include "CompressedSparseMatrix.hpp"
@@ -41,6 +42,9 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> class Front;
   template<typename integer_t> class SeparatorTree;
+  class BinaryWriter;
+  class BinaryReader;
+  class OutOfCoreStore;
 
   // TODO rename this to SuperNodalTree?
   template<typename scalar_t,typename integer_t>
@@ -55,16 +59,92 @@ namespace strumpack {
     EliminationTree(const SPOptions<scalar_t>& opts,
                     const SpMat_t& A,
                     SeparatorTree<integer_t>& sep_tree);
+
+    /**
+     * Construct the tree using the update index lists (one per
+     * separator) from an earlier symbolic factorization, which is
+     * then skipped. If upd is empty, the symbolic factorization is
+     * performed, and its result is returned in upd.
+     */
+    EliminationTree(const SPOptions<scalar_t>& opts,
+                    const SpMat_t& A,
+                    SeparatorTree<integer_t>& sep_tree,
+                    std::vector<std::vector<integer_t>>& upd);
     virtual ~EliminationTree();
 
     virtual ReturnCode
     multifrontal_factorization(const SpMat_t& A,
                                const SPOptions<scalar_t>& opts);
 
+    /**
+     * Mark the fronts which need to be refactored when the matrix
+     * entries (i,j) with min(i,j) in the sorted vector rows (in the
+     * permuted ordering) changed. The next multifrontal_factorization
+     * only refactors those fronts and their ancestors, see
+     * incremental_refactorization_supported.
+     */
+    void mark_changed(const std::vector<integer_t>& rows);
+    bool incremental_refactorization_supported() const;
+
+    /**
+     * After multifrontal_factorization, for a tree where the last
+     * variables were moved out of the root separator (see
+     * MatrixReordering::move_to_end), assemble the Schur complement
+     * on those variables from the contribution block of the root
+     * front and the corresponding block of A. The Schur complement
+     * is in the permuted ordering.
+     */
+    void schur_complement(const SpMat_t& A, DenseM_t& S);
+
+    /**
+     * Compute the entries (rows[k], cols[k]) of the inverse of the
+     * factored matrix, with the Takahashi recurrences, in the
+     * permuted ordering. This requires dense fronts, see
+     * selected_inversion_supported. Returns false if an entry is not
+     * in the sparsity pattern of the factors.
+     */
+    bool selected_inversion(const std::vector<integer_t>& rows,
+                            const std::vector<integer_t>& cols,
+                            std::vector<scalar_t>& z) const;
+    bool selected_inversion_supported() const;
+
     virtual void delete_factors();
 
+    /**
+     * Solve with the factors. This can be called concurrently from
+     * different threads, each with its own x. If the fronts do not
+     * support this, see Front::concurrent_solve_supported, for
+     * instance with out-of-core factors, the solves are serialized.
+     */
     virtual void multifrontal_solve(DenseM_t& x) const;
 
+    /**
+     * Solve with op(A), where op is Trans::N, Trans::T or Trans::C,
+     * using the same factors. Check transpose_solve_supported()
+     * first for op != Trans::N.
+     */
+    void multifrontal_solve(Trans op, DenseM_t& x) const;
+    bool transpose_solve_supported() const;
+
+    /**
+     * False if the factors could not be written to, or read back
+     * from, the out-of-core file, see
+     * SPOptions::set_out_of_core_file. Once false, the solves give
+     * wrong results until the matrix is factored again.
+     */
+    bool out_of_core_good() const;
+
+    /**
+     * Solve with a right-hand side which is only nonzero in rows
+     * b_rows, computing only the rows x_rows of the solution. Row
+     * indices are sorted and in the ordering of the fronts. See
+     * Front::multifrontal_solve_sparse.
+     */
+    void multifrontal_solve_sparse(DenseM_t& x,
+                                   const std::vector<integer_t>& b_rows,
+                                   const std::vector<integer_t>& x_rows)
+      const;
+
     virtual void
     multifrontal_solve_dist(DenseM_t& x,
                             const std::vector<integer_t>& dist) {} // TODO const
@@ -73,6 +153,16 @@ namespace strumpack {
     virtual long long factor_nonzeros() const;
     virtual long long dense_factor_nonzeros() const;
 
+    /**
+     * Predict the memory and flops of the numerical factorization
+     * from the front dimensions, see Front::factorization_estimate.
+     * For the distributed trees, this only counts the part of the
+     * fronts on this process.
+     */
+    void factorization_estimate(const SPOptions<scalar_t>& opts,
+                                long long& fnnz, long long& cnnz,
+                                long long& peak, long long& flops) const;
+
     virtual ReturnCode inertia(integer_t& neg,
                                integer_t& zero,
                                integer_t& pos) const;
@@ -87,19 +177,54 @@ namespace strumpack {
 
     void draw(const SpMat_t& A, const std::string& name) const;
 
+    /**
+     * Write the frontal tree, with all the factors, in binary
+     * format.
+     */
+    virtual ReturnCode write(BinaryWriter& w) const;
+
+    /**
+     * Recreate the frontal tree, with all the factors, from a binary
+     * file written with write.
+     */
+    virtual ReturnCode read(BinaryReader& r);
+
     F_t* root() const;
 
   protected:
     FrontCounter nr_fronts_;
     std::unique_ptr<F_t> root_;
+    std::unique_ptr<OutOfCoreStore> ooc_;
+    /** sparsity pattern of the last factored matrix */
+    std::uint64_t pattern_hash_ = 0;
+    /**
+     * serializes the solves which cannot run concurrently, and the
+     * other calls which load out-of-core factors
+     */
+    mutable std::mutex solve_mutex_;
+    std::unique_lock<std::mutex> solve_lock() const;
 
   private:
     std::unique_ptr<F_t>
     setup_tree(const SPOptions<scalar_t>& opts, const SpMat_t& A,
                SeparatorTree<integer_t>& sep_tree,
                std::vector<std::vector<integer_t>>& upd,
+               const std::vector<bool>& rfirst,
                integer_t sep, int level);
 
+    /**
+     * Peak size of the stack of contribution blocks when the subtree
+     * rooted at sep is factored in postorder, when for each node the
+     * child with the largest difference between its peak and its own
+     * contribution block is visited first (Liu's algorithm, for a
+     * binary tree). rfirst[s] is set if the right child of s is to be
+     * visited first.
+     */
+    std::size_t
+    peak_memory_child_order(const SeparatorTree<integer_t>& sep_tree,
+                            const std::vector<std::vector<integer_t>>& upd,
+                            integer_t sep, std::vector<bool>& rfirst) const;
+
     void
     symbolic_factorization(const SpMat_t& A,
                            const SeparatorTree<integer_t>& sep_tree,
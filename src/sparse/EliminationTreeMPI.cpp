@@ -36,6 +36,7 @@
 #include "dense/DistributedMatrix.hpp"
 #include "fronts/FrontFactory.hpp"
 #include "fronts/FrontMPI.hpp"
+#include "misc/BinaryIO.hpp"
 
 namespace strumpack {
 
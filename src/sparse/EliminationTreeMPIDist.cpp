@@ -36,6 +36,7 @@
 #include "fronts/FrontFactory.hpp"
 #include "fronts/Front.hpp"
 #include "fronts/FrontMPI.hpp"
+#include "misc/BinaryIO.hpp"
 
 namespace strumpack {
 
@@ -434,6 +434,34 @@ namespace strumpack {
     }
   }
 
+  template<typename scalar_t,typename integer_t> void
+  PropMapSparseMatrix<scalar_t,integer_t>::extract_front_symmetric
+  (DenseM_t& F11, DenseM_t& F21, integer_t slo, integer_t shi,
+   const std::vector<integer_t>& upd, int depth) const {
+    integer_t dim_upd = upd.size();
+    auto c = find_global(slo);
+    auto chi = find_global(shi, c);
+    for (; c<chi; c++) {
+      auto col = global_col_[c];
+      integer_t row_ptr = 0;
+      auto hij = ptr_[c+1];
+      for (integer_t j=ptr_[c]; j<hij; j++) {
+        auto row = ind_[j];
+        if (row >= col) {
+          if (row < shi)
+            F11(row-slo, col-slo) = val_[j];
+          else {
+            while (row_ptr<dim_upd && upd[row_ptr]<row)
+              row_ptr++;
+            if (row_ptr == dim_upd) break;
+            if (upd[row_ptr] == row)
+              F21(row_ptr, col-slo) = val_[j];
+          }
+        }
+      }
+    }
+  }
+
   template<typename scalar_t,typename integer_t> void
   PropMapSparseMatrix<scalar_t,integer_t>::push_front_elements
   (integer_t slo, integer_t shi, const std::vector<integer_t>& upd,
@@ -84,6 +84,10 @@ namespace strumpack {
                        integer_t slo, integer_t shi,
                        const std::vector<integer_t>& upd,
                        int depth) const override;
+    void extract_front_symmetric(DenseM_t& F11, DenseM_t& F21,
+                                 integer_t slo, integer_t shi,
+                                 const std::vector<integer_t>& upd,
+                                 int depth) const override;
 
     void push_front_elements(integer_t, integer_t,
                              const std::vector<integer_t>&,
@@ -0,0 +1,138 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+#include <numeric>
+#include <complex>
+
+#include "SELLMatrix.hpp"
+#include "misc/Tools.hpp"
+
+namespace strumpack {
+
+  template<typename scalar_t,typename integer_t>
+  SELLMatrix<scalar_t,integer_t>::SELLMatrix
+  (integer_t n, const integer_t* ptr, const integer_t* ind,
+   const scalar_t* val, integer_t sigma) : n_(n) {
+    sigma = std::max(integer_t(C), (sigma + C - 1) / C * C);
+    slices_ = (n_ + C - 1) / C;
+    rows_.resize(slices_ * C);
+    // sort the rows on decreasing length, in windows of sigma rows
+    integer_t windows = (n_ + sigma - 1) / sigma;
+#pragma omp parallel for
+    for (integer_t w=0; w<windows; w++) {
+      auto b = rows_.begin() + w*sigma,
+        e = rows_.begin() + std::min(n_, (w+1)*sigma);
+      std::iota(b, e, w*sigma);
+      std::stable_sort
+        (b, e, [ptr](integer_t i, integer_t j) {
+          return ptr[i+1] - ptr[i] > ptr[j+1] - ptr[j]; });
+    }
+    std::fill(rows_.begin()+n_, rows_.end(), integer_t(-1));
+    // sigma is a multiple of C, so the first row of a slice is the
+    // longest
+    sptr_.resize(slices_+1);
+    sptr_[0] = 0;
+    for (integer_t s=0; s<slices_; s++) {
+      auto r = rows_[s*C];
+      sptr_[s+1] = sptr_[s] + (ptr[r+1] - ptr[r]) * C;
+    }
+    ind_.resize(sptr_[slices_]);
+    val_.resize(sptr_[slices_]);
+#pragma omp parallel for
+    for (integer_t s=0; s<slices_; s++) {
+      const auto len = (sptr_[s+1] - sptr_[s]) / C;
+      auto pi = ind_.data() + sptr_[s];
+      auto pv = val_.data() + sptr_[s];
+      for (int l=0; l<C; l++) {
+        auto r = rows_[s*C+l];
+        integer_t k = 0, pad = 0;
+        if (r >= 0) {
+          for (integer_t j=ptr[r]; j<ptr[r+1]; j++, k++) {
+            pi[k*C+l] = ind[j];
+            pv[k*C+l] = val[j];
+          }
+          // the padding uses a column from the same row, already in
+          // cache
+          if (k) pad = ind[ptr[r+1]-1];
+        }
+        for (; k<len; k++) {
+          pi[k*C+l] = pad;
+          pv[k*C+l] = scalar_t(0.);
+        }
+      }
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  SELLMatrix<scalar_t,integer_t>::spmv
+  (const scalar_t* x, scalar_t* y) const {
+#pragma omp parallel
+    {
+      integer_t s0 = 0, s1 = slices_;
+#if defined(_OPENMP)
+      int t = omp_get_thread_num(), T = omp_get_num_threads();
+      s0 = nnz_balanced_row(sptr_.data(), slices_, t, T);
+      s1 = nnz_balanced_row(sptr_.data(), slices_, t+1, T);
+#endif
+      for (integer_t s=s0; s<s1; s++) {
+        scalar_t ys[C];
+        for (int l=0; l<C; l++) ys[l] = scalar_t(0.);
+        const auto len = (sptr_[s+1] - sptr_[s]) / C;
+        auto pi = ind_.data() + sptr_[s];
+        auto pv = val_.data() + sptr_[s];
+        for (integer_t k=0; k<len; k++, pi+=C, pv+=C) {
+#pragma omp simd
+          for (int l=0; l<C; l++)
+            ys[l] += pv[l] * x[pi[l]];
+        }
+        for (int l=0; l<C; l++) {
+          auto r = rows_[s*C+l];
+          if (r >= 0) y[r] = ys[l];
+        }
+      }
+    }
+  }
+
+  // explicit template instantiations
+  template class SELLMatrix<float,int>;
+  template class SELLMatrix<double,int>;
+  template class SELLMatrix<std::complex<float>,int>;
+  template class SELLMatrix<std::complex<double>,int>;
+
+  template class SELLMatrix<float,long int>;
+  template class SELLMatrix<double,long int>;
+  template class SELLMatrix<std::complex<float>,long int>;
+  template class SELLMatrix<std::complex<double>,long int>;
+
+  template class SELLMatrix<float,long long int>;
+  template class SELLMatrix<double,long long int>;
+  template class SELLMatrix<std::complex<float>,long long int>;
+  template class SELLMatrix<std::complex<double>,long long int>;
+
+} // end namespace strumpack
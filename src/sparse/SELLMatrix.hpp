@@ -0,0 +1,98 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+/*!
+ * \file SELLMatrix.hpp
+ * \brief Contains a sliced ELLPACK (SELL-C-sigma) copy of a CSR
+ * matrix, used for a vectorized sparse matrix-vector product.
+ */
+#ifndef STRUMPACK_SELL_MATRIX_HPP
+#define STRUMPACK_SELL_MATRIX_HPP
+
+#include <vector>
+#include <cstddef>
+
+namespace strumpack {
+
+  /**
+   * \class SELLMatrix
+   * \brief Sliced ELLPACK storage, see Kreutzer et al., "A unified
+   * sparse matrix data format for efficient general sparse
+   * matrix-vector multiplication on modern processors with wide SIMD
+   * units", SIAM J. Sci. Comput., 2014.
+   *
+   * The rows are sorted by decreasing number of nonzeros within
+   * windows of sigma rows, and then grouped in slices of C
+   * consecutive rows. Each slice is padded to its longest row, and
+   * stored column by column, so that the inner loop of the product
+   * handles C rows at once with unit stride. The sorting keeps the
+   * padding small, while the windows keep most of the locality in x
+   * and y.
+   *
+   * \tparam scalar_t
+   * \tparam integer_t
+   */
+  template<typename scalar_t,typename integer_t> class SELLMatrix {
+  public:
+    /** number of rows in a slice */
+    static const int C = 8;
+
+    /**
+     * Build from a CSR matrix with n rows.
+     *
+     * \param sigma sorting window, in rows, rounded up to a multiple
+     * of C
+     */
+    SELLMatrix(integer_t n, const integer_t* ptr, const integer_t* ind,
+               const scalar_t* val, integer_t sigma=32*C);
+
+    /** y = A*x */
+    void spmv(const scalar_t* x, scalar_t* y) const;
+
+    /** number of stored entries, including the padding */
+    std::size_t stored() const { return ind_.size(); }
+
+    /** memory used, in bytes */
+    std::size_t memory() const {
+      return ind_.size() * (sizeof(integer_t) + sizeof(scalar_t)) +
+        (sptr_.size() + rows_.size()) * sizeof(integer_t);
+    }
+
+  private:
+    integer_t n_ = 0, slices_ = 0;
+    // start of slice s in ind_/val_
+    std::vector<integer_t> sptr_;
+    // original row of row l of slice s, -1 for padding rows
+    std::vector<integer_t> rows_;
+    std::vector<integer_t> ind_;
+    std::vector<scalar_t> val_;
+  };
+
+} // end namespace strumpack
+
+#endif // STRUMPACK_SELL_MATRIX_HPP
@@ -59,6 +59,13 @@ namespace strumpack {
     check();
   }
 
+  template<typename integer_t> SeparatorTree<integer_t>
+  SeparatorTree<integer_t>::deserialize(const std::vector<integer_t>& buf) {
+    SeparatorTree<integer_t> t((buf.size() - 1) / 4);
+    std::copy(buf.begin(), buf.end(), t.iwork_.begin());
+    return t;
+  }
+
 #if defined(STRUMPACK_USE_MPI)
   template<typename integer_t> void
   SeparatorTree<integer_t>::broadcast(const MPIComm& c) {
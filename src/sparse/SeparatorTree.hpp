@@ -80,6 +80,14 @@ namespace strumpack {
     void broadcast(const MPIComm& c);
 #endif
 
+    /**
+     * Return the sizes, parent, lch and rch arrays, as a single
+     * vector, see deserialize.
+     */
+    std::vector<integer_t> serialize() const { return iwork_; }
+    static SeparatorTree<integer_t>
+    deserialize(const std::vector<integer_t>& buf);
+
     integer_t *sizes = nullptr,
       *parent = nullptr,
       *lch = nullptr,
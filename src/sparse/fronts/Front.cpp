@@ -33,6 +33,8 @@
 #include <cmath>
 
 #include "Front.hpp"
+#include "FrontFactory.hpp"
+#include "misc/BinaryIO.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #include "FrontMPI.hpp"
@@ -151,11 +153,44 @@ namespace strumpack {
     return I;
   }
 
+  template<typename scalar_t,typename integer_t>
+  const std::vector<std::size_t>&
+  Front<scalar_t,integer_t>::upd_to_parent
+  (const F_t* pa, std::size_t& upd2sep,
+   std::vector<std::size_t>& tmp) const {
+    if (pa == pmap_pa_) {
+      upd2sep = pmap_upd2sep_;
+      return pmap_;
+    }
+    tmp = upd_to_parent(pa, upd2sep);
+    return tmp;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::cache_assembly_maps
+  (const SpMat_t& A, bool enable, const F_t* pa) {
+    if (lchild_) lchild_->cache_assembly_maps(A, enable, this);
+    if (rchild_) rchild_->cache_assembly_maps(A, enable, this);
+    if (!enable) {
+      amap_.clear();
+      pmap_ = std::vector<std::size_t>();
+      pmap_pa_ = nullptr;
+      return;
+    }
+    if (pa && pmap_pa_ != pa) {
+      pmap_ = upd_to_parent(pa, pmap_upd2sep_);
+      pmap_pa_ = pa;
+    }
+    if (amap_.empty() && node_assembly_map_supported())
+      A.front_scatter_map(sep_begin_, sep_end_, upd_, amap_);
+  }
+
   template<typename scalar_t,typename integer_t> inline void
   Front<scalar_t,integer_t>::extend_add_b
   (DenseM_t& b, DenseM_t& bupd, const DenseM_t& CB, const F_t* pa) const {
     std::size_t upd2sep;
-    auto I = upd_to_parent(pa, upd2sep);
+    std::vector<std::size_t> tmp;
+    const auto& I = upd_to_parent(pa, upd2sep, tmp);
     for (std::size_t c=0; c<b.cols(); c++) {
       for (std::size_t r=0; r<upd2sep; r++)
         b(I[r]+pa->sep_begin_, c) += CB(r, c);
@@ -179,7 +214,8 @@ namespace strumpack {
   Front<scalar_t,integer_t>::extract_b
   (const DenseM_t& y, const DenseM_t& yupd, DenseM_t& CB, const F_t* pa) const {
     std::size_t upd2sep;
-    auto I = upd_to_parent(pa, upd2sep);
+    std::vector<std::size_t> tmp;
+    const auto& I = upd_to_parent(pa, upd2sep, tmp);
     for (std::size_t c=0; c<y.cols(); c++) {
       for (std::size_t r=0; r<upd2sep; r++)
         CB(r,c) = y(I[r]+pa->sep_begin_, c);
@@ -227,6 +263,339 @@ namespace strumpack {
     TIMER_STOP(t_bwd);
   }
 
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::multifrontal_solve
+  (Trans op, DenseM_t& b) const {
+    if (op == Trans::N) {
+      multifrontal_solve(b);
+      return;
+    }
+    assert(transpose_solve_supported());
+    auto max_dupd = max_dim_upd();
+    std::vector<DenseM_t> CB(levels());
+    for (std::size_t i=0; i<CB.size(); i++)
+      CB[i] = DenseM_t(max_dupd, b.cols());
+    TIMER_TIME(TaskType::FORWARD_SOLVE, 0, t_fwd);
+    forward_multifrontal_solve(op, b, CB.data(), 0, 0);
+    TIMER_STOP(t_fwd);
+    TIMER_TIME(TaskType::BACKWARD_SOLVE, 0, t_bwd);
+    backward_multifrontal_solve(op, b, CB.data(), 0, 0);
+    TIMER_STOP(t_bwd);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::multifrontal_solve_sparse
+  (DenseM_t& b, const std::vector<integer_t>& b_rows,
+   const std::vector<integer_t>& x_rows) const {
+    assert(std::is_sorted(b_rows.begin(), b_rows.end()));
+    assert(std::is_sorted(x_rows.begin(), x_rows.end()));
+    if (!pruned_solve_supported()) {
+      // HSS/HODLR fronts keep state between forward and backward
+      // solve, so they need the full traversal
+      multifrontal_solve(b);
+      return;
+    }
+    auto max_dupd = max_dim_upd();
+    std::vector<DenseM_t> CB(levels());
+    for (std::size_t i=0; i<CB.size(); i++)
+      CB[i] = DenseM_t(max_dupd, b.cols());
+    TIMER_TIME(TaskType::FORWARD_SOLVE, 0, t_fwd);
+    if (!b_rows.empty())
+      forward_multifrontal_solve_sparse(b, CB.data(), 0, b_rows, 0);
+    TIMER_STOP(t_fwd);
+    TIMER_TIME(TaskType::BACKWARD_SOLVE, 0, t_bwd);
+    if (!x_rows.empty())
+      backward_multifrontal_solve_sparse(b, CB.data(), 0, x_rows, 0);
+    TIMER_STOP(t_bwd);
+  }
+
+  /** does the sorted vector rows contain an element in [lo,hi) */
+  template<typename integer_t> bool
+  has_rows(const std::vector<integer_t>& rows, integer_t lo, integer_t hi) {
+    auto r = std::lower_bound(rows.begin(), rows.end(), lo);
+    return r != rows.end() && *r < hi;
+  }
+
+  template<typename scalar_t,typename integer_t> integer_t
+  Front<scalar_t,integer_t>::child_begin
+  (const F_t* ch, integer_t lo) const {
+    // subtrees are numbered before their root, and the subtrees of
+    // the two children after each other
+    if (!ch) return lo;
+    auto sib = (ch == lchild_.get()) ? rchild_.get() : lchild_.get();
+    return (sib && sib->sep_end_ < ch->sep_end_) ? sib->sep_end_ : lo;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::forward_multifrontal_solve_sparse
+  (DenseM_t& b, DenseM_t* work, integer_t lo,
+   const std::vector<integer_t>& rows, int etree_level) const {
+    DenseMW_t bupd(dim_upd(), b.cols(), work[0], 0, 0);
+    bupd.zero();
+    auto lo_l = child_begin(lchild_.get(), lo),
+      lo_r = child_begin(rchild_.get(), lo);
+    if (lchild_ && has_rows(rows, lo_l, lchild_->sep_end_)) {
+      lchild_->forward_multifrontal_solve_sparse
+        (b, work+1, lo_l, rows, etree_level+1);
+      DenseMW_t CBch(lchild_->dim_upd(), b.cols(), work[1], 0, 0);
+      lchild_->extend_add_b(b, bupd, CBch, this);
+    }
+    if (rchild_ && has_rows(rows, lo_r, rchild_->sep_end_)) {
+      rchild_->forward_multifrontal_solve_sparse
+        (b, work+1, lo_r, rows, etree_level+1);
+      DenseMW_t CBch(rchild_->dim_upd(), b.cols(), work[1], 0, 0);
+      rchild_->extend_add_b(b, bupd, CBch, this);
+    }
+    if (load_factors())
+      fwd_solve_phase2
+        (b, bupd, etree_level, params::task_recursion_cutoff_level);
+    unload_factors();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::backward_multifrontal_solve_sparse
+  (DenseM_t& y, DenseM_t* work, integer_t lo,
+   const std::vector<integer_t>& rows, int etree_level) const {
+    DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
+    if (load_factors(false))
+      bwd_solve_phase1
+        (y, yupd, etree_level, params::task_recursion_cutoff_level);
+    unload_factors();
+    auto lo_l = child_begin(lchild_.get(), lo),
+      lo_r = child_begin(rchild_.get(), lo);
+    if (lchild_ && has_rows(rows, lo_l, lchild_->sep_end_)) {
+      DenseMW_t CB(lchild_->dim_upd(), y.cols(), work[1], 0, 0);
+      lchild_->extract_b(y, yupd, CB, this);
+      lchild_->backward_multifrontal_solve_sparse
+        (y, work+1, lo_l, rows, etree_level+1);
+    }
+    if (rchild_ && has_rows(rows, lo_r, rchild_->sep_end_)) {
+      DenseMW_t CB(rchild_->dim_upd(), y.cols(), work[1], 0, 0);
+      rchild_->extract_b(y, yupd, CB, this);
+      rchild_->backward_multifrontal_solve_sparse
+        (y, work+1, lo_r, rows, etree_level+1);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::selected_inversion
+  (const DenseM_t& Zuu, const std::vector<integer_t>& key,
+   const std::vector<integer_t>& rows, const std::vector<integer_t>& cols,
+   std::vector<scalar_t>& z, int task_depth) const {
+    DenseM_t Z;
+    if (!load_factors(false)) return false;
+    selected_inversion_node(Zuu, Z, task_depth);
+    unload_factors();
+    // position of index i in [sep, upd], or -1
+    auto local = [&](integer_t i) -> integer_t {
+      if (i >= sep_begin_ && i < sep_end_) return i - sep_begin_;
+      auto u = std::lower_bound(upd_.begin(), upd_.end(), i);
+      if (u != upd_.end() && *u == i)
+        return dim_sep() + (u - upd_.begin());
+      return -1;
+    };
+    // requested entries with the smallest index in this separator
+    bool found = true;
+    auto kb = std::lower_bound(key.begin(), key.end(), sep_begin_);
+    auto ke = std::lower_bound(kb, key.end(), sep_end_);
+    for (auto k=kb-key.begin(); k<ke-key.begin(); k++) {
+      auto i = local(rows[k]), j = local(cols[k]);
+      if (i == -1 || j == -1) found = false;
+      else z[k] = Z(i, j);
+    }
+    DenseM_t Zl, Zr;
+    if (lchild_) {
+      auto I = lchild_->upd_to_parent(this);
+      Zl = Z.extract(I, I);
+    }
+    if (rchild_) {
+      auto I = rchild_->upd_to_parent(this);
+      Zr = Z.extract(I, I);
+    }
+    Z.clear();
+    bool fl = true, fr = true;
+    if (task_depth < params::task_recursion_cutoff_level) {
+      if (lchild_)
+#pragma omp task default(shared)                                        \
+  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
+        fl = lchild_->selected_inversion
+          (Zl, key, rows, cols, z, task_depth+1);
+      if (rchild_)
+#pragma omp task default(shared)                                        \
+  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
+        fr = rchild_->selected_inversion
+          (Zr, key, rows, cols, z, task_depth+1);
+#pragma omp taskwait
+    } else {
+      if (lchild_)
+        fl = lchild_->selected_inversion(Zl, key, rows, cols, z, task_depth);
+      if (rchild_)
+        fr = rchild_->selected_inversion(Zr, key, rows, cols, z, task_depth);
+    }
+    return found && fl && fr;
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::mark_changed
+  (const std::vector<integer_t>& rows, integer_t lo) {
+    bool cl = lchild_ &&
+      lchild_->mark_changed(rows, child_begin(lchild_.get(), lo));
+    bool cr = rchild_ &&
+      rchild_->mark_changed(rows, child_begin(rchild_.get(), lo));
+    changed_ = cl || cr || has_rows(rows, sep_begin_, sep_end_);
+    return changed_;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::reset_changed() {
+    changed_ = true;
+    if (lchild_) lchild_->reset_changed();
+    if (rchild_) rchild_->reset_changed();
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::incremental_refactorization_supported() const {
+    return node_incremental_refactorization_supported() &&
+      (!lchild_ || lchild_->incremental_refactorization_supported()) &&
+      (!rchild_ || rchild_->incremental_refactorization_supported());
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::selected_inversion_supported() const {
+    return node_selected_inversion_supported() &&
+      (!lchild_ || lchild_->selected_inversion_supported()) &&
+      (!rchild_ || rchild_->selected_inversion_supported());
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::pruned_solve_supported() const {
+    return node_pruned_solve_supported() &&
+      (!lchild_ || lchild_->pruned_solve_supported()) &&
+      (!rchild_ || rchild_->pruned_solve_supported());
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::concurrent_solve_supported() const {
+    return !ooc_ && node_concurrent_solve_supported() &&
+      (!lchild_ || lchild_->concurrent_solve_supported()) &&
+      (!rchild_ || rchild_->concurrent_solve_supported());
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::transpose_solve_supported() const {
+    if (!node_transpose_solve_supported()) return false;
+    if (lchild_ && !lchild_->transpose_solve_supported()) return false;
+    return !rchild_ || rchild_->transpose_solve_supported();
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  Front<scalar_t,integer_t>::write(BinaryWriter& w) const {
+    w.write(type());
+    w.write(sep_);
+    w.write(sep_begin_);
+    w.write(sep_end_);
+    w.write_vector(upd_);
+    w.write(char(lchild_ != nullptr));
+    w.write(char(rchild_ != nullptr));
+    if (!load_factors()) return ReturnCode::IO_ERROR;
+    auto ierr = write_node(w);
+    unload_factors();
+    if (ierr != ReturnCode::SUCCESS) return ierr;
+    if (lchild_) {
+      ierr = lchild_->write(w);
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    if (rchild_) {
+      ierr = rchild_->write(w);
+      if (ierr != ReturnCode::SUCCESS) return ierr;
+    }
+    return w.good() ? ReturnCode::SUCCESS : ReturnCode::IO_ERROR;
+  }
+
+  template<typename scalar_t,typename integer_t>
+  std::unique_ptr<Front<scalar_t,integer_t>>
+  Front<scalar_t,integer_t>::read
+  (BinaryReader& r, FrontCounter& fc, int etree_level) {
+    std::string t;
+    integer_t sep = 0, sep_begin = 0, sep_end = 0;
+    std::vector<integer_t> upd;
+    r.read(t);
+    r.read(sep);
+    r.read(sep_begin);
+    r.read(sep_end);
+    r.read_vector(upd);
+    auto lch = r.read<char>();
+    auto rch = r.read<char>();
+    if (!r.good()) return nullptr;
+    auto F = create_frontal_matrix<scalar_t,integer_t>
+      (t, sep, sep_begin, sep_end, upd, fc);
+    if (!F) {
+      std::cerr << "ERROR: unknown front type " << t << std::endl;
+      return nullptr;
+    }
+    if (F->read_node(r, etree_level) != ReturnCode::SUCCESS || !r.good())
+      return nullptr;
+    if (lch) {
+      auto ch = read(r, fc, etree_level+1);
+      if (!ch) return nullptr;
+      F->set_lchild(std::move(ch));
+    }
+    if (rch) {
+      auto ch = read(r, fc, etree_level+1);
+      if (!ch) return nullptr;
+      F->set_rchild(std::move(ch));
+    }
+    return F;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::set_out_of_core(OutOfCoreStore* s) {
+    ooc_ = s;
+    if (lchild_) lchild_->set_out_of_core(s);
+    if (rchild_) rchild_->set_out_of_core(s);
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::out_of_core_supported() const {
+    return node_out_of_core_supported() &&
+      (!lchild_ || lchild_->out_of_core_supported()) &&
+      (!rchild_ || rchild_->out_of_core_supported());
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::store_factors() {
+    if (!ooc_) return;
+    ooc_nnz_ = node_factor_nonzeros();
+    ooc_id_ = ooc_->write([&](BinaryWriter& w) { write_node(w); });
+    release_factors();
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  Front<scalar_t,integer_t>::load_factors(bool forward) const {
+    if (!ooc_) return true;
+    // the factors in memory are only a copy of the store
+    auto self = const_cast<F_t*>(this);
+    if (!ooc_->read(ooc_id_, [&](BinaryReader& r) {
+          return self->read_node(r, 0) == ReturnCode::SUCCESS; })) {
+      self->release_factors();
+      return false;
+    }
+    // the fronts are stored in the order in which they were factored
+    if (forward) ooc_->prefetch(ooc_id_ + 1);
+    else {
+      if (lchild_) ooc_->prefetch(lchild_->ooc_id_);
+      if (rchild_) ooc_->prefetch(rchild_->ooc_id_);
+    }
+    return true;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::unload_factors() const {
+    if (!ooc_) return;
+    const_cast<F_t*>(this)->release_factors();
+    ooc_->evict(ooc_id_);
+  }
+
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::forward_multifrontal_solve
   (DenseM_t& b, DenseM_t* work, int etree_level, int task_depth) const {
@@ -238,23 +607,52 @@ namespace strumpack {
 #pragma omp single nowait
       this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth);
       // no tasking for the root node computations, use system blas threading!
-      fwd_solve_phase2(b, bupd, etree_level, params::task_recursion_cutoff_level);
+      if (load_factors())
+        fwd_solve_phase2
+          (b, bupd, etree_level, params::task_recursion_cutoff_level);
     } else {
       this->fwd_solve_phase1(b, bupd, work, etree_level, task_depth);
-      fwd_solve_phase2(b, bupd, etree_level, task_depth);
+      if (load_factors())
+        fwd_solve_phase2(b, bupd, etree_level, task_depth);
     }
+    unload_factors();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::forward_multifrontal_solve
+  (Trans op, DenseM_t& b, DenseM_t* work,
+   int etree_level, int task_depth) const {
+    if (op == Trans::N) {
+      forward_multifrontal_solve(b, work, etree_level, task_depth);
+      return;
+    }
+    DenseMW_t bupd(dim_upd(), b.cols(), work[0], 0, 0);
+    bupd.zero();
+    if (task_depth == 0) {
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+      fwd_solve_phase1(b, bupd, work, etree_level, task_depth, op);
+      if (load_factors())
+        fwd_solve_phase2
+          (op, b, bupd, etree_level, params::task_recursion_cutoff_level);
+    } else {
+      fwd_solve_phase1(b, bupd, work, etree_level, task_depth, op);
+      if (load_factors())
+        fwd_solve_phase2(op, b, bupd, etree_level, task_depth);
+    }
+    unload_factors();
   }
 
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::fwd_solve_phase1
   (DenseM_t& b, DenseM_t& bupd, DenseM_t* work,
-   int etree_level, int task_depth) const {
+   int etree_level, int task_depth, Trans op) const {
     if (task_depth < params::task_recursion_cutoff_level) {
       if (lchild_)
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
         lchild_->forward_multifrontal_solve
-          (b, work+1, etree_level+1, task_depth+1);
+          (op, b, work+1, etree_level+1, task_depth+1);
       if (rchild_)
 #pragma omp task untied default(shared)                                 \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
@@ -265,7 +663,7 @@ namespace strumpack {
           for (std::size_t i=0; i<work2.size(); i++)
             work2[i] = DenseM_t(rchild_->max_dim_upd(), b.cols());
           rchild_->forward_multifrontal_solve
-            (b, work2.data(), etree_level+1, task_depth+1);
+            (op, b, work2.data(), etree_level+1, task_depth+1);
           DenseMW_t CBch(rchild_->dim_upd(), b.cols(), work2[0], 0, 0);
           rchild_->extend_add_b(b, bupd, CBch, this);
         }
@@ -277,13 +675,13 @@ namespace strumpack {
     } else {
       if (lchild_) {
         lchild_->forward_multifrontal_solve
-          (b, work+1, etree_level+1, task_depth);
+          (op, b, work+1, etree_level+1, task_depth);
         DenseMW_t CBch(lchild_->dim_upd(), b.cols(), work[1], 0, 0);
         lchild_->extend_add_b(b, bupd, CBch, this);
       }
       if (rchild_) {
         rchild_->forward_multifrontal_solve
-          (b, work+1, etree_level+1, task_depth);
+          (op, b, work+1, etree_level+1, task_depth);
         DenseMW_t CBch(rchild_->dim_upd(), b.cols(), work[1], 0, 0);
         rchild_->extend_add_b(b, bupd, CBch, this);
       }
@@ -294,24 +692,53 @@ namespace strumpack {
   Front<scalar_t,integer_t>::backward_multifrontal_solve
   (DenseM_t& y, DenseM_t* work, int etree_level, int task_depth) const {
     DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
+    bool loaded = load_factors(false);
     if (task_depth == 0) {
       // no tasking in blas routines, use system threaded blas instead
-      bwd_solve_phase1
-        (y, yupd, etree_level, params::task_recursion_cutoff_level);
+      if (loaded)
+        bwd_solve_phase1
+          (y, yupd, etree_level, params::task_recursion_cutoff_level);
+      unload_factors();
 #pragma omp parallel if(!omp_in_parallel())
 #pragma omp single nowait
       // tasking when calling children
       this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
     } else {
-      bwd_solve_phase1(y, yupd, etree_level, task_depth);
+      if (loaded) bwd_solve_phase1(y, yupd, etree_level, task_depth);
+      unload_factors();
       this->bwd_solve_phase2(y, yupd, work, etree_level, task_depth);
     }
   }
 
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::backward_multifrontal_solve
+  (Trans op, DenseM_t& y, DenseM_t* work,
+   int etree_level, int task_depth) const {
+    if (op == Trans::N) {
+      backward_multifrontal_solve(y, work, etree_level, task_depth);
+      return;
+    }
+    DenseMW_t yupd(dim_upd(), y.cols(), work[0], 0, 0);
+    bool loaded = load_factors(false);
+    if (task_depth == 0) {
+      if (loaded)
+        bwd_solve_phase1
+          (op, y, yupd, etree_level, params::task_recursion_cutoff_level);
+      unload_factors();
+#pragma omp parallel if(!omp_in_parallel())
+#pragma omp single nowait
+      bwd_solve_phase2(y, yupd, work, etree_level, task_depth, op);
+    } else {
+      if (loaded) bwd_solve_phase1(op, y, yupd, etree_level, task_depth);
+      unload_factors();
+      bwd_solve_phase2(y, yupd, work, etree_level, task_depth, op);
+    }
+  }
+
   template<typename scalar_t,typename integer_t> void
   Front<scalar_t,integer_t>::bwd_solve_phase2
   (DenseM_t& y, DenseM_t& yupd, DenseM_t* work,
-   int etree_level, int task_depth) const {
+   int etree_level, int task_depth, Trans op) const {
     if (task_depth < params::task_recursion_cutoff_level) {
       if (lchild_) {
 #pragma omp task untied default(shared)                                 \
@@ -320,7 +747,7 @@ namespace strumpack {
           DenseMW_t CB(lchild_->dim_upd(), y.cols(), work[1], 0, 0);
           lchild_->extract_b(y, yupd, CB, this);
           lchild_->backward_multifrontal_solve
-            (y, work+1, etree_level+1, task_depth+1);
+            (op, y, work+1, etree_level+1, task_depth+1);
         }
       }
       if (rchild_) {
@@ -335,7 +762,7 @@ namespace strumpack {
           DenseMW_t CB(rchild_->dim_upd(), y.cols(), work2[0], 0, 0);
           rchild_->extract_b(y, yupd, CB, this);
           rchild_->backward_multifrontal_solve
-            (y, work2.data(), etree_level+1, task_depth+1);
+            (op, y, work2.data(), etree_level+1, task_depth+1);
         }
       }
 #pragma omp taskwait
@@ -344,20 +771,21 @@ namespace strumpack {
         DenseMW_t CB(lchild_->dim_upd(), y.cols(), work[1], 0, 0);
         lchild_->extract_b(y, yupd, CB, this);
         lchild_->backward_multifrontal_solve
-          (y, work+1, etree_level+1, task_depth);
+          (op, y, work+1, etree_level+1, task_depth);
       }
       if (rchild_) {
         DenseMW_t CB(rchild_->dim_upd(), y.cols(), work[1], 0, 0);
         rchild_->extract_b(y, yupd, CB, this);
         rchild_->backward_multifrontal_solve
-          (y, work+1, etree_level+1, task_depth);
+          (op, y, work+1, etree_level+1, task_depth);
       }
     }
   }
 
   template<typename scalar_t,typename integer_t> long long
   Front<scalar_t,integer_t>::factor_nonzeros(int task_depth) const {
-    long long nnz = node_factor_nonzeros(), nnzl = 0, nnzr = 0;
+    long long nnz = ooc_ ? ooc_nnz_ : node_factor_nonzeros(),
+      nnzl = 0, nnzr = 0;
     if (lchild_)
 #pragma omp task default(shared)                        \
   if(task_depth < params::task_recursion_cutoff_level)
@@ -386,6 +814,42 @@ namespace strumpack {
     return nnz + nnzl + nnzr;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::factorization_estimate
+  (const Opts_t& opts, long long& fnnz, long long& cnnz,
+   long long& peak, long long& flops) const {
+    fnnz = cnnz = peak = flops = 0;
+    // the contribution blocks of the children which are factored
+    long long stack = 0;
+    for (auto ch : {lchild_.get(), rchild_.get()}) {
+      if (!ch) continue;
+      long long f, c, p, fl, nnz, cb, nfl;
+      ch->factorization_estimate(opts, f, c, p, fl);
+      ch->node_factorization_estimate(nnz, cb, nfl);
+      peak = std::max(peak, fnnz + stack + p);
+      fnnz += f; cnnz += c; flops += fl; stack += cb;
+    }
+    long long nnz, cb, fl;
+    node_factorization_estimate(nnz, cb, fl);
+    if (is_compressed(dim_sep(), dim_upd(), opts)) cnnz += nnz;
+    peak = std::max(peak, fnnz + stack + nnz + cb);
+    fnnz += nnz;
+    flops += fl;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  Front<scalar_t,integer_t>::node_factorization_estimate
+  (long long& nnz, long long& cb, long long& flops) const {
+    long long dsep = dim_sep(), dupd = dim_upd();
+    nnz = dense_node_factor_nonzeros();
+    cb = dupd * dupd;
+    flops = (is_complex<scalar_t>() ? 4 : 1) *
+      (blas::getrf_flops(dsep, dsep) +
+       blas::trsm_flops(dsep, dupd, scalar_t(1.), 'L') +
+       blas::trsm_flops(dupd, dsep, scalar_t(1.), 'R') +
+       blas::gemm_flops(dupd, dupd, dsep, scalar_t(-1.), scalar_t(1.)));
+  }
+
   template<typename scalar_t,typename integer_t> ReturnCode
   Front<scalar_t,integer_t>::inertia
   (integer_t& neg, integer_t& zero, integer_t& pos) const {
@@ -394,7 +858,10 @@ namespace strumpack {
     if (rchild_) er = rchild_->inertia(neg, zero, pos);
     if (el != ReturnCode::SUCCESS) return el;
     if (er != ReturnCode::SUCCESS) return er;
-    return node_inertia(neg, zero, pos);
+    if (!load_factors()) return ReturnCode::IO_ERROR;
+    auto e = node_inertia(neg, zero, pos);
+    unload_factors();
+    return e;
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
@@ -405,7 +872,10 @@ namespace strumpack {
     if (rchild_) er = rchild_->subnormals(ns, nz);
     if (el != ReturnCode::SUCCESS) return el;
     if (er != ReturnCode::SUCCESS) return er;
-    return node_subnormals(ns, nz);
+    if (!load_factors()) return ReturnCode::IO_ERROR;
+    auto e = node_subnormals(ns, nz);
+    unload_factors();
+    return e;
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
@@ -416,7 +886,10 @@ namespace strumpack {
     if (rchild_) er = rchild_->pivot_growth(pgL, pgU);
     if (el != ReturnCode::SUCCESS) return el;
     if (er != ReturnCode::SUCCESS) return er;
-    return node_pivot_growth(pgL, pgU);
+    if (!load_factors()) return ReturnCode::IO_ERROR;
+    auto e = node_pivot_growth(pgL, pgU);
+    unload_factors();
+    return e;
   }
 
 #if defined(STRUMPACK_USE_MPI)
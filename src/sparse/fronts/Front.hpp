@@ -51,6 +51,10 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> class FrontMPI;
   template<typename scalar_t,typename integer_t> class FrontBLRMPI;
+  struct FrontCounter;
+  class BinaryWriter;
+  class BinaryReader;
+  class OutOfCoreStore;
 
 
   template<typename scalar_t,typename integer_t> class Front {
@@ -92,6 +96,14 @@ namespace strumpack {
     std::vector<std::size_t> upd_to_parent(const F_t* pa,
                                            std::size_t& upd2sep) const;
     std::vector<std::size_t> upd_to_parent(const F_t* pa) const;
+    /**
+     * Same as upd_to_parent(pa, upd2sep), but returns the map stored
+     * by cache_assembly_maps if pa is the parent it was computed for,
+     * otherwise the map is computed in tmp.
+     */
+    const std::vector<std::size_t>&
+    upd_to_parent(const F_t* pa, std::size_t& upd2sep,
+                  std::vector<std::size_t>& tmp) const;
 
     virtual void release_work_memory() {
       VectorPool<scalar_t> workspace;
@@ -124,6 +136,118 @@ namespace strumpack {
 
     virtual void multifrontal_solve(DenseM_t& b) const;
 
+    /**
+     * Solve with op(A), op = Trans::N, Trans::T or Trans::C, using
+     * the factors of A. For op != Trans::N, this requires
+     * transpose_solve_supported().
+     */
+    void multifrontal_solve(Trans op, DenseM_t& b) const;
+
+    /**
+     * Check whether all fronts in this subtree implement the
+     * (conjugate) transposed forward/backward solve.
+     */
+    bool transpose_solve_supported() const;
+
+    /**
+     * Solve with a sparse right-hand side, and only compute selected
+     * entries of the solution. On input, b can only be nonzero in
+     * the rows b_rows, on output only the rows x_rows of b hold the
+     * solution. Both are sorted, in the (permuted) ordering of the
+     * fronts. The forward solve only visits the fronts on the paths
+     * from b_rows to the root, the backward solve only the fronts on
+     * the paths from the root to x_rows. If the tree contains fronts
+     * which do not support this, the full solve is done.
+     */
+    void multifrontal_solve_sparse(DenseM_t& b,
+                                   const std::vector<integer_t>& b_rows,
+                                   const std::vector<integer_t>& x_rows)
+      const;
+
+    /**
+     * Check whether all fronts in this subtree support the pruned
+     * solve, see multifrontal_solve_sparse.
+     */
+    bool pruned_solve_supported() const;
+
+    /**
+     * Check whether the solve with this subtree can run concurrently
+     * in different threads, ie, whether none of the fronts is
+     * modified by the solve. This is not the case for out-of-core
+     * fronts, which read their factors during the solve, or for
+     * fronts which keep work memory between the forward and backward
+     * solve.
+     */
+    bool concurrent_solve_supported() const;
+
+    /**
+     * Selected inversion of the factored matrix, top-down from this
+     * front, with the Takahashi recurrences. Zuu contains the entries
+     * of the inverse for the update indices of this front, it is
+     * empty for the root. The requested entries (rows[k], cols[k])
+     * are sorted by key[k] = min(rows[k], cols[k]), in the ordering
+     * of the fronts. Entry k is stored in z[k]. Returns false if one
+     * of the requested entries is not in the sparsity pattern of the
+     * factors.
+     */
+    bool selected_inversion(const DenseM_t& Zuu,
+                            const std::vector<integer_t>& key,
+                            const std::vector<integer_t>& rows,
+                            const std::vector<integer_t>& cols,
+                            std::vector<scalar_t>& z,
+                            int task_depth=0) const;
+
+    /**
+     * Check whether all fronts in this subtree support the selected
+     * inversion.
+     */
+    bool selected_inversion_supported() const;
+
+    /**
+     * Mark the fronts in this subtree which need to be refactored
+     * after a change of the matrix values in the (sorted) rows, in
+     * the ordering of the fronts. A matrix entry (i,j) is assembled
+     * in the front with min(i,j) in its separator, so rows should
+     * hold min(i,j) for all changed entries. The fronts which do not
+     * contain one of these rows, and do not have a descendant which
+     * does, keep their factors and contribution blocks. lo is the
+     * first row of this subtree. Returns whether any front in this
+     * subtree changed.
+     */
+    bool mark_changed(const std::vector<integer_t>& rows, integer_t lo=0);
+    /** mark all fronts in this subtree as changed */
+    void reset_changed();
+    bool changed() const { return changed_; }
+
+    /**
+     * Check whether all fronts in this subtree can keep their
+     * contribution blocks for an incremental refactorization.
+     */
+    bool incremental_refactorization_supported() const;
+
+    /**
+     * Out-of-core factorization, see SPOptions::set_out_of_core_file.
+     * Each front in this subtree writes its factors to s as soon as
+     * it is factored, and releases them. The solve reads the factors
+     * back one front at a time. Pass nullptr to keep the factors in
+     * memory.
+     */
+    void set_out_of_core(OutOfCoreStore* s);
+    bool out_of_core_supported() const;
+
+    /**
+     * Compute and keep (enable) or free (!enable) the index maps used
+     * to assemble the fronts in this subtree: the positions of the
+     * nonzeros of A in each front, see
+     * CompressedSparseMatrix::front_scatter_map, and the positions of
+     * the rows of each contribution block in the parent front, see
+     * upd_to_parent. With these, refactoring a matrix with the same
+     * sparsity pattern only does indexed copies. pa is the parent of
+     * this front.
+     */
+    void cache_assembly_maps(const SpMat_t& A, bool enable,
+                             const F_t* pa=nullptr);
+
     virtual void
     forward_multifrontal_solve(DenseM_t& b, DenseM_t* work,
                                int etree_level=0,
@@ -133,17 +257,85 @@ namespace strumpack {
                                 int etree_level=0,
                                 int task_depth=0) const;
 
+    void
+    forward_multifrontal_solve(Trans op, DenseM_t& b, DenseM_t* work,
+                               int etree_level, int task_depth) const;
+    void
+    backward_multifrontal_solve(Trans op, DenseM_t& y, DenseM_t* work,
+                                int etree_level, int task_depth) const;
+
     void fwd_solve_phase1(DenseM_t& b, DenseM_t& bupd, DenseM_t* work,
-                          int etree_level, int task_depth) const;
+                          int etree_level, int task_depth,
+                          Trans op=Trans::N) const;
     virtual
     void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd,
                           int etree_level, int task_depth) const {};
     void bwd_solve_phase2(DenseM_t& y, DenseM_t& yupd, DenseM_t* work,
-                          int etree_level, int task_depth) const;
+                          int etree_level, int task_depth,
+                          Trans op=Trans::N) const;
     virtual
     void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
                           int etree_level, int task_depth) const {};
 
+    /**
+     * Forward/backward solve with the front blocks for the
+     * (conjugate) transposed system, op is Trans::T or
+     * Trans::C. Only called when node_transpose_solve_supported().
+     */
+    virtual
+    void fwd_solve_phase2(Trans op, DenseM_t& b, DenseM_t& bupd,
+                          int etree_level, int task_depth) const {};
+    virtual
+    void bwd_solve_phase1(Trans op, DenseM_t& y, DenseM_t& yupd,
+                          int etree_level, int task_depth) const {};
+    virtual bool node_transpose_solve_supported() const { return false; }
+
+    /**
+     * Subtrees of the front (with rows [lo, sep_end_)) are visited
+     * by the pruned solve only if they contain one of the rows.
+     */
+    void forward_multifrontal_solve_sparse
+    (DenseM_t& b, DenseM_t* work, integer_t lo,
+     const std::vector<integer_t>& rows, int etree_level) const;
+    void backward_multifrontal_solve_sparse
+    (DenseM_t& y, DenseM_t* work, integer_t lo,
+     const std::vector<integer_t>& rows, int etree_level) const;
+    /**
+     * False for fronts which override forward_multifrontal_solve and
+     * backward_multifrontal_solve instead of the solve phases.
+     */
+    virtual bool node_pruned_solve_supported() const { return true; }
+    virtual bool node_concurrent_solve_supported() const {
+      return node_pruned_solve_supported();
+    }
+
+    /**
+     * Compute the entries of the inverse for all indices of this
+     * front, [sep, upd] x [sep, upd], from the entries Zuu for the
+     * update indices.
+     */
+    virtual void
+    selected_inversion_node(const DenseM_t& Zuu, DenseM_t& Z,
+                            int task_depth) const {}
+    virtual bool node_selected_inversion_supported() const {
+      return false;
+    }
+    virtual bool node_incremental_refactorization_supported() const {
+      return false;
+    }
+    virtual bool node_out_of_core_supported() const { return false; }
+    /** true if this front assembles A with amap_, if it is set */
+    virtual bool node_assembly_map_supported() const { return false; }
+    /**
+     * True if this front is a plain FrontDense, which can be factored
+     * as a single task, see FrontDense::factor_dag, and which can
+     * allocate its contribution block from a StackArena, see
+     * FrontDense::factor_arena.
+     */
+    virtual bool node_dag_factorization_supported() const {
+      return false;
+    }
+
     ReturnCode inertia(integer_t& neg,
                        integer_t& zero,
                        integer_t& pos) const;
@@ -151,6 +343,20 @@ namespace strumpack {
     ReturnCode pivot_growth(scalar_t& pgL, scalar_t& pgU) const;
 
 
+    /**
+     * Write the factors of this front and all its descendants (in
+     * preorder) to w. This fails with ReturnCode::IO_ERROR for front
+     * types that do not support (de)serialization.
+     */
+    ReturnCode write(BinaryWriter& w) const;
+
+    /**
+     * Recreate a front (sub)tree, with its factors, written earlier
+     * with write. Returns a nullptr on failure.
+     */
+    static std::unique_ptr<F_t>
+    read(BinaryReader& r, FrontCounter& fc, int etree_level=0);
+
     virtual std::size_t get_device_F22_worksize() {
       return dim_upd()*dim_upd();
     }
@@ -167,7 +373,8 @@ namespace strumpack {
       const std::size_t pdsep = F11.rows();
       const std::size_t dupd = CB.rows();
       std::size_t upd2sep;
-      auto I = upd_to_parent(p, upd2sep);
+      std::vector<std::size_t> tmp;
+      const auto& I = upd_to_parent(p, upd2sep, tmp);
 #if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
 #pragma omp taskloop default(shared) grainsize(64)
 #endif
@@ -211,6 +418,13 @@ namespace strumpack {
     extend_add_to_dense(DenseM_t& paF11,
                         DenseM_t& paF21, DenseM_t& paF22,
                         const F_t* p, int task_depth) { abort(); }
+    virtual void
+    extend_add_to_dense(DenseM_t& paF11,
+                        DenseM_t& paF21, DenseM_t& paF22,
+                        const F_t* p, VectorPool<scalar_t>& workspace,
+                        int task_depth) {
+      extend_add_to_dense(paF11, paF21, paF22, p, task_depth);
+    }
 
     virtual void
     extend_add_to_blr(BLRM_t& paF11, BLRM_t& paF12,
@@ -272,6 +486,23 @@ namespace strumpack {
 
     virtual long long factor_nonzeros(int task_depth=0) const;
     virtual long long dense_factor_nonzeros(int task_depth=0) const;
+    /**
+     * Predict the cost of factoring this subtree, from the front
+     * dimensions only, so this can be used before the numerical
+     * factorization. Fronts which will be compressed, according to
+     * the compression thresholds in opts, are counted as dense.
+     *
+     * \param fnnz nonzeros in the factors of this subtree
+     * \param cnnz part of fnnz in fronts which will be compressed
+     * \param peak maximum number of nonzeros, factors plus
+     * contribution blocks, when this subtree is factored in postorder
+     * \param flops floating point operations for the dense
+     * factorization of this subtree
+     */
+    virtual void factorization_estimate(const Opts_t& opts,
+                                        long long& fnnz, long long& cnnz,
+                                        long long& peak,
+                                        long long& flops) const;
     virtual bool isHSS() const { return false; }
     virtual bool isMPI() const { return false; }
     virtual bool isGPU() const { return false; }
@@ -439,10 +670,56 @@ namespace strumpack {
     integer_t sep_, sep_begin_, sep_end_;
     std::vector<integer_t> upd_;
     std::unique_ptr<F_t> lchild_, rchild_;
+    /** false if the factors can be reused, see mark_changed */
+    bool changed_ = true;
+
+    /**
+     * First index of the subtree of child ch, if this subtree starts
+     * at lo. The left child is not always numbered first, see
+     * SPOptions::enable_peak_memory_child_order.
+     */
+    integer_t child_begin(const F_t* ch, integer_t lo) const;
+
+    /** see cache_assembly_maps */
+    FrontScatterMap<integer_t> amap_;
+    std::vector<std::size_t> pmap_;
+    std::size_t pmap_upd2sep_ = 0;
+    const F_t* pmap_pa_ = nullptr;
+
+    OutOfCoreStore* ooc_ = nullptr;
+    std::size_t ooc_id_ = 0;
+    long long ooc_nnz_ = 0;
+    /**
+     * Write the factors of this front to the out-of-core store, and
+     * release them. Does nothing if the factors are kept in memory.
+     */
+    void store_factors();
+    /**
+     * Read the factors of this front back from the out-of-core store,
+     * and start reading the front which is needed next, for the
+     * forward (postorder) or backward (preorder) solve. Returns false
+     * if the factors could not be read, then the store is no longer
+     * good. This modifies the front, so it cannot be called
+     * concurrently for the same front: the out-of-core fronts do not
+     * support concurrent solves, see concurrent_solve_supported, and
+     * the EliminationTree serializes the calls with solve_lock.
+     */
+    bool load_factors(bool forward=true) const;
+    void unload_factors() const;
+    /** free the factors of this front, but not of its children */
+    virtual void release_factors() {}
 
     virtual long long node_factor_nonzeros() const {
       return dense_node_factor_nonzeros();
     }
+    /**
+     * Nonzeros in the factors and contribution block of this front,
+     * and the flops to factor it, on this process, see
+     * factorization_estimate.
+     */
+    virtual void node_factorization_estimate(long long& nnz,
+                                             long long& cb,
+                                             long long& flops) const;
 
     virtual void partition(const Opts_t& opts, const SpMat_t& A,
                            integer_t* sorder,
@@ -463,6 +740,17 @@ namespace strumpack {
       return ReturnCode::INACCURATE_INERTIA;
     }
 
+    virtual ReturnCode write_node(BinaryWriter& w) const {
+      std::cerr << "ERROR: writing the factors is not supported for "
+                << type() << std::endl;
+      return ReturnCode::IO_ERROR;
+    }
+    virtual ReturnCode read_node(BinaryReader& r, int etree_level) {
+      std::cerr << "ERROR: reading the factors is not supported for "
+                << type() << std::endl;
+      return ReturnCode::IO_ERROR;
+    }
+
   private:
     Front(const Front&) = delete;
     Front& operator=(Front const&) = delete;
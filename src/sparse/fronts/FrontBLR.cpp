@@ -34,6 +34,7 @@
 #include "sparse/CSRGraph.hpp"
 #include "misc/TaskTimer.hpp"
 #include "dense/BLASLAPACKWrapper.hpp"
+#include "misc/BinaryIO.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #include "BLR/BLRExtendAdd.hpp"
@@ -518,6 +519,7 @@ namespace strumpack {
     //   BLR::draw(F11blr_, "F11root_"
     //             + std::to_string(opts.BLR_options().leaf_size()) + "_"
     //             + BLR::get_name(opts.BLR_options().admissibility()));
+    this->store_factors();
     return err_code;
   }
 
@@ -570,6 +572,75 @@ namespace strumpack {
     }
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::fwd_solve_phase2
+  (Trans op, DenseM_t& b, DenseM_t& bupd,
+   int etree_level, int task_depth) const {
+    if (dim_sep()) {
+      DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      auto rb = F11blr_.rowblocks();
+      // op(U) is block lower triangular, op(U)_ij = op(U_ji)
+      for (std::size_t i=0; i<rb; i++) {
+        DenseMW_t bi(F11blr_.tilerows(i), b.cols(), bloc,
+                     F11blr_.tileroff(i), 0);
+        for (std::size_t k=0; k<i; k++) {
+          DenseMW_t bk(F11blr_.tilerows(k), b.cols(), bloc,
+                       F11blr_.tileroff(k), 0);
+          F11blr_.tile(k, i).gemm_a
+            (op, Trans::N, scalar_t(-1.), bk, scalar_t(1.), bi, task_depth);
+        }
+        trsm(Side::L, UpLo::U, op, Diag::N, scalar_t(1.),
+             F11blr_.tile(i, i).D(), bi, task_depth);
+      }
+      if (dim_upd())
+        for (std::size_t j=0; j<F12blr_.colblocks(); j++) {
+          DenseMW_t bj(F12blr_.tilecols(j), b.cols(), bupd,
+                       F12blr_.tilecoff(j), 0);
+          for (std::size_t k=0; k<rb; k++) {
+            DenseMW_t bk(F11blr_.tilerows(k), b.cols(), bloc,
+                         F11blr_.tileroff(k), 0);
+            F12blr_.tile(k, j).gemm_a
+              (op, Trans::N, scalar_t(-1.), bk, scalar_t(1.), bj, task_depth);
+          }
+        }
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::bwd_solve_phase1
+  (Trans op, DenseM_t& y, DenseM_t& yupd,
+   int etree_level, int task_depth) const {
+    if (dim_sep()) {
+      DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      auto rb = F11blr_.rowblocks();
+      if (dim_upd())
+        for (std::size_t j=0; j<rb; j++) {
+          DenseMW_t yj(F11blr_.tilerows(j), y.cols(), yloc,
+                       F11blr_.tileroff(j), 0);
+          for (std::size_t k=0; k<F21blr_.rowblocks(); k++) {
+            DenseMW_t yk(F21blr_.tilerows(k), y.cols(), yupd,
+                         F21blr_.tileroff(k), 0);
+            F21blr_.tile(k, j).gemm_a
+              (op, Trans::N, scalar_t(-1.), yk, scalar_t(1.), yj, task_depth);
+          }
+        }
+      // op(L) is unit block upper triangular, op(L)_ij = op(L_ji)
+      for (int i=int(rb)-1; i>=0; i--) {
+        DenseMW_t yi(F11blr_.tilerows(i), y.cols(), yloc,
+                     F11blr_.tileroff(i), 0);
+        for (std::size_t k=i+1; k<rb; k++) {
+          DenseMW_t yk(F11blr_.tilerows(k), y.cols(), yloc,
+                       F11blr_.tileroff(k), 0);
+          F11blr_.tile(k, i).gemm_a
+            (op, Trans::N, scalar_t(-1.), yk, scalar_t(1.), yi, task_depth);
+        }
+        trsm(Side::L, UpLo::L, op, Diag::U, scalar_t(1.),
+             F11blr_.tile(i, i).D(), yi, task_depth);
+      }
+      yloc.laswp(F11blr_.piv(), false);
+    }
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontBLR<scalar_t,integer_t>::extract_CB_sub_matrix
   (const std::vector<std::size_t>& I, const std::vector<std::size_t>& J,
@@ -618,6 +689,29 @@ namespace strumpack {
     return ReturnCode::SUCCESS;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontBLR<scalar_t,integer_t>::release_factors() {
+    F11blr_ = BLRM_t();
+    F12blr_ = BLRM_t();
+    F21blr_ = BLRM_t();
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontBLR<scalar_t,integer_t>::write_node(BinaryWriter& w) const {
+    F11blr_.write(w);
+    F12blr_.write(w);
+    F21blr_.write(w);
+    return w.good() ? ReturnCode::SUCCESS : ReturnCode::IO_ERROR;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontBLR<scalar_t,integer_t>::read_node(BinaryReader& r, int etree_level) {
+    F11blr_.read(r);
+    F12blr_.read(r);
+    F21blr_.read(r);
+    return r.good() ? ReturnCode::SUCCESS : ReturnCode::IO_ERROR;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontBLR<scalar_t,integer_t>::partition
   (const Opts_t& opts, const SpMat_t& A,
@@ -132,6 +132,11 @@ namespace strumpack {
                           int etree_level, int task_depth) const override;
     void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
                           int etree_level, int task_depth) const override;
+    void fwd_solve_phase2(Trans op, DenseM_t& b, DenseM_t& bupd,
+                          int etree_level, int task_depth) const override;
+    void bwd_solve_phase1(Trans op, DenseM_t& y, DenseM_t& yupd,
+                          int etree_level, int task_depth) const override;
+    bool node_transpose_solve_supported() const override { return true; }
 
     void draw_node(std::ostream& of, bool is_root) const override;
 
@@ -140,6 +145,12 @@ namespace strumpack {
     virtual ReturnCode node_subnormals(std::size_t& ns,
                                        std::size_t& nz) const override;
 
+    ReturnCode write_node(BinaryWriter& w) const override;
+    ReturnCode read_node(BinaryReader& r, int etree_level) override;
+
+    bool node_out_of_core_supported() const override { return true; }
+    void release_factors() override;
+
     using F_t::lchild_;
     using F_t::rchild_;
     using F_t::dim_sep;
@@ -27,7 +27,13 @@
  *
  */
 
+#include <atomic>
+#include <functional>
+#include <numeric>
+
 #include "FrontDense.hpp"
+#include "misc/BinaryIO.hpp"
+#include "dense/BLASLAPACKOpenMPTask.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #include "FrontMPI.hpp"
@@ -36,6 +42,43 @@
 
 namespace strumpack {
 
+  /**
+   * C += alpha op(A) B, with A stored in lower precision. A is
+   * converted one block of columns at a time, so the converted block
+   * is still in cache when it is used.
+   */
+  template<typename scalar_t,typename low_t> void
+  gemm_low_precision(Trans op, scalar_t alpha,
+                     const DenseMatrix<low_t>& A,
+                     const DenseMatrix<scalar_t>& B,
+                     DenseMatrix<scalar_t>& C, int task_depth) {
+    const std::size_t m = A.rows(), n = A.cols(), nb = 64;
+    DenseMatrix<scalar_t> Ab(m, std::min(n, nb));
+    for (std::size_t j=0; j<n; j+=nb) {
+      auto bn = std::min(nb, n-j);
+      DenseMatrixWrapper<scalar_t> Aj(m, bn, Ab, 0, 0);
+      copy(m, bn, A, 0, j, Aj, 0, 0);
+      if (op == Trans::N) {
+        auto Bj = ConstDenseMatrixWrapperPtr(bn, B.cols(), B, j, 0);
+        gemm(op, Trans::N, alpha, Aj, *Bj, scalar_t(1.), C, task_depth);
+      } else {
+        DenseMatrixWrapper<scalar_t> Cj(bn, C.cols(), C, j, 0);
+        gemm(op, Trans::N, alpha, Aj, B, scalar_t(1.), Cj, task_depth);
+      }
+    }
+  }
+
+  /** F, or the lower precision Flp converted to tmp if not empty */
+  template<typename scalar_t,typename low_t> const DenseMatrix<scalar_t>&
+  working_precision(const DenseMatrix<scalar_t>& F,
+                    const DenseMatrix<low_t>& Flp,
+                    DenseMatrix<scalar_t>& tmp) {
+    if (!Flp.rows()) return F;
+    tmp = DenseMatrix<scalar_t>(Flp.rows(), Flp.cols());
+    copy(Flp.rows(), Flp.cols(), Flp, 0, 0, tmp, 0, 0);
+    return tmp;
+  }
+
   template<typename scalar_t,typename integer_t>
   FrontDense<scalar_t,integer_t>::FrontDense
   (integer_t sep, integer_t sep_begin, integer_t sep_end,
@@ -81,8 +124,10 @@ namespace strumpack {
   template<typename scalar_t,typename integer_t> ReturnCode
   FrontDense<scalar_t,integer_t>::node_subnormals
   (std::size_t& ns, std::size_t& nz) const {
-    auto dns = F11_.subnormals() + F12_.subnormals() + F21_.subnormals();
-    auto dnz = F11_.zeros() + F12_.zeros() + F21_.zeros();
+    auto dns = F11_.subnormals() + F12_.subnormals() + F21_.subnormals()
+      + F12lp_.subnormals() + F21lp_.subnormals();
+    auto dnz = F11_.zeros() + F12_.zeros() + F21_.zeros()
+      + F12lp_.zeros() + F21lp_.zeros();
     // if (dns || dnz)
     //   std::cout << "DENSE front ds= " << this->dim_sep()
     //             << " du= " << this->dim_upd()
@@ -115,7 +160,7 @@ namespace strumpack {
   (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
    const F_t* p, VectorPool<scalar_t>& workspace, int task_depth) {
     this->extend_add(paF11, paF12, paF21, paF22, F22_, p);
-    release_work_memory(workspace);
+    if (!keep_CB_) release_work_memory(workspace);
   }
 
   template<typename scalar_t,typename integer_t> void
@@ -127,7 +172,8 @@ namespace strumpack {
     const std::size_t pdsep = paF11.rows();
     const std::size_t dupd = dim_upd();
     std::size_t upd2sep;
-    auto I = this->upd_to_parent(p, upd2sep);
+    std::vector<std::size_t> tmp;
+    const auto& I = this->upd_to_parent(p, upd2sep, tmp);
 #if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
 #pragma omp taskloop default(shared) grainsize(64)      \
   if(task_depth < params::task_recursion_cutoff_level)
@@ -160,7 +206,8 @@ namespace strumpack {
     const std::size_t pdsep = paF11.rows();
     const std::size_t dupd = dim_upd();
     std::size_t upd2sep;
-    auto I = this->upd_to_parent(p, upd2sep);
+    std::vector<std::size_t> tmp;
+    const auto& I = this->upd_to_parent(p, upd2sep, tmp);
 #if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
 #pragma omp taskloop default(shared) grainsize(64)      \
   if(task_depth < params::task_recursion_cutoff_level)
@@ -201,6 +248,7 @@ namespace strumpack {
       e1 = factor_phase1(A, opts, workspace, etree_level, task_depth);
       e2 = factor_phase2(A, opts, etree_level, task_depth);
     }
+    this->store_factors();
     return (e1 == ReturnCode::SUCCESS) ? e2 : e1;
   }
 
@@ -209,34 +257,143 @@ namespace strumpack {
   (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
    int etree_level, int task_depth) {
     ReturnCode el = ReturnCode::SUCCESS, er = ReturnCode::SUCCESS;
+    // unchanged children still hold their factors and CB
+    bool fl = lchild_ && lchild_->changed(),
+      fr = rchild_ && rchild_->changed();
     if (opts.use_openmp_tree() &&
         task_depth < params::task_recursion_cutoff_level) {
-      if (lchild_)
+      if (fl)
 #pragma omp task default(shared)                                        \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
         el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
-      if (rchild_)
+      if (fr)
 #pragma omp task default(shared)                                        \
   final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
         er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
 #pragma omp taskwait
     } else {
-      if (lchild_)
-        el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth);
-      if (rchild_)
-        er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth);
+      // The children are factored sequentially. If possible, each
+      // child subtree uses a single stack for its contribution
+      // blocks. Not with incremental refactorization, since then the
+      // contribution blocks are kept.
+      auto factor_child = [&](F_t* ch) {
+        auto fch = dynamic_cast<FrontDense<scalar_t,integer_t>*>(ch);
+        if (fch && !opts.incremental_refactorization() &&
+            fch->arena_supported())
+          return fch->factor_arena
+            (A, opts, workspace, etree_level+1, task_depth);
+        return ch->factor(A, opts, workspace, etree_level+1, task_depth);
+      };
+      if (fl) el = factor_child(lchild_.get());
+      if (fr) er = factor_child(rchild_.get());
+    }
+    assemble(A, opts, workspace, etree_level, task_depth);
+    return (el == ReturnCode::SUCCESS) ? er : el;
+  }
+
+  template<typename scalar_t,typename integer_t> std::size_t
+  FrontDense<scalar_t,integer_t>::cb_stack_size() const {
+    auto cb_size = [](const F_t* f) -> std::size_t {
+      return f ? std::size_t(f->dim_upd()) * f->dim_upd() : 0;
+    };
+    auto stack_size = [](const F_t* f) -> std::size_t {
+      return f ? static_cast<const FrontDense<scalar_t,integer_t>*>
+        (f)->cb_stack_size() : 0;
+    };
+    // the left child's CB stays on the stack while the right child
+    // is factored, then both are on the stack with the CB of this
+    // front
+    auto cl = cb_size(lchild_.get()), cr = cb_size(rchild_.get());
+    return std::max({stack_size(lchild_.get()),
+          cl + stack_size(rchild_.get()),
+          cl + cr + cb_size(this)});
+  }
+
+  template<typename scalar_t,typename integer_t> bool
+  FrontDense<scalar_t,integer_t>::arena_supported() const {
+    return this->node_dag_factorization_supported() &&
+      (!lchild_ || (lchild_->node_dag_factorization_supported() &&
+                    static_cast<const FrontDense<scalar_t,integer_t>*>
+                    (lchild_.get())->arena_supported())) &&
+      (!rchild_ || (rchild_->node_dag_factorization_supported() &&
+                    static_cast<const FrontDense<scalar_t,integer_t>*>
+                    (rchild_.get())->arena_supported()));
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::factor_arena
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   int etree_level, int task_depth) {
+    StackArena<scalar_t> arena(workspace.get(cb_stack_size()));
+    auto e = factor_arena(A, opts, workspace, arena, etree_level, task_depth);
+    // the CB of this front is now at the bottom of the stack, copy
+    // it out so the parent does not keep the whole stack alive, the
+    // stack itself goes back to the pool, for the next subtree
+    const std::size_t dupd = dim_upd();
+    if (dupd) {
+      CBstorage_ = workspace.get(dupd*dupd);
+      std::copy(arena.data(0), arena.data(0)+dupd*dupd, CBstorage_.data());
+      F22_ = DenseMW_t(dupd, dupd, CBstorage_.data(), dupd);
+    }
+    workspace.restore(arena.buffer());
+    return e;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::factor_arena
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   StackArena<scalar_t>& arena, int etree_level, int task_depth) {
+    ReturnCode el = ReturnCode::SUCCESS, er = ReturnCode::SUCCESS;
+    auto t0 = arena.top();
+    // unchanged children, see factor_batched, already have their
+    // contribution block in CBstorage_
+    if (lchild_ && lchild_->changed())
+      el = static_cast<FrontDense<scalar_t,integer_t>*>(lchild_.get())->
+        factor_arena(A, opts, workspace, arena, etree_level+1, task_depth);
+    if (rchild_ && rchild_->changed())
+      er = static_cast<FrontDense<scalar_t,integer_t>*>(rchild_.get())->
+        factor_arena(A, opts, workspace, arena, etree_level+1, task_depth);
+    const std::size_t dupd = dim_upd();
+    auto CB = arena.push(dupd*dupd);
+    assemble(A, opts, workspace, etree_level, task_depth, CB);
+    auto e2 = factor_phase2(A, opts, etree_level, task_depth);
+    this->store_factors();
+    // the CBs of the children have been extend-added, move the CB of
+    // this front down on the stack, to where the children started
+    arena.pop(t0);
+    if (dupd) {
+      auto dst = arena.push(dupd*dupd);
+      if (dst != CB) std::copy(CB, CB+dupd*dupd, dst);
+      F22_ = DenseMW_t(dupd, dupd, dst, dupd);
     }
-    ReturnCode err_code = (el == ReturnCode::SUCCESS) ? er : el;
+    if (el != ReturnCode::SUCCESS) return el;
+    return (er == ReturnCode::SUCCESS) ? e2 : er;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDense<scalar_t,integer_t>::assemble
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   int etree_level, int task_depth, scalar_t* CB) {
+    keep_CB_ = opts.incremental_refactorization();
     // TODO can we allocate the memory in one go??
     const auto dsep = dim_sep();
     const auto dupd = dim_upd();
     F11_ = DenseM_t(dsep, dsep); F11_.zero();
     F12_ = DenseM_t(dsep, dupd); F12_.zero();
     F21_ = DenseM_t(dupd, dsep); F21_.zero();
-    A.extract_front
-      (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
-       this->upd_, task_depth);
-    if (dupd) {
+    if (!this->amap_.empty())
+      A.extract_front(F11_, F12_, F21_, this->amap_);
+    else
+      A.extract_front
+        (F11_, F12_, F21_, this->sep_begin_, this->sep_end_,
+         this->upd_, task_depth);
+    if (dupd && CB) {
+      // the CB is allocated on a StackArena, see factor_arena
+      F22_ = DenseMW_t(dupd, dupd, CB, dupd);
+      F22_.zero();
+    } else if (dupd) {
+      // a CB kept from an earlier factorization, see keep_CB_
+      workspace.restore(CBstorage_);
       CBstorage_ = workspace.get();
       integer_t old_size = CBstorage_.size();
       if (dupd*dupd > old_size) {
@@ -253,7 +410,145 @@ namespace strumpack {
       rchild_->extend_add_to_dense
         (F11_, F12_, F21_, F22_, this, workspace, task_depth);
     if (etree_level == 0 && opts.write_root_front()) F11_.write("Froot");
-    return err_code;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::factor_dag
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace) {
+    // The fronts to factor, with for each front the index of its
+    // parent, its level in the tree and the number of children which
+    // still need to be factored. Unchanged subtrees, see
+    // mark_changed, are skipped.
+    std::vector<FrontDense<scalar_t,integer_t>*> fronts;
+    std::vector<int> parent, level;
+    std::function<bool(F_t*,int,int)> collect =
+      [&](F_t* f, int p, int l) {
+        if (!f->node_dag_factorization_supported()) return false;
+        auto fd = static_cast<FrontDense<scalar_t,integer_t>*>(f);
+        int id = fronts.size();
+        fronts.push_back(fd);
+        parent.push_back(p);
+        level.push_back(l);
+        for (auto& ch : {fd->lchild_.get(), fd->rchild_.get()})
+          if (ch && ch->changed() && !collect(ch, id, l+1))
+            return false;
+        return true;
+      };
+    if (!collect(this, -1, 0))
+      return factor(A, opts, workspace);
+    std::size_t n = fronts.size();
+    std::unique_ptr<std::atomic<int>[]> pending(new std::atomic<int>[n]);
+    for (std::size_t i=0; i<n; i++) pending[i] = 0;
+    for (std::size_t i=0; i<n; i++)
+      if (parent[i] != -1) pending[parent[i]]++;
+    std::vector<int> leaves;
+    for (std::size_t i=0; i<n; i++)
+      if (pending[i] == 0) leaves.push_back(i);
+    std::vector<ReturnCode> err(n, ReturnCode::SUCCESS);
+    // A front becomes a task as soon as its last child is done. The
+    // tasks are untied, so a thread waiting for the BLAS tasks of a
+    // large front can pick up fronts elsewhere in the tree.
+    std::function<void(int)> run = [&](int i) {
+      auto f = fronts[i];
+      int td = std::min(level[i], params::task_recursion_cutoff_level);
+      f->assemble(A, opts, workspace, level[i], td);
+      err[i] = f->factor_phase2(A, opts, level[i], td);
+      f->store_factors();
+      int p = parent[i];
+      if (p != -1 && pending[p].fetch_sub(1) == 1) {
+#pragma omp task untied default(shared) firstprivate(p)
+        run(p);
+      }
+    };
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+    {
+#pragma omp taskgroup
+      {
+        for (auto i : leaves) {
+#pragma omp task untied default(shared) firstprivate(i)
+          run(i);
+        }
+      }
+    }
+    for (auto e : err)
+      if (e != ReturnCode::SUCCESS) return e;
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::factor_batched
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace) {
+    using FD_t = FrontDense<scalar_t,integer_t>;
+    // For each height, the fronts with that height in the small
+    // subtrees, and whether they are the root of such a subtree.
+    // For each height, last is the largest height of the parents,
+    // after which the CB buffer of that height can be released.
+    std::vector<std::vector<std::pair<FD_t*,bool>>> levels;
+    std::vector<int> last;
+    auto add = [&](FD_t* f, int h, bool root, int ph) {
+      for (int i=levels.size(); i<=h; i++) {
+        levels.emplace_back();
+        last.push_back(i);
+      }
+      levels[h].emplace_back(f, root);
+      last[h] = std::max(last[h], ph);
+    };
+    // returns the height of the subtree of f, or -1 if it is not
+    // small, in which case the small child subtrees become roots
+    std::function<int(F_t*)> height = [&](F_t* f) {
+      if (!f->node_dag_factorization_supported() || !f->changed())
+        return -1;
+      auto fd = static_cast<FD_t*>(f);
+      bool small = fd->dim_blk() <= BatchedFrontSize;
+      int h = 0;
+      std::vector<std::pair<FD_t*,int>> ch;
+      for (auto& c : {fd->lchild_.get(), fd->rchild_.get()}) {
+        if (!c) continue;
+        int hc = height(c);
+        if (hc < 0) small = false;
+        else {
+          h = std::max(h, hc+1);
+          ch.emplace_back(static_cast<FD_t*>(c), hc);
+        }
+      }
+      for (auto& c : ch)
+        add(c.first, c.second, !small, small ? h : c.second);
+      return small ? h : -1;
+    };
+    int hroot = height(this);
+    if (hroot >= 0) add(this, hroot, true, hroot);
+    std::vector<std::vector<scalar_t,NoInit<scalar_t>>> buf(levels.size());
+    ReturnCode err = ReturnCode::SUCCESS;
+    for (std::size_t h=0; h<levels.size(); h++) {
+      auto& l = levels[h];
+      std::size_t nf = l.size();
+      // the CBs of this level, except for the roots, in one buffer
+      std::vector<std::size_t> offset(nf+1, 0);
+      for (std::size_t i=0; i<nf; i++) {
+        std::size_t dupd = l[i].second ? 0 : l[i].first->dim_upd();
+        offset[i+1] = offset[i] + dupd*dupd;
+      }
+      buf[h] = workspace.get(offset[nf]);
+      std::vector<ReturnCode> e(nf, ReturnCode::SUCCESS);
+      const int td = params::task_recursion_cutoff_level;
+#pragma omp parallel for schedule(dynamic) if(!omp_in_parallel())
+      for (std::size_t i=0; i<nf; i++) {
+        auto f = l[i].first;
+        int el = (f == this) ? 0 : 1;
+        f->assemble(A, opts, workspace, el, td, l[i].second ?
+                    nullptr : buf[h].data() + offset[i]);
+        e[i] = f->factor_phase2(A, opts, el, td);
+        f->store_factors();
+      }
+      for (std::size_t i=0; i<nf; i++) {
+        if (l[i].second) l[i].first->changed_ = false;
+        if (e[i] != ReturnCode::SUCCESS) err = e[i];
+      }
+      for (std::size_t hh=0; hh<=h; hh++)
+        if (last[hh] == int(h)) workspace.restore(buf[hh]);
+    }
+    return err;
   }
 
   template<typename scalar_t,typename integer_t> ReturnCode
@@ -261,7 +556,33 @@ namespace strumpack {
   (const SpMat_t& A, const Opts_t& opts,
    int etree_level, int task_depth) {
     ReturnCode err_code = ReturnCode::SUCCESS;
-    if (dim_sep()) {
+    bool tiled = false;
+#if defined(_OPENMP) && defined(STRUMPACK_USE_OPENMP_TASK_DEPEND)
+    // the large fronts, at the top of the tree: one tiled task graph
+    // for the LU of F11 and the updates of F12, F21 and F22
+    tiled = dim_sep() >= 4*TiledLUTileSize && omp_in_parallel() &&
+      task_depth < params::task_recursion_cutoff_level;
+#endif
+    if (opts.batched_factorization() && dim_sep() &&
+        this->dim_blk() <= BatchedFrontSize) {
+      piv_.resize(dim_sep());
+      auto thresh = opts.replace_tiny_pivots() ?
+        double(opts.pivot_threshold()) : 0.;
+      if (getrf_small
+          (dim_sep(), dim_upd(), F11_.data(), F11_.ld(),
+           F12_.data(), F12_.ld(), F21_.data(), F21_.ld(),
+           F22_.data(), F22_.ld(), piv_.data(), thresh))
+        err_code = ReturnCode::ZERO_PIVOT;
+    } else if (tiled) {
+      piv_.resize(dim_sep());
+      auto thresh = opts.replace_tiny_pivots() ?
+        double(opts.pivot_threshold()) : 0.;
+      if (getrf_tiled_omp_task
+          (dim_sep(), dim_upd(), F11_.data(), F11_.ld(),
+           F12_.data(), F12_.ld(), F21_.data(), F21_.ld(),
+           F22_.data(), F22_.ld(), piv_.data(), thresh))
+        err_code = ReturnCode::ZERO_PIVOT;
+    } else if (dim_sep()) {
       if (F11_.LU(piv_, task_depth))
         err_code = ReturnCode::ZERO_PIVOT;
       if (opts.replace_tiny_pivots()) {
@@ -285,9 +606,33 @@ namespace strumpack {
        gemm_flops(Trans::N, Trans::N, scalar_t(-1.), F21_, F12_, scalar_t(1.)) +
        trsm_flops(Side::L, scalar_t(1.), F11_, F12_) +
        trsm_flops(Side::R, scalar_t(1.), F11_, F21_));
+    reduce_factor_precision(opts);
     return err_code;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontDense<scalar_t,integer_t>::reduce_factor_precision
+  (const Opts_t& opts) {
+    F12lp_ = DenseMatrix<low_t>();
+    F21lp_ = DenseMatrix<low_t>();
+    if (!opts.reduced_precision_factors() ||
+        !node_reduced_precision_supported() || !dim_sep() || !dim_upd())
+      return;
+    F12lp_ = DenseMatrix<low_t>(F12_.rows(), F12_.cols());
+    copy(F12_.rows(), F12_.cols(), F12_, 0, 0, F12lp_, 0, 0);
+    F12_ = DenseM_t();
+    F21lp_ = DenseMatrix<low_t>(F21_.rows(), F21_.cols());
+    copy(F21_.rows(), F21_.cols(), F21_, 0, 0, F21lp_, 0, 0);
+    F21_ = DenseM_t();
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  FrontDense<scalar_t,integer_t>::node_factor_nonzeros() const {
+    // in terms of scalar_t, a single precision entry counts for half
+    return F_t::node_factor_nonzeros() -
+      (F12lp_.rows()*F12lp_.cols() + F21lp_.rows()*F21lp_.cols()) / 2;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontDense<scalar_t,integer_t>::fwd_solve_phase2
   (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
@@ -296,16 +641,20 @@ namespace strumpack {
       bloc.laswp(piv_, true);
       if (b.cols() == 1) {
         trsv(UpLo::L, Trans::N, Diag::U, F11_, bloc, task_depth);
-        if (dim_upd())
-          gemv(Trans::N, scalar_t(-1.), F21_, bloc,
-               scalar_t(1.), bupd, task_depth);
       } else {
         trsm(Side::L, UpLo::L, Trans::N, Diag::U,
              scalar_t(1.), F11_, bloc, task_depth);
-        if (dim_upd())
-          gemm(Trans::N, Trans::N, scalar_t(-1.), F21_, bloc,
-               scalar_t(1.), bupd, task_depth);
       }
+      if (!dim_upd()) return;
+      if (F21lp_.rows())
+        gemm_low_precision(Trans::N, scalar_t(-1.), F21lp_, bloc,
+                           bupd, task_depth);
+      else if (b.cols() == 1)
+        gemv(Trans::N, scalar_t(-1.), F21_, bloc,
+             scalar_t(1.), bupd, task_depth);
+      else
+        gemm(Trans::N, Trans::N, scalar_t(-1.), F21_, bloc,
+             scalar_t(1.), bupd, task_depth);
     }
   }
 
@@ -314,18 +663,63 @@ namespace strumpack {
   (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
     if (dim_sep()) {
       DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
-      if (y.cols() == 1) {
-        if (dim_upd())
+      if (dim_upd()) {
+        if (F12lp_.rows())
+          gemm_low_precision(Trans::N, scalar_t(-1.), F12lp_, yupd,
+                             yloc, task_depth);
+        else if (y.cols() == 1)
           gemv(Trans::N, scalar_t(-1.), F12_, yupd,
                scalar_t(1.), yloc, task_depth);
-        trsv(UpLo::U, Trans::N, Diag::N, F11_, yloc, task_depth);
-      } else {
-        if (dim_upd())
+        else
           gemm(Trans::N, Trans::N, scalar_t(-1.), F12_, yupd,
                scalar_t(1.), yloc, task_depth);
+      }
+      if (y.cols() == 1)
+        trsv(UpLo::U, Trans::N, Diag::N, F11_, yloc, task_depth);
+      else
         trsm(Side::L, UpLo::U, Trans::N, Diag::N, scalar_t(1.),
              F11_, yloc, task_depth);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDense<scalar_t,integer_t>::fwd_solve_phase2
+  (Trans op, DenseM_t& b, DenseM_t& bupd,
+   int etree_level, int task_depth) const {
+    // with P F11 = L U, op(F11) = op(U) op(L) P, and F12, F21 are
+    // stored as L^{-1} P F12 and F21 U^{-1}
+    if (dim_sep()) {
+      DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      trsm(Side::L, UpLo::U, op, Diag::N, scalar_t(1.),
+           F11_, bloc, task_depth);
+      if (dim_upd()) {
+        if (F12lp_.rows())
+          gemm_low_precision(op, scalar_t(-1.), F12lp_, bloc,
+                             bupd, task_depth);
+        else
+          gemm(op, Trans::N, scalar_t(-1.), F12_, bloc,
+               scalar_t(1.), bupd, task_depth);
+      }
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDense<scalar_t,integer_t>::bwd_solve_phase1
+  (Trans op, DenseM_t& y, DenseM_t& yupd,
+   int etree_level, int task_depth) const {
+    if (dim_sep()) {
+      DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      if (dim_upd()) {
+        if (F21lp_.rows())
+          gemm_low_precision(op, scalar_t(-1.), F21lp_, yupd,
+                             yloc, task_depth);
+        else
+          gemm(op, Trans::N, scalar_t(-1.), F21_, yupd,
+               scalar_t(1.), yloc, task_depth);
       }
+      trsm(Side::L, UpLo::L, op, Diag::U, scalar_t(1.),
+           F11_, yloc, task_depth);
+      yloc.laswp(piv_, false);
     }
   }
 
@@ -497,6 +891,54 @@ namespace strumpack {
     STRUMPACK_CB_SAMPLE_FLOPS((dupd-u2s)*Rcols);
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontDense<scalar_t,integer_t>::selected_inversion_node
+  (const DenseM_t& Zuu, DenseM_t& Z, int task_depth) const {
+    const std::size_t dsep = dim_sep(), dupd = dim_upd();
+    Z = DenseM_t(dsep+dupd, dsep+dupd);
+    DenseMW_t Zss(dsep, dsep, Z, 0, 0), Zsu(dsep, dupd, Z, 0, dsep),
+      Zus(dupd, dsep, Z, dsep, 0), Z22(dupd, dupd, Z, dsep, dsep);
+    Z22.copy(Zuu);
+    if (!dsep) return;
+    DenseM_t F12tmp, F21tmp;
+    const auto& F12 = working_precision(F12_, F12lp_, F12tmp);
+    const auto& F21 = working_precision(F21_, F21lp_, F21tmp);
+    // with P F11 = L U, F12 = L^{-1} P A12 and F21 = A21 U^{-1}:
+    //   Zsu = -U^{-1} F12 Zuu
+    //   Zus = -Zuu F21 L^{-1} P
+    //   Zss = U^{-1} (L^{-1} P - F12 Zus)
+    Zss.eye();
+    Zss.laswp(piv_, true);
+    trsm(Side::L, UpLo::L, Trans::N, Diag::U,
+         scalar_t(1.), F11_, Zss, task_depth);
+    if (dupd) {
+      gemm(Trans::N, Trans::N, scalar_t(-1.), F12, Zuu,
+           scalar_t(0.), Zsu, task_depth);
+      trsm(Side::L, UpLo::U, Trans::N, Diag::N,
+           scalar_t(1.), F11_, Zsu, task_depth);
+      gemm(Trans::N, Trans::N, scalar_t(-1.), Zuu, F21,
+           scalar_t(0.), Zus, task_depth);
+      trsm(Side::R, UpLo::L, Trans::N, Diag::U,
+           scalar_t(1.), F11_, Zus, task_depth);
+      // multiply with P from the right, the permutation P applies
+      // the row interchanges from piv_ in order
+      std::vector<int> p(dsep);
+      std::iota(p.begin(), p.end(), 1);
+      for (std::size_t i=0; i<dsep; i++)
+        std::swap(p[i], p[piv_[i]-1]);
+      Zus.lapmt(p, false);
+      gemm(Trans::N, Trans::N, scalar_t(-1.), F12, Zus,
+           scalar_t(1.), Zss, task_depth);
+    }
+    trsm(Side::L, UpLo::U, Trans::N, Diag::N,
+         scalar_t(1.), F11_, Zss, task_depth);
+    STRUMPACK_FULL_RANK_FLOPS
+      (trsm_flops(Side::L, scalar_t(1.), F11_, Zss) * 2 +
+       (dupd ? gemm_flops(Trans::N, Trans::N, scalar_t(-1.), F12, Zuu,
+                          scalar_t(0.)) * 3 +
+        trsm_flops(Side::L, scalar_t(1.), F11_, Zsu) * 2 : 0));
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontDense<scalar_t,integer_t>::delete_factors() {
     if (lchild_) lchild_->delete_factors();
@@ -505,9 +947,44 @@ namespace strumpack {
     F12_ = DenseM_t();
     F21_ = DenseM_t();
     F22_ = DenseMW_t();
+    F12lp_ = DenseMatrix<low_t>();
+    F21lp_ = DenseMatrix<low_t>();
+    piv_ = std::vector<int>();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDense<scalar_t,integer_t>::release_factors() {
+    F11_ = DenseM_t();
+    F12_ = DenseM_t();
+    F21_ = DenseM_t();
+    F12lp_ = DenseMatrix<low_t>();
+    F21lp_ = DenseMatrix<low_t>();
     piv_ = std::vector<int>();
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::write_node(BinaryWriter& w) const {
+    w.write_matrix(F11_);
+    w.write_matrix(F12_);
+    w.write_matrix(F21_);
+    w.write_vector(piv_);
+    w.write_matrix(F12lp_);
+    w.write_matrix(F21lp_);
+    return w.good() ? ReturnCode::SUCCESS : ReturnCode::IO_ERROR;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDense<scalar_t,integer_t>::read_node
+  (BinaryReader& r, int etree_level) {
+    r.read_matrix(F11_);
+    r.read_matrix(F12_);
+    r.read_matrix(F21_);
+    r.read_vector(piv_);
+    r.read_matrix(F12lp_);
+    r.read_matrix(F21lp_);
+    return r.good() ? ReturnCode::SUCCESS : ReturnCode::IO_ERROR;
+  }
+
 #if defined(STRUMPACK_USE_MPI)
   template<typename scalar_t,typename integer_t> void
   FrontDense<scalar_t,integer_t>::extend_add_copy_to_buffers
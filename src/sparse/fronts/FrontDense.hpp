@@ -34,6 +34,7 @@
 #include <algorithm>
 #include <cmath>
 #include <random>
+#include <type_traits>
 
 #include "Front.hpp"
 #if defined(STRUMPACK_USE_MPI)
@@ -52,6 +53,11 @@ namespace strumpack {
     using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
     using BLRM_t = BLR::BLRMatrix<scalar_t>;
     using Opts_t = SPOptions<scalar_t>;
+    using real_t = typename RealType<scalar_t>::value_type;
+    /** single precision counterpart of scalar_t */
+    using low_t = typename std::conditional
+      <std::is_same<scalar_t,real_t>::value,
+       float, std::complex<float>>::type;
 
   public:
     FrontDense(integer_t sep, integer_t sep_begin, integer_t sep_end,
@@ -95,7 +101,16 @@ namespace strumpack {
     multifrontal_factorization(const SpMat_t& A, const Opts_t& opts,
                                int etree_level=0, int task_depth=0) override {
       VectorPool<scalar_t> workspace;
-      return factor(A, opts, workspace, etree_level, task_depth);
+      ReturnCode eb = ReturnCode::SUCCESS;
+      if (opts.batched_factorization() && etree_level == 0 &&
+          !opts.incremental_refactorization()) {
+        eb = factor_batched(A, opts, workspace);
+        if (!this->changed()) return eb;
+      }
+      auto e = (opts.use_dag_scheduler() && etree_level == 0) ?
+        factor_dag(A, opts, workspace) :
+        factor(A, opts, workspace, etree_level, task_depth);
+      return (eb == ReturnCode::SUCCESS) ? e : eb;
     }
     virtual ReturnCode factor(const SpMat_t& A, const Opts_t& opts,
                               VectorPool<scalar_t>& workspace,
@@ -133,7 +148,15 @@ namespace strumpack {
     DenseM_t F11_, F12_, F21_;
     DenseMW_t F22_;
     std::vector<scalar_t,NoInit<scalar_t>> CBstorage_;
+    /** keep F22_ after extend-add, for incremental refactorization */
+    bool keep_CB_ = false;
     std::vector<int> piv_; // regular int because it is passed to BLAS
+    /**
+     * F12 and F21 in single precision, used instead of F12_ and F21_
+     * if they are not empty, see
+     * SPOptions::enable_reduced_precision_factors
+     */
+    DenseMatrix<low_t> F12lp_, F21lp_;
 
     FrontDense(const FrontDense&) = delete;
     FrontDense& operator=(FrontDense const&) = delete;
@@ -143,6 +166,62 @@ namespace strumpack {
                              int etree_level, int task_depth);
     ReturnCode factor_phase2(const SpMat_t& A, const Opts_t& opts,
                              int etree_level, int task_depth);
+    /**
+     * Extract the front from A and extend-add the contribution
+     * blocks of the children, which should already be factored.
+     */
+    void assemble(const SpMat_t& A, const Opts_t& opts,
+                  VectorPool<scalar_t>& workspace,
+                  int etree_level, int task_depth,
+                  scalar_t* CB=nullptr);
+    /**
+     * Factor this subtree by executing the fronts as OpenMP tasks in
+     * dependency order, see SPOptions::enable_dag_scheduler. Falls
+     * back to factor if the subtree has fronts other than
+     * FrontDense.
+     */
+    ReturnCode factor_dag(const SpMat_t& A, const Opts_t& opts,
+                          VectorPool<scalar_t>& workspace);
+
+    /**
+     * Factor the subtrees at the bottom of this tree which only
+     * consist of FrontDense fronts with at most BatchedFrontSize rows
+     * and columns, see SPOptions::enable_batched_factorization. These
+     * fronts are factored one level at a time, in a parallel loop,
+     * where a level is the set of fronts with the same height. The
+     * contribution blocks of a level are stored in a single buffer,
+     * except for the roots of the subtrees, which keep their
+     * contribution block in CBstorage_ for the parent. The roots are
+     * marked as unchanged, so that factor and factor_dag skip these
+     * subtrees.
+     */
+    ReturnCode factor_batched(const SpMat_t& A, const Opts_t& opts,
+                              VectorPool<scalar_t>& workspace);
+
+    /**
+     * Size of the stack needed to hold the contribution blocks when
+     * this subtree is factored in postorder, see factor_arena.
+     */
+    std::size_t cb_stack_size() const;
+    /**
+     * True if the whole subtree consists of FrontDense fronts, which
+     * can put their contribution blocks on a StackArena.
+     */
+    bool arena_supported() const;
+    /**
+     * Factor this subtree sequentially, with all contribution blocks
+     * allocated from a single StackArena, taken from the workspace
+     * with size cb_stack_size. Afterwards, the contribution block of
+     * this front is copied to CBstorage_, and the stack is returned
+     * to the workspace.
+     */
+    ReturnCode factor_arena(const SpMat_t& A, const Opts_t& opts,
+                            VectorPool<scalar_t>& workspace,
+                            int etree_level, int task_depth);
+    ReturnCode factor_arena(const SpMat_t& A, const Opts_t& opts,
+                            VectorPool<scalar_t>& workspace,
+                            StackArena<scalar_t>& arena,
+                            int etree_level, int task_depth);
 
     virtual void
     fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd, int etree_level,
@@ -150,6 +229,36 @@ namespace strumpack {
     virtual void
     bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd, int etree_level,
                      int task_depth) const override;
+    void fwd_solve_phase2(Trans op, DenseM_t& b, DenseM_t& bupd,
+                          int etree_level, int task_depth) const override;
+    void bwd_solve_phase1(Trans op, DenseM_t& y, DenseM_t& yupd,
+                          int etree_level, int task_depth) const override;
+    bool node_transpose_solve_supported() const override { return true; }
+
+    void selected_inversion_node(const DenseM_t& Zuu, DenseM_t& Z,
+                                 int task_depth) const override;
+    bool node_selected_inversion_supported() const override {
+      return true;
+    }
+    bool node_incremental_refactorization_supported() const override {
+      return keep_CB_;
+    }
+    bool node_dag_factorization_supported() const override {
+      return true;
+    }
+    bool node_out_of_core_supported() const override { return true; }
+    bool node_assembly_map_supported() const override { return true; }
+    void release_factors() override;
+    virtual bool node_reduced_precision_supported() const {
+      return !std::is_same<scalar_t,low_t>::value;
+    }
+    /**
+     * Move F12_ and F21_ to F12lp_ and F21lp_ if
+     * opts.reduced_precision_factors(), called at the end of
+     * factor_phase2.
+     */
+    void reduce_factor_precision(const Opts_t& opts);
+    long long node_factor_nonzeros() const override;
 
     ReturnCode matrix_inertia(const DenseM_t& F,
                               integer_t& neg,
@@ -163,6 +272,9 @@ namespace strumpack {
     virtual ReturnCode node_pivot_growth(scalar_t& pgL,
                                          scalar_t& pgU) const override;
 
+    ReturnCode write_node(BinaryWriter& w) const override;
+    ReturnCode read_node(BinaryReader& r, int etree_level) override;
+
     using F_t::lchild_;
     using F_t::rchild_;
     using F_t::dim_sep;
@@ -0,0 +1,580 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+
+#include "FrontDenseSymmetric.hpp"
+#include "misc/BinaryIO.hpp"
+#if defined(STRUMPACK_USE_MPI)
+#include "ExtendAdd.hpp"
+#include "FrontMPI.hpp"
+#include "FrontBLRMPI.hpp"
+#endif
+
+namespace strumpack {
+
+  template<typename scalar_t,typename integer_t>
+  FrontDenseSymmetric<scalar_t,integer_t>::FrontDenseSymmetric
+  (integer_t sep, integer_t sep_begin, integer_t sep_end,
+   std::vector<integer_t>& upd, bool chol)
+    : FD_t(sep, sep_begin, sep_end, upd), chol_(chol) {}
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::symmetrize_CB() {
+    const std::size_t dupd = dim_upd();
+    for (std::size_t c=0; c<dupd; c++)
+      for (std::size_t r=c+1; r<dupd; r++)
+        F22_(c, r) = blas::my_conj(F22_(r, c));
+  }
+
+  template<typename scalar_t,typename integer_t> DenseMatrix<scalar_t>
+  FrontDenseSymmetric<scalar_t,integer_t>::full_CB() const {
+    const std::size_t dupd = dim_upd();
+    DenseM_t CB(dupd, dupd);
+    for (std::size_t c=0; c<dupd; c++) {
+      CB(c, c) = F22_(c, c);
+      for (std::size_t r=c+1; r<dupd; r++) {
+        CB(r, c) = F22_(r, c);
+        CB(c, r) = blas::my_conj(F22_(r, c));
+      }
+    }
+    return CB;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::extend_add_to_dense
+  (DenseM_t& paF11, DenseM_t& paF21, DenseM_t& paF22,
+   const F_t* p, int task_depth) {
+    VectorPool<scalar_t> workspace;
+    extend_add_to_dense(paF11, paF21, paF22, p, workspace, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::extend_add_to_dense
+  (DenseM_t& paF11, DenseM_t& paF21, DenseM_t& paF22, const F_t* p,
+   VectorPool<scalar_t>& workspace, int task_depth) {
+    // only the lower triangular part of the CB is added, the
+    // parent indices are increasing, so this only touches the lower
+    // triangular part of the parent front
+    const std::size_t pdsep = paF11.rows();
+    const std::size_t dupd = dim_upd();
+    std::size_t upd2sep;
+    auto I = this->upd_to_parent(p, upd2sep);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(64)      \
+  if(task_depth < params::task_recursion_cutoff_level)
+#endif
+    for (std::size_t c=0; c<dupd; c++) {
+      auto pc = I[c];
+      if (pc < pdsep) {
+        for (std::size_t r=c; r<upd2sep; r++)
+          paF11(I[r],pc) += F22_(r,c);
+        for (std::size_t r=std::max(c, upd2sep); r<dupd; r++)
+          paF21(I[r]-pdsep,pc) += F22_(r,c);
+      } else {
+        for (std::size_t r=c; r<dupd; r++)
+          paF22(I[r]-pdsep,pc-pdsep) += F22_(r,c);
+      }
+    }
+    STRUMPACK_FLOPS((is_complex<scalar_t>()?2:1) * dupd * (dupd+1) / 2);
+    STRUMPACK_FULL_RANK_FLOPS
+      ((is_complex<scalar_t>()?2:1) * dupd * (dupd+1) / 2);
+    this->release_work_memory(workspace);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::extend_add_to_dense
+  (DenseM_t& paF11, DenseM_t& paF12, DenseM_t& paF21, DenseM_t& paF22,
+   const F_t* p, VectorPool<scalar_t>& workspace, int task_depth) {
+    symmetrize_CB();
+    FD_t::extend_add_to_dense
+      (paF11, paF12, paF21, paF22, p, workspace, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::extend_add_to_blr
+  (BLRM_t& paF11, BLRM_t& paF12, BLRM_t& paF21, BLRM_t& paF22,
+   const F_t* p, VectorPool<scalar_t>& workspace,
+   int task_depth, const Opts_t& opts) {
+    symmetrize_CB();
+    FD_t::extend_add_to_blr
+      (paF11, paF12, paF21, paF22, p, workspace, task_depth, opts);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::extend_add_to_blr_col
+  (BLRM_t& paF11, BLRM_t& paF12, BLRM_t& paF21, BLRM_t& paF22,
+   const F_t* p, integer_t begin_col, integer_t end_col, int task_depth,
+   const Opts_t& opts) {
+    symmetrize_CB();
+    FD_t::extend_add_to_blr_col
+      (paF11, paF12, paF21, paF22, p, begin_col, end_col, task_depth, opts);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDenseSymmetric<scalar_t,integer_t>::factor
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   int etree_level, int task_depth) {
+    ReturnCode e1, e2;
+    if (task_depth == 0) {
+#pragma omp parallel if(!omp_in_parallel()) default(shared)
+#pragma omp single nowait
+      {
+        e1 = factor_phase1(A, opts, workspace, etree_level, task_depth+1);
+        e2 = factor_phase2(A, opts, etree_level, task_depth);
+      }
+    } else {
+      e1 = factor_phase1(A, opts, workspace, etree_level, task_depth);
+      e2 = factor_phase2(A, opts, etree_level, task_depth);
+    }
+    this->store_factors();
+    return (e1 == ReturnCode::SUCCESS) ? e2 : e1;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDenseSymmetric<scalar_t,integer_t>::factor_phase1
+  (const SpMat_t& A, const Opts_t& opts, VectorPool<scalar_t>& workspace,
+   int etree_level, int task_depth) {
+    ReturnCode el = ReturnCode::SUCCESS, er = ReturnCode::SUCCESS;
+    if (opts.use_openmp_tree() &&
+        task_depth < params::task_recursion_cutoff_level) {
+      if (lchild_)
+#pragma omp task default(shared)                                        \
+  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
+        el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+      if (rchild_)
+#pragma omp task default(shared)                                        \
+  final(task_depth >= params::task_recursion_cutoff_level-1) mergeable
+        er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth+1);
+#pragma omp taskwait
+    } else {
+      if (lchild_)
+        el = lchild_->factor(A, opts, workspace, etree_level+1, task_depth);
+      if (rchild_)
+        er = rchild_->factor(A, opts, workspace, etree_level+1, task_depth);
+    }
+    ReturnCode err_code = (el == ReturnCode::SUCCESS) ? er : el;
+    const auto dsep = dim_sep();
+    const auto dupd = dim_upd();
+    F11_ = DenseM_t(dsep, dsep); F11_.zero();
+    F12_ = DenseM_t();
+    F21_ = DenseM_t(dupd, dsep); F21_.zero();
+    A.extract_front_symmetric
+      (F11_, F21_, this->sep_begin_, this->sep_end_,
+       this->upd_, task_depth);
+    if (dupd) {
+      CBstorage_ = workspace.get();
+      integer_t old_size = CBstorage_.size();
+      if (dupd*dupd > old_size) {
+        STRUMPACK_ADD_MEMORY((dupd*dupd - old_size)*sizeof(scalar_t));
+      }
+      CBstorage_.resize(dupd*dupd);
+      F22_ = DenseMW_t(dupd, dupd, CBstorage_.data(), dupd);
+      F22_.zero();
+    }
+    if (lchild_)
+      lchild_->extend_add_to_dense
+        (F11_, F21_, F22_, this, workspace, task_depth);
+    if (rchild_)
+      rchild_->extend_add_to_dense
+        (F11_, F21_, F22_, this, workspace, task_depth);
+    if (etree_level == 0 && opts.write_root_front()) F11_.write("Froot");
+    return err_code;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDenseSymmetric<scalar_t,integer_t>::factor_phase2
+  (const SpMat_t& A, const Opts_t& opts,
+   int etree_level, int task_depth) {
+    chol_ = opts.use_positive_definite();
+    if (!dim_sep()) return ReturnCode::SUCCESS;
+    if (chol_) return factor_Cholesky(task_depth);
+    return factor_LDLt(opts, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDenseSymmetric<scalar_t,integer_t>::factor_Cholesky(int task_depth) {
+    using real_t = typename RealType<scalar_t>::value_type;
+    ReturnCode err_code = ReturnCode::SUCCESS;
+    if (F11_.Cholesky(task_depth))
+      err_code = ReturnCode::ZERO_PIVOT;
+    else if (dim_upd()) {
+      // L21 = A21 L11^-H,  F22 = F22 - L21 L21^H
+      trsm(Side::R, UpLo::L, Trans::C, Diag::N,
+           scalar_t(1.), F11_, F21_, task_depth);
+      herk(UpLo::L, Trans::N, real_t(-1.), F21_,
+           real_t(1.), F22_, task_depth);
+    }
+    STRUMPACK_FULL_RANK_FLOPS
+      ((is_complex<scalar_t>() ? 4 : 1) *
+       (blas::potrf_flops(dim_sep()) +
+        blas::herk_flops(dim_upd(), dim_sep())) +
+       trsm_flops(Side::R, scalar_t(1.), F11_, F21_));
+    return err_code;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDenseSymmetric<scalar_t,integer_t>::factor_LDLt
+  (const Opts_t& opts, int task_depth) {
+    if (is_complex<scalar_t>()) {
+      std::cerr << "ERROR: LDL^T factorization is not supported for"
+                << " complex (Hermitian indefinite) fronts" << std::endl;
+      return ReturnCode::ZERO_PIVOT;
+    }
+    ReturnCode err_code = ReturnCode::SUCCESS;
+    const std::size_t dsep = dim_sep(), dupd = dim_upd();
+    auto ipiv = F11_.LDLt(task_depth);
+    // Convert the factored form returned by xSYTRF to
+    //   P F11 P^T = L D L^T
+    // with explicit unit lower triangular L, by applying the
+    // interchanges of later steps to the earlier columns of L. The
+    // permutation P is stored in piv_ in xLASWP format, the
+    // off-diagonal elements of the 2x2 blocks of D in D2_.
+    piv_.resize(dsep);
+    D2_.assign(dsep, scalar_t(0.));
+    for (std::size_t k=0; k<dsep; k++) {
+      if (ipiv[k] > 0) {
+        std::size_t kp = ipiv[k] - 1;
+        piv_[k] = kp + 1;
+        if (kp != k)
+          for (std::size_t j=0; j<k; j++)
+            std::swap(F11_(k, j), F11_(kp, j));
+        if (opts.replace_tiny_pivots()) {
+          auto thresh = opts.pivot_threshold();
+          if (std::abs(F11_(k,k)) < thresh)
+            F11_(k,k) = (std::real(F11_(k,k)) < 0) ? -thresh : thresh;
+        }
+        if (F11_(k,k) == scalar_t(0.))
+          err_code = ReturnCode::ZERO_PIVOT;
+      } else {
+        std::size_t kp = -ipiv[k] - 1;
+        piv_[k] = k + 1;
+        piv_[k+1] = kp + 1;
+        if (kp != k+1)
+          for (std::size_t j=0; j<k; j++)
+            std::swap(F11_(k+1, j), F11_(kp, j));
+        D2_[k] = F11_(k+1, k);
+        F11_(k+1, k) = scalar_t(0.);
+        k++;
+      }
+    }
+    if (dupd) {
+      // Y = A21 P^T L^-T,  Z = Y D^-1,  F22 = F22 - Z Y^T,  L21 = Z
+      for (std::size_t k=0; k<dsep; k++)
+        if (piv_[k] != int(k+1))
+          std::swap_ranges
+            (F21_.ptr(0, k), F21_.ptr(0, k)+dupd, F21_.ptr(0, piv_[k]-1));
+      trsm(Side::R, UpLo::L, Trans::T, Diag::U,
+           scalar_t(1.), F11_, F21_, task_depth);
+      DenseM_t Z(F21_);
+      for (std::size_t k=0; k<dsep; k++) {
+        if (D2_[k] == scalar_t(0.)) {
+          auto dinv = scalar_t(1.) / F11_(k, k);
+          for (std::size_t i=0; i<dupd; i++)
+            Z(i, k) *= dinv;
+        } else {
+          auto b = D2_[k], a = F11_(k, k) / b, c = F11_(k+1, k+1) / b,
+            denom = a * c - scalar_t(1.);
+          for (std::size_t i=0; i<dupd; i++) {
+            auto z1 = Z(i, k) / b, z2 = Z(i, k+1) / b;
+            Z(i, k) = (c * z1 - z2) / denom;
+            Z(i, k+1) = (a * z2 - z1) / denom;
+          }
+          k++;
+        }
+      }
+      // there is no xSYRK variant with a diagonal scaling, the lower
+      // triangle of Z Y^T is computed with gemm on block columns
+      const std::size_t B = 128;
+      for (std::size_t c=0; c<dupd; c+=B) {
+        auto nb = std::min(B, dupd-c);
+        DenseMW_t Zc(dupd-c, dsep, Z, c, 0), Yc(nb, dsep, F21_, c, 0),
+          F22c(dupd-c, nb, F22_, c, c);
+        gemm(Trans::N, Trans::T, scalar_t(-1.), Zc, Yc,
+             scalar_t(1.), F22c, task_depth);
+      }
+      F21_ = std::move(Z);
+    }
+    STRUMPACK_FULL_RANK_FLOPS
+      (blas::sytrf_flops(dsep) +
+       trsm_flops(Side::R, scalar_t(1.), F11_, F21_) +
+       2 * blas::herk_flops(dupd, dsep));
+    return err_code;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::D_solve(DenseM_t& b) const {
+    const std::size_t dsep = dim_sep(), nrhs = b.cols();
+    for (std::size_t k=0; k<dsep; k++) {
+      if (D2_[k] == scalar_t(0.)) {
+        auto dinv = scalar_t(1.) / F11_(k, k);
+        for (std::size_t j=0; j<nrhs; j++)
+          b(k, j) *= dinv;
+      } else {
+        // same scaling as in xSYTRS
+        auto d = D2_[k], a = F11_(k, k) / d, c = F11_(k+1, k+1) / d,
+          denom = a * c - scalar_t(1.);
+        for (std::size_t j=0; j<nrhs; j++) {
+          auto b1 = b(k, j) / d, b2 = b(k+1, j) / d;
+          b(k, j) = (c * b1 - b2) / denom;
+          b(k+1, j) = (a * b2 - b1) / denom;
+        }
+        k++;
+      }
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::fwd_solve_phase2
+  (DenseM_t& b, DenseM_t& bupd, int etree_level, int task_depth) const {
+    if (dim_sep()) {
+      DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      auto d = chol_ ? Diag::N : Diag::U;
+      if (!chol_) bloc.laswp(piv_, true);
+      if (b.cols() == 1) {
+        trsv(UpLo::L, Trans::N, d, F11_, bloc, task_depth);
+        if (dim_upd())
+          gemv(Trans::N, scalar_t(-1.), F21_, bloc,
+               scalar_t(1.), bupd, task_depth);
+      } else {
+        trsm(Side::L, UpLo::L, Trans::N, d,
+             scalar_t(1.), F11_, bloc, task_depth);
+        if (dim_upd())
+          gemm(Trans::N, Trans::N, scalar_t(-1.), F21_, bloc,
+               scalar_t(1.), bupd, task_depth);
+      }
+      if (!chol_) D_solve(bloc);
+    }
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::bwd_solve_phase1
+  (DenseM_t& y, DenseM_t& yupd, int etree_level, int task_depth) const {
+    if (dim_sep()) {
+      DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      if (dim_upd()) {
+        if (y.cols() == 1)
+          gemv(Trans::C, scalar_t(-1.), F21_, yupd,
+               scalar_t(1.), yloc, task_depth);
+        else
+          gemm(Trans::C, Trans::N, scalar_t(-1.), F21_, yupd,
+               scalar_t(1.), yloc, task_depth);
+      }
+      trsm(Side::L, UpLo::L, Trans::C, chol_ ? Diag::N : Diag::U,
+           scalar_t(1.), F11_, yloc, task_depth);
+      if (!chol_) yloc.laswp(piv_, false);
+    }
+  }
+
+  template<typename scalar_t> void conjugate(DenseMatrix<scalar_t>& A) {
+    if (!is_complex<scalar_t>()) return;
+    for (std::size_t j=0; j<A.cols(); j++)
+      for (std::size_t i=0; i<A.rows(); i++)
+        A(i, j) = blas::my_conj(A(i, j));
+  }
+
+  // A^H = A, and A^T = conj(A), which is solved as conj(A^{-1}
+  // conj(b)). Every front of the tree works on the conjugated
+  // vectors, so the extend-add between fronts is not affected.
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::fwd_solve_phase2
+  (Trans op, DenseM_t& b, DenseM_t& bupd,
+   int etree_level, int task_depth) const {
+    if (op == Trans::T && is_complex<scalar_t>() && dim_sep()) {
+      DenseMW_t bloc(dim_sep(), b.cols(), b, this->sep_begin_, 0);
+      conjugate(bloc);
+      conjugate(bupd);
+      fwd_solve_phase2(b, bupd, etree_level, task_depth);
+      conjugate(bloc);
+      conjugate(bupd);
+    } else fwd_solve_phase2(b, bupd, etree_level, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::bwd_solve_phase1
+  (Trans op, DenseM_t& y, DenseM_t& yupd,
+   int etree_level, int task_depth) const {
+    if (op == Trans::T && is_complex<scalar_t>() && dim_sep()) {
+      DenseMW_t yloc(dim_sep(), y.cols(), y, this->sep_begin_, 0);
+      conjugate(yloc);
+      conjugate(yupd);
+      bwd_solve_phase1(y, yupd, etree_level, task_depth);
+      conjugate(yloc);
+      conjugate(yupd);
+    } else bwd_solve_phase1(y, yupd, etree_level, task_depth);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::extract_CB_sub_matrix
+  (const std::vector<std::size_t>& I, const std::vector<std::size_t>& J,
+   DenseM_t& B, int task_depth) const {
+    std::vector<std::size_t> lJ, oJ;
+    this->find_upd_indices(J, lJ, oJ);
+    if (lJ.empty()) return;
+    std::vector<std::size_t> lI, oI;
+    this->find_upd_indices(I, lI, oI);
+    if (lI.empty()) return;
+    for (std::size_t j=0; j<lJ.size(); j++)
+      for (std::size_t i=0; i<lI.size(); i++)
+        B(oI[i], oJ[j]) += (lI[i] >= lJ[j]) ? F22_(lI[i], lJ[j]) :
+          blas::my_conj(F22_(lJ[j], lI[i]));
+    STRUMPACK_FLOPS((is_complex<scalar_t>() ? 2 : 1) * lJ.size() * lI.size());
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDenseSymmetric<scalar_t,integer_t>::node_inertia
+  (integer_t& neg, integer_t& zero, integer_t& pos) const {
+    using real_t = typename RealType<scalar_t>::value_type;
+    const std::size_t dsep = dim_sep();
+    if (chol_) {
+      pos += dsep;
+      return ReturnCode::SUCCESS;
+    }
+    for (std::size_t k=0; k<dsep; k++) {
+      if (D2_[k] == scalar_t(0.)) {
+        auto d = std::real(F11_(k, k));
+        if (d > real_t(0.)) pos++;
+        else if (d < real_t(0.)) neg++;
+        else zero++;
+      } else {
+        // a 2x2 block with negative determinant has one positive and
+        // one negative eigenvalue
+        auto a = std::real(F11_(k, k)), c = std::real(F11_(k+1, k+1)),
+          b = std::abs(D2_[k]), det = a * c - b * b;
+        if (det < real_t(0.)) { pos++; neg++; }
+        else if (det > real_t(0.)) {
+          if (a > real_t(0.)) pos += 2;
+          else neg += 2;
+        } else {
+          zero++;
+          if (a + c > real_t(0.)) pos++;
+          else neg++;
+        }
+        k++;
+      }
+    }
+    return ReturnCode::SUCCESS;
+  }
+
+  template<typename scalar_t,typename integer_t> long long
+  FrontDenseSymmetric<scalar_t,integer_t>::dense_node_factor_nonzeros() const {
+    long long dsep = dim_sep(), dupd = dim_upd();
+    return dsep * (dsep + 1) / 2 + dsep * dupd;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::node_factorization_estimate
+  (long long& nnz, long long& cb, long long& flops) const {
+    long long dsep = dim_sep(), dupd = dim_upd();
+    nnz = dense_node_factor_nonzeros();
+    cb = dupd * dupd;
+    // same counts as factor_Cholesky and factor_LDLt
+    flops = (is_complex<scalar_t>() ? 4 : 1) *
+      ((chol_ ?
+        blas::potrf_flops(dsep) + blas::herk_flops(dupd, dsep) :
+        blas::sytrf_flops(dsep) + 2 * blas::herk_flops(dupd, dsep)) +
+       blas::trsm_flops(dupd, dsep, scalar_t(1.), 'R'));
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::delete_factors() {
+    FD_t::delete_factors();
+    D2_ = std::vector<scalar_t>();
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::release_factors() {
+    FD_t::release_factors();
+    D2_ = std::vector<scalar_t>();
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDenseSymmetric<scalar_t,integer_t>::write_node
+  (BinaryWriter& w) const {
+    w.write(char(chol_));
+    w.write_matrix(F11_);
+    w.write_matrix(F21_);
+    w.write_vector(piv_);
+    w.write_vector(D2_);
+    return w.good() ? ReturnCode::SUCCESS : ReturnCode::IO_ERROR;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontDenseSymmetric<scalar_t,integer_t>::read_node
+  (BinaryReader& r, int etree_level) {
+    chol_ = r.read<char>();
+    r.read_matrix(F11_);
+    r.read_matrix(F21_);
+    r.read_vector(piv_);
+    r.read_vector(D2_);
+    return r.good() ? ReturnCode::SUCCESS : ReturnCode::IO_ERROR;
+  }
+
+#if defined(STRUMPACK_USE_MPI)
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::extend_add_copy_to_buffers
+  (std::vector<std::vector<scalar_t>>& sbuf,
+   const FrontMPI<scalar_t,integer_t>* pa) const {
+    ExtendAdd<scalar_t,integer_t>::extend_add_seq_copy_to_buffers
+      (full_CB(), sbuf, pa, this);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::extadd_blr_copy_to_buffers
+  (std::vector<std::vector<scalar_t>>& sbuf,
+   const FrontBLRMPI<scalar_t,integer_t>* pa) const {
+    BLR::BLRExtendAdd<scalar_t,integer_t>::
+      seq_copy_to_buffers(full_CB(), sbuf, pa, this);
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontDenseSymmetric<scalar_t,integer_t>::extadd_blr_copy_to_buffers_col
+  (std::vector<std::vector<scalar_t>>& sbuf,
+   const FrontBLRMPI<scalar_t,integer_t>* pa,
+   integer_t begin_col, integer_t end_col, const Opts_t& opts) const {
+    BLR::BLRExtendAdd<scalar_t,integer_t>::
+      seq_copy_to_buffers_col(full_CB(), sbuf, pa, this, begin_col, end_col);
+  }
+#endif
+
+  // explicit template instantiations
+  template class FrontDenseSymmetric<float,int>;
+  template class FrontDenseSymmetric<double,int>;
+  template class FrontDenseSymmetric<std::complex<float>,int>;
+  template class FrontDenseSymmetric<std::complex<double>,int>;
+
+  template class FrontDenseSymmetric<float,long int>;
+  template class FrontDenseSymmetric<double,long int>;
+  template class FrontDenseSymmetric<std::complex<float>,long int>;
+  template class FrontDenseSymmetric<std::complex<double>,long int>;
+
+  template class FrontDenseSymmetric<float,long long int>;
+  template class FrontDenseSymmetric<double,long long int>;
+  template class FrontDenseSymmetric<std::complex<float>,long long int>;
+  template class FrontDenseSymmetric<std::complex<double>,long long int>;
+
+} // end namespace strumpack
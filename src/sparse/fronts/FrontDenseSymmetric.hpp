@@ -0,0 +1,193 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef FRONTAL_MATRIX_DENSE_SYMMETRIC_HPP
+#define FRONTAL_MATRIX_DENSE_SYMMETRIC_HPP
+
+#include "FrontDense.hpp"
+
+namespace strumpack {
+
+  /**
+   * Dense frontal matrix for symmetric (Hermitian) problems. Only the
+   * lower triangular part of the front is assembled, and only the
+   * lower triangular factors are stored. If the matrix is positive
+   * definite, a Cholesky factorization (xPOTRF) is used, else a
+   * Bunch-Kaufman LDL^T factorization (xSYTRF, only for real
+   * scalar_t). The Schur complement update is computed with a
+   * symmetric rank-k update, which is about half the work of the
+   * gemm in the LU (FrontDense).
+   *
+   * The factors are stored as:
+   *  - F11_: lower triangular L11 (unit diagonal in the LDL^T case,
+   *    with the diagonal of D on the diagonal)
+   *  - F21_: L21
+   *  - F12_: not used
+   *  - piv_: the symmetric pivoting sequence (LDL^T only) in the
+   *    format used by xLASWP
+   *  - D2_: the off-diagonal elements of the 2x2 pivot blocks in D
+   *
+   * Only the lower triangular part of the contribution block F22_ is
+   * computed. When it is needed by a non-symmetric parent, it is
+   * first made Hermitian.
+   */
+  template<typename scalar_t,typename integer_t> class FrontDenseSymmetric
+    : public FrontDense<scalar_t,integer_t> {
+    using F_t = Front<scalar_t,integer_t>;
+    using FD_t = FrontDense<scalar_t,integer_t>;
+    using DenseM_t = DenseMatrix<scalar_t>;
+    using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+    using SpMat_t = CompressedSparseMatrix<scalar_t,integer_t>;
+    using BLRM_t = BLR::BLRMatrix<scalar_t>;
+    using Opts_t = SPOptions<scalar_t>;
+
+  public:
+    /**
+     * chol selects Cholesky instead of LDL^T, this is only used for
+     * the factorization estimate, factor uses the options.
+     */
+    FrontDenseSymmetric(integer_t sep, integer_t sep_begin,
+                        integer_t sep_end, std::vector<integer_t>& upd,
+                        bool chol=true);
+
+    using FD_t::extend_add_to_dense;
+
+    void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF21,
+                             DenseM_t& paF22, const F_t* p,
+                             VectorPool<scalar_t>& workspace,
+                             int task_depth) override;
+    void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF21,
+                             DenseM_t& paF22, const F_t* p,
+                             int task_depth) override;
+
+    void extend_add_to_dense(DenseM_t& paF11, DenseM_t& paF12,
+                             DenseM_t& paF21, DenseM_t& paF22,
+                             const F_t* p, VectorPool<scalar_t>& workspace,
+                             int task_depth) override;
+    void extend_add_to_blr(BLRM_t& paF11, BLRM_t& paF12, BLRM_t& paF21,
+                           BLRM_t& paF22, const F_t* p,
+                           VectorPool<scalar_t>& workspace,
+                           int task_depth, const Opts_t& opts) override;
+    void extend_add_to_blr_col(BLRM_t& paF11, BLRM_t& paF12, BLRM_t& paF21,
+                               BLRM_t& paF22, const F_t* p,
+                               integer_t begin_col, integer_t end_col,
+                               int task_depth, const Opts_t& opts) override;
+
+    ReturnCode factor(const SpMat_t& A, const Opts_t& opts,
+                      VectorPool<scalar_t>& workspace,
+                      int etree_level=0, int task_depth=0) override;
+
+    void
+    extract_CB_sub_matrix(const std::vector<std::size_t>& I,
+                          const std::vector<std::size_t>& J,
+                          DenseM_t& B, int task_depth) const override;
+
+    void delete_factors() override;
+
+    std::string type() const override { return "FrontDenseSymmetric"; }
+
+#if defined(STRUMPACK_USE_MPI)
+    void
+    extend_add_copy_to_buffers(std::vector<std::vector<scalar_t>>& sbuf,
+                               const FrontMPI<scalar_t,integer_t>* pa)
+      const override;
+    void
+    extadd_blr_copy_to_buffers(std::vector<std::vector<scalar_t>>& sbuf,
+                               const FrontBLRMPI<scalar_t,integer_t>* pa)
+      const override;
+    void
+    extadd_blr_copy_to_buffers_col(std::vector<std::vector<scalar_t>>& sbuf,
+                                   const FrontBLRMPI<scalar_t,integer_t>* pa,
+                                   integer_t begin_col, integer_t end_col,
+                                   const Opts_t& opts)
+      const override;
+#endif
+
+  private:
+    bool chol_ = true;
+    std::vector<scalar_t> D2_;
+
+    FrontDenseSymmetric(const FrontDenseSymmetric&) = delete;
+    FrontDenseSymmetric& operator=(FrontDenseSymmetric const&) = delete;
+
+    ReturnCode factor_phase1(const SpMat_t& A, const Opts_t& opts,
+                             VectorPool<scalar_t>& workspace,
+                             int etree_level, int task_depth);
+    ReturnCode factor_phase2(const SpMat_t& A, const Opts_t& opts,
+                             int etree_level, int task_depth);
+    ReturnCode factor_Cholesky(int task_depth);
+    ReturnCode factor_LDLt(const Opts_t& opts, int task_depth);
+
+    void D_solve(DenseM_t& b) const;
+    void symmetrize_CB();
+    DenseM_t full_CB() const;
+
+    void fwd_solve_phase2(DenseM_t& b, DenseM_t& bupd, int etree_level,
+                          int task_depth) const override;
+    void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd, int etree_level,
+                          int task_depth) const override;
+    void fwd_solve_phase2(Trans op, DenseM_t& b, DenseM_t& bupd,
+                          int etree_level, int task_depth) const override;
+    void bwd_solve_phase1(Trans op, DenseM_t& y, DenseM_t& yupd,
+                          int etree_level, int task_depth) const override;
+
+    bool node_selected_inversion_supported() const override {
+      return false;
+    }
+    bool node_dag_factorization_supported() const override {
+      return false;
+    }
+    void release_factors() override;
+    // assembled with extract_front_symmetric
+    bool node_assembly_map_supported() const override { return false; }
+
+    ReturnCode node_inertia(integer_t& neg, integer_t& zero,
+                            integer_t& pos) const override;
+
+    long long dense_node_factor_nonzeros() const override;
+    void node_factorization_estimate(long long& nnz, long long& cb,
+                                     long long& flops) const override;
+
+    ReturnCode write_node(BinaryWriter& w) const override;
+    ReturnCode read_node(BinaryReader& r, int etree_level) override;
+
+    using FD_t::F11_;
+    using FD_t::F12_;
+    using FD_t::F21_;
+    using FD_t::F22_;
+    using FD_t::CBstorage_;
+    using FD_t::piv_;
+    using F_t::lchild_;
+    using F_t::rchild_;
+    using F_t::dim_sep;
+    using F_t::dim_upd;
+  };
+
+} // end namespace strumpack
+
+#endif
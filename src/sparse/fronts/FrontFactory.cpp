@@ -33,6 +33,7 @@
 
 #include "sparse/CSRGraph.hpp"
 #include "FrontDense.hpp"
+#include "FrontDenseSymmetric.hpp"
 #include "FrontHSS.hpp"
 #include "FrontBLR.hpp"
 #if defined(STRUMPACK_USE_BPACK)
@@ -145,7 +146,7 @@ namespace strumpack {
     if (front) return front;
     if (is_GPU(opts)) {
 #if defined(STRUMPACK_USE_CUDA)
-      if (is_symmetric(opts) && is_positive_definite(opts))
+      if (is_symmetric_front(opts))
         front = std::make_unique<FrontGPUSPD<scalar_t,integer_t>>
           (s, sbegin, send, upd);
       else
@@ -162,6 +163,12 @@ namespace strumpack {
       if (root && front) fc.dense++;
     }
     if (front) return front;
+    if (is_symmetric_front(opts)) {
+      front = std::make_unique<FrontDenseSymmetric<scalar_t,integer_t>>
+        (s, sbegin, send, upd, is_positive_definite(opts));
+      if (root) fc.dense++;
+      return front;
+    }
     // fallback in case support for cublas/zfp/hodlr is missing
     front = std::make_unique<FrontDense<scalar_t,integer_t>>
       (s, sbegin, send, upd);
@@ -219,6 +226,79 @@ namespace strumpack {
                         int level, FrontCounter& fc, bool root);
 
 
+  template<typename scalar_t, typename integer_t>
+  std::unique_ptr<Front<scalar_t,integer_t>> create_frontal_matrix
+  (const std::string& type, integer_t s, integer_t sbegin,
+   integer_t send, std::vector<integer_t>& upd, FrontCounter& fc) {
+    std::unique_ptr<Front<scalar_t,integer_t>> front;
+    if (type == "FrontDense") {
+      front = std::make_unique<FrontDense<scalar_t,integer_t>>
+        (s, sbegin, send, upd);
+      fc.dense++;
+    } else if (type == "FrontDenseSymmetric") {
+      front = std::make_unique<FrontDenseSymmetric<scalar_t,integer_t>>
+        (s, sbegin, send, upd);
+      fc.dense++;
+    } else if (type == "FrontBLR") {
+      front = std::make_unique<FrontBLR<scalar_t,integer_t>>
+        (s, sbegin, send, upd);
+      fc.BLR++;
+    } else if (type == "FrontHSS") {
+      front = std::make_unique<FrontHSS<scalar_t,integer_t>>
+        (s, sbegin, send, upd);
+      fc.HSS++;
+    }
+    return front;
+  }
+
+  template std::unique_ptr<Front<float,int>>
+  create_frontal_matrix(const std::string& type, int s, int sbegin, int send,
+                        std::vector<int>& upd, FrontCounter& fc);
+  template std::unique_ptr<Front<double,int>>
+  create_frontal_matrix(const std::string& type, int s, int sbegin, int send,
+                        std::vector<int>& upd, FrontCounter& fc);
+  template std::unique_ptr<Front<std::complex<float>,int>>
+  create_frontal_matrix(const std::string& type, int s, int sbegin, int send,
+                        std::vector<int>& upd, FrontCounter& fc);
+  template std::unique_ptr<Front<std::complex<double>,int>>
+  create_frontal_matrix(const std::string& type, int s, int sbegin, int send,
+                        std::vector<int>& upd, FrontCounter& fc);
+
+  template std::unique_ptr<Front<float,long int>>
+  create_frontal_matrix(const std::string& type, long int s, long int sbegin,
+                        long int send, std::vector<long int>& upd,
+                        FrontCounter& fc);
+  template std::unique_ptr<Front<double,long int>>
+  create_frontal_matrix(const std::string& type, long int s, long int sbegin,
+                        long int send, std::vector<long int>& upd,
+                        FrontCounter& fc);
+  template std::unique_ptr<Front<std::complex<float>,long int>>
+  create_frontal_matrix(const std::string& type, long int s, long int sbegin,
+                        long int send, std::vector<long int>& upd,
+                        FrontCounter& fc);
+  template std::unique_ptr<Front<std::complex<double>,long int>>
+  create_frontal_matrix(const std::string& type, long int s, long int sbegin,
+                        long int send, std::vector<long int>& upd,
+                        FrontCounter& fc);
+
+  template std::unique_ptr<Front<float,long long int>>
+  create_frontal_matrix(const std::string& type, long long int s,
+                        long long int sbegin, long long int send,
+                        std::vector<long long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<Front<double,long long int>>
+  create_frontal_matrix(const std::string& type, long long int s,
+                        long long int sbegin, long long int send,
+                        std::vector<long long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<Front<std::complex<float>,long long int>>
+  create_frontal_matrix(const std::string& type, long long int s,
+                        long long int sbegin, long long int send,
+                        std::vector<long long int>& upd, FrontCounter& fc);
+  template std::unique_ptr<Front<std::complex<double>,long long int>>
+  create_frontal_matrix(const std::string& type, long long int s,
+                        long long int sbegin, long long int send,
+                        std::vector<long long int>& upd, FrontCounter& fc);
+
+
 #if defined(STRUMPACK_USE_MPI)
   template<typename scalar_t, typename integer_t>
   std::unique_ptr<FrontMPI<scalar_t,integer_t>> create_frontal_matrix
@@ -30,12 +30,16 @@
 #define FRONT_FACTORY_HPP
 
 #include <array>
+#include <string>
+#include <vector>
+#include <memory>
 
 #include "StrumpackConfig.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "misc/MPIWrapper.hpp"
 #endif
 #include "StrumpackOptions.hpp"
+#include "dense/BLASLAPACKWrapper.hpp"
 
 
 namespace strumpack {
@@ -65,21 +69,53 @@ namespace strumpack {
 #endif
   }
 
-    template<typename scalar_t> bool is_symmetric
-            (const SPOptions<scalar_t>& opts) {
-#if defined(STRUMPACK_USE_CUDA) || defined(STRUMPACK_USE_HIP) || defined(STRUMPACK_USE_SYCL)
-        return opts.use_symmetric() && opts.compression() == CompressionType::NONE;
+  template<typename scalar_t> bool is_symmetric
+  (const SPOptions<scalar_t>& opts) {
+    return opts.use_symmetric() &&
+      opts.compression() == CompressionType::NONE;
+  }
+
+  template<typename scalar_t> bool is_positive_definite
+  (const SPOptions<scalar_t>& opts) {
+    return opts.use_positive_definite();
+  }
+
+  /**
+   * Whether the factory will actually create symmetric (Cholesky or
+   * LDL^T) fronts. The symmetric option is ignored, and LU is used
+   * instead, for complex indefinite matrices and for GPU fronts other
+   * than the CUDA Cholesky front.
+   */
+  template<typename scalar_t> bool is_symmetric_front
+  (const SPOptions<scalar_t>& opts) {
+    if (!is_symmetric(opts)) return false;
+    if (is_GPU(opts)) {
+#if defined(STRUMPACK_USE_CUDA)
+      return is_positive_definite(opts);
+#else
+      return false;
 #endif
-        return false;
     }
+    // symmetric indefinite (LDL^T) is only supported for real data
+    return is_positive_definite(opts) || !is_complex<scalar_t>();
+  }
 
-    template<typename scalar_t> bool is_positive_definite
-            (const SPOptions<scalar_t>& opts) {
-#if defined(STRUMPACK_USE_CUDA) || defined(STRUMPACK_USE_HIP) || defined(STRUMPACK_USE_SYCL)
-        return opts.use_positive_definite();
-#endif
-        return false;
+  /**
+   * Whether the solve will use (preconditioned) conjugate gradient,
+   * either selected explicitly or by KrylovSolver::AUTO for a
+   * symmetric positive definite matrix with compression.
+   */
+  template<typename scalar_t> bool is_CG
+  (const SPOptions<scalar_t>& opts) {
+    switch (opts.Krylov_solver()) {
+    case KrylovSolver::CG:
+    case KrylovSolver::PREC_CG: return true;
+    case KrylovSolver::AUTO:
+      return opts.compression() != CompressionType::NONE &&
+        opts.use_symmetric() && opts.use_positive_definite();
+    default: return false;
     }
+  }
 
   template<typename scalar_t> bool is_HSS
   (int dsep, int dupd, const SPOptions<scalar_t>& opts) {
@@ -142,6 +178,17 @@ namespace strumpack {
    integer_t send, std::vector<integer_t>& upd,
    int level, FrontCounter& fc, bool root=true);
 
+  /**
+   * Create a front of the given type, as returned by Front::type().
+   * Only the sequential CPU front types are supported (FrontDense,
+   * FrontBLR and FrontHSS), for other types this returns a nullptr.
+   * This is used to recreate an elimination tree from a file.
+   */
+  template<typename scalar_t, typename integer_t>
+  std::unique_ptr<Front<scalar_t,integer_t>> create_frontal_matrix
+  (const std::string& type, integer_t s, integer_t sbegin,
+   integer_t send, std::vector<integer_t>& upd, FrontCounter& fc);
+
 
 #if defined(STRUMPACK_USE_MPI)
   template<typename scalar_t, typename integer_t>
@@ -29,6 +29,7 @@
 
 #include "FrontHSS.hpp"
 #include "sparse/CSRGraph.hpp"
+#include "misc/BinaryIO.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "ExtendAdd.hpp"
 #endif
@@ -520,6 +521,37 @@ namespace strumpack {
       + Phi_.nonzeros() + ThetaVhatC_or_VhatCPhiC_.nonzeros();
   }
 
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontHSS<scalar_t,integer_t>::write_node(BinaryWriter& w) const {
+    w.write_matrix(Theta_);
+    w.write_matrix(Phi_);
+    w.write_matrix(ThetaVhatC_or_VhatCPhiC_);
+    w.write_matrix(DUB01_);
+    H_.write(w.stream());
+    return w.good() ? ReturnCode::SUCCESS : ReturnCode::IO_ERROR;
+  }
+
+  template<typename scalar_t,typename integer_t> ReturnCode
+  FrontHSS<scalar_t,integer_t>::read_node(BinaryReader& r, int etree_level) {
+    r.read_matrix(Theta_);
+    r.read_matrix(Phi_);
+    r.read_matrix(ThetaVhatC_or_VhatCPhiC_);
+    r.read_matrix(DUB01_);
+    r.read_stream([&](std::ifstream& is) { H_.read(is); });
+    if (!r.good()) return ReturnCode::IO_ERROR;
+    // the ULV factors are not stored, recompute them from the
+    // compressed HSS representation
+    if (dim_sep()) {
+#pragma omp parallel
+#pragma omp single nowait
+      {
+        if (etree_level > 0) H_.partial_factor();
+        else H_.factor();
+      }
+    }
+    return ReturnCode::SUCCESS;
+  }
+
   template<typename scalar_t,typename integer_t> void
   FrontHSS<scalar_t,integer_t>::draw_node
   (std::ostream& of, bool is_root) const {
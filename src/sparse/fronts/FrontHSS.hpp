@@ -88,6 +88,7 @@ namespace strumpack {
     void backward_multifrontal_solve(DenseM_t& y, DenseM_t* work,
                                      int etree_level=0,
                                      int task_depth=0) const override;
+    bool node_pruned_solve_supported() const override { return false; }
 
     integer_t front_rank(int task_depth=0) const override;
     void print_rank_statistics(std::ostream &out) const override;
@@ -138,6 +139,9 @@ namespace strumpack {
 
     long long node_factor_nonzeros() const override;
 
+    ReturnCode write_node(BinaryWriter& w) const override;
+    ReturnCode read_node(BinaryReader& r, int etree_level) override;
+
     using F_t::lchild_;
     using F_t::rchild_;
     using F_t::dim_sep;
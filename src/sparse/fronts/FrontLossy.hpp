@@ -133,6 +133,18 @@ namespace strumpack {
                           int etree_level, int task_depth) const override;
     void bwd_solve_phase1(DenseM_t& y, DenseM_t& yupd,
                           int etree_level, int task_depth) const override;
+    bool node_transpose_solve_supported() const override { return false; }
+    bool node_selected_inversion_supported() const override {
+      return false;
+    }
+    bool node_incremental_refactorization_supported() const override {
+      return false;
+    }
+    bool node_dag_factorization_supported() const override {
+      return false;
+    }
+    bool node_out_of_core_supported() const override { return false; }
+    bool node_reduced_precision_supported() const override { return false; }
 
     virtual ReturnCode node_inertia(integer_t& neg,
                                     integer_t& zero,
@@ -81,6 +81,8 @@ namespace strumpack {
 
     std::string type() const override { return "FrontMAGMA"; }
     bool isGPU() const override { return true; }
+    // the GPU solve uses the device memory of the factorization
+    bool node_concurrent_solve_supported() const override { return false; }
 
 #if defined(STRUMPACK_USE_MPI)
     void multifrontal_solve(DenseM_t& bloc,
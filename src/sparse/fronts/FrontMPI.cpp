@@ -30,6 +30,7 @@
 #include "FrontMPI.hpp"
 #include "FrontBLRMPI.hpp"
 #include "ExtendAdd.hpp"
+#include "FrontFactory.hpp"
 
 namespace strumpack {
 
@@ -247,6 +248,42 @@ namespace strumpack {
     return nnz;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  FrontMPI<scalar_t,integer_t>::factorization_estimate
+  (const Opts_t& opts, long long& fnnz, long long& cnnz,
+   long long& peak, long long& flops) const {
+    fnnz = cnnz = peak = flops = 0;
+    long long stack = 0;
+    for (auto ch : {lchild_.get(), rchild_.get()}) {
+      if (!visit(ch)) continue;
+      long long f, c, p, fl, nnz, cb, nfl;
+      ch->factorization_estimate(opts, f, c, p, fl);
+      ch->node_factorization_estimate(nnz, cb, nfl);
+      peak = std::max(peak, fnnz + stack + p);
+      fnnz += f; cnnz += c; flops += fl; stack += cb;
+    }
+    long long nnz, cb, fl;
+    node_factorization_estimate(nnz, cb, fl);
+    if (is_compressed(this->dim_sep(), this->dim_upd(), opts)) cnnz += nnz;
+    peak = std::max(peak, fnnz + stack + nnz + cb);
+    fnnz += nnz;
+    flops += fl;
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  FrontMPI<scalar_t,integer_t>::node_factorization_estimate
+  (long long& nnz, long long& cb, long long& flops) const {
+    nnz = cb = flops = 0;
+    if (Comm().is_null()) return;
+    // the front is distributed 2D block-cyclicly over the processes
+    // in Comm(), assume each gets an equal part
+    F_t::node_factorization_estimate(nnz, cb, flops);
+    long long P = Comm().size();
+    nnz = (nnz + P - 1) / P;
+    cb = (cb + P - 1) / P;
+    flops = (flops + P - 1) / P;
+  }
+
   template<typename scalar_t,typename integer_t> long long
   FrontMPI<scalar_t,integer_t>::node_factor_nonzeros() const {
     long long dsep = this->dim_sep();
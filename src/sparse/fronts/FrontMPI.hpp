@@ -146,6 +146,10 @@ namespace strumpack {
 
     virtual long long factor_nonzeros(int task_depth=0) const override;
     virtual long long dense_factor_nonzeros(int task_depth=0) const override;
+    void factorization_estimate(const Opts_t& opts,
+                                long long& fnnz, long long& cnnz,
+                                long long& peak,
+                                long long& flops) const override;
     virtual std::string type() const override { return "FrontMPI"; }
     virtual bool isMPI() const override { return true; }
 
@@ -156,6 +160,8 @@ namespace strumpack {
     BLACSGrid blacs_grid_;     // 2D processor grid
 
     virtual long long node_factor_nonzeros() const override;
+    void node_factorization_estimate(long long& nnz, long long& cb,
+                                     long long& flops) const override;
 
     using F_t::lchild_;
     using F_t::rchild_;
@@ -0,0 +1,226 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef STRUMPACK_ORDERING_AUTO_REORDERING_HPP
+#define STRUMPACK_ORDERING_AUTO_REORDERING_HPP
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "StrumpackOptions.hpp"
+#include "StrumpackParameters.hpp"
+#include "sparse/SeparatorTree.hpp"
+#include "dense/BLASLAPACKWrapper.hpp"
+#include "misc/TaskTimer.hpp"
+#include "misc/Tools.hpp"
+#if defined(STRUMPACK_USE_SCOTCH)
+#include "ScotchReordering.hpp"
+#endif
+#include "MetisReordering.hpp"
+#include "RCMReordering.hpp"
+#include "ANDSparspak.hpp"
+#include "MTNDReordering.hpp"
+#include "minimum_degree/AMDReordering.hpp"
+
+namespace strumpack {
+  namespace ordering {
+
+    /**
+     * Predicted size and cost of the (exact) multifrontal
+     * factorization for a given ordering.
+     */
+    struct FillEstimate {
+      long long nnz = 0;   /*!< nonzeros in the factors        */
+      long long flops = 0; /*!< flops for the factorization    */
+    };
+
+    /**
+     * Compute the number of update indices of each front, which is
+     * the same as the symbolic factorization in EliminationTree, but
+     * without storing the index sets of the fronts that have already
+     * been merged into their parent. The matrix is not permuted,
+     * rows are mapped through perm instead.
+     */
+    template<typename integer_t> void
+    symbolic_update_sizes(const integer_t* ptr, const integer_t* ind,
+                          const std::vector<integer_t>& perm,
+                          const std::vector<integer_t>& iperm,
+                          const SeparatorTree<integer_t>& tree,
+                          integer_t sep,
+                          std::vector<std::vector<integer_t>>& upd,
+                          std::vector<integer_t>& dupd, int depth=0) {
+      auto chl = tree.lch[sep];
+      auto chr = tree.rch[sep];
+      if (depth < params::task_recursion_cutoff_level) {
+        if (chl != -1)
+#pragma omp task untied default(shared)                                 \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+          symbolic_update_sizes
+            (ptr, ind, perm, iperm, tree, chl, upd, dupd, depth+1);
+        if (chr != -1)
+#pragma omp task untied default(shared)                                 \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+          symbolic_update_sizes
+            (ptr, ind, perm, iperm, tree, chr, upd, dupd, depth+1);
+#pragma omp taskwait
+      } else {
+        if (chl != -1)
+          symbolic_update_sizes
+            (ptr, ind, perm, iperm, tree, chl, upd, dupd, depth);
+        if (chr != -1)
+          symbolic_update_sizes
+            (ptr, ind, perm, iperm, tree, chr, upd, dupd, depth);
+      }
+      const auto sep_end = tree.sizes[sep+1];
+      auto& u = upd[sep];
+      for (auto c=tree.sizes[sep]; c<sep_end; c++) {
+        auto i = iperm[c];
+        for (auto t=ptr[i]; t<ptr[i+1]; t++) {
+          auto r = perm[ind[t]];
+          if (r >= sep_end) u.push_back(r);
+        }
+      }
+      for (auto ch : {chl, chr}) {
+        if (ch == -1) continue;
+        for (auto r : upd[ch])
+          if (r >= sep_end) u.push_back(r);
+        std::vector<integer_t>().swap(upd[ch]);
+      }
+      std::sort(u.begin(), u.end());
+      u.erase(std::unique(u.begin(), u.end()), u.end());
+      dupd[sep] = u.size();
+    }
+
+    /**
+     * Estimate the number of nonzeros in the factors and the
+     * factorization flops, with dense fronts, for the ordering
+     * perm/iperm with separator tree tree, of the graph ptr/ind.
+     */
+    template<typename scalar_t,typename integer_t> FillEstimate
+    symbolic_fill_estimate(const integer_t* ptr, const integer_t* ind,
+                           const std::vector<integer_t>& perm,
+                           const std::vector<integer_t>& iperm,
+                           const SeparatorTree<integer_t>& tree) {
+      FillEstimate e;
+      const auto ns = tree.separators();
+      if (ns == 0) return e;
+      std::vector<std::vector<integer_t>> upd(ns);
+      std::vector<integer_t> dupd(ns);
+#pragma omp parallel default(shared)
+#pragma omp single
+      symbolic_update_sizes(ptr, ind, perm, iperm, tree, tree.root(),
+                            upd, dupd);
+      for (integer_t s=0; s<ns; s++) {
+        long long ds = tree.sizes[s+1] - tree.sizes[s], du = dupd[s];
+        e.nnz += ds * (ds + 2 * du);
+        e.flops += blas::getrf_flops(ds, ds) +
+          blas::gemm_flops(du, du, ds, scalar_t(-1.), scalar_t(1.)) +
+          2 * blas::trsm_flops(ds, du, scalar_t(1.), 'L');
+      }
+      return e;
+    }
+
+    /**
+     * Run several fill-reducing orderings concurrently, as OpenMP
+     * tasks, and keep the one with the fewest estimated
+     * factorization flops, see symbolic_fill_estimate. The
+     * candidates are METIS, Scotch (if available), MTND, AMD, AND
+     * and RCM. With verbose output, the estimates for all candidates
+     * are printed.
+     */
+    template<typename scalar_t,typename integer_t,typename G>
+    SeparatorTree<integer_t>
+    auto_reordering(const G& A, std::vector<integer_t>& perm,
+                    std::vector<integer_t>& iperm,
+                    const SPOptions<scalar_t>& opts) {
+      const std::vector<ReorderingStrategy> methods =
+        {ReorderingStrategy::METIS,
+#if defined(STRUMPACK_USE_SCOTCH)
+         ReorderingStrategy::SCOTCH,
+#endif
+         ReorderingStrategy::MTND, ReorderingStrategy::AMD,
+         ReorderingStrategy::AND, ReorderingStrategy::RCM};
+      const std::size_t nm = methods.size();
+      std::vector<std::vector<integer_t>> P(nm, perm), IP(nm, iperm);
+      std::vector<SeparatorTree<integer_t>> T(nm);
+      std::vector<FillEstimate> E(nm);
+      std::vector<double> time(nm);
+#pragma omp parallel default(shared)
+#pragma omp single
+      for (std::size_t m=0; m<nm; m++) {
+#pragma omp task default(shared) firstprivate(m)
+        {
+          TaskTimer t("auto_reordering");
+          t.start();
+          switch (methods[m]) {
+          case ReorderingStrategy::METIS:
+            T[m] = metis_nested_dissection(A, P[m], IP[m], opts); break;
+#if defined(STRUMPACK_USE_SCOTCH)
+          case ReorderingStrategy::SCOTCH:
+            T[m] = scotch_nested_dissection(A, P[m], IP[m], opts); break;
+#endif
+          case ReorderingStrategy::MTND:
+            T[m] = mtnd_reordering(A, P[m], IP[m], opts); break;
+          case ReorderingStrategy::AMD:
+            T[m] = amd_reordering(A, P[m], IP[m]); break;
+          case ReorderingStrategy::AND:
+            T[m] = and_reordering(A, P[m], IP[m]); break;
+          case ReorderingStrategy::RCM:
+            T[m] = rcm_reordering(A, P[m], IP[m]); break;
+          default: break;
+          }
+          E[m] = symbolic_fill_estimate<scalar_t>
+            (A.ptr(), A.ind(), P[m], IP[m], T[m]);
+          time[m] = t.elapsed();
+        }
+      }
+      std::size_t best = 0;
+      for (std::size_t m=1; m<nm; m++)
+        if (E[m].flops < E[best].flops ||
+            (E[m].flops == E[best].flops && E[m].nnz < E[best].nnz))
+          best = m;
+      if (opts.verbose() && mpi_root()) {
+        std::cout << "# automatic reordering selection:" << std::endl;
+        for (std::size_t m=0; m<nm; m++)
+          std::cout << "#   - " << get_name(methods[m])
+                    << ": factor nonzeros = "
+                    << number_format_with_commas(E[m].nnz)
+                    << ", factor flops = " << double(E[m].flops)
+                    << ", time = " << time[m]
+                    << (m == best ? " (selected)" : "") << std::endl;
+      }
+      perm.swap(P[best]);
+      iperm.swap(IP[best]);
+      return std::move(T[best]);
+    }
+
+  } // end namespace ordering
+} // end namespace strumpack
+
+#endif // STRUMPACK_ORDERING_AUTO_REORDERING_HPP
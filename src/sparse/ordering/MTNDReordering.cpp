@@ -0,0 +1,909 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+#include "MTNDReordering.hpp"
+#include "minimum_degree/AMDReordering.hpp"
+#include "StrumpackParameters.hpp"
+#include "dense/BLASLAPACKWrapper.hpp"
+
+namespace strumpack {
+  namespace ordering {
+
+    template<typename integer> struct NDGraph {
+      integer n = 0;
+      std::vector<integer> xadj, adjncy, vwgt, adjwgt;
+      integer weight() const {
+        return std::accumulate(vwgt.begin(), vwgt.end(), integer(0));
+      }
+    };
+
+    template<typename integer> struct NDNode {
+      integer size, lch, rch;
+    };
+
+    /**
+     * Quality of a separator, smaller is better: first the amount
+     * by which the largest part exceeds maxpw, then the separator
+     * weight, then the imbalance between the two parts.
+     */
+    template<typename integer> std::tuple<integer,integer,integer>
+    nd_key(const integer* pw, integer maxpw) {
+      auto mx = std::max(pw[0], pw[1]);
+      return std::make_tuple
+        ((mx > maxpw) ? mx : integer(0), pw[2],
+         (pw[0] > pw[1]) ? pw[0] - pw[1] : pw[1] - pw[0]);
+    }
+
+    /**
+     * Heavy-edge matching, vertices of low degree are visited first
+     * since those are the hardest to match. Returns the coarse graph
+     * and sets cmap, the coarse vertex of each fine vertex.
+     */
+    template<typename integer> NDGraph<integer>
+    nd_coarsen(const NDGraph<integer>& g, std::vector<integer>& cmap,
+               integer maxvwgt, std::mt19937& gen) {
+      const auto n = g.n;
+      std::vector<integer> perm(n), order(n), match(n, -1), cvtx;
+      std::iota(perm.begin(), perm.end(), 0);
+      for (integer i=0; i<n/8; i++)
+        std::swap(perm[gen() % n], perm[gen() % n]);
+      { // bucket sort by degree, ties in random order
+        integer maxd = 0;
+        for (integer v=0; v<n; v++)
+          maxd = std::max(maxd, g.xadj[v+1] - g.xadj[v]);
+        std::vector<integer> cnt(maxd+2, 0);
+        for (integer v=0; v<n; v++)
+          cnt[g.xadj[v+1] - g.xadj[v] + 1]++;
+        for (integer d=0; d<=maxd; d++)
+          cnt[d+1] += cnt[d];
+        for (auto v : perm)
+          order[cnt[g.xadj[v+1] - g.xadj[v]]++] = v;
+      }
+      cmap.resize(n);
+      cvtx.reserve(n);
+      for (auto v : order) {
+        if (match[v] != -1) continue;
+        integer m = v, mw = 0;
+        for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++) {
+          auto u = g.adjncy[j];
+          if (match[u] == -1 && g.adjwgt[j] > mw &&
+              g.vwgt[v] + g.vwgt[u] <= maxvwgt) {
+            m = u;
+            mw = g.adjwgt[j];
+          }
+        }
+        match[v] = m;
+        match[m] = v;
+      }
+      // number the coarse vertices following the fine vertices, for
+      // better locality in the contraction
+      for (integer v=0; v<n; v++)
+        if (v <= match[v]) {
+          cmap[v] = cmap[match[v]] = cvtx.size();
+          cvtx.push_back(v);
+        }
+      const integer nc = cvtx.size();
+      NDGraph<integer> c;
+      c.n = nc;
+      c.xadj.resize(nc+1);
+      c.vwgt.resize(nc);
+      // upper bound for the number of edges of each coarse vertex
+      std::vector<integer> bnd(nc+1), cdeg(nc);
+      bnd[0] = 0;
+      for (integer i=0; i<nc; i++) {
+        auto v = cvtx[i], u = match[v];
+        bnd[i+1] = bnd[i] + g.xadj[v+1] - g.xadj[v] +
+          ((u != v) ? g.xadj[u+1] - g.xadj[u] : 0);
+      }
+      std::vector<std::pair<integer,integer>> tmp(bnd[nc]);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(2048)
+#endif
+      for (integer i=0; i<nc; i++) {
+        auto v = cvtx[i], u = match[v];
+        c.vwgt[i] = g.vwgt[v] + ((u != v) ? g.vwgt[u] : 0);
+        auto t = tmp.begin() + bnd[i];
+        integer d = 0;
+        // coarse vertices have few neighbors, a linear search to
+        // merge parallel edges is cheaper than sorting
+        auto add = [&](integer w) {
+          for (auto j=g.xadj[w]; j<g.xadj[w+1]; j++) {
+            auto cu = cmap[g.adjncy[j]];
+            if (cu == i) continue;
+            integer k = 0;
+            while (k < d && t[k].first != cu) k++;
+            if (k < d) t[k].second += g.adjwgt[j];
+            else t[d++] = {cu, g.adjwgt[j]};
+          }
+        };
+        add(v);
+        if (u != v) add(u);
+        cdeg[i] = d;
+      }
+      c.xadj[0] = 0;
+      for (integer i=0; i<nc; i++)
+        c.xadj[i+1] = c.xadj[i] + cdeg[i];
+      c.adjncy.resize(c.xadj[nc]);
+      c.adjwgt.resize(c.xadj[nc]);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(2048)
+#endif
+      for (integer i=0; i<nc; i++)
+        for (integer k=0; k<cdeg[i]; k++) {
+          c.adjncy[c.xadj[i]+k] = tmp[bnd[i]+k].first;
+          c.adjwgt[c.xadj[i]+k] = tmp[bnd[i]+k].second;
+        }
+      return c;
+    }
+
+    /**
+     * Turn the edge bisection in where (parts 0 and 1) into a vertex
+     * separator, by moving the smallest of the two boundaries to the
+     * separator (part 2), and compute the part weights.
+     */
+    template<typename integer> void
+    nd_boundary_separator(const NDGraph<integer>& g, std::vector<int>& where,
+                          integer* pw) {
+      const auto n = g.n;
+      std::vector<char> bnd(n, 0);
+      integer bw[2] = {0, 0};
+      for (integer v=0; v<n; v++)
+        for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++)
+          if (where[g.adjncy[j]] != where[v]) {
+            bnd[v] = 1;
+            bw[where[v]] += g.vwgt[v];
+            break;
+          }
+      int s = (bw[0] <= bw[1]) ? 0 : 1;
+      pw[0] = pw[1] = pw[2] = 0;
+      for (integer v=0; v<n; v++) {
+        if (bnd[v] && where[v] == s) where[v] = 2;
+        pw[where[v]] += g.vwgt[v];
+      }
+    }
+
+    /**
+     * Grow part 0 breadth-first from seed until it holds half the
+     * weight, the rest is part 1. The smallest of the two boundaries
+     * of this edge bisection is taken as the vertex separator.
+     */
+    template<typename integer> void
+    nd_grow(const NDGraph<integer>& g, integer seed,
+            std::vector<int>& where, integer* pw) {
+      const auto n = g.n;
+      const auto tw = g.weight();
+      std::vector<integer> q(n);
+      std::vector<char> visited(n, 0);
+      std::fill(where.begin(), where.end(), 1);
+      integer head = 0, tail = 0, w0 = 0, next = 0;
+      q[tail++] = seed;
+      visited[seed] = 1;
+      while (2 * w0 < tw) {
+        if (head == tail) {
+          // continue in another connected component
+          while (next < n && visited[next]) next++;
+          if (next == n) break;
+          q[tail++] = next;
+          visited[next] = 1;
+        }
+        auto v = q[head++];
+        where[v] = 0;
+        w0 += g.vwgt[v];
+        for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++) {
+          auto u = g.adjncy[j];
+          if (!visited[u]) {
+            visited[u] = 1;
+            q[tail++] = u;
+          }
+        }
+      }
+      nd_boundary_separator(g, where, pw);
+    }
+
+    /**
+     * Fiduccia-Mattheyses refinement of a vertex separator. A
+     * separator vertex moved to one part pulls its neighbors from
+     * the other part into the separator. Each pass allows a limited
+     * number of moves that do not improve the separator, and then
+     * rolls back to the best separator encountered.
+     */
+    template<typename integer> void
+    nd_refine(const NDGraph<integer>& g, std::vector<int>& where,
+              integer* pw, integer maxpw, int passes) {
+      const auto n = g.n;
+      const integer limit =
+        std::min(std::max(integer(15), n / 100), integer(100));
+      auto gain = [&](integer v, int s) {
+        integer gn = g.vwgt[v];
+        for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++)
+          if (where[g.adjncy[j]] == 1 - s) gn -= g.vwgt[g.adjncy[j]];
+        return gn;
+      };
+      std::vector<char> locked(n, 0);
+      std::vector<std::pair<integer,int>> moves;
+      std::vector<integer> sep, pulled;
+      std::vector<std::size_t> pulled_end;
+      for (integer v=0; v<n; v++)
+        if (where[v] == 2) sep.push_back(v);
+      for (int pass=0; pass<passes; pass++) {
+        // ties are broken in favor of the lightest part
+        std::priority_queue<std::tuple<integer,integer,integer,int>> pq;
+        auto push = [&](integer v) {
+          if (locked[v] || where[v] != 2) return;
+          pq.emplace(gain(v, 0), -pw[0], v, 0);
+          pq.emplace(gain(v, 1), -pw[1], v, 1);
+        };
+        moves.clear();
+        pulled.clear();
+        pulled_end.clear();
+        for (auto v : sep) push(v);
+        auto best = nd_key(pw, maxpw);
+        std::size_t nbest = 0;
+        while (!pq.empty()) {
+          integer gn, v;
+          int s;
+          std::tie(gn, std::ignore, v, s) = pq.top();
+          pq.pop();
+          // skip stale entries, the updated gain was pushed as well
+          if (locked[v] || where[v] != 2 || gn != gain(v, s)) continue;
+          const int o = 1 - s;
+          if (pw[s] + g.vwgt[v] > maxpw &&
+              pw[s] + g.vwgt[v] > pw[o] - (g.vwgt[v] - gn))
+            continue;
+          where[v] = s;
+          locked[v] = 1;
+          pw[s] += g.vwgt[v];
+          pw[2] -= g.vwgt[v];
+          auto p0 = pulled.size();
+          for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++) {
+            auto u = g.adjncy[j];
+            if (where[u] == o) {
+              where[u] = 2;
+              pw[o] -= g.vwgt[u];
+              pw[2] += g.vwgt[u];
+              pulled.push_back(u);
+            }
+          }
+          pulled_end.push_back(pulled.size());
+          moves.emplace_back(v, s);
+          for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++)
+            push(g.adjncy[j]);
+          for (auto i=p0; i<pulled.size(); i++)
+            for (auto j=g.xadj[pulled[i]]; j<g.xadj[pulled[i]+1]; j++)
+              push(g.adjncy[j]);
+          auto k = nd_key(pw, maxpw);
+          if (k < best) {
+            best = k;
+            nbest = moves.size();
+          } else if (moves.size() - nbest > std::size_t(limit)) break;
+        }
+        for (auto m=moves.size(); m>nbest; m--) {
+          auto v = moves[m-1].first;
+          int s = moves[m-1].second, o = 1 - s;
+          for (auto i=(m > 1 ? pulled_end[m-2] : 0);
+               i<pulled_end[m-1]; i++) {
+            auto u = pulled[i];
+            where[u] = o;
+            pw[o] += g.vwgt[u];
+            pw[2] -= g.vwgt[u];
+          }
+          where[v] = 2;
+          pw[s] -= g.vwgt[v];
+          pw[2] += g.vwgt[v];
+        }
+        for (auto& m : moves) locked[m.first] = 0;
+        // the new separator is a subset of the old one plus the
+        // vertices pulled in, locked is used to remove duplicates
+        std::vector<integer> nsep;
+        for (auto v : sep)
+          if (where[v] == 2 && !locked[v]) { locked[v] = 1; nsep.push_back(v); }
+        for (auto v : pulled)
+          if (where[v] == 2 && !locked[v]) { locked[v] = 1; nsep.push_back(v); }
+        for (auto v : nsep) locked[v] = 0;
+        sep.swap(nsep);
+        if (nbest == 0) break;
+      }
+    }
+
+    /**
+     * Level-structure separator: breadth-first search from a
+     * pseudo-peripheral vertex, the vertices in the level where half
+     * of the weight is reached that connect to the next level form
+     * the separator. Unreached vertices, in other connected
+     * components, are put in part 1.
+     */
+    template<typename integer> void
+    nd_level_separator(const NDGraph<integer>& g, std::vector<int>& where,
+                       integer* pw) {
+      const auto n = g.n;
+      const auto tw = g.weight();
+      std::vector<integer> level(n), q(n);
+      integer ncc = 0;
+      auto bfs = [&](integer r) {
+        std::fill(level.begin(), level.end(), -1);
+        integer head = 0, tail = 0;
+        q[tail++] = r;
+        level[r] = 0;
+        while (head < tail) {
+          auto v = q[head++];
+          for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++) {
+            auto u = g.adjncy[j];
+            if (level[u] == -1) {
+              level[u] = level[v] + 1;
+              q[tail++] = u;
+            }
+          }
+        }
+        ncc = tail;
+        return level[q[tail-1]] + 1;
+      };
+      integer root = 0, nlvl = bfs(root);
+      for (int it=0; it<4; it++) {
+        // restart from a minimum degree vertex in the last level
+        integer r = q[ncc-1], mindeg = n;
+        for (auto i=ncc-1; i>=0 && level[q[i]] == nlvl-1; i--) {
+          auto d = g.xadj[q[i]+1] - g.xadj[q[i]];
+          if (d < mindeg) {
+            mindeg = d;
+            r = q[i];
+          }
+        }
+        auto nl = bfs(r);
+        if (nl <= nlvl) {
+          bfs(root);
+          break;
+        }
+        root = r;
+        nlvl = nl;
+      }
+      integer w = 0, sl = 0;
+      for (integer i=0; i<ncc; i++) {
+        w += g.vwgt[q[i]];
+        if (2 * w >= tw) {
+          sl = level[q[i]];
+          break;
+        }
+      }
+      for (integer v=0; v<n; v++)
+        where[v] = (level[v] == -1 || level[v] > sl) ? 1 : 0;
+      for (integer v=0; v<n; v++)
+        if (level[v] == sl)
+          for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++)
+            if (level[g.adjncy[j]] == sl + 1) {
+              where[v] = 2;
+              break;
+            }
+      pw[0] = pw[1] = pw[2] = 0;
+      for (integer v=0; v<n; v++)
+        pw[where[v]] += g.vwgt[v];
+    }
+
+    /**
+     * Coarsen g until it has at most coarsen_to vertices, or until
+     * coarsening no longer reduces the graph. G[l] is the graph at
+     * level l+1, with cmaps[l] mapping the vertices of level l to
+     * those of level l+1, level 0 is g itself.
+     */
+    template<typename integer> void
+    nd_coarsen_levels(const NDGraph<integer>& g, integer coarsen_to,
+                      std::vector<NDGraph<integer>>& G,
+                      std::vector<std::vector<integer>>& cmaps,
+                      std::mt19937& gen) {
+      const integer maxvwgt =
+        std::max(integer(1), integer(1.5 * g.weight() / coarsen_to));
+      auto graph = [&](std::size_t l) -> const NDGraph<integer>& {
+        return l ? G[l-1] : g; };
+      while (graph(G.size()).n > coarsen_to) {
+        std::vector<integer> cmap;
+        auto c = nd_coarsen(graph(G.size()), cmap, maxvwgt, gen);
+        if (c.n > 0.9 * graph(G.size()).n) break;
+        G.push_back(std::move(c));
+        cmaps.push_back(std::move(cmap));
+      }
+    }
+
+    /**
+     * Multilevel vertex bisection: coarsen, compute a number of
+     * initial separators on the coarsest graph, keep the best one
+     * and refine it while projecting back to the original graph.
+     */
+    template<typename integer> void
+    nd_multilevel(const NDGraph<integer>& g, std::vector<int>& where,
+                  integer* pw, integer maxpw, std::mt19937& gen) {
+      const int trials = 4, passes = 10;
+      std::vector<NDGraph<integer>> G;
+      std::vector<std::vector<integer>> cmaps;
+      nd_coarsen_levels(g, integer(100), G, cmaps, gen);
+      auto graph = [&](std::size_t l) -> const NDGraph<integer>& {
+        return l ? G[l-1] : g; };
+      const auto& gc = graph(G.size());
+      std::vector<int> w(gc.n);
+      std::uniform_int_distribution<integer> seed(0, gc.n-1);
+      integer tpw[3];
+      for (int t=0; t<trials; t++) {
+        nd_grow(gc, seed(gen), w, tpw);
+        nd_refine(gc, w, tpw, maxpw, passes);
+        if (t == 0 || nd_key(tpw, maxpw) < nd_key(pw, maxpw)) {
+          where = w;
+          std::copy(tpw, tpw+3, pw);
+        }
+      }
+      for (auto l=G.size(); l>0; l--) {
+        const auto& f = graph(l-1);
+        const auto& cmap = cmaps[l-1];
+        std::vector<int> fw(f.n);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(4096)
+#endif
+        for (integer v=0; v<f.n; v++)
+          fw[v] = where[cmap[v]];
+        where.swap(fw);
+        G.pop_back();
+        nd_refine(f, where, pw, maxpw, passes);
+      }
+    }
+
+    /**
+     * y = L x, with L the weighted Laplacian of g.
+     */
+    template<typename integer> void
+    nd_laplacian(const NDGraph<integer>& g, const std::vector<double>& x,
+                 std::vector<double>& y) {
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(4096)
+#endif
+      for (integer v=0; v<g.n; v++) {
+        double yv = 0.;
+        for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++)
+          yv += g.adjwgt[j] * (x[v] - x[g.adjncy[j]]);
+        y[v] = yv;
+      }
+    }
+
+    /**
+     * Dot product, summed per block of fixed size, so that the
+     * result does not depend on the number of threads.
+     */
+    inline double nd_dot(const std::vector<double>& x,
+                         const std::vector<double>& y) {
+      const std::size_t n = x.size(), B = 4096, nb = (n + B - 1) / B;
+      std::vector<double> part(nb);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared)
+#endif
+      for (std::size_t b=0; b<nb; b++) {
+        double s = 0.;
+        for (std::size_t i=b*B; i<std::min(n, (b+1)*B); i++)
+          s += x[i] * y[i];
+        part[b] = s;
+      }
+      return std::accumulate(part.begin(), part.end(), 0.);
+    }
+
+    /**
+     * Orthonormalize x against the constant vector (the null space
+     * of the Laplacian of a connected graph) and against the
+     * (orthonormal) vectors in Q. If Lx is not empty, it holds L x
+     * and is updated accordingly, using LQ, which holds L Q. Returns
+     * false if nothing is left of x.
+     */
+    inline bool
+    nd_orthonormalize(std::vector<double>& x, std::vector<double>& Lx,
+                      const std::vector<std::vector<double>>& Q,
+                      const std::vector<std::vector<double>>& LQ) {
+      const auto n = x.size();
+      const bool track = !Lx.empty();
+      const double nrm0 = std::sqrt(nd_dot(x, x));
+      if (nrm0 == 0.) return false;
+      for (int it=0; it<2; it++) {
+        double mean = std::accumulate(x.begin(), x.end(), 0.) / n;
+        for (auto& xi : x) xi -= mean;
+        for (std::size_t q=0; q<Q.size(); q++) {
+          double a = nd_dot(Q[q], x);
+          for (std::size_t i=0; i<n; i++) x[i] -= a * Q[q][i];
+          if (track)
+            for (std::size_t i=0; i<n; i++) Lx[i] -= a * LQ[q][i];
+        }
+      }
+      const double nrm = std::sqrt(nd_dot(x, x));
+      if (nrm <= 1e-10 * nrm0) return false;
+      for (auto& xi : x) xi /= nrm;
+      if (track) for (auto& yi : Lx) yi /= nrm;
+      return true;
+    }
+
+    /**
+     * Improve the approximate Fiedler vector x of g with a few
+     * iterations of LOBPCG, deflating the constant vector. The
+     * Rayleigh-Ritz problem on the subspace [x, r, p] is solved with
+     * dense LAPACK. L x and L p are updated along with x and p, so
+     * each iteration only requires a single product with L.
+     */
+    template<typename integer> void
+    nd_lobpcg(const NDGraph<integer>& g, std::vector<double>& x, int iters) {
+      const auto n = g.n;
+      std::vector<double> none, p, Lp, Lx(n);
+      if (!nd_orthonormalize(x, none, {}, {})) return;
+      nd_laplacian(g, x, Lx);
+      for (int it=0; it<iters; it++) {
+        const double lambda = nd_dot(x, Lx);
+        std::vector<double> r(n), Lr(n);
+        for (integer i=0; i<n; i++) r[i] = Lx[i] - lambda * x[i];
+        if (std::sqrt(nd_dot(r, r)) <= 1e-4 * lambda) break;
+        std::vector<std::vector<double>> S = {std::move(x)},
+          LS = {std::move(Lx)};
+        if (nd_orthonormalize(r, none, S, LS)) {
+          nd_laplacian(g, r, Lr);
+          S.push_back(std::move(r));
+          LS.push_back(std::move(Lr));
+        }
+        if (!p.empty() && nd_orthonormalize(p, Lp, S, LS)) {
+          S.push_back(std::move(p));
+          LS.push_back(std::move(Lp));
+        }
+        const int m = S.size();
+        x = std::move(S[0]);
+        Lx = std::move(LS[0]);
+        if (m == 1) break;
+        S[0] = x;
+        LS[0] = Lx;
+        std::vector<double> H(m*m), w(m);
+        for (int i=0; i<m; i++)
+          for (int j=0; j<=i; j++)
+            H[i+j*m] = H[j+i*m] = nd_dot(S[j], LS[i]);
+        if (blas::syev('V', 'U', m, H.data(), m, w.data())) break;
+        // smallest Ritz pair, p is the update without the x component
+        p.assign(n, 0.);
+        Lp.assign(n, 0.);
+        for (int k=1; k<m; k++)
+          for (integer i=0; i<n; i++) {
+            p[i] += H[k] * S[k][i];
+            Lp[i] += H[k] * LS[k][i];
+          }
+        for (integer i=0; i<n; i++) {
+          x[i] = H[0] * S[0][i] + p[i];
+          Lx[i] = H[0] * LS[0][i] + Lp[i];
+        }
+        if (!nd_orthonormalize(x, Lx, {}, {})) return;
+      }
+    }
+
+    /**
+     * Spectral vertex bisection. The Fiedler vector is computed with
+     * a dense eigensolver on the coarsest graph of a heavy-edge
+     * matching hierarchy, and interpolated and improved with LOBPCG
+     * on each finer level. The graph is split where the sorted
+     * Fiedler vector gives the smallest ratio cut, within the
+     * balance constraint. The smallest boundary is used as vertex
+     * separator, and is refined with FM. This falls back to
+     * nd_multilevel when the graph cannot be coarsened enough.
+     */
+    template<typename integer> void
+    nd_spectral(const NDGraph<integer>& g, std::vector<int>& where,
+                integer* pw, integer maxpw, std::mt19937& gen) {
+      const integer coarsen_to = 100, max_dense = 1000;
+      const int iters = 40, passes = 10;
+      std::vector<NDGraph<integer>> G;
+      std::vector<std::vector<integer>> cmaps;
+      nd_coarsen_levels(g, coarsen_to, G, cmaps, gen);
+      auto graph = [&](std::size_t l) -> const NDGraph<integer>& {
+        return l ? G[l-1] : g; };
+      const auto& gc = graph(G.size());
+      if (gc.n > max_dense || gc.n < 3) {
+        nd_multilevel(g, where, pw, maxpw, gen);
+        return;
+      }
+      const int nc = gc.n;
+      std::vector<double> L(nc*nc, 0.), lambda(nc), x(nc);
+      for (int v=0; v<nc; v++)
+        for (auto j=gc.xadj[v]; j<gc.xadj[v+1]; j++) {
+          L[v+v*nc] += gc.adjwgt[j];
+          L[v+gc.adjncy[j]*nc] -= gc.adjwgt[j];
+        }
+      if (blas::syev('V', 'U', nc, L.data(), nc, lambda.data())) {
+        nd_multilevel(g, where, pw, maxpw, gen);
+        return;
+      }
+      std::copy(L.begin()+nc, L.begin()+2*nc, x.begin());
+      for (auto l=G.size(); l>0; l--) {
+        const auto& f = graph(l-1);
+        const auto& cmap = cmaps[l-1];
+        std::vector<double> fx(f.n);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(4096)
+#endif
+        for (integer v=0; v<f.n; v++)
+          fx[v] = x[cmap[v]];
+        x.swap(fx);
+        G.pop_back();
+        nd_lobpcg(f, x, iters);
+      }
+      std::vector<integer> order(g.n);
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](integer a, integer b) {
+          return x[a] < x[b] || (x[a] == x[b] && a < b); });
+      // sweep over the splits of the sorted Fiedler vector that
+      // respect the balance constraint, keep the smallest ratio cut
+      const double tw = g.weight();
+      std::fill(where.begin(), where.end(), 1);
+      double cut = 0., w0 = 0., best = -1.;
+      std::size_t split = 0;
+      for (std::size_t i=0; i<order.size(); i++) {
+        auto v = order[i];
+        where[v] = 0;
+        w0 += g.vwgt[v];
+        for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++)
+          cut += (where[g.adjncy[j]] == 0) ? -g.adjwgt[j] : g.adjwgt[j];
+        if (w0 > maxpw) break;
+        if (tw - w0 > maxpw) continue;
+        double r = cut / (w0 * (tw - w0));
+        if (best < 0 || r < best) {
+          best = r;
+          split = i + 1;
+        }
+      }
+      if (best < 0) split = order.size() / 2;
+      for (std::size_t i=0; i<order.size(); i++)
+        where[order[i]] = (i < split) ? 0 : 1;
+      nd_boundary_separator(g, where, pw);
+      nd_refine(g, where, pw, maxpw, passes);
+    }
+
+    /**
+     * Compute a vertex separator for g, as the best of a multilevel
+     * bisection and a refined level-structure separator. The latter
+     * is often better on regular meshes. With spectral bisection,
+     * the spectral separator is a third candidate. All are computed
+     * concurrently near the top of the dissection tree.
+     */
+    template<typename integer> void
+    nd_bisect(const NDGraph<integer>& g, std::vector<int>& where,
+              integer* pw, NDBisection method, int depth) {
+      const int passes = 10;
+      const auto tw = g.weight();
+      const integer maxpw = std::max(integer(0.6 * tw), (tw + 1) / 2);
+      std::vector<int> lw(g.n), sw;
+      integer lpw[3], spw[3];
+#pragma omp task default(shared) if(depth < params::task_recursion_cutoff_level)
+      {
+        nd_level_separator(g, lw, lpw);
+        nd_refine(g, lw, lpw, maxpw, passes);
+      }
+      if (method == NDBisection::SPECTRAL) {
+#pragma omp task default(shared) if(depth < params::task_recursion_cutoff_level)
+        {
+          std::mt19937 gen(g.n);
+          sw.resize(g.n);
+          nd_spectral(g, sw, spw, maxpw, gen);
+        }
+      }
+      std::mt19937 gen(g.n);
+      nd_multilevel(g, where, pw, maxpw, gen);
+#pragma omp taskwait
+      if (nd_key(lpw, maxpw) < nd_key(pw, maxpw)) {
+        where.swap(lw);
+        std::copy(lpw, lpw+3, pw);
+      }
+      if (method == NDBisection::SPECTRAL &&
+          nd_key(spw, maxpw) <= nd_key(pw, maxpw)) {
+        where.swap(sw);
+        std::copy(spw, spw+3, pw);
+      }
+    }
+
+    /**
+     * Extract the subgraph induced by the vertices vtx, which all
+     * have where[v] == part, with lid the local index of each vertex
+     * in its part.
+     */
+    template<typename integer> void
+    nd_extract(const NDGraph<integer>& g, const std::vector<integer>& label,
+               const std::vector<int>& where, const std::vector<integer>& lid,
+               const std::vector<integer>& vtx, int part,
+               NDGraph<integer>& sub, std::vector<integer>& sublabel) {
+      const integer n = vtx.size();
+      sub.n = n;
+      sub.xadj.resize(n+1);
+      sub.vwgt.assign(n, 1);
+      sublabel.resize(n);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(4096)
+#endif
+      for (integer i=0; i<n; i++) {
+        auto v = vtx[i];
+        integer d = 0;
+        for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++)
+          if (where[g.adjncy[j]] == part) d++;
+        sub.xadj[i+1] = d;
+        sublabel[i] = label[v];
+      }
+      sub.xadj[0] = 0;
+      for (integer i=0; i<n; i++)
+        sub.xadj[i+1] += sub.xadj[i];
+      sub.adjncy.resize(sub.xadj[n]);
+      sub.adjwgt.assign(sub.xadj[n], 1);
+#if defined(STRUMPACK_USE_OPENMP_TASKLOOP)
+#pragma omp taskloop default(shared) grainsize(4096)
+#endif
+      for (integer i=0; i<n; i++) {
+        auto v = vtx[i];
+        auto e = sub.xadj[i];
+        for (auto j=g.xadj[v]; j<g.xadj[v+1]; j++)
+          if (where[g.adjncy[j]] == part)
+            sub.adjncy[e++] = lid[g.adjncy[j]];
+      }
+    }
+
+    /**
+     * Below this size, bisection no longer pays off and the subgraph
+     * is ordered with approximate minimum degree instead.
+     */
+    const int nd_amd_switch = 500;
+
+    /**
+     * Order a small graph with AMD and return the separator tree
+     * derived from its elimination tree.
+     */
+    template<typename integer> std::vector<NDNode<integer>>
+    nd_amd(const NDGraph<integer>& g, const std::vector<integer>& label,
+           integer* iperm) {
+      const auto n = g.n;
+      std::vector<AMDInt> xadj(n+1), adjncy(g.xadj[n]);
+      for (integer i=0; i<=n; i++) xadj[i] = g.xadj[i] + 1;
+      for (integer i=0; i<g.xadj[n]; i++) adjncy[i] = g.adjncy[i] + 1;
+      std::vector<AMDInt> ap(n), aip(n);
+      WRAPPER_amd(AMDInt(n), xadj.data(), adjncy.data(),
+                  aip.data(), ap.data());
+      std::vector<integer> p(n), ip(n);
+      for (integer i=0; i<n; i++) {
+        p[i] = ap[i] - 1;
+        ip[i] = aip[i] - 1;
+      }
+      auto stree = build_sep_tree_from_perm(g.xadj.data(), g.adjncy.data(), p, ip);
+      for (integer i=0; i<n; i++)
+        iperm[i] = label[ip[i]];
+      std::vector<NDNode<integer>> t(stree.separators());
+      for (integer s=0; s<stree.separators(); s++)
+        t[s] = {stree.sizes[s+1] - stree.sizes[s],
+                stree.lch[s], stree.rch[s]};
+      return t;
+    }
+
+    /**
+     * Order the graph g, with label the original indices of its
+     * vertices, in iperm[0, g.n). Returns the separator tree of g in
+     * postorder, with child indices local to this subtree.
+     */
+    template<typename integer> std::vector<NDNode<integer>>
+    nd_recurse(NDGraph<integer>& g, std::vector<integer>& label,
+               integer* iperm, integer leaf, NDBisection method,
+               int depth) {
+      const auto n = g.n;
+      if (n <= leaf) {
+        std::copy(label.begin(), label.end(), iperm);
+        return {{n, -1, -1}};
+      }
+      if (n <= nd_amd_switch) return nd_amd(g, label, iperm);
+      std::vector<int> where(n);
+      integer pw[3];
+      nd_bisect(g, where, pw, method, depth);
+      if (pw[0] == 0 || pw[1] == 0) {
+        std::copy(label.begin(), label.end(), iperm);
+        return {{n, -1, -1}};
+      }
+      std::vector<integer> lid(n), vtx[3];
+      for (integer v=0; v<n; v++) {
+        lid[v] = vtx[where[v]].size();
+        vtx[where[v]].push_back(v);
+      }
+      const integer n0 = vtx[0].size(), n1 = vtx[1].size(),
+        ns = vtx[2].size();
+      for (integer i=0; i<ns; i++)
+        iperm[n0+n1+i] = label[vtx[2][i]];
+      NDGraph<integer> g0, g1;
+      std::vector<integer> l0, l1;
+      nd_extract(g, label, where, lid, vtx[0], 0, g0, l0);
+      nd_extract(g, label, where, lid, vtx[1], 1, g1, l1);
+      // release the memory before recursing
+      g = NDGraph<integer>();
+      std::vector<integer>().swap(label);
+      std::vector<NDNode<integer>> t0, t1;
+      if (depth < params::task_recursion_cutoff_level) {
+#pragma omp task untied default(shared)                                 \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        t0 = nd_recurse(g0, l0, iperm, leaf, method, depth+1);
+#pragma omp task untied default(shared)                                 \
+  final(depth >= params::task_recursion_cutoff_level-1) mergeable
+        t1 = nd_recurse(g1, l1, iperm+n0, leaf, method, depth+1);
+#pragma omp taskwait
+      } else {
+        t0 = nd_recurse(g0, l0, iperm, leaf, method, depth+1);
+        t1 = nd_recurse(g1, l1, iperm+n0, leaf, method, depth+1);
+      }
+      auto t = std::move(t0);
+      const integer off = t.size();
+      t.reserve(off + t1.size() + 1);
+      for (const auto& nd : t1)
+        t.push_back({nd.size, (nd.lch == -1) ? -1 : nd.lch + off,
+                     (nd.rch == -1) ? -1 : nd.rch + off});
+      t.push_back({ns, off-1, integer(t.size())-1});
+      return t;
+    }
+
+    template<typename integer> SeparatorTree<integer>
+    mtnd(integer n, const integer* xadj, const integer* adjncy,
+         integer* iperm, integer leaf, NDBisection method) {
+      if (n <= 0) return SeparatorTree<integer>();
+      NDGraph<integer> g;
+      g.n = n;
+      g.xadj.assign(xadj, xadj+n+1);
+      g.adjncy.assign(adjncy, adjncy+xadj[n]);
+      g.vwgt.assign(n, 1);
+      g.adjwgt.assign(xadj[n], 1);
+      std::vector<integer> label(n);
+      std::iota(label.begin(), label.end(), 0);
+      std::vector<NDNode<integer>> t;
+#pragma omp parallel default(shared)
+#pragma omp single
+      t = nd_recurse(g, label, iperm, leaf, method, 0);
+      std::vector<Separator<integer>> tree;
+      tree.reserve(t.size());
+      integer end = 0;
+      for (const auto& nd : t) {
+        end += nd.size;
+        tree.emplace_back(end, -1, nd.lch, nd.rch);
+      }
+      for (std::size_t i=0; i<tree.size(); i++) {
+        if (tree[i].lch != -1) tree[tree[i].lch].pa = i;
+        if (tree[i].rch != -1) tree[tree[i].rch].pa = i;
+      }
+      return SeparatorTree<integer>(tree);
+    }
+
+    // explicit template instantiation
+    template SeparatorTree<int>
+    mtnd(int n, const int* xadj, const int* adjncy, int* iperm, int leaf,
+         NDBisection method);
+    template SeparatorTree<long int>
+    mtnd(long int n, const long int* xadj, const long int* adjncy,
+         long int* iperm, long int leaf, NDBisection method);
+    template SeparatorTree<long long int>
+    mtnd(long long int n, const long long int* xadj,
+         const long long int* adjncy, long long int* iperm,
+         long long int leaf, NDBisection method);
+
+  } // end namespace ordering
+} // end namespace strumpack
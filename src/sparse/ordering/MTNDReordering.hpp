@@ -0,0 +1,113 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef STRUMPACK_ORDERING_MTND_REORDERING_HPP
+#define STRUMPACK_ORDERING_MTND_REORDERING_HPP
+
+#include <vector>
+#include <iostream>
+
+#include "StrumpackOptions.hpp"
+#include "sparse/SeparatorTree.hpp"
+#include "misc/Tools.hpp"
+
+
+namespace strumpack {
+  namespace ordering {
+
+    /**
+     * How the graphs are bisected in mtnd.
+     */
+    enum class NDBisection {
+      MULTILEVEL,  /*!< multilevel, greedy graph growing + FM   */
+      SPECTRAL     /*!< multilevel Fiedler vector, ratio cut + FM */
+    };
+
+    /**
+     * Multithreaded multilevel nested dissection. Each (sub)graph is
+     * bisected with a vertex separator, computed by heavy-edge
+     * matching coarsening, greedy graph growing on the coarsest
+     * graph and vertex-separator FM refinement during uncoarsening,
+     * or from a refined level structure if that gives a better
+     * separator. The two halves are then ordered recursively, as
+     * OpenMP tasks. Separators are numbered after the two halves and
+     * the separator tree is constructed directly from the
+     * recursion. Small subgraphs are ordered with AMD.
+     *
+     * \param n number of vertices
+     * \param xadj, adjncy graph, without self-loops, symmetric
+     * \param iperm on output, iperm[i] is the original index of the
+     * vertex ordered at position i, should be of size n
+     * \param leaf do not bisect graphs with at most leaf vertices
+     * \param method use multilevel or spectral bisection
+     */
+    template<typename integer> SeparatorTree<integer>
+    mtnd(integer n, const integer* xadj, const integer* adjncy,
+         integer* iperm, integer leaf,
+         NDBisection method=NDBisection::MULTILEVEL);
+
+    template<typename scalar_t,typename integer_t>
+    SeparatorTree<integer_t>
+    mtnd_reordering(integer_t n, const integer_t* ptr, const integer_t* ind,
+                    std::vector<integer_t>& perm,
+                    std::vector<integer_t>& iperm,
+                    const SPOptions<scalar_t>& opts,
+                    NDBisection method=NDBisection::MULTILEVEL) {
+      std::vector<integer_t> xadj(n+1), adjncy(ptr[n]);
+      integer_t e = 0;
+      for (integer_t j=0; j<n; j++) {
+        xadj[j] = e;
+        for (integer_t t=ptr[j]; t<ptr[j+1]; t++)
+          if (ind[t] != j) adjncy[e++] = ind[t];
+      }
+      xadj[n] = e;
+      if (e==0)
+        if (mpi_root())
+          std::cerr << "# WARNING: matrix seems to be diagonal!" << std::endl;
+      auto stree = mtnd
+        (n, xadj.data(), adjncy.data(), iperm.data(),
+         std::max(integer_t(1), integer_t(opts.nd_param())), method);
+      for (integer_t i=0; i<n; i++)
+        perm[iperm[i]] = i;
+      return stree;
+    }
+
+    template<typename scalar_t,typename integer_t,typename G>
+    SeparatorTree<integer_t>
+    mtnd_reordering(const G& A, std::vector<integer_t>& perm,
+                    std::vector<integer_t>& iperm,
+                    const SPOptions<scalar_t>& opts,
+                    NDBisection method=NDBisection::MULTILEVEL) {
+      return mtnd_reordering<scalar_t,integer_t>
+        (A.size(), A.ptr(), A.ind(), perm, iperm, opts, method);
+    }
+
+  } // end namespace ordering
+} // end namespace strumpack
+
+#endif // STRUMPACK_ORDERING_MTND_REORDERING_HPP
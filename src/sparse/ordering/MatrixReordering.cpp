@@ -38,6 +38,7 @@
 #include "sparse/fronts/Front.hpp"
 #include "sparse/SeparatorTree.hpp"
 #include "sparse/CSRMatrix.hpp"
+#include "misc/BinaryIO.hpp"
 #if defined(STRUMPACK_USE_MPI)
 #include "misc/MPIWrapper.hpp"
 #include "sparse/CSRMatrixMPI.hpp"
@@ -54,10 +55,13 @@
 #endif
 #include "RCMReordering.hpp"
 #include "ANDSparspak.hpp"
+#include "MTNDReordering.hpp"
 #include "GeometricReordering.hpp"
 #include "minimum_degree/AMDReordering.hpp"
 #include "minimum_degree/MMDReordering.hpp"
-// #include "spectral/SpectralReordering.hpp"
+#include "minimum_degree/MLFReordering.hpp"
+#include "SpectralReordering.hpp"
+#include "AutoReordering.hpp"
 
 namespace strumpack {
 
@@ -114,16 +118,21 @@ namespace strumpack {
       tree_ = ordering::and_reordering(A, perm_, iperm_);
       break;
     }
+    case ReorderingStrategy::MTND: {
+      tree_ = ordering::mtnd_reordering(A, perm_, iperm_, opts);
+      break;
+    }
     case ReorderingStrategy::MLF: {
-      std::cerr << "# ERROR: MLF ordering not supported." << std::endl;
-      return 1;
+      tree_ = ordering::mlf_reordering(A, perm_, iperm_);
+      break;
     }
     case ReorderingStrategy::SPECTRAL: {
-      std::cerr << "# ERROR: spectral ordering not supported." << std::endl;
-      return 1;
-      // tree_ = ordering::spectral_nd
-      //   (A, perm_, iperm_, opts.ND_options());
-      // break;
+      tree_ = ordering::spectral_nd(A, perm_, iperm_, opts);
+      break;
+    }
+    case ReorderingStrategy::AUTO: {
+      tree_ = ordering::auto_reordering(A, perm_, iperm_, opts);
+      break;
     }
     default:
       std::cerr << "# ERROR: parallel matrix reorderings are"
@@ -149,17 +158,59 @@ namespace strumpack {
     return 0;
   }
 
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::move_to_end
+  (const std::vector<integer_t>& vars) {
+    integer_t n = perm_.size(), m = vars.size();
+    std::vector<integer_t> pos(n, -1), cnt(n+1);
+    for (integer_t k=0; k<m; k++)
+      pos[vars[k]] = n - m + k;
+    // cnt[k] is the number of remaining variables before position k
+    integer_t r = 0;
+    for (integer_t k=0; k<n; k++) {
+      cnt[k] = r;
+      auto i = iperm_[k];
+      if (pos[i] == -1) pos[i] = r++;
+    }
+    cnt[n] = r;
+    for (integer_t s=0; s<=tree_.separators(); s++)
+      tree_.sizes[s] = cnt[tree_.sizes[s]];
+    for (integer_t i=0; i<n; i++) {
+      perm_[i] = pos[i];
+      iperm_[pos[i]] = i;
+    }
+  }
+
   template<typename scalar_t,typename integer_t> void
   MatrixReordering<scalar_t,integer_t>::clear_tree_data() {
     tree_ = SeparatorTree<integer_t>();
   }
 
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::write(BinaryWriter& w) const {
+    w.write_vector(perm_);
+    w.write_vector(iperm_);
+    w.write_vector(tree_.serialize());
+  }
+
+  template<typename scalar_t,typename integer_t> void
+  MatrixReordering<scalar_t,integer_t>::read(BinaryReader& r) {
+    std::vector<integer_t> t;
+    r.read_vector(perm_);
+    r.read_vector(iperm_);
+    r.read_vector(t);
+    if (r.good() && !t.empty())
+      tree_ = SeparatorTree<integer_t>::deserialize(t);
+  }
+
   // reorder the vertices in the separator to get a better rank structure
   template<typename scalar_t,typename integer_t> void
   MatrixReordering<scalar_t,integer_t>::separator_reordering
   (const Opts_t& opts, CSR_t& A, F_t* F) {
     auto N = A.size();
     std::vector<integer_t> sorder(N);
+    // variables not in any separator, see move_to_end, stay in place
+    std::iota(sorder.begin(), sorder.end(), 0);
 #pragma omp parallel
 #pragma omp single
     F->partition_fronts(opts, A, sorder.data());
@@ -43,6 +43,8 @@ namespace strumpack {
 
   template<typename scalar_t,typename integer_t> class CSRMatrix;
   template<typename scalar_t,typename integer_t> class Front;
+  class BinaryWriter;
+  class BinaryReader;
 
   template<typename scalar_t,typename integer_t> class MatrixReordering {
     using Opts_t = SPOptions<scalar_t>;
@@ -61,10 +63,22 @@ namespace strumpack {
     int set_permutation(const Opts_t& opts, const CSR_t& A,
                         const int* p, int base);
 
+    /**
+     * Move the variables vars (original numbering) to the end of the
+     * permutation, in the given order, after the root separator. The
+     * separators are shrunk accordingly, so vars are not part of any
+     * separator in the tree. The root front then has (a subset of)
+     * vars as update indices, see SparseSolver::factor_schur.
+     */
+    void move_to_end(const std::vector<integer_t>& vars);
+
     void separator_reordering(const Opts_t& opts, CSR_t& A, F_t* F);
 
     virtual void clear_tree_data();
 
+    void write(BinaryWriter& w) const;
+    void read(BinaryReader& r);
+
     const std::vector<integer_t>& perm() const { return perm_; }
     const std::vector<integer_t>& iperm() const { return iperm_; }
 
@@ -48,9 +48,12 @@
 #include "GeometricReorderingMPI.hpp"
 #include "RCMReordering.hpp"
 #include "ANDSparspak.hpp"
+#include "MTNDReordering.hpp"
 #include "minimum_degree/AMDReordering.hpp"
 #include "minimum_degree/MMDReordering.hpp"
-// #include "spectral/SpectralReordering.hpp"
+#include "minimum_degree/MLFReordering.hpp"
+#include "SpectralReordering.hpp"
+#include "AutoReordering.hpp"
 
 
 namespace strumpack {
@@ -113,16 +116,23 @@ namespace strumpack {
           global_sep_tree = ordering::and_reordering(*Aseq, perm_, iperm_);
           break;
         }
+        case ReorderingStrategy::MTND: {
+          global_sep_tree = ordering::mtnd_reordering
+            (*Aseq, perm_, iperm_, opts);
+          break;
+        }
         case ReorderingStrategy::MLF: {
-          std::cerr << "# ERROR: MLF ordering not supported." << std::endl;
-          return 1;
+          global_sep_tree = ordering::mlf_reordering(*Aseq, perm_, iperm_);
+          break;
         }
         case ReorderingStrategy::SPECTRAL: {
-          std::cerr << "# ERROR: spectral ordering not supported." << std::endl;
-          return 1;
-          // global_sep_tree = ordering::spectral_nd
-          //   (*Aseq, perm_, iperm_, opts.ND_options());
-          // break;
+          global_sep_tree = ordering::spectral_nd(*Aseq, perm_, iperm_, opts);
+          break;
+        }
+        case ReorderingStrategy::AUTO: {
+          global_sep_tree = ordering::auto_reordering
+            (*Aseq, perm_, iperm_, opts);
+          break;
         }
         default: assert(true);
         }
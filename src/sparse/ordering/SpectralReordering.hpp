@@ -0,0 +1,60 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#ifndef STRUMPACK_ORDERING_SPECTRAL_REORDERING_HPP
+#define STRUMPACK_ORDERING_SPECTRAL_REORDERING_HPP
+
+#include "MTNDReordering.hpp"
+
+namespace strumpack {
+  namespace ordering {
+
+    /**
+     * Spectral nested dissection. This uses the same multithreaded
+     * dissection as mtnd_reordering, but also bisects each subgraph
+     * by sorting the entries of its Fiedler vector, the eigenvector
+     * of the second smallest eigenvalue of the graph Laplacian, and
+     * splitting where the ratio cut is smallest. The Fiedler vector
+     * is computed on a coarsened graph and improved with LOBPCG
+     * while uncoarsening, the resulting separator is refined with
+     * FM. The spectral separator competes with the multilevel and
+     * the level-structure separators, and is kept unless one of
+     * those is smaller, or as small and better balanced.
+     */
+    template<typename scalar_t,typename integer_t,typename G>
+    SeparatorTree<integer_t>
+    spectral_nd(const G& A, std::vector<integer_t>& perm,
+                std::vector<integer_t>& iperm,
+                const SPOptions<scalar_t>& opts) {
+      return mtnd_reordering(A, perm, iperm, opts, NDBisection::SPECTRAL);
+    }
+
+  } // end namespace ordering
+} // end namespace strumpack
+
+#endif // STRUMPACK_ORDERING_SPECTRAL_REORDERING_HPP
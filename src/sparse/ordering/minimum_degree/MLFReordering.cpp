@@ -0,0 +1,338 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+#include "MLFReordering.hpp"
+
+namespace strumpack {
+  namespace ordering {
+
+    /**
+     * Elimination graph for minimum local fill, with sorted
+     * adjacency lists. Vertices with the same closed neighborhood
+     * are merged into supervariables, with nv_ the number of
+     * original vertices in each, and are eliminated together. The
+     * fill and degree are counted in original vertices.
+     */
+    template<typename integer> class MLFGraph {
+    public:
+      MLFGraph(integer n, const integer* xadj, const integer* adjncy)
+        : adj_(n), nv_(n, 1), next_(n, -1), tail_(n),
+          mark_(n, 0), bmark_(n, 0), clique_(n, 0),
+          fill_(n), deg_(n), live_(n) {
+        for (integer v=0; v<n; v++) {
+          adj_[v].assign(adjncy+xadj[v], adjncy+xadj[v+1]);
+          std::sort(adj_[v].begin(), adj_[v].end());
+          adj_[v].erase(std::unique(adj_[v].begin(), adj_[v].end()),
+                        adj_[v].end());
+          edges_ += adj_[v].size();
+          tail_[v] = v;
+        }
+        edges_ /= 2;
+        for (integer v=0; v<n; v++) {
+          fill_[v] = fill(v);
+          deg_[v] = adj_[v].size();
+        }
+      }
+
+      /** fill created by eliminating v */
+      std::int64_t fill_of(integer v) const { return fill_[v]; }
+      /** number of original vertices adjacent to v */
+      std::int64_t degree(integer v) const { return deg_[v]; }
+      /** false if v was merged in another supervariable */
+      bool live(integer v) const { return nv_[v] > 0; }
+      /** next vertex in the supervariable, or -1 */
+      integer next(integer v) const { return next_[v]; }
+
+      /**
+       * True if the remaining supervariables form a clique, so
+       * eliminating them in any order does not create more fill.
+       */
+      bool is_clique() const {
+        return edges_ == live_ * (live_ - 1) / 2;
+      }
+
+      /**
+       * Eliminate v, turning its neighborhood into a clique, and
+       * update the fill and degree of the other supervariables. The
+       * live supervariables whose fill or degree changed are returned
+       * in changed.
+       */
+      void eliminate(integer v, std::vector<integer>& changed) {
+        auto av = std::move(adj_[v]);
+        adj_[v].clear();
+        edges_ -= av.size();
+        live_--;
+        changed.assign(av.begin(), av.end());
+        // new edges, computed before the adjacency lists are updated
+        std::vector<std::pair<integer,integer>> fe;
+        next_stamp();
+        for (auto u : av) mark_[u] = stamp_;
+        for (auto u : av) clique_[u] = 1;
+        for (auto u : av) {
+          auto& au = adj_[u];
+          au.erase(std::lower_bound(au.begin(), au.end(), v));
+          std::vector<integer> merged;
+          merged.reserve(au.size() + av.size());
+          auto a = au.begin();
+          for (auto b : av) {
+            if (b == u) continue;
+            while (a != au.end() && *a < b) merged.push_back(*a++);
+            if (a != au.end() && *a == b) merged.push_back(*a++);
+            else {
+              merged.push_back(b);
+              if (u < b) fe.emplace_back(u, b);
+            }
+          }
+          merged.insert(merged.end(), a, au.end());
+          au.swap(merged);
+        }
+        edges_ += fe.size();
+        // a vertex outside of N(v) only sees its fill change if it is
+        // adjacent to both endpoints of a new edge, which is then no
+        // longer missing from its neighborhood
+        for (const auto& e : fe) {
+          const auto& a = adj_[e.first];
+          const auto& b = adj_[e.second];
+          const std::int64_t w = std::int64_t(nv_[e.first]) * nv_[e.second];
+          std::size_t i = 0, j = 0;
+          while (i < a.size() && j < b.size()) {
+            if (a[i] < b[j]) i++;
+            else if (b[j] < a[i]) j++;
+            else {
+              auto x = a[i];
+              if (!clique_[x]) {
+                if (mark_[x] != stamp_) {
+                  mark_[x] = stamp_;
+                  changed.push_back(x);
+                }
+                fill_[x] -= w;
+              }
+              i++; j++;
+            }
+          }
+        }
+        merge_indistinguishable(av);
+        for (auto u : av)
+          if (live(u)) fill_[u] = clique_fill(u);
+        for (auto u : av) clique_[u] = 0;
+        changed.erase
+          (std::remove_if(changed.begin(), changed.end(),
+                          [&](integer u) { return !live(u); }),
+           changed.end());
+      }
+
+    private:
+      std::vector<std::vector<integer>> adj_;
+      std::vector<integer> nv_, next_, tail_;
+      std::vector<std::int64_t> mark_, bmark_;
+      std::vector<char> clique_;
+      std::vector<std::int64_t> fill_, deg_;
+      std::int64_t stamp_ = 0, edges_ = 0, live_ = 0;
+
+      void next_stamp() { stamp_++; }
+
+      /**
+       * Fill of v computed from scratch: the weight of the pairs of
+       * neighbors of v that are not adjacent.
+       */
+      std::int64_t fill(integer v) {
+        const auto& av = adj_[v];
+        std::int64_t W = 0;
+        next_stamp();
+        for (auto u : av) {
+          mark_[u] = stamp_;
+          W += nv_[u];
+        }
+        std::int64_t s = 0;
+        for (auto u : av) {
+          std::int64_t c = 0;
+          for (auto w : adj_[u])
+            if (mark_[w] == stamp_) c += nv_[w];
+          s += std::int64_t(nv_[u]) * (W - nv_[u] - c);
+        }
+        return s / 2;
+      }
+
+      /**
+       * Fill of a supervariable u in the clique (marked in clique_)
+       * that was just formed, also updates its degree. Pairs within
+       * the clique are adjacent, so only the neighbors b of u outside
+       * of the clique, the set B, need to be considered. With c_b
+       * the weight of the neighbors of u adjacent to b, the sum of
+       * nv(b) (W-nv(b)-c_b) over B counts missing pairs between the
+       * clique and B once, and missing pairs within B twice.
+       */
+      std::int64_t clique_fill(integer u) {
+        const auto& au = adj_[u];
+        next_stamp();
+        std::int64_t W = 0, WB = 0;
+        for (auto w : au) {
+          mark_[w] = stamp_;
+          W += nv_[w];
+          if (!clique_[w]) {
+            bmark_[w] = stamp_;
+            WB += nv_[w];
+          }
+        }
+        deg_[u] = W;
+        std::int64_t s = 0, sB = 0;
+        for (auto b : au) {
+          if (clique_[b]) continue;
+          std::int64_t c = 0, cB = 0;
+          for (auto w : adj_[b])
+            if (mark_[w] == stamp_) {
+              c += nv_[w];
+              if (bmark_[w] == stamp_) cB += nv_[w];
+            }
+          s += std::int64_t(nv_[b]) * (W - nv_[b] - c);
+          sB += std::int64_t(nv_[b]) * (WB - nv_[b] - cB);
+        }
+        return s - sB / 2;
+      }
+
+      /**
+       * Only supervariables in the new clique K can have become
+       * indistinguishable. Candidates are found by hashing their
+       * closed neighborhoods. Merging does not change the fill or
+       * the degree of any other supervariable.
+       */
+      void merge_indistinguishable(const std::vector<integer>& K) {
+        std::vector<std::tuple<std::int64_t,std::size_t,integer>> h;
+        h.reserve(K.size());
+        for (auto u : K) {
+          std::int64_t s = u;
+          for (auto w : adj_[u]) s += w;
+          h.emplace_back(s, adj_[u].size(), u);
+        }
+        std::sort(h.begin(), h.end());
+        std::vector<integer> absorbing;
+        for (std::size_t i=0; i<h.size(); ) {
+          std::size_t e = i + 1;
+          while (e < h.size() && std::get<0>(h[e]) == std::get<0>(h[i]) &&
+                 std::get<1>(h[e]) == std::get<1>(h[i])) e++;
+          for (auto a=i; a<e; a++) {
+            auto u = std::get<2>(h[a]);
+            if (!live(u)) continue;
+            bool merged = false;
+            next_stamp();
+            mark_[u] = stamp_;
+            for (auto w : adj_[u]) mark_[w] = stamp_;
+            for (auto b=a+1; b<e; b++) {
+              auto w = std::get<2>(h[b]);
+              if (!live(w) || mark_[w] != stamp_) continue;
+              if (!std::all_of(adj_[w].begin(), adj_[w].end(),
+                               [&](integer x) { return mark_[x] == stamp_; }))
+                continue;
+              nv_[u] += nv_[w];
+              nv_[w] = 0;
+              next_[tail_[u]] = w;
+              tail_[u] = tail_[w];
+              edges_ -= adj_[w].size();
+              live_--;
+              std::vector<integer>().swap(adj_[w]);
+              merged = true;
+            }
+            if (merged) absorbing.push_back(u);
+          }
+          i = e;
+        }
+        if (absorbing.empty()) return;
+        // remove the merged supervariables from the adjacency lists
+        next_stamp();
+        auto compact = [&](integer x) {
+          if (mark_[x] == stamp_) return;
+          mark_[x] = stamp_;
+          auto& ax = adj_[x];
+          ax.erase(std::remove_if(ax.begin(), ax.end(),
+                                  [&](integer y) { return !live(y); }),
+                   ax.end());
+        };
+        for (auto u : absorbing) {
+          compact(u);
+          for (auto x : adj_[u]) compact(x);
+        }
+      }
+    };
+
+    template<typename integer> void
+    mlf(integer n, const integer* xadj, const integer* adjncy,
+        integer* perm, integer* iperm) {
+      if (n <= 0) return;
+      MLFGraph<integer> g(n, xadj, adjncy);
+      using key_t = std::tuple<std::int64_t,std::int64_t,integer>;
+      std::priority_queue<key_t,std::vector<key_t>,std::greater<key_t>> pq;
+      for (integer v=0; v<n; v++)
+        pq.emplace(g.fill_of(v), g.degree(v), v);
+      std::vector<char> done(n, 0);
+      std::vector<integer> changed;
+      integer k = 0;
+      auto order = [&](integer v) {
+        done[v] = 1;
+        for (auto u=v; u!=-1; u=g.next(u)) iperm[k++] = u;
+      };
+      while (k < n) {
+        if (g.is_clique()) {
+          // the remaining graph is a clique, no more fill
+          for (integer v=0; v<n; v++)
+            if (!done[v] && g.live(v)) order(v);
+          break;
+        }
+        auto top = pq.top();
+        pq.pop();
+        auto v = std::get<2>(top);
+        if (done[v] || !g.live(v) || std::get<0>(top) != g.fill_of(v) ||
+            std::get<1>(top) != g.degree(v))
+          continue;
+        order(v);
+        g.eliminate(v, changed);
+        for (auto u : changed)
+          pq.emplace(g.fill_of(u), g.degree(u), u);
+      }
+      for (integer i=0; i<n; i++)
+        perm[iperm[i]] = i;
+    }
+
+    // explicit template instantiation
+    template void mlf(int n, const int* xadj, const int* adjncy,
+                      int* perm, int* iperm);
+    template void mlf(long int n, const long int* xadj,
+                      const long int* adjncy,
+                      long int* perm, long int* iperm);
+    template void mlf(long long int n, const long long int* xadj,
+                      const long long int* adjncy,
+                      long long int* perm, long long int* iperm);
+
+  } // end namespace ordering
+} // end namespace strumpack
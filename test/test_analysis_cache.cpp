@@ -0,0 +1,129 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "misc/RandomWrapper.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+
+/**
+ * Solve twice with the same analysis cache file. The first solve
+ * writes the cache, the second one reads it. Both should give the
+ * same solution. A third solve, with a different nested dissection
+ * parameter, should not use the cache.
+ */
+template<typename scalar_t,typename integer_t> int
+test_analysis_cache(int argc, const char* const argv[],
+                    CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  string fname("strumpack_analysis_cache_test.bin");
+  remove(fname.c_str());
+  int N = A.size();
+  vector<scalar_t> b(N), x0(N), x1(N), x2(N), x_exact(N);
+  {
+    auto rgen = random::make_default_random_generator<real_t>();
+    for (auto& xi : x_exact)
+      xi = rgen->get();
+  }
+  A.spmv(x_exact.data(), b.data());
+
+  for (auto x : {&x0, &x1, &x2}) {
+    StrumpackSparseSolver<scalar_t,integer_t> spss;
+    spss.options().set_from_command_line(argc, argv);
+    spss.options().set_analysis_cache(fname);
+    if (x == &x2)
+      spss.options().set_nd_param(spss.options().nd_param() + 1);
+    spss.set_matrix(A);
+    if (spss.solve(b.data(), x->data()) != ReturnCode::SUCCESS) {
+      cout << "problem solving with the analysis cache." << endl;
+      return 1;
+    }
+    if (spss.analysis_cache_hit() != (x == &x1)) {
+      cout << "analysis cache was " << (x == &x1 ? "not " : "")
+           << "used." << endl;
+      return 1;
+    }
+    if (!ifstream(fname).good()) {
+      cout << "analysis cache file was not written." << endl;
+      return 1;
+    }
+    auto comp_scal_res = A.max_scaled_residual(x->data(), b.data());
+    cout << "# COMPONENTWISE SCALED RESIDUAL = "
+         << comp_scal_res << endl;
+    if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+      cout << "RESIDUAL TOO LARGE!" << endl;
+      return 1;
+    }
+  }
+  remove(fname.c_str());
+  blas::axpy(N, scalar_t(-1.), x0.data(), 1, x1.data(), 1);
+  auto nrm_diff = blas::nrm2(N, x1.data(), 1);
+  cout << "# ||x_cached - x|| = " << nrm_diff << endl;
+  if (nrm_diff != real_t(0.)) {
+    cout << "SOLUTION WITH CACHED ANALYSIS DIFFERS!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f) == 0)
+    return test_analysis_cache(argc, argv, A);
+  else {
+    CSRMatrix<complex<real_t>,integer_t> Acomplex;
+    if (Acomplex.read_matrix_market(f)) {
+      std::cerr << "Could not read matrix from file." << std::endl;
+      return 1;
+    }
+    return test_analysis_cache(argc, argv, Acomplex);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Solve twice with a matrix given in matrix market format,\n"
+      << "reusing the ordering and symbolic factorization.\n\n"
+      << "Usage: \n\t./test_analysis_cache pde900.mtx" << endl;
+    return 1;
+  }
+  int ierr = read_matrix_and_run_tests<double,int>(argc, argv);
+  if (ierr) return ierr;
+  return read_matrix_and_run_tests<double,long long int>(argc, argv);
+}
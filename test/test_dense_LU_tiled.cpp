@@ -0,0 +1,115 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+using namespace std;
+
+#include "dense/DenseMatrix.hpp"
+#include "dense/BLASLAPACKOpenMPTask.hpp"
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e3
+
+/**
+ * Partial LU factorization of a random front [A11 A12; A21 A22] with
+ * the tiled task graph, or with the kernel for small fronts,
+ * compared to the inverse of A11 and the Schur complement A22 - A21
+ * inv(A11) A12 computed with a regular LU.
+ */
+template<typename scalar_t> int test_tiled_LU(int n, int m, bool small) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  DenseMatrix<scalar_t> A11(n, n), A12(n, m), A21(m, n), A22(m, m);
+  auto rgen = random::make_default_random_generator<real_t>();
+  A11.random(*rgen); A12.random(*rgen);
+  A21.random(*rgen); A22.random(*rgen);
+  DenseMatrix<scalar_t> B(n, 3);
+  B.random(*rgen);
+  auto F11(A11), F12(A12), F21(A21), F22(A22), LU11(A11);
+
+  // reference: X = inv(A11) A12, S = A22 - A21 X
+  auto piv = LU11.LU();
+  auto X = LU11.solve(A12, piv), Y = LU11.solve(B, piv);
+  DenseMatrix<scalar_t> S(A22);
+  gemm(Trans::N, Trans::N, scalar_t(-1.), A21, X, scalar_t(1.), S);
+
+  std::vector<int> tpiv(n);
+  int info = 0;
+  if (small)
+    info = getrf_small
+      (n, m, F11.data(), F11.ld(), F12.data(), F12.ld(),
+       F21.data(), F21.ld(), F22.data(), F22.ld(), tpiv.data(), 0.);
+  else {
+#pragma omp parallel
+#pragma omp single
+    info = getrf_tiled_omp_task
+      (n, m, F11.data(), F11.ld(), F12.data(), F12.ld(),
+       F21.data(), F21.ld(), F22.data(), F22.ld(), tpiv.data(), 0.);
+  }
+  if (info) {
+    cout << "# " << (small ? "getrf_small" : "getrf_tiled_omp_task")
+         << " failed, info = " << info << endl;
+    return 1;
+  }
+  // the factors of A11, with all row interchanges
+  auto Y2 = F11.solve(B, tpiv);
+  Y2.scaled_add(scalar_t(-1.), Y);
+  auto eY = Y2.normF() / Y.normF(), eX = real_t(0.), eS = real_t(0.);
+  if (m) {
+    // F12 = inv(L) P A12, so X = inv(U) F12
+    trsm(Side::L, UpLo::U, Trans::N, Diag::N, scalar_t(1.), F11, F12);
+    F12.scaled_add(scalar_t(-1.), X);
+    F22.scaled_add(scalar_t(-1.), S);
+    eX = F12.normF() / X.normF();
+    eS = F22.normF() / S.normF();
+  }
+  auto eps = blas::lamch<real_t>('E');
+  cout << "# n = " << n << ", m = " << m
+       << ", rel. error inv(A11) B = " << eY
+       << ", rel. error inv(A11) A12 = " << eX
+       << ", rel. error Schur complement = " << eS << endl;
+  if (std::max(eY, std::max(eX, eS)) > ERROR_TOLERANCE * n * eps) {
+    cout << "ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  // sizes which are, and are not, multiples of the tile size
+  for (auto n : {4*TiledLUTileSize, 4*TiledLUTileSize+37})
+    for (auto m : {0, 2*TiledLUTileSize+5}) {
+      if (test_tiled_LU<double>(n, m, false)) return 1;
+      if (test_tiled_LU<std::complex<float>>(n, m, false)) return 1;
+    }
+  for (auto n : {1, 7, BatchedFrontSize/2})
+    for (auto m : {0, 5, BatchedFrontSize-n}) {
+      if (test_tiled_LU<double>(n, m, true)) return 1;
+      if (test_tiled_LU<std::complex<float>>(n, m, true)) return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,263 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "misc/RandomWrapper.hpp"
+#include "misc/BinaryIO.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+
+vector<char> read_file(const string& fname) {
+  ifstream f(fname, ifstream::binary);
+  return vector<char>(istreambuf_iterator<char>(f),
+                      istreambuf_iterator<char>());
+}
+void write_file(const string& fname, const vector<char>& d) {
+  ofstream f(fname, ofstream::binary);
+  f.write(d.data(), d.size());
+}
+
+/**
+ * Find the CSR row pointer of the (permuted) n x n matrix in a
+ * factors file: the array length n+1, followed, at the next 64 byte
+ * boundary, by n+1 sorted integers starting at 0. Returns the offset
+ * of the length, or the size of the file if not found.
+ */
+template<typename integer_t> size_t
+find_row_ptr(const vector<char>& f, integer_t n) {
+  vector<integer_t> ptr(n+1);
+  for (size_t q=0; q+8<=f.size(); q++) {
+    uint64_t len;
+    memcpy(&len, &f[q], 8);
+    auto d = (q + 8 + 63) / 64 * 64;
+    if (len != uint64_t(n+1) || d + (n+1)*sizeof(integer_t) > f.size())
+      continue;
+    memcpy(ptr.data(), &f[d], (n+1)*sizeof(integer_t));
+    if (ptr[0] == 0 && ptr[n] > 0 && is_sorted(ptr.begin(), ptr.end()))
+      return q;
+  }
+  return f.size();
+}
+
+/**
+ * Write corrupt copies of the factors file, and check that
+ * load_factors rejects them.
+ */
+template<typename scalar_t,typename integer_t> int
+test_corrupt_files(StrumpackSparseSolver<scalar_t,integer_t>& spss,
+                   const string& fname, integer_t n) {
+  string cname("strumpack_factors_corrupt.bin");
+  auto f = read_file(fname);
+  auto q = find_row_ptr(f, n);
+  if (q == f.size()) {
+    cout << "could not find the matrix in the factors file" << endl;
+    return 1;
+  }
+  auto d = (q + 8 + 63) / 64 * 64;
+  // the ind array follows the row pointers
+  auto qi = d + (n+1) * sizeof(integer_t);
+  auto di = (qi + 8 + 63) / 64 * 64;
+  integer_t nnz;
+  memcpy(&nnz, &f[d + n*sizeof(integer_t)], sizeof(integer_t));
+  vector<pair<string,vector<char>>> files;
+  files.emplace_back("truncated", vector<char>(f.begin(), f.begin()+f.size()/2));
+  {
+    // length * sizeof(integer_t) overflows to a small number
+    auto g = f;
+    uint64_t len = uint64_t(1) << (64 - (sizeof(integer_t) == 4 ? 2 : 3));
+    memcpy(&g[q], &len, 8);
+    files.emplace_back("huge length", g);
+  }
+  {
+    auto g = f;
+    integer_t p1 = nnz + 1;
+    memcpy(&g[d + sizeof(integer_t)], &p1, sizeof(integer_t));
+    files.emplace_back("row pointer not sorted", g);
+  }
+  {
+    auto g = f;
+    integer_t c = n + 7;
+    memcpy(&g[di + (nnz/2)*sizeof(integer_t)], &c, sizeof(integer_t));
+    files.emplace_back("column index out of range", g);
+  }
+  for (auto& cf : files) {
+    write_file(cname, cf.second);
+    auto ierr = spss.load_factors(cname);
+    remove(cname.c_str());
+    if (ierr != ReturnCode::IO_ERROR) {
+      cout << "load_factors accepted a corrupt file: "
+           << cf.first << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ * Factor a matrix, write the factors to a file, read them back in a
+ * new solver and check that both solvers give the same solution.
+ */
+template<typename scalar_t,typename integer_t> int
+test_factor_IO(int argc, const char* const argv[],
+               CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  string fname("strumpack_factors_test.bin");
+  int N = A.size();
+  vector<scalar_t> b(N), x(N), y(N), x_exact(N);
+  {
+    auto rgen = random::make_default_random_generator<real_t>();
+    for (auto& xi : x_exact)
+      xi = rgen->get();
+  }
+  A.spmv(x_exact.data(), b.data());
+
+  {
+    StrumpackSparseSolver<scalar_t,integer_t> spss;
+    spss.options().set_from_command_line(argc, argv);
+    if (spss.save_factors(fname) != ReturnCode::MATRIX_NOT_SET) {
+      cout << "save_factors without a matrix should fail." << endl;
+      return 1;
+    }
+    spss.set_matrix(A);
+    if (spss.save_factors(fname) != ReturnCode::NOT_SUPPORTED) {
+      cout << "save_factors before factor should fail." << endl;
+      return 1;
+    }
+    if (spss.factor() != ReturnCode::SUCCESS) {
+      cout << "problem during factorization of the matrix." << endl;
+      return 1;
+    }
+    spss.solve(b.data(), x.data());
+    if (spss.save_factors(fname) != ReturnCode::SUCCESS) {
+      cout << "problem writing the factors." << endl;
+      return 1;
+    }
+  }
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  auto ierr = spss.load_factors(fname);
+  if (ierr != ReturnCode::SUCCESS) {
+    remove(fname.c_str());
+    cout << "problem reading the factors." << endl;
+    return 1;
+  }
+  // a failed load should keep the factors loaded above
+  int cierr = test_corrupt_files(spss, fname, integer_t(N));
+  remove(fname.c_str());
+  if (cierr) return cierr;
+  spss.solve(b.data(), y.data());
+
+  auto comp_scal_res = A.max_scaled_residual(y.data(), b.data());
+  cout << "# COMPONENTWISE SCALED RESIDUAL = "
+       << comp_scal_res << endl;
+  blas::axpy(N, scalar_t(-1.), x.data(), 1, y.data(), 1);
+  auto nrm_diff = blas::nrm2(N, y.data(), 1);
+  auto nrm_x = blas::nrm2(N, x.data(), 1);
+  cout << "# ||x_loaded - x||/||x|| = " << (nrm_diff/nrm_x) << endl;
+
+  if (comp_scal_res > ERROR_TOLERANCE*spss.options().rel_tol() ||
+      nrm_diff > ERROR_TOLERANCE*spss.options().rel_tol()*nrm_x) {
+    cout << "SOLUTION FROM LOADED FACTORS DIFFERS!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * The out-of-core store can only be read after finish_writing, and
+ * a failed read makes the store no longer good.
+ */
+int test_out_of_core_store() {
+  string fname("strumpack_ooc_test.bin");
+  vector<double> v(100), u;
+  for (size_t i=0; i<v.size(); i++) v[i] = i;
+  auto write_v = [&](BinaryWriter& w) { w.write_vector(v); };
+  auto read_v = [&](BinaryReader& r) { r.read_vector(u); return true; };
+  {
+    OutOfCoreStore s(fname);
+    auto id = s.write(write_v);
+    if (s.read(id, read_v) || s.good()) {
+      cout << "out-of-core read before finish_writing should fail" << endl;
+      return 1;
+    }
+  }
+  OutOfCoreStore s(fname);
+  auto id = s.write(write_v);
+  if (!s.finish_writing() || !s.read(id, read_v) || u != v || !s.good()) {
+    cout << "out-of-core read failed" << endl;
+    return 1;
+  }
+  if (s.read(id+1, read_v) || s.good()) {
+    cout << "out-of-core read of a missing record should fail" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f) == 0)
+    return test_factor_IO(argc, argv, A);
+  else {
+    CSRMatrix<complex<real_t>,integer_t> Acomplex;
+    if (Acomplex.read_matrix_market(f)) {
+      std::cerr << "Could not read matrix from file." << std::endl;
+      return 1;
+    }
+    return test_factor_IO(argc, argv, Acomplex);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Factor a matrix given in matrix market format, write the\n"
+      << "factors to a file, read them back and solve.\n\n"
+      << "Usage: \n\t./test_factor_IO pde900.mtx" << endl;
+    return 1;
+  }
+  int ierr = test_out_of_core_store();
+  if (ierr) return ierr;
+  ierr = read_matrix_and_run_tests<double,int>(argc, argv);
+  if (ierr) return ierr;
+  return read_matrix_and_run_tests<double,long long int>(argc, argv);
+}
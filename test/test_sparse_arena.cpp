@@ -0,0 +1,239 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <random>
+#include <functional>
+#include <map>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/fronts/FrontDense.hpp"
+
+using namespace strumpack;
+
+/**
+ * FrontDense with access to the StackArena factorization, see
+ * FrontDense::factor_arena.
+ */
+template<typename scalar_t,typename integer_t>
+class ArenaFront : public FrontDense<scalar_t,integer_t> {
+  using FD_t = FrontDense<scalar_t,integer_t>;
+public:
+  ArenaFront(integer_t sep, integer_t sep_begin, integer_t sep_end,
+             std::vector<integer_t>& upd)
+    : FD_t(sep, sep_begin, sep_end, upd) {}
+  using FD_t::cb_stack_size;
+  using FD_t::arena_supported;
+  using FD_t::factor_arena;
+  std::size_t CB_capacity() const { return this->CBstorage_.capacity(); }
+};
+
+/**
+ * A deep assembly tree, a long chain of fronts with small subtrees
+ * hanging off, and a sparse matrix with exactly the structure of that
+ * tree. The separators are numbered in postorder and the update
+ * indices of a child are a subset of the separator and update
+ * indices of its parent.
+ */
+template<typename scalar_t,typename integer_t> struct DeepTree {
+  using Front_t = ArenaFront<scalar_t,integer_t>;
+  struct Node {
+    int l = -1, r = -1;
+    integer_t sep_begin = 0, sep_end = 0;
+    std::vector<integer_t> upd;
+  };
+  std::vector<Node> nodes;
+  int root = -1;
+  CSRMatrix<scalar_t,integer_t> A;
+
+  DeepTree(int chain_length) {
+    std::mt19937 gen(1);
+    std::function<int(int)> shape = [&](int depth) -> int {
+      int f = nodes.size();
+      nodes.emplace_back();
+      if (depth > 0) {
+        int l = shape(depth-1), r = -1;
+        if (gen() % 2) r = shape(std::min(depth-1, 3));
+        nodes[f].l = l;
+        nodes[f].r = r;
+      }
+      return f;
+    };
+    root = shape(chain_length);
+    integer_t n = 0;
+    std::function<void(int)> number = [&](int f) {
+      if (nodes[f].l >= 0) number(nodes[f].l);
+      if (nodes[f].r >= 0) number(nodes[f].r);
+      nodes[f].sep_begin = n;
+      n += 1 + gen() % 3;
+      nodes[f].sep_end = n;
+    };
+    number(root);
+    std::function<void(int)> update = [&](int f) {
+      for (auto c : {nodes[f].l, nodes[f].r}) {
+        if (c < 0) continue;
+        auto& upd = nodes[c].upd;
+        for (integer_t i=nodes[f].sep_begin; i<nodes[f].sep_end; i++)
+          upd.push_back(i);
+        for (auto i : nodes[f].upd)
+          if (upd.size() < 12 && gen() % 2) upd.push_back(i);
+        std::sort(upd.begin(), upd.end());
+        update(c);
+      }
+    };
+    update(root);
+    std::uniform_real_distribution<double> dis(-1., 1.);
+    std::vector<std::map<integer_t,scalar_t>> rows(n);
+    for (auto& f : nodes)
+      for (integer_t i=f.sep_begin; i<f.sep_end; i++) {
+        for (integer_t j=f.sep_begin; j<f.sep_end; j++)
+          rows[i][j] += dis(gen);
+        for (auto u : f.upd) {
+          rows[i][u] += dis(gen);
+          rows[u][i] += dis(gen);
+        }
+      }
+    std::vector<integer_t> ptr(n+1), ind;
+    std::vector<scalar_t> val;
+    for (integer_t i=0; i<n; i++) {
+      scalar_t d(1.);
+      for (auto& e : rows[i])
+        if (e.first != i) d += std::abs(e.second);
+      rows[i][i] = d;
+      for (auto& e : rows[i]) {
+        ind.push_back(e.first);
+        val.push_back(e.second);
+      }
+      ptr[i+1] = ind.size();
+    }
+    A = CSRMatrix<scalar_t,integer_t>(n, ptr.data(), ind.data(), val.data());
+  }
+
+  std::unique_ptr<Front_t> fronts(int f) {
+    auto upd = nodes[f].upd;
+    auto F = std::make_unique<Front_t>
+      (f, nodes[f].sep_begin, nodes[f].sep_end, upd);
+    if (nodes[f].l >= 0) F->set_lchild(fronts(nodes[f].l));
+    if (nodes[f].r >= 0) F->set_rchild(fronts(nodes[f].r));
+    return F;
+  }
+};
+
+template<typename scalar_t,typename integer_t> int
+check_solve(const CSRMatrix<scalar_t,integer_t>& A,
+            const Front<scalar_t,integer_t>& F) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t n = A.size();
+  DenseMatrix<scalar_t> x(n, 1), b(n, 1), r(n, 1);
+  x.random();
+  A.spmv(x, b);
+  r.copy(b);
+  F.multifrontal_solve(r);
+  r.scaled_add(scalar_t(-1.), x);
+  auto err = r.normF() / x.normF();
+  cout << "# relative error = " << err << endl;
+  if (err > 1e3 * blas::lamch<real_t>('E')) {
+    cout << "ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Factor a deep tree with the contribution blocks on a StackArena,
+ * and compare the peak of the stack with cb_stack_size, the estimate
+ * from the symbolic factorization. Also factor it through
+ * FrontDense::factor, without OpenMP tree parallelism, so every
+ * child subtree uses its own arena, and check that a subtree root
+ * only keeps its own contribution block.
+ */
+template<typename scalar_t,typename integer_t> int test_arena() {
+  DeepTree<scalar_t,integer_t> T(150);
+  cout << "# deep tree with " << T.nodes.size() << " fronts, n = "
+       << T.A.size() << endl;
+  SPOptions<scalar_t> opts;
+  opts.disable_openmp_tree();
+
+  auto F = T.fronts(T.root);
+  if (!F->arena_supported()) {
+    cout << "tree should support the stack arena" << endl;
+    return 1;
+  }
+  VectorPool<scalar_t> workspace;
+  auto est = F->cb_stack_size();
+  StackArena<scalar_t> arena(workspace.get(est));
+  if (F->factor_arena(T.A, opts, workspace, arena, 0, 0) !=
+      ReturnCode::SUCCESS) {
+    cout << "problem during factorization on the stack arena" << endl;
+    return 1;
+  }
+  cout << "# peak CB stack = " << arena.peak()
+       << ", estimate = " << est << endl;
+  if (arena.peak() != est) {
+    cout << "peak CB stack does not match the estimate" << endl;
+    return 1;
+  }
+  if (arena.top() != 0) {
+    cout << "the stack should be empty after factoring the root" << endl;
+    return 1;
+  }
+  if (check_solve(T.A, *F)) return 1;
+
+  auto G = T.fronts(T.root);
+  if (G->factor(T.A, opts, workspace) != ReturnCode::SUCCESS) {
+    cout << "problem during factorization" << endl;
+    return 1;
+  }
+  if (check_solve(T.A, *G)) return 1;
+
+  // a subtree root only keeps its own CB, not the whole stack
+  auto l = T.nodes[T.root].l;
+  auto H = T.fronts(l);
+  VectorPool<scalar_t> ws;
+  if (H->factor_arena(T.A, opts, ws, 1, 0) != ReturnCode::SUCCESS) {
+    cout << "problem during factorization of a subtree" << endl;
+    return 1;
+  }
+  std::size_t dupd = T.nodes[l].upd.size();
+  if (H->CB_capacity() != dupd*dupd) {
+    cout << "subtree root keeps " << H->CB_capacity()
+         << " elements, expected " << dupd*dupd << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  int ierr = test_arena<double,int>();
+  if (ierr) return ierr;
+  ierr = test_arena<std::complex<double>,int>();
+  if (ierr) return ierr;
+  return test_arena<double,long long int>();
+}
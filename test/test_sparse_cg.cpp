@@ -0,0 +1,164 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+#define NRHS 4
+
+/**
+ * Solve a symmetric positive definite 5-point Laplacian with
+ * (preconditioned) conjugate gradient, with --sp_Krylov_solver pcg,
+ * or with auto and compression. The matrix is marked as symmetric
+ * positive definite, so auto should select conjugate gradient.
+ *
+ * With scaled=true, the matrix is D*A*D, with D a diagonal with
+ * entries between 1e-1 and 1e1, which is still symmetric positive
+ * definite, but for which matching and equilibration would compute a
+ * nonsymmetric scaling. The solution of the scaled system is badly
+ * scaled, so for that matrix only the relative error is checked, not
+ * the componentwise residual.
+ */
+template<typename scalar_t,typename integer_t> CSRMatrix<scalar_t,integer_t>
+laplacian2d(integer_t k, bool scaled=false) {
+  integer_t n = k * k, nnz = 5 * n - 4 * k;
+  CSRMatrix<scalar_t,integer_t> A(n, nnz);
+  auto ptr = A.ptr();
+  auto ind = A.ind();
+  auto val = A.val();
+  integer_t e = 0;
+  ptr[0] = 0;
+  for (integer_t y=0; y<k; y++)
+    for (integer_t x=0; x<k; x++) {
+      integer_t r = x + y * k;
+      auto add = [&](integer_t c, scalar_t v) { ind[e] = c; val[e++] = v; };
+      if (y > 0) add(r - k, -1.);
+      if (x > 0) add(r - 1, -1.);
+      add(r, 4.);
+      if (x < k-1) add(r + 1, -1.);
+      if (y < k-1) add(r + k, -1.);
+      ptr[r+1] = e;
+    }
+  if (scaled) {
+    std::vector<double> D(n);
+    for (integer_t i=0; i<n; i++)
+      D[i] = std::pow(10., double((i * 37) % 5) / 2. - 1.);
+    for (integer_t r=0; r<n; r++)
+      for (integer_t j=ptr[r]; j<ptr[r+1]; j++)
+        val[j] *= D[r] * D[ind[j]];
+  }
+  return A;
+}
+
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver(int argc, const char* const argv[],
+                   CSRMatrix<scalar_t,integer_t>& A, int nrhs,
+                   bool scaled) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().enable_symmetric();
+  spss.options().enable_positive_definite();
+  spss.options().set_from_command_line(argc, argv);
+
+  int N = A.size();
+  DenseMatrix<scalar_t> B(N, nrhs), X(N, nrhs), X_exact(N, nrhs);
+  X_exact.random();
+  A.spmv(X_exact, B);
+
+  spss.set_matrix(A);
+  if (spss.reorder() != ReturnCode::SUCCESS) {
+    cout << "problem with reordering of the matrix." << endl;
+    return 1;
+  }
+  if (spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during factorization of the matrix." << endl;
+    return 1;
+  }
+  spss.solve(B, X);
+  cout << "# Krylov iterations = " << spss.Krylov_iterations() << endl;
+  if (spss.Krylov_iterations() >= spss.options().maxit()) {
+    cout << "CONJUGATE GRADIENT DID NOT CONVERGE!" << endl;
+    return 1;
+  }
+
+  real_t max_res = 0.;
+  for (int c=0; c<nrhs; c++) {
+    auto comp_scal_res = A.max_scaled_residual(X.ptr(0, c), B.ptr(0, c));
+    cout << "# COMPONENTWISE SCALED RESIDUAL " << c << " = "
+         << comp_scal_res << endl;
+    max_res = std::max(max_res, comp_scal_res);
+  }
+  X.scaled_add(scalar_t(-1.), X_exact);
+  auto err = X.normF() / X_exact.normF();
+  cout << "# RELATIVE ERROR = " << err << endl;
+  // the Krylov solver stops on the residual of the scaled system, so
+  // the error can grow with the ratio of the largest and smallest
+  // entries of D
+  real_t etol = ERROR_TOLERANCE * spss.options().rel_tol();
+  if (err > (scaled ? 1e2 : 1.) * etol) {
+    cout << "ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+  if (!scaled && max_res > etol) {
+    cout << "RESIDUAL TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename scalar_t,typename integer_t>
+int run_tests(int argc, const char* const argv[], integer_t k) {
+  for (bool scaled : {false, true}) {
+    auto A = laplacian2d<scalar_t,integer_t>(k, scaled);
+    int ierr = test_sparse_solver(argc, argv, A, 1, scaled);
+    if (ierr) return ierr;
+    ierr = test_sparse_solver(argc, argv, A, NRHS, scaled);
+    if (ierr) return ierr;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Solve a 2D Laplacian on a k x k grid with conjugate gradient.\n\n"
+      << "Usage: \n\t./test_sparse_cg k [options]" << endl;
+    return 1;
+  }
+  int k = stoi(argv[1]);
+  int ierr = run_tests<double,int>(argc, argv, k);
+  if (ierr) return ierr;
+  return run_tests<std::complex<double>,long long int>(argc, argv, k);
+}
@@ -0,0 +1,111 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+#define NSOLVES 8
+
+/**
+ * Solve with NSOLVES different right-hand sides, each in its own
+ * OpenMP thread, using the same solver object. The first solves also
+ * trigger the reordering and the factorization, since factor is not
+ * called explicitly.
+ */
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver(int argc, const char* const argv[],
+                   CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  StrumpackSparseSolver<scalar_t,integer_t> spss(false);
+  spss.options().set_from_command_line(argc, argv);
+  spss.set_matrix(A);
+
+  int N = A.size();
+  std::vector<DenseMatrix<scalar_t>> B(NSOLVES), X(NSOLVES);
+  auto rgen = random::make_default_random_generator<real_t>();
+  for (int k=0; k<NSOLVES; k++) {
+    // alternate between one and two right-hand sides
+    B[k] = DenseMatrix<scalar_t>(N, 1 + k % 2);
+    X[k] = DenseMatrix<scalar_t>(N, 1 + k % 2);
+    B[k].random(*rgen);
+  }
+  std::vector<ReturnCode> ierr(NSOLVES);
+#pragma omp parallel for schedule(static, 1)
+  for (int k=0; k<NSOLVES; k++)
+    ierr[k] = spss.solve(B[k], X[k]);
+  for (int k=0; k<NSOLVES; k++) {
+    if (ierr[k] != ReturnCode::SUCCESS) {
+      cout << "problem during solve " << k << ": " << ierr[k] << endl;
+      return 1;
+    }
+    DenseMatrix<scalar_t> R(B[k].rows(), B[k].cols());
+    A.spmv(X[k], R);
+    R.scaled_add(scalar_t(-1.), B[k]);
+    auto rel_res = R.normF() / B[k].normF();
+    cout << "# solve " << k << " RELATIVE RESIDUAL = " << rel_res << endl;
+    if (rel_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+      cout << "RESIDUAL TOO LARGE!" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f)) {
+    std::cerr << "Could not read matrix from file." << std::endl;
+    return 1;
+  }
+  int ierr = test_sparse_solver(argc, argv, A);
+  if (ierr) return ierr;
+  std::vector<complex<real_t>> val(A.val(), A.val()+A.nnz());
+  CSRMatrix<complex<real_t>,integer_t> Acomplex
+    (A.size(), A.ptr(), A.ind(), val.data());
+  return test_sparse_solver(argc, argv, Acomplex);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Solve with different right-hand sides concurrently, from\n"
+      << "multiple threads, using a single solver object, with a\n"
+      << "matrix given in matrix market format.\n\n"
+      << "Usage: \n\t./test_sparse_concurrent_solve pde900.mtx" << endl;
+    return 1;
+  }
+  return read_matrix_and_run_tests<double,int>(argc, argv);
+}
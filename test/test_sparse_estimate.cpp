@@ -0,0 +1,189 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Compare the prediction from factorization_estimate, computed after
+ * reorder, with the memory of the factors after factor. Without
+ * compression the prediction of the factor memory is exact, with
+ * compression it is an upper bound.
+ */
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver(int argc, const char* const argv[],
+                   const CSRMatrix<scalar_t,integer_t>& A) {
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  spss.set_matrix(A);
+  auto e = spss.factorization_estimate();
+  if (e.factor_memory != 0. || e.peak_memory != 0. || e.flops != 0.) {
+    cout << "estimate should be zero before reorder" << endl;
+    return 1;
+  }
+  if (spss.reorder() != ReturnCode::SUCCESS) {
+    cout << "problem with reordering of the matrix." << endl;
+    return 1;
+  }
+  e = spss.factorization_estimate();
+  cout << "# predicted factor memory = " << e.factor_memory / 1e6
+       << " MB, compressed = " << e.compressed_memory / 1e6
+       << " MB, peak = " << e.peak_memory / 1e6
+       << " MB, flops = " << e.flops << endl;
+  if (e.flops <= 0. || e.peak_memory < e.factor_memory ||
+      e.compressed_memory > e.factor_memory) {
+    cout << "inconsistent estimate" << endl;
+    return 1;
+  }
+  if (spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during factorization of the matrix." << endl;
+    return 1;
+  }
+  double fmem = spss.factor_memory();
+  cout << "# factor memory = " << fmem / 1e6 << " MB" << endl;
+  if (spss.options().compression() == CompressionType::NONE) {
+    if (fmem != e.factor_memory || e.compressed_memory != 0.) {
+      cout << "wrong factor memory prediction" << endl;
+      return 1;
+    }
+  } else if (fmem > e.factor_memory) {
+    cout << "factor memory larger than predicted" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * The symmetric solver only stores the lower triangle, and predicts
+ * the flops for Cholesky or LDL^T instead of LU. Compare with LU
+ * with the same ordering, without matching.
+ */
+template<typename scalar_t,typename integer_t> int
+test_symmetric_estimate(int argc, const char* const argv[],
+                        const CSRMatrix<scalar_t,integer_t>& A) {
+  auto estimate = [&](bool sym, bool pd) {
+    StrumpackSparseSolver<scalar_t,integer_t> spss;
+    spss.options().set_from_command_line(argc, argv);
+    spss.options().set_matching(MatchingJob::NONE);
+    if (sym) spss.options().enable_symmetric();
+    if (pd) spss.options().enable_positive_definite();
+    spss.set_matrix(A);
+    spss.reorder();
+    return spss.factorization_estimate();
+  };
+  auto LU = estimate(false, false), LDLt = estimate(true, false),
+    LLt = estimate(true, true);
+  cout << "# predicted flops LU = " << LU.flops << ", LDLt = "
+       << LDLt.flops << ", Cholesky = " << LLt.flops << endl;
+  if (LLt.flops <= 0. || LLt.flops > .6 * LU.flops ||
+      LLt.factor_memory >= LU.factor_memory) {
+    cout << "wrong prediction for Cholesky" << endl;
+    return 1;
+  }
+  // LDL^T is only used for real data, complex symmetric indefinite
+  // matrices use LU
+  if (!is_complex<scalar_t>() &&
+      (LDLt.flops >= LU.flops || LLt.flops >= LDLt.flops ||
+       LLt.factor_memory != LDLt.factor_memory)) {
+    cout << "wrong prediction for LDL^T" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Visiting the children in the order that minimizes the peak of the
+ * contribution block stack (Liu) should not increase the predicted
+ * peak memory, compared to the default order.
+ */
+template<typename scalar_t,typename integer_t> int
+test_child_order_estimate(int argc, const char* const argv[],
+                          const CSRMatrix<scalar_t,integer_t>& A) {
+  auto estimate = [&](bool child_order) {
+    StrumpackSparseSolver<scalar_t,integer_t> spss;
+    spss.options().set_from_command_line(argc, argv);
+    if (child_order) spss.options().enable_peak_memory_child_order();
+    else spss.options().disable_peak_memory_child_order();
+    spss.set_matrix(A);
+    spss.reorder();
+    return spss.factorization_estimate();
+  };
+  auto e0 = estimate(false), e1 = estimate(true);
+  cout << "# predicted peak memory = " << e0.peak_memory / 1e6
+       << " MB, with peak memory child order = "
+       << e1.peak_memory / 1e6 << " MB" << endl;
+  if (e1.peak_memory > e0.peak_memory ||
+      e1.factor_memory != e0.factor_memory || e1.flops != e0.flops) {
+    cout << "peak memory child order increased the peak memory" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f)) {
+    std::cerr << "Could not read matrix from file." << std::endl;
+    return 1;
+  }
+  std::vector<complex<real_t>> val(A.val(), A.val()+A.nnz());
+  CSRMatrix<complex<real_t>,integer_t> Acomplex
+    (A.size(), A.ptr(), A.ind(), val.data());
+  int ierr = test_sparse_solver(argc, argv, A);
+  if (ierr) return ierr;
+  ierr = test_sparse_solver(argc, argv, Acomplex);
+  if (ierr) return ierr;
+  ierr = test_child_order_estimate(argc, argv, A);
+  if (ierr) return ierr;
+  StrumpackSparseSolver<real_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  if (spss.options().compression() != CompressionType::NONE) return 0;
+  ierr = test_symmetric_estimate(argc, argv, A);
+  if (ierr) return ierr;
+  return test_symmetric_estimate(argc, argv, Acomplex);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Predict the memory usage of the factorization of a matrix\n"
+      << "given in matrix market format, and compare with the factors.\n\n"
+      << "Usage: \n\t./test_sparse_estimate pde900.mtx" << endl;
+    return 1;
+  }
+  int ierr = read_matrix_and_run_tests<double,int>(argc, argv);
+  if (ierr) return ierr;
+  return read_matrix_and_run_tests<double,long long int>(argc, argv);
+}
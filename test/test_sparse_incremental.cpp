@@ -0,0 +1,149 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <random>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e4
+
+template<typename real_t> void
+perturb(real_t& v, std::mt19937& gen,
+        std::uniform_real_distribution<real_t>& dis) {
+  v *= dis(gen);
+}
+template<typename real_t> void
+perturb(std::complex<real_t>& v, std::mt19937& gen,
+        std::uniform_real_distribution<real_t>& dis) {
+  v *= std::polar(dis(gen), dis(gen));
+}
+
+template<typename scalar_t,typename integer_t> int
+check_solve(StrumpackSparseSolver<scalar_t,integer_t>& spss,
+            const CSRMatrix<scalar_t,integer_t>& A, const char* what) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t N = A.size();
+  DenseMatrix<scalar_t> B(N, 1), X(N, 1), R(N, 1);
+  B.random();
+  if (spss.solve(B, X) != ReturnCode::SUCCESS) {
+    cout << "problem during solve " << what << endl;
+    return 1;
+  }
+  A.spmv(X, R);
+  R.scaled_add(scalar_t(-1.), B);
+  auto rel_res = R.normF() / B.normF();
+  cout << "# " << what << " RELATIVE RESIDUAL = " << rel_res << endl;
+  if (rel_res > ERROR_TOLERANCE * blas::lamch<real_t>('E') * N) {
+    cout << "RESIDUAL TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Factor A, change the values in a few rows, and refactor with
+ * incremental refactorization. Without iterative refinement, the
+ * residual is only small if all fronts affected by the changed
+ * values were refactored.
+ */
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver(int argc, const char* const argv[],
+                   CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<real_t> dis(0.8, 1.25);
+  for (integer_t i=0; i<A.nnz(); i++)
+    perturb(A.val()[i], gen, dis);
+
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().enable_incremental_refactorization();
+  spss.options().set_Krylov_solver(KrylovSolver::DIRECT);
+  spss.options().set_from_command_line(argc, argv);
+  spss.set_matrix(A);
+  if (check_solve(spss, A, "initial")) return 1;
+
+  integer_t N = A.size();
+  std::uniform_int_distribution<integer_t> row(0, N-1);
+  auto update_rows = [&](int nrows) {
+    for (int r=0; r<nrows; r++) {
+      auto i = row(gen);
+      for (integer_t k=A.ptr(i); k<A.ptr(i+1); k++)
+        perturb(A.val()[k], gen, dis);
+    }
+  };
+  // a few rows, all rows, no rows, and two updates without a
+  // factorization in between
+  update_rows(3);
+  spss.update_matrix_values(A);
+  if (check_solve(spss, A, "few rows")) return 1;
+  update_rows(N);
+  spss.update_matrix_values(A);
+  if (check_solve(spss, A, "all rows")) return 1;
+  spss.update_matrix_values(A);
+  if (check_solve(spss, A, "no rows")) return 1;
+  update_rows(1);
+  spss.update_matrix_values(A);
+  update_rows(1);
+  spss.update_matrix_values(A);
+  if (check_solve(spss, A, "two updates")) return 1;
+  return 0;
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f)) {
+    std::cerr << "Could not read matrix from file." << std::endl;
+    return 1;
+  }
+  std::vector<complex<real_t>> val(A.val(), A.val()+A.nnz());
+  CSRMatrix<complex<real_t>,integer_t> Acomplex
+    (A.size(), A.ptr(), A.ind(), val.data());
+  int ierr = test_sparse_solver(argc, argv, A);
+  if (ierr) return ierr;
+  return test_sparse_solver(argc, argv, Acomplex);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Refactor a matrix given in matrix market format after\n"
+      << "changing some of its values, with incremental refactorization.\n\n"
+      << "Usage: \n\t./test_sparse_incremental pde900.mtx" << endl;
+    return 1;
+  }
+  int ierr = read_matrix_and_run_tests<double,int>(argc, argv);
+  if (ierr) return ierr;
+  return read_matrix_and_run_tests<double,long long int>(argc, argv);
+}
@@ -0,0 +1,300 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <tuple>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+using namespace std;
+
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+template<typename scalar_t,typename integer_t>
+using Entries = vector<tuple<integer_t,integer_t,scalar_t>>;
+
+/**
+ * Write the contents s to a file, replace the line endings with eol.
+ */
+string write_file(const string& name, const string& s,
+                  const string& eol="\n") {
+  ofstream f(name, ofstream::binary);
+  for (auto c : s) {
+    if (c == '\n') f << eol;
+    else f << c;
+  }
+  return name;
+}
+
+/**
+ * Check that the matrix A has exactly the (zero based) entries E.
+ */
+template<typename scalar_t,typename integer_t> int
+check_entries(const CSRMatrix<scalar_t,integer_t>& A, integer_t n,
+              Entries<scalar_t,integer_t> E, const string& name) {
+  if (A.size() != n || A.nnz() != integer_t(E.size())) {
+    cout << "ERROR: " << name << ": read a matrix of size " << A.size()
+         << " with " << A.nnz() << " nonzeros, expected " << n
+         << " with " << E.size() << " nonzeros" << endl;
+    return 1;
+  }
+  Entries<scalar_t,integer_t> F;
+  for (integer_t r=0; r<n; r++) {
+    for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++) {
+      if (j > A.ptr(r) && A.ind(j-1) >= A.ind(j)) {
+        cout << "ERROR: " << name << ": row " << r
+             << " is not sorted" << endl;
+        return 1;
+      }
+      F.emplace_back(r, A.ind(j), A.val(j));
+    }
+  }
+  auto lt = [](const tuple<integer_t,integer_t,scalar_t>& a,
+               const tuple<integer_t,integer_t,scalar_t>& b) {
+    return get<0>(a) < get<0>(b) ||
+      (get<0>(a) == get<0>(b) && get<1>(a) < get<1>(b)); };
+  sort(E.begin(), E.end(), lt);
+  if (E != F) {
+    cout << "ERROR: " << name << ": wrong entries" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename scalar_t,typename integer_t> int
+expect_read(const string& name, const string& s, integer_t n,
+            const Entries<scalar_t,integer_t>& E, bool symm,
+            const string& eol="\n") {
+  CSRMatrix<scalar_t,integer_t> A;
+  if (A.read_matrix_market(write_file(name, s, eol))) {
+    cout << "ERROR: " << name << ": could not read the matrix" << endl;
+    return 1;
+  }
+  remove(name.c_str());
+  if (A.symm_sparse() != symm) {
+    cout << "ERROR: " << name << ": wrong symm_sparse" << endl;
+    return 1;
+  }
+  return check_entries(A, n, E, name);
+}
+
+template<typename scalar_t,typename integer_t> int
+expect_fail(const string& name, const string& s) {
+  CSRMatrix<scalar_t,integer_t> A;
+  int ierr = A.read_matrix_market(write_file(name, s));
+  remove(name.c_str());
+  if (!ierr) {
+    cout << "ERROR: " << name << ": invalid file was accepted" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Read small files, with every kind of symmetry, zero based indices
+ * and invalid files.
+ */
+template<typename scalar_t,typename integer_t> int test_small() {
+  using E_t = Entries<scalar_t,integer_t>;
+  int ierr = 0;
+  string gen =
+    "%%MatrixMarket matrix coordinate real general\n"
+    "% comment\n"
+    "\n"
+    "4 4 5\n"
+    "1 1 1.5\n"
+    "4 1 -2.25\n"
+    "  2 3 +3e0\n"
+    "3 3 4\n"
+    "4 4 0.5\n";
+  E_t Egen = {{0,0,1.5}, {3,0,-2.25}, {1,2,3.}, {2,2,4.}, {3,3,.5}};
+  ierr |= expect_read<scalar_t,integer_t>
+    ("test_mm_general.mtx", gen, 4, Egen, false);
+  ierr |= expect_read<scalar_t,integer_t>
+    ("test_mm_crlf.mtx", gen, 4, Egen, false, "\r\n");
+  ierr |= expect_read<scalar_t,integer_t>
+    ("test_mm_zero_based.mtx",
+     "%%MatrixMarket matrix coordinate real general\n"
+     "4 4 5\n"
+     "0 0 1.5\n3 0 -2.25\n1 2 3\n2 2 4\n3 3 0.5\n", 4, Egen, false);
+  // a value longer than the parse buffer, and one which underflows
+  ierr |= expect_read<scalar_t,integer_t>
+    ("test_mm_long_values.mtx",
+     "%%MatrixMarket matrix coordinate real general\n"
+     "2 2 2\n"
+     "1 1 1.25" + string(80, '0') + "\n"
+     "2 2 1e-400\n", 2, E_t{{0,0,1.25}, {1,1,0.}}, false);
+  ierr |= expect_read<scalar_t,integer_t>
+    ("test_mm_symmetric.mtx",
+     "%%MatrixMarket matrix coordinate real symmetric\n"
+     "3 3 4\n"
+     "1 1 2\n2 1 -1\n2 2 2\n3 2 -1\n", 3,
+     E_t{{0,0,2.}, {1,0,-1.}, {0,1,-1.}, {1,1,2.}, {2,1,-1.}, {1,2,-1.}},
+     true);
+  ierr |= expect_read<scalar_t,integer_t>
+    ("test_mm_skew.mtx",
+     "%%MatrixMarket matrix coordinate real skew-symmetric\n"
+     "3 3 2\n"
+     "2 1 1.5\n3 1 -2\n", 3,
+     E_t{{1,0,1.5}, {0,1,-1.5}, {2,0,-2.}, {0,2,2.}}, true);
+  // invalid files
+  string hdr = "%%MatrixMarket matrix coordinate real general\n";
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_truncated.mtx", hdr + "3 3 3\n1 1 1\n2 2 1\n");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_truncated_line.mtx", hdr + "3 3 3\n1 1 1\n2 2 1\n3 3");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_extra.mtx", hdr + "3 3 2\n1 1 1\n2 2 1\n3 3 1\n");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_out_of_range.mtx", hdr + "3 3 2\n1 1 1\n4 2 1\n");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_huge_index.mtx", hdr + "3 3 2\n1 1 1\n2 1000000 1\n");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_negative.mtx", hdr + "3 3 2\n1 1 1\n-1 2 1\n");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_mixed_base.mtx", hdr + "3 3 2\n0 0 1\n3 3 1\n");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_malformed.mtx", hdr + "3 3 2\n1 1 1\n2 2 abc\n");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_no_size.mtx", hdr + "% no size\n");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_not_square.mtx", hdr + "3 4 1\n1 1 1\n");
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_pattern.mtx",
+     "%%MatrixMarket matrix coordinate pattern general\n3 3 1\n1 1\n");
+  return ierr;
+}
+
+/**
+ * Complex files, a complex file cannot be read in a real matrix.
+ */
+template<typename real_t,typename integer_t> int test_complex() {
+  using scalar_t = complex<real_t>;
+  using E_t = Entries<scalar_t,integer_t>;
+  int ierr = 0;
+  string gen =
+    "%%MatrixMarket matrix coordinate complex general\n"
+    "2 2 3\n"
+    "1 1 1 -1\n2 1 0.5 2\n2 2 3 0\n";
+  ierr |= expect_read<scalar_t,integer_t>
+    ("test_mm_complex.mtx", gen, 2,
+     E_t{{0,0,{1.,-1.}}, {1,0,{.5,2.}}, {1,1,{3.,0.}}}, false);
+  ierr |= expect_fail<real_t,integer_t>("test_mm_complex_real.mtx", gen);
+  ierr |= expect_read<scalar_t,integer_t>
+    ("test_mm_hermitian.mtx",
+     "%%MatrixMarket matrix coordinate complex hermitian\n"
+     "3 3 3\n"
+     "1 1 2 0\n3 1 1 2\n3 3 2 0\n", 3,
+     E_t{{0,0,{2.,0.}}, {2,0,{1.,2.}}, {0,2,{1.,-2.}}, {2,2,{2.,0.}}},
+     true);
+  ierr |= expect_fail<scalar_t,integer_t>
+    ("test_mm_complex_malformed.mtx",
+     "%%MatrixMarket matrix coordinate complex general\n"
+     "2 2 1\n1 1 1\n");
+  return ierr;
+}
+
+/**
+ * A file that is large enough to be parsed in several chunks, with
+ * the entries in random order and CRLF line endings. The matrix is
+ * then written and read back in binary format.
+ */
+template<typename scalar_t,typename integer_t> int test_large() {
+  int ierr = 0;
+  integer_t n = 3000, d = 20;
+  Entries<scalar_t,integer_t> E;
+  for (integer_t r=0; r<n; r++)
+    for (integer_t j=0; j<d; j++)
+      E.emplace_back(r, (r + 37*j) % n, scalar_t((r*d+j) % 1000 + .5));
+  auto S = E;
+  shuffle(S.begin(), S.end(), mt19937(1));
+  ostringstream s;
+  s << "%%MatrixMarket matrix coordinate real general\n"
+    << n << " " << n << " " << S.size() << "\n";
+  for (auto& e : S)
+    s << get<0>(e)+1 << " " << get<1>(e)+1 << " "
+      << real(get<2>(e)) << "\n";
+  CSRMatrix<scalar_t,integer_t> A;
+  if (A.read_matrix_market(write_file("test_mm_large.mtx", s.str(), "\r\n"))) {
+    cout << "ERROR: could not read test_mm_large.mtx" << endl;
+    return 1;
+  }
+  remove("test_mm_large.mtx");
+  ierr |= check_entries(A, n, E, "test_mm_large.mtx");
+  // drop the last half of the file
+  auto t = s.str();
+  t.resize(t.find('\n', t.size() / 2) + 1);
+  ierr |= expect_fail<scalar_t,integer_t>("test_mm_large_truncated.mtx", t);
+
+  A.print_binary("test_mm_large.bin");
+  CSRMatrix<scalar_t,integer_t> B;
+  if (B.read_binary("test_mm_large.bin")) {
+    cout << "ERROR: could not read test_mm_large.bin" << endl;
+    return 1;
+  }
+  remove("test_mm_large.bin");
+  if (B.size() != A.size() || B.nnz() != A.nnz() ||
+      !equal(A.ptr(), A.ptr()+n+1, B.ptr()) ||
+      !equal(A.ind(), A.ind()+A.nnz(), B.ind()) ||
+      !equal(A.val(), A.val()+A.nnz(), B.val())) {
+    cout << "ERROR: binary round-trip changed the matrix" << endl;
+    return 1;
+  }
+  return ierr;
+}
+
+template<typename real_t,typename integer_t> int run() {
+  int ierr = 0;
+  ierr |= test_small<real_t,integer_t>();
+  ierr |= test_small<complex<real_t>,integer_t>();
+  ierr |= test_complex<real_t,integer_t>();
+  ierr |= test_large<real_t,integer_t>();
+  ierr |= test_large<complex<real_t>,integer_t>();
+  return ierr;
+}
+
+int main(int argc, char* argv[]) {
+  cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+  cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+  for (int i=0; i<argc; i++) cout << argv[i] << " ";
+  cout << endl;
+
+  int ierr = 0;
+  ierr |= run<double,int>();
+  ierr |= run<double,long long int>();
+  ierr |= run<float,int>();
+  if (!ierr) cout << "# all matrix market tests passed" << endl;
+  return ierr;
+}
@@ -0,0 +1,184 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+using namespace std;
+
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/CSRMatrixMPI.hpp"
+
+using namespace strumpack;
+
+/**
+ * Rank 0 writes the file, with the entries in random order.
+ */
+void write_file(const MPIComm& c, const string& name, const string& header,
+                vector<string> lines) {
+  if (c.is_root()) {
+    shuffle(lines.begin(), lines.end(), mt19937(1));
+    ofstream f(name);
+    f << header;
+    for (auto& l : lines) f << l;
+  }
+  c.barrier();
+}
+
+/**
+ * Read the file with all processes, and compare the gathered matrix
+ * with the matrix read by the root process only.
+ */
+template<typename scalar_t,typename integer_t>
+int compare_read(const MPIComm& c, const string& name) {
+  CSRMatrixMPI<scalar_t,integer_t> D;
+  if (D.read_matrix_market(name)) {
+    if (c.is_root())
+      cout << "ERROR: could not read " << name << endl;
+    return 1;
+  }
+  auto G = D.gather();
+  int ierr = 0;
+  if (c.is_root()) {
+    CSRMatrix<scalar_t,integer_t> S;
+    S.read_matrix_market(name);
+    if (G->size() != S.size() || G->nnz() != S.nnz() ||
+        D.symm_sparse() != S.symm_sparse()) {
+      cout << "ERROR: " << name << ": wrong size, nnz or symmetry" << endl;
+      ierr = 1;
+    } else {
+      // the gathered rows are not sorted
+      for (integer_t r=0; r<S.size() && !ierr; r++) {
+        vector<pair<integer_t,scalar_t>> a, b;
+        for (integer_t j=S.ptr(r); j<S.ptr(r+1); j++)
+          a.emplace_back(S.ind(j), S.val(j));
+        for (integer_t j=G->ptr(r); j<G->ptr(r+1); j++)
+          b.emplace_back(G->ind(j), G->val(j));
+        auto lt = [](const pair<integer_t,scalar_t>& x,
+                     const pair<integer_t,scalar_t>& y) {
+          return x.first < y.first; };
+        sort(b.begin(), b.end(), lt);
+        if (a != b) {
+          cout << "ERROR: " << name << ": row " << r
+               << " differs from the sequential read" << endl;
+          ierr = 1;
+        }
+      }
+    }
+    remove(name.c_str());
+  }
+  return c.all_reduce(ierr, MPI_MAX);
+}
+
+template<typename scalar_t,typename integer_t>
+int expect_fail(const MPIComm& c, const string& name) {
+  CSRMatrixMPI<scalar_t,integer_t> D;
+  // all processes should fail
+  int ierr = D.read_matrix_market(name) ? 0 : 1;
+  if (c.is_root()) remove(name.c_str());
+  ierr = c.all_reduce(ierr, MPI_MAX);
+  if (ierr && c.is_root())
+    cout << "ERROR: " << name << " was accepted" << endl;
+  return ierr;
+}
+
+template<typename integer_t> int run(const MPIComm& c) {
+  int ierr = 0, n = 4000, d = 15;
+  vector<string> gen, sym, herm;
+  for (int r=0; r<n; r++)
+    for (int j=0; j<d; j++) {
+      int col = (r + 53*j) % n;
+      ostringstream l;
+      l << r+1 << " " << col+1 << " " << (r*d+j) % 1000 + .5 << "\n";
+      gen.push_back(l.str());
+      if (r >= col) sym.push_back(l.str());
+      ostringstream h;
+      h << r << " " << col << " " << (r+j) % 10 << " "
+        << (r == col ? 0 : (r*j) % 7) << "\n";
+      if (r >= col) herm.push_back(h.str());
+    }
+  auto size = [n](size_t nnz) {
+    return to_string(n) + " " + to_string(n) + " " + to_string(nnz) + "\n"; };
+  write_file(c, "test_mm_mpi_general.mtx",
+             "%%MatrixMarket matrix coordinate real general\n"
+             "% comment\n\n" + size(gen.size()), gen);
+  ierr |= compare_read<double,integer_t>(c, "test_mm_mpi_general.mtx");
+  write_file(c, "test_mm_mpi_symmetric.mtx",
+             "%%MatrixMarket matrix coordinate real symmetric\n" +
+             size(sym.size()), sym);
+  ierr |= compare_read<double,integer_t>(c, "test_mm_mpi_symmetric.mtx");
+  // complex Hermitian, with zero based indices
+  write_file(c, "test_mm_mpi_hermitian.mtx",
+             "%%MatrixMarket matrix coordinate complex hermitian\n" +
+             size(herm.size()), herm);
+  ierr |= compare_read<complex<double>,integer_t>
+    (c, "test_mm_mpi_hermitian.mtx");
+  // the header has more entries than the file
+  write_file(c, "test_mm_mpi_truncated.mtx",
+             "%%MatrixMarket matrix coordinate real general\n" +
+             size(gen.size()+1), gen);
+  ierr |= expect_fail<double,integer_t>(c, "test_mm_mpi_truncated.mtx");
+  gen.push_back(to_string(n+1) + " 1 1.\n");
+  write_file(c, "test_mm_mpi_out_of_range.mtx",
+             "%%MatrixMarket matrix coordinate real general\n" +
+             size(gen.size()), gen);
+  ierr |= expect_fail<double,integer_t>(c, "test_mm_mpi_out_of_range.mtx");
+  gen.back() = "0 1 1.\n";
+  write_file(c, "test_mm_mpi_mixed_base.mtx",
+             "%%MatrixMarket matrix coordinate real general\n" +
+             size(gen.size()), gen);
+  ierr |= expect_fail<double,integer_t>(c, "test_mm_mpi_mixed_base.mtx");
+  return ierr;
+}
+
+int main(int argc, char* argv[]) {
+  MPI_Init(&argc, &argv);
+  int ierr = 0;
+  {
+    MPIComm c;
+    if (c.is_root()) {
+      cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+      cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+      cout << "mpirun -n " << c.size() << " ";
+      for (int i=0; i<argc; i++) cout << argv[i] << " ";
+      cout << endl;
+    }
+    ierr |= run<int>(c);
+    ierr |= run<long long int>(c);
+    if (!ierr && c.is_root())
+      cout << "# all matrix market tests passed" << endl;
+  }
+  MPI_Finalize();
+  return ierr;
+}
@@ -0,0 +1,230 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/ordering/MTNDReordering.hpp"
+
+using namespace strumpack;
+
+/**
+ * ncomp disconnected copies of the 5-point Laplacian on a k x k grid,
+ * followed by niso isolated vertices.
+ */
+template<typename integer_t> CSRMatrix<double,integer_t>
+laplacian2d(integer_t k, integer_t ncomp, integer_t niso) {
+  integer_t n = k * k * ncomp + niso;
+  std::vector<integer_t> ptr(n+1), ind;
+  std::vector<double> val;
+  for (integer_t c=0; c<ncomp; c++)
+    for (integer_t y=0; y<k; y++)
+      for (integer_t x=0; x<k; x++) {
+        integer_t i = c*k*k + y*k + x;
+        auto add = [&](integer_t j, double v) {
+          ind.push_back(j);
+          val.push_back(v);
+        };
+        if (y > 0) add(i-k, -1.);
+        if (x > 0) add(i-1, -1.);
+        add(i, 4.);
+        if (x < k-1) add(i+1, -1.);
+        if (y < k-1) add(i+k, -1.);
+        ptr[i+1] = ind.size();
+      }
+  for (integer_t i=k*k*ncomp; i<n; i++) {
+    ind.push_back(i);
+    val.push_back(1.);
+    ptr[i+1] = ind.size();
+  }
+  return CSRMatrix<double,integer_t>(n, ptr.data(), ind.data(), val.data());
+}
+
+/**
+ * Check that iperm is a permutation, that the separators of the
+ * separator tree cover [0, n), and that the ordering is a nested
+ * dissection: every edge connects a separator to itself or to one
+ * of its ancestors.
+ */
+template<typename integer_t> int
+check_nested_dissection(const CSRMatrix<double,integer_t>& A,
+                        const std::vector<integer_t>& iperm,
+                        const SeparatorTree<integer_t>& tree) {
+  integer_t n = A.size(), nsep = tree.separators();
+  std::vector<integer_t> perm(n, -1);
+  for (integer_t i=0; i<n; i++) {
+    if (iperm[i] < 0 || iperm[i] >= n || perm[iperm[i]] != -1) {
+      cout << "ordering is not a permutation" << endl;
+      return 1;
+    }
+    perm[iperm[i]] = i;
+  }
+  if (nsep == 0 || tree.sizes[0] != 0 || tree.sizes[nsep] != n ||
+      !tree.is_root(nsep-1)) {
+    cout << "separator tree does not cover the graph" << endl;
+    return 1;
+  }
+  std::vector<integer_t> sep(n);
+  for (integer_t s=0; s<nsep; s++) {
+    if (tree.sizes[s+1] < tree.sizes[s]) {
+      cout << "negative separator size" << endl;
+      return 1;
+    }
+    for (integer_t i=tree.sizes[s]; i<tree.sizes[s+1]; i++)
+      sep[i] = s;
+  }
+  for (integer_t r=0; r<n; r++)
+    for (integer_t k=A.ptr(r); k<A.ptr(r+1); k++) {
+      auto a = sep[perm[r]], b = sep[perm[A.ind()[k]]];
+      if (a > b) std::swap(a, b);
+      while (a != -1 && a != b) a = tree.parent[a];
+      if (a != b) {
+        cout << "edge between separators " << sep[perm[r]] << " and "
+             << sep[perm[A.ind()[k]]] << " which are not nested" << endl;
+        return 1;
+      }
+    }
+  return 0;
+}
+
+/**
+ * Order with mtnd, check the ordering, and compare the number of
+ * nonzeros in the factors with AMD.
+ */
+template<typename integer_t> int
+test_mtnd(const CSRMatrix<double,integer_t>& A, double bound) {
+  integer_t n = A.size();
+  std::vector<integer_t> xadj(n+1), adjncy, iperm(n);
+  for (integer_t i=0; i<n; i++) {
+    for (integer_t k=A.ptr(i); k<A.ptr(i+1); k++)
+      if (A.ind()[k] != i) adjncy.push_back(A.ind()[k]);
+    xadj[i+1] = adjncy.size();
+  }
+  for (auto method : {ordering::NDBisection::MULTILEVEL,
+        ordering::NDBisection::SPECTRAL}) {
+    auto tree = ordering::mtnd
+      (n, xadj.data(), adjncy.data(), iperm.data(), integer_t(8), method);
+    if (check_nested_dissection(A, iperm, tree)) return 1;
+    integer_t empty = 0;
+    for (integer_t s=0; s<tree.separators(); s++)
+      if (tree.sizes[s+1] == tree.sizes[s]) empty++;
+    cout << "# " << tree.separators() << " separators, " << empty
+         << " empty" << endl;
+  }
+  auto factor_memory = [&](ReorderingStrategy method) {
+    StrumpackSparseSolver<double,integer_t> spss(false);
+    spss.options().set_reordering_method(method);
+    spss.options().set_matching(MatchingJob::NONE);
+    spss.set_matrix(A);
+    spss.reorder();
+    return spss.factorization_estimate().factor_memory;
+  };
+  auto fmtnd = factor_memory(ReorderingStrategy::MTND),
+    famd = factor_memory(ReorderingStrategy::AMD);
+  cout << "# n = " << n << ", factor memory mtnd = " << fmtnd / 1e6
+       << " MB, amd = " << famd / 1e6 << " MB" << endl;
+  if (fmtnd <= 0. || fmtnd > bound * famd) {
+    cout << "mtnd fill too large compared to AMD" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Minimum local fill should not give more fill than AMD on a small
+ * mesh.
+ */
+template<typename integer_t> int
+test_fill(const CSRMatrix<double,integer_t>& A) {
+  auto factor_memory = [&](ReorderingStrategy method) {
+    StrumpackSparseSolver<double,integer_t> spss(false);
+    spss.options().set_reordering_method(method);
+    spss.options().set_matching(MatchingJob::NONE);
+    spss.set_matrix(A);
+    spss.reorder();
+    return spss.factorization_estimate().factor_memory;
+  };
+  auto famd = factor_memory(ReorderingStrategy::AMD),
+    fmlf = factor_memory(ReorderingStrategy::MLF);
+  cout << "# n = " << A.size() << ", factor memory amd = " << famd / 1e6
+       << " MB, mlf = " << fmlf / 1e6 << " MB" << endl;
+  if (fmlf <= 0. || fmlf > famd) {
+    cout << "mlf fill larger than AMD" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * The automatic selection should pick an ordering with no more
+ * predicted factorization flops than any of its candidates.
+ */
+template<typename integer_t> int
+test_auto(const CSRMatrix<double,integer_t>& A) {
+  auto flops = [&](ReorderingStrategy method) {
+    StrumpackSparseSolver<double,integer_t> spss(false);
+    spss.options().set_reordering_method(method);
+    spss.options().set_matching(MatchingJob::NONE);
+    spss.set_matrix(A);
+    spss.reorder();
+    return spss.factorization_estimate().flops;
+  };
+  auto fauto = flops(ReorderingStrategy::AUTO);
+  cout << "# n = " << A.size() << ", factor flops auto = " << fauto;
+  for (auto method : {ReorderingStrategy::METIS,
+#if defined(STRUMPACK_USE_SCOTCH)
+        ReorderingStrategy::SCOTCH,
+#endif
+        ReorderingStrategy::MTND, ReorderingStrategy::AMD,
+        ReorderingStrategy::AND, ReorderingStrategy::RCM}) {
+    auto f = flops(method);
+    cout << ", " << get_name(method) << " = " << f;
+    if (fauto <= 0. || fauto > f) {
+      cout << endl << "auto ordering is not the cheapest candidate" << endl;
+      return 1;
+    }
+  }
+  cout << endl;
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  // several levels of bisection above the AMD switch, as OpenMP
+  // tasks, should not be worse than AMD
+  if (test_mtnd(laplacian2d<int>(150, 1, 0), 1.1)) return 1;
+  // disconnected, the bisection finds empty separators, and each
+  // component is small enough for AMD to do well
+  if (test_mtnd(laplacian2d<int>(40, 3, 20), 1.5)) return 1;
+  if (test_mtnd(laplacian2d<long long int>(40, 3, 20), 1.5)) return 1;
+  if (test_fill(laplacian2d<int>(30, 1, 0))) return 1;
+  if (test_auto(laplacian2d<int>(30, 1, 0))) return 1;
+  return test_auto(laplacian2d<long long int>(20, 3, 10));
+}
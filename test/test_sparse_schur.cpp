@@ -0,0 +1,131 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <numeric>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+#define NVARS 20
+
+/**
+ * Compute the Schur complement S on a set of variables v, and check
+ * that S * inv(A)(v,v) = I, with inv(A)(v,v) computed from a solve
+ * with the unit vectors for v, using a second solver.
+ */
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver(int argc, const char* const argv[],
+                   CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t N = A.size();
+  std::vector<integer_t> vars(N);
+  std::iota(vars.begin(), vars.end(), 0);
+  std::shuffle(vars.begin(), vars.end(), std::mt19937(1));
+  vars.resize(NVARS);
+  integer_t m = vars.size();
+
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  auto ref_matching = spss.options().matching();
+  spss.set_matrix(A);
+  DenseMatrix<scalar_t> S;
+  if (spss.factor_schur(vars, S) != ReturnCode::SUCCESS) {
+    cout << "problem computing the Schur complement" << endl;
+    return 1;
+  }
+  if (spss.options().matching() != ref_matching) {
+    cout << "factor_schur should not change the matching option" << endl;
+    return 1;
+  }
+  DenseMatrix<scalar_t> X;
+  if (spss.solve(X, X) != ReturnCode::NOT_SUPPORTED) {
+    cout << "solve after factor_schur should not be supported" << endl;
+    return 1;
+  }
+
+  StrumpackSparseSolver<scalar_t,integer_t> ref;
+  ref.options().set_from_command_line(argc, argv);
+  ref.set_matrix(A);
+  DenseMatrix<scalar_t> E(N, m), Y(N, m), Yv(m, m);
+  E.zero();
+  for (integer_t j=0; j<m; j++)
+    E(vars[j], j) = scalar_t(1.);
+  if (ref.solve(E, Y) != ReturnCode::SUCCESS) {
+    cout << "problem during solve" << endl;
+    return 1;
+  }
+  for (integer_t j=0; j<m; j++)
+    for (integer_t i=0; i<m; i++)
+      Yv(i, j) = Y(vars[i], j);
+  DenseMatrix<scalar_t> I(m, m);
+  I.eye();
+  gemm(Trans::N, Trans::N, scalar_t(1.), S, Yv, scalar_t(-1.), I);
+  auto err = I.normF() / std::sqrt(real_t(m));
+  cout << "# |S * inv(A)(v,v) - I|_F / sqrt(m) = " << err << endl;
+  if (err > ERROR_TOLERANCE * ref.options().rel_tol()) {
+    cout << "ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f)) {
+    std::cerr << "Could not read matrix from file." << std::endl;
+    return 1;
+  }
+  int ierr = test_sparse_solver(argc, argv, A);
+  if (ierr) return ierr;
+  std::vector<complex<real_t>> val(A.val(), A.val()+A.nnz());
+  CSRMatrix<complex<real_t>,integer_t> Acomplex
+    (A.size(), A.ptr(), A.ind(), val.data());
+  return test_sparse_solver(argc, argv, Acomplex);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Compute the Schur complement on a set of variables, with a\n"
+      << "matrix given in matrix market format.\n\n"
+      << "Usage: \n\t./test_sparse_schur pde900.mtx" << endl;
+    return 1;
+  }
+  int ierr = read_matrix_and_run_tests<double,int>(argc, argv);
+  if (ierr) return ierr;
+  return read_matrix_and_run_tests<double,long long int>(argc, argv);
+}
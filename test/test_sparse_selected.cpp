@@ -0,0 +1,127 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <random>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+#define NRHS 2
+
+/**
+ * Solve with a right-hand side with only a few nonzeros, computing
+ * only a few entries of the solution, and compare with those entries
+ * from a full (direct) solve with the same factors.
+ */
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver(int argc, const char* const argv[],
+                   CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  spss.options().set_Krylov_solver(KrylovSolver::DIRECT);
+  spss.set_matrix(A);
+  if (spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during factorization of the matrix." << endl;
+    return 1;
+  }
+  integer_t N = A.size();
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<integer_t> rows(0, N-1);
+  for (int nb : {1, 5, int(N)}) {
+    for (int nx : {1, 7}) {
+      DenseMatrix<scalar_t> B(N, NRHS), X(N, NRHS), Xs(N, NRHS);
+      std::vector<integer_t> b_rows, x_rows;
+      B.zero();
+      if (nb == N) {
+        B.random();
+        for (integer_t i=0; i<N; i++) b_rows.push_back(i);
+      } else
+        for (int k=0; k<nb; k++) {
+          auto r = rows(gen);
+          b_rows.push_back(r);
+          for (int j=0; j<NRHS; j++)
+            B(r, j) = scalar_t(k+1.) / scalar_t(j+1.);
+        }
+      for (int k=0; k<nx; k++)
+        x_rows.push_back(rows(gen));
+      if (spss.solve(B, X) != ReturnCode::SUCCESS ||
+          spss.solve_sparse(B, b_rows, Xs, x_rows) != ReturnCode::SUCCESS) {
+        cout << "problem during solve" << endl;
+        return 1;
+      }
+      real_t err(0.), nrm(0.);
+      for (auto r : x_rows)
+        for (int j=0; j<NRHS; j++) {
+          err = std::max(err, std::abs(X(r, j) - Xs(r, j)));
+          nrm = std::max(nrm, std::abs(X(r, j)));
+        }
+      cout << "# nb=" << nb << " nx=" << nx
+           << " RELATIVE ERROR = " << err / nrm << endl;
+      if (err > ERROR_TOLERANCE * blas::lamch<real_t>('E') * nrm) {
+        cout << "ERROR TOO LARGE!" << endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f)) {
+    std::cerr << "Could not read matrix from file." << std::endl;
+    return 1;
+  }
+  int ierr = test_sparse_solver(argc, argv, A);
+  if (ierr) return ierr;
+  std::vector<complex<real_t>> val(A.val(), A.val()+A.nnz());
+  CSRMatrix<complex<real_t>,integer_t> Acomplex
+    (A.size(), A.ptr(), A.ind(), val.data());
+  return test_sparse_solver(argc, argv, Acomplex);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Solve with a sparse right-hand side, for selected entries\n"
+      << "of the solution, with a matrix given in matrix market format.\n\n"
+      << "Usage: \n\t./test_sparse_selected pde900.mtx" << endl;
+    return 1;
+  }
+  int ierr = read_matrix_and_run_tests<double,int>(argc, argv);
+  if (ierr) return ierr;
+  return read_matrix_and_run_tests<double,long long int>(argc, argv);
+}
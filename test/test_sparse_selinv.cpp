@@ -0,0 +1,190 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <random>
+#include <type_traits>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e4
+
+template<typename real_t> void
+perturb(real_t& v, std::mt19937& gen,
+        std::uniform_real_distribution<real_t>& dis) {
+  v *= dis(gen);
+}
+template<typename real_t> void
+perturb(std::complex<real_t>& v, std::mt19937& gen,
+        std::uniform_real_distribution<real_t>& dis) {
+  v *= std::polar(dis(gen), dis(gen));
+}
+
+/**
+ * Compute the diagonal of inv(A), and inv(A) on the sparsity pattern
+ * of A^T, with selected inversion, and compare with the inverse
+ * computed by solving with the identity. Fronts that do not support
+ * selected inversion should report NOT_SUPPORTED.
+ */
+template<typename scalar_t,typename integer_t> int
+check_selected_inverse(StrumpackSparseSolver<scalar_t,integer_t>& spss,
+                       const CSRMatrix<scalar_t,integer_t>& A,
+                       bool supported) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t N = A.size();
+  DenseMatrix<scalar_t> I(N, N), Ainv(N, N);
+  I.eye();
+  if (spss.solve(I, Ainv) != ReturnCode::SUCCESS) {
+    cout << "problem during solve" << endl;
+    return 1;
+  }
+  std::vector<scalar_t> d, z;
+  std::vector<integer_t> rows, cols;
+  for (integer_t i=0; i<N; i++)
+    for (integer_t k=A.ptr(i); k<A.ptr(i+1); k++) {
+      rows.push_back(A.ind()[k]);
+      cols.push_back(i);
+    }
+  auto ierr = spss.inverse_diagonal(d);
+  if (ierr == ReturnCode::SUCCESS)
+    ierr = spss.selected_inverse(rows, cols, z);
+  if (!supported) {
+    if (ierr != ReturnCode::NOT_SUPPORTED) {
+      cout << "selected inversion should not be supported" << endl;
+      return 1;
+    }
+    return 0;
+  }
+  if (ierr != ReturnCode::SUCCESS) {
+    cout << "problem during selected inversion" << endl;
+    return 1;
+  }
+  real_t err(0.), nrm = Ainv.normF() / N;
+  for (integer_t i=0; i<N; i++)
+    err = std::max(err, std::abs(d[i] - Ainv(i, i)));
+  for (std::size_t k=0; k<rows.size(); k++)
+    err = std::max(err, std::abs(z[k] - Ainv(rows[k], cols[k])));
+  cout << "# max error selected inverse = " << err
+       << ", |inv(A)|_F / N = " << nrm << endl;
+  if (err > ERROR_TOLERANCE * blas::lamch<real_t>('E') * nrm) {
+    cout << "ERROR TOO LARGE!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver(int argc, const char* const argv[],
+                   CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<real_t> dis(0.8, 1.25);
+  for (integer_t i=0; i<A.nnz(); i++)
+    perturb(A.val()[i], gen, dis);
+
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  spss.set_matrix(A);
+  return check_selected_inverse(spss, A, true);
+}
+
+/**
+ * Same check with the symmetric (LDL^T) solver, on a symmetric
+ * diagonally dominant matrix with the (symmetric) sparsity pattern of
+ * A. The symmetric (real) fronts do not support selected inversion.
+ */
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver_symmetric(int argc, const char* const argv[],
+                             const CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  integer_t N = A.size();
+  std::vector<scalar_t> val(A.nnz());
+  for (integer_t i=0; i<N; i++) {
+    real_t diag(1.);
+    integer_t kd = -1;
+    for (integer_t k=A.ptr(i); k<A.ptr(i+1); k++) {
+      auto j = A.ind()[k];
+      if (j == i) { kd = k; continue; }
+      real_t v = real_t(-1.) / (1 + (std::min(i, j) + std::max(i, j)) % 7);
+      val[k] = v;
+      diag += std::abs(v);
+    }
+    if (kd < 0) {
+      cout << "matrix has a zero diagonal entry" << endl;
+      return 1;
+    }
+    val[kd] = diag;
+  }
+  CSRMatrix<scalar_t,integer_t> S
+    (N, A.ptr(), A.ind(), val.data(), true);
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  spss.options().enable_symmetric();
+  spss.set_matrix(S);
+  // complex indefinite and compressed fronts are nonsymmetric
+  bool supported = !std::is_same<scalar_t,real_t>::value ||
+    spss.options().compression() != CompressionType::NONE;
+  return check_selected_inverse(spss, S, supported);
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f)) {
+    std::cerr << "Could not read matrix from file." << std::endl;
+    return 1;
+  }
+  std::vector<complex<real_t>> val(A.val(), A.val()+A.nnz());
+  CSRMatrix<complex<real_t>,integer_t> Acomplex
+    (A.size(), A.ptr(), A.ind(), val.data());
+  int ierr = test_sparse_solver_symmetric(argc, argv, A);
+  if (ierr) return ierr;
+  ierr = test_sparse_solver_symmetric(argc, argv, Acomplex);
+  if (ierr) return ierr;
+  ierr = test_sparse_solver(argc, argv, A);
+  if (ierr) return ierr;
+  return test_sparse_solver(argc, argv, Acomplex);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Compute selected entries of the inverse of a matrix given\n"
+      << "in matrix market format.\n\n"
+      << "Usage: \n\t./test_sparse_selinv pde900.mtx" << endl;
+    return 1;
+  }
+  int ierr = read_matrix_and_run_tests<double,int>(argc, argv);
+  if (ierr) return ierr;
+  return read_matrix_and_run_tests<double,long long int>(argc, argv);
+}
@@ -0,0 +1,162 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <limits>
+using namespace std;
+
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/SELLMatrix.hpp"
+
+using namespace strumpack;
+
+/**
+ * Random n x n CSR matrix with widely varying row lengths: every
+ * fifth row is empty, most rows are short, and some are long, so
+ * that every sorting window has rows of very different lengths.
+ */
+template<typename scalar_t,typename integer_t>
+CSRMatrix<scalar_t,integer_t> random_matrix(integer_t n, unsigned seed) {
+  mt19937 gen(seed);
+  uniform_real_distribution<double> val(-1., 1.);
+  vector<integer_t> ptr(n+1, 0), ind;
+  vector<scalar_t> v;
+  for (integer_t r=0; r<n; r++) {
+    integer_t len = 0;
+    if (r % 5 != 0)
+      len = (gen() % 8 == 0) ? 20 + gen() % 200 : gen() % 4;
+    len = std::min(len, n);
+    for (integer_t k=0; k<len; k++) {
+      ind.push_back(gen() % n);
+      v.push_back(scalar_t(val(gen)));
+    }
+    ptr[r+1] = ind.size();
+  }
+  return CSRMatrix<scalar_t,integer_t>
+    (n, ptr.data(), ind.data(), v.data());
+}
+
+template<typename scalar_t,typename integer_t> int
+test_spmv(integer_t n, unsigned seed) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  using DenseM_t = DenseMatrix<scalar_t>;
+  auto A = random_matrix<scalar_t,integer_t>(n, seed);
+  const real_t tol = 100 * numeric_limits<real_t>::epsilon();
+  const scalar_t nan(numeric_limits<real_t>::quiet_NaN());
+  integer_t d = 3;
+  DenseM_t X(n, d);
+  for (integer_t c=0; c<d; c++)
+    for (integer_t i=0; i<n; i++)
+      X(i, c) = scalar_t(std::sin(1. + i + 7.*c));
+  // reference: plain loop over the CSR matrix
+  DenseM_t Y(n, d);
+  real_t ymax = 1;
+  for (integer_t c=0; c<d; c++)
+    for (integer_t r=0; r<n; r++) {
+      scalar_t yr(0.);
+      for (integer_t j=A.ptr(r); j<A.ptr(r+1); j++)
+        yr += A.val(j) * X(A.ind(j), c);
+      Y(r, c) = yr;
+      ymax = std::max(ymax, std::abs(yr));
+    }
+  // returns true if Z is not close to Y, NaN means a row was not set
+  auto differs = [&](const DenseM_t& Z, integer_t c0, integer_t cols) {
+    for (integer_t c=0; c<cols; c++)
+      for (integer_t i=0; i<n; i++)
+        if (!(std::abs(Z(i, c) - Y(i, c0+c)) <= tol * ymax))
+          return true;
+    return false;
+  };
+  int ierr = 0;
+  // sigma rounded up to C, several windows, and one window
+  for (integer_t sigma : {integer_t(1), integer_t(8), integer_t(24),
+        integer_t(256), n}) {
+    SELLMatrix<scalar_t,integer_t> S
+      (n, A.ptr(), A.ind(), A.val(), sigma);
+    if (S.stored() < std::size_t(A.nnz()) ||
+        S.stored() % SELLMatrix<scalar_t,integer_t>::C) {
+      cout << "ERROR: SELL n=" << n << " sigma=" << sigma
+           << " stores " << S.stored() << " entries, nnz= "
+           << A.nnz() << endl;
+      ierr = 1;
+    }
+    for (integer_t c=0; c<d; c++) {
+      DenseM_t y(n, 1);
+      y.fill(nan);
+      S.spmv(X.ptr(0, c), y.data());
+      if (differs(y, c, 1)) {
+        cout << "ERROR: SELL spmv differs from CSR, n=" << n
+             << " sigma=" << sigma << " column " << c << endl;
+        ierr = 1;
+      }
+    }
+  }
+  // through the CSR matrix, with and without the SELL copy, single
+  // and multiple columns
+  for (bool sell : {false, true}) {
+    A.set_SELL_spmv(sell);
+    DenseM_t y(n, 1), Z(n, d);
+    y.fill(nan);
+    Z.fill(nan);
+    A.spmv(X.ptr(0, d-1), y.data());
+    A.spmv(X, Z);
+    if (differs(y, d-1, 1) || differs(Z, 0, d)) {
+      cout << "ERROR: CSRMatrix::spmv is wrong, n=" << n
+           << " SELL=" << sell << endl;
+      ierr = 1;
+    }
+  }
+  return ierr;
+}
+
+template<typename scalar_t,typename integer_t> int run() {
+  int ierr = 0;
+  // not a multiple of C, fewer rows than C, and a single slice
+  for (integer_t n : {1, 7, 8, 9, 63, 1001, 4099})
+    ierr |= test_spmv<scalar_t,integer_t>(n, n);
+  return ierr;
+}
+
+int main(int argc, char* argv[]) {
+  cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+  cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+  for (int i=0; i<argc; i++) cout << argv[i] << " ";
+  cout << endl;
+
+  int ierr = 0;
+  ierr |= run<double,int>();
+  ierr |= run<float,int>();
+  ierr |= run<complex<double>,int>();
+  ierr |= run<double,long long int>();
+  if (!ierr) cout << "# all spmv tests passed" << endl;
+  return ierr;
+}
@@ -0,0 +1,133 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <random>
+#include <limits>
+using namespace std;
+
+#include "sparse/CSRMatrix.hpp"
+#include "sparse/CSRMatrixMPI.hpp"
+
+using namespace strumpack;
+
+/**
+ * Random n x n CSR matrix, the same on every process, with empty
+ * rows and rows of very different lengths. The columns are spread
+ * over the whole matrix, so every process needs values of x from
+ * all other processes.
+ */
+template<typename scalar_t,typename integer_t>
+CSRMatrix<scalar_t,integer_t> random_matrix(integer_t n, unsigned seed) {
+  mt19937 gen(seed);
+  uniform_real_distribution<double> val(-1., 1.);
+  vector<integer_t> ptr(n+1, 0), ind;
+  vector<scalar_t> v;
+  for (integer_t r=0; r<n; r++) {
+    integer_t len = 0;
+    if (r % 5 != 0)
+      len = (gen() % 8 == 0) ? 20 + gen() % 100 : 1 + gen() % 4;
+    for (integer_t k=0; k<len; k++) {
+      ind.push_back(gen() % n);
+      v.push_back(scalar_t(val(gen)));
+    }
+    ptr[r+1] = ind.size();
+  }
+  return CSRMatrix<scalar_t,integer_t>
+    (n, ptr.data(), ind.data(), v.data());
+}
+
+/**
+ * Compare the distributed product with the sequential product, for
+ * a number of columns around the block size used in the multi-column
+ * spmv, and with a leading dimension larger than the number of local
+ * rows.
+ */
+template<typename scalar_t,typename integer_t> int
+test_spmv(const MPIComm& comm, integer_t n) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  using DenseM_t = DenseMatrix<scalar_t>;
+  using DenseMW_t = DenseMatrixWrapper<scalar_t>;
+  auto A = random_matrix<scalar_t,integer_t>(n, 1);
+  CSRMatrixMPI<scalar_t,integer_t> Ad(&A, comm, false);
+  auto lr = Ad.local_rows(), br = Ad.begin_row();
+  const real_t tol = 100 * numeric_limits<real_t>::epsilon();
+  const scalar_t nan(numeric_limits<real_t>::quiet_NaN());
+  int ierr = 0;
+  for (integer_t d : {1, 2, 7, 8, 9, 17}) {
+    DenseM_t X(n, d), Y(n, d), Yd(lr, d);
+    for (integer_t c=0; c<d; c++)
+      for (integer_t i=0; i<n; i++)
+        X(i, c) = scalar_t(std::sin(1. + i + 7.*c));
+    A.spmv(X, Y);
+    real_t ymax = 1;
+    for (integer_t c=0; c<d; c++)
+      for (integer_t i=0; i<n; i++)
+        ymax = std::max(ymax, std::abs(Y(i, c)));
+    // the local rows of X, with leading dimension n
+    DenseMW_t Xd(lr, d, X, br, 0);
+    Yd.fill(nan);
+    Ad.spmv(Xd, Yd);
+    for (integer_t c=0; c<d; c++)
+      for (integer_t i=0; i<lr; i++)
+        if (!(std::abs(Yd(i, c) - Y(br+i, c)) <= tol * ymax))
+          ierr = 1;
+    if (comm.all_reduce(ierr, MPI_MAX)) {
+      if (comm.is_root())
+        cout << "ERROR: distributed spmv with " << d
+             << " columns differs from the sequential spmv" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  MPI_Init(&argc, &argv);
+  int ierr = 0;
+  {
+    MPIComm c;
+    if (c.is_root()) {
+      cout << "# Running with:\n# ";
+#if defined(_OPENMP)
+      cout << "OMP_NUM_THREADS=" << omp_get_max_threads() << " ";
+#endif
+      cout << "mpirun -n " << c.size() << " ";
+      for (int i=0; i<argc; i++) cout << argv[i] << " ";
+      cout << endl;
+    }
+    ierr |= test_spmv<double,int>(c, 1001);
+    ierr |= test_spmv<complex<double>,int>(c, 1001);
+    ierr |= test_spmv<double,long long int>(c, 2003);
+    if (!ierr && c.is_root())
+      cout << "# all distributed spmv tests passed" << endl;
+  }
+  MPI_Finalize();
+  return ierr;
+}
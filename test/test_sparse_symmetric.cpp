@@ -0,0 +1,189 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+#define NRHS 4
+
+/**
+ * Solve a shifted 5-point Laplacian, A = L - sigma*I, with the
+ * symmetric (LDL^T or Cholesky) dense fronts. Only the lower
+ * triangular part is passed to the solver. With sigma > 0 the matrix
+ * is indefinite, and the inertia is compared to the number of
+ * eigenvalues of L smaller than sigma. Complex indefinite matrices
+ * are not supported by the symmetric fronts, the solver falls back to
+ * LU and should then keep the (nonsymmetric) matching and scaling.
+ */
+template<typename scalar_t,typename integer_t> CSRMatrix<scalar_t,integer_t>
+shifted_laplacian2d(integer_t k, double sigma) {
+  integer_t n = k * k, nnz = 5 * n - 4 * k;
+  CSRMatrix<scalar_t,integer_t> A(n, nnz);
+  auto ptr = A.ptr();
+  auto ind = A.ind();
+  auto val = A.val();
+  integer_t e = 0;
+  ptr[0] = 0;
+  for (integer_t y=0; y<k; y++)
+    for (integer_t x=0; x<k; x++) {
+      integer_t r = x + y * k;
+      auto add = [&](integer_t c, scalar_t v) { ind[e] = c; val[e++] = v; };
+      if (y > 0) add(r - k, -1.);
+      if (x > 0) add(r - 1, -1.);
+      add(r, 4. - sigma);
+      if (x < k-1) add(r + 1, -1.);
+      if (y < k-1) add(r + k, -1.);
+      ptr[r+1] = e;
+    }
+  return A;
+}
+
+template<typename integer_t> integer_t
+laplacian2d_eigs_below(integer_t k, double sigma) {
+  const double pi = 3.14159265358979323846;
+  integer_t neg = 0;
+  for (integer_t i=1; i<=k; i++)
+    for (integer_t j=1; j<=k; j++)
+      if (4. - 2. * std::cos(i * pi / (k + 1))
+          - 2. * std::cos(j * pi / (k + 1)) < sigma)
+        neg++;
+  return neg;
+}
+
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver(int argc, const char* const argv[], integer_t k,
+                   double sigma, int nrhs) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  auto A = shifted_laplacian2d<scalar_t,integer_t>(k, sigma);
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().enable_symmetric();
+  if (sigma <= 0) spss.options().enable_positive_definite();
+  spss.options().set_from_command_line(argc, argv);
+  const bool LU = is_complex<scalar_t>() && sigma > 0;
+  const auto matching = spss.options().matching();
+
+  int N = A.size();
+  DenseMatrix<scalar_t> B(N, nrhs), X(N, nrhs), X_exact(N, nrhs);
+  X_exact.random();
+  A.spmv(X_exact, B);
+
+  spss.set_lower_triangle_matrix(A);
+  if (spss.reorder() != ReturnCode::SUCCESS) {
+    cout << "problem with reordering of the matrix." << endl;
+    return 1;
+  }
+  if (LU && spss.options().matching() != matching) {
+    cout << "matching disabled for the LU fallback!" << endl;
+    return 1;
+  }
+  if (spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during factorization of the matrix." << endl;
+    return 1;
+  }
+  spss.solve(B, X);
+
+  real_t max_res = 0.;
+  for (int c=0; c<nrhs; c++) {
+    auto comp_scal_res = A.max_scaled_residual(X.ptr(0, c), B.ptr(0, c));
+    cout << "# COMPONENTWISE SCALED RESIDUAL " << c << " = "
+         << comp_scal_res << endl;
+    max_res = std::max(max_res, comp_scal_res);
+  }
+  if (max_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+    cout << "RESIDUAL TOO LARGE!" << endl;
+    return 1;
+  }
+
+  // A^T = A, the transposed solve reuses the same factors
+  if (spss.solve(B, X, Trans::T) != ReturnCode::SUCCESS) {
+    cout << "problem during the transposed solve." << endl;
+    return 1;
+  }
+  for (int c=0; c<nrhs; c++)
+    max_res = std::max
+      (max_res, A.max_scaled_residual(X.ptr(0, c), B.ptr(0, c)));
+  cout << "# MAX COMPONENTWISE SCALED RESIDUAL, A^T X = B: "
+       << max_res << endl;
+  if (max_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+    cout << "RESIDUAL TOO LARGE!" << endl;
+    return 1;
+  }
+
+  if (LU) return 0;
+  integer_t neg, zero, pos;
+  if (spss.inertia(neg, zero, pos) != ReturnCode::SUCCESS) {
+    cout << "problem computing the inertia." << endl;
+    return 1;
+  }
+  cout << "# INERTIA neg,zero,pos = "
+       << neg << ", " << zero << ", " << pos << endl;
+  if (neg != laplacian2d_eigs_below(k, sigma) || zero != 0 ||
+      neg + pos != N) {
+    cout << "WRONG INERTIA!" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+template<typename scalar_t,typename integer_t>
+int run_tests(int argc, const char* const argv[], integer_t k,
+              double sigma) {
+  int ierr = test_sparse_solver<scalar_t>(argc, argv, k, sigma, 1);
+  if (ierr) return ierr;
+  return test_sparse_solver<scalar_t>(argc, argv, k, sigma, NRHS);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Solve a shifted 2D Laplacian on a k x k grid with the\n"
+      << "symmetric LDL^T and Cholesky frontal matrices.\n\n"
+      << "Usage: \n\t./test_sparse_symmetric k [options]" << endl;
+    return 1;
+  }
+  int k = stoi(argv[1]);
+  // indefinite, LDL^T
+  int ierr = run_tests<double,int>(argc, argv, k, 1.3);
+  if (ierr) return ierr;
+  ierr = run_tests<float,long long int>(argc, argv, k, 2.7);
+  if (ierr) return ierr;
+  // positive definite, Cholesky
+  ierr = run_tests<double,long long int>(argc, argv, k, 0.);
+  if (ierr) return ierr;
+  ierr = run_tests<std::complex<double>,int>(argc, argv, k, 0.);
+  if (ierr) return ierr;
+  // complex indefinite, falls back to LU
+  return run_tests<std::complex<double>,int>(argc, argv, k, 1.3);
+}
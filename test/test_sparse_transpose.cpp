@@ -0,0 +1,132 @@
+/*
+ * STRUMPACK -- STRUctured Matrices PACKage, Copyright (c) 2014, The
+ * Regents of the University of California, through Lawrence Berkeley
+ * National Laboratory (subject to receipt of any required approvals
+ * from the U.S. Dept. of Energy).  All rights reserved.
+ *
+ * If you have questions about your rights to use or distribute this
+ * software, please contact Berkeley Lab's Technology Transfer
+ * Department at TTD@lbl.gov.
+ *
+ * NOTICE. This software is owned by the U.S. Department of Energy. As
+ * such, the U.S. Government has been granted for itself and others
+ * acting on its behalf a paid-up, nonexclusive, irrevocable,
+ * worldwide license in the Software to reproduce, prepare derivative
+ * works, and perform publicly and display publicly.  Beginning five
+ * (5) years after the date permission to assert copyright is obtained
+ * from the U.S. Department of Energy, and subject to any subsequent
+ * five (5) year renewals, the U.S. Government is granted for itself
+ * and others acting on its behalf a paid-up, nonexclusive,
+ * irrevocable, worldwide license in the Software to reproduce,
+ * prepare derivative works, distribute copies to the public, perform
+ * publicly and display publicly, and to permit others to do so.
+ *
+ * Developers: Pieter Ghysels, Francois-Henry Rouet, Xiaoye S. Li.
+ *             (Lawrence Berkeley National Lab, Computational Research
+ *             Division).
+ *
+ */
+#include <iostream>
+#include <random>
+using namespace std;
+
+#include "StrumpackSparseSolver.hpp"
+#include "sparse/CSRMatrix.hpp"
+
+using namespace strumpack;
+
+#define ERROR_TOLERANCE 1e2
+#define NRHS 3
+
+template<typename real_t> void
+perturb(real_t& v, std::mt19937& gen,
+        std::uniform_real_distribution<real_t>& dis) {
+  v *= dis(gen);
+}
+template<typename real_t> void
+perturb(std::complex<real_t>& v, std::mt19937& gen,
+        std::uniform_real_distribution<real_t>& dis) {
+  v *= std::polar(dis(gen), dis(gen));
+}
+
+/**
+ * Factor A once, and solve with A, A^T and A^H, using the same
+ * factors. The matrix values are perturbed to make A nonsymmetric,
+ * so the matching and equilibration scalings are different for the
+ * rows and the columns.
+ */
+template<typename scalar_t,typename integer_t> int
+test_sparse_solver(int argc, const char* const argv[],
+                   CSRMatrix<scalar_t,integer_t>& A) {
+  using real_t = typename RealType<scalar_t>::value_type;
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<real_t> dis(0.8, 1.25);
+  for (integer_t i=0; i<A.nnz(); i++)
+    perturb(A.val()[i], gen, dis);
+
+  StrumpackSparseSolver<scalar_t,integer_t> spss;
+  spss.options().set_from_command_line(argc, argv);
+  spss.set_matrix(A);
+  if (spss.reorder() != ReturnCode::SUCCESS) {
+    cout << "problem with reordering of the matrix." << endl;
+    return 1;
+  }
+  if (spss.factor() != ReturnCode::SUCCESS) {
+    cout << "problem during factorization of the matrix." << endl;
+    return 1;
+  }
+
+  int N = A.size();
+  for (auto op : {Trans::N, Trans::T, Trans::C}) {
+    for (int nrhs : {1, NRHS}) {
+      DenseMatrix<scalar_t> B(N, nrhs), X(N, nrhs), R(N, nrhs);
+      B.random();
+      auto ierr = nrhs == 1 ?
+        spss.solve(B.data(), X.data(), op) : spss.solve(B, X, op);
+      if (ierr != ReturnCode::SUCCESS) {
+        cout << "problem during solve with op=" << char(op)
+             << ": " << ierr << endl;
+        return 1;
+      }
+      A.spmv(op, X, R);
+      R.scaled_add(scalar_t(-1.), B);
+      auto rel_res = R.normF() / B.normF();
+      cout << "# op=" << char(op) << " nrhs=" << nrhs
+           << " RELATIVE RESIDUAL = " << rel_res << endl;
+      if (rel_res > ERROR_TOLERANCE*spss.options().rel_tol()) {
+        cout << "RESIDUAL TOO LARGE!" << endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+template<typename real_t,typename integer_t>
+int read_matrix_and_run_tests(int argc, const char* const argv[]) {
+  string f(argv[1]);
+  CSRMatrix<real_t,integer_t> A;
+  if (A.read_matrix_market(f)) {
+    std::cerr << "Could not read matrix from file." << std::endl;
+    return 1;
+  }
+  int ierr = test_sparse_solver(argc, argv, A);
+  if (ierr) return ierr;
+  std::vector<complex<real_t>> val(A.val(), A.val()+A.nnz());
+  CSRMatrix<complex<real_t>,integer_t> Acomplex
+    (A.size(), A.ptr(), A.ind(), val.data());
+  return test_sparse_solver(argc, argv, Acomplex);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cout
+      << "Solve a linear system with A, A^T and A^H, using the\n"
+      << "factors of A, with a matrix given in matrix market format.\n\n"
+      << "Usage: \n\t./test_sparse_transpose pde900.mtx" << endl;
+    return 1;
+  }
+  int ierr = read_matrix_and_run_tests<double,int>(argc, argv);
+  if (ierr) return ierr;
+  return read_matrix_and_run_tests<double,long long int>(argc, argv);
+}